@@ -20,16 +20,21 @@
 #include "hikptdev_plug.h"
 
 static uint32_t g_cmd_param_mask = {0};
+static struct core_ring_watch g_ring_watch;
 
 static int hikp_core_ring_help(struct major_cmd_ctrl *self, const char *argv)
 {
 	HIKP_SET_USED(argv);
 
-	printf("\n  Usage: %s %s\n", self->cmd_ptr->name, "-d");
+	printf("\n  Usage: %s %s\n", self->cmd_ptr->name, "-d | -w <ms> [-n <count>]");
 	printf("\n         %s\n", self->cmd_ptr->help_info);
 	printf("  Options:\n\n");
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-d", "--dump", "dump the ring info of the cpu core");
+	printf("    %s, %-25s %s\n", "-w", "--watch=<ms>",
+	       "resample every <ms> and print one line per changed cluster");
+	printf("    %s, %-25s %s\n", "-n", "--count=<num>",
+	       "stop watching after <num> rounds, default until interrupted");
 	printf("\n");
 
 	return 0;
@@ -45,6 +50,40 @@ static int hikp_core_ring_get_info(struct major_cmd_ctrl *self, const char *argv
 	return 0;
 }
 
+static int hikp_core_ring_watch_interval(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t val = 0;
+
+	if (string_toui(argv, &val) != 0 || val < RING_WATCH_MIN_INTERVAL ||
+	    val > RING_WATCH_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "Invalid watch interval, range is %u~%u ms.",
+			 RING_WATCH_MIN_INTERVAL, RING_WATCH_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+
+	g_ring_watch.interval = val;
+	g_cmd_param_mask |= PARAM_WATCH_MASK;
+
+	return 0;
+}
+
+static int hikp_core_ring_watch_count(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t val = 0;
+
+	if (string_toui(argv, &val) != 0 || val == 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "Invalid watch count.");
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+
+	g_ring_watch.count = val;
+
+	return 0;
+}
+
 static void hikp_core_ring_print_info(const struct core_ring_info *ring_info)
 {
 	uint32_t cnt = 0;
@@ -61,30 +100,126 @@ static void hikp_core_ring_print_info(const struct core_ring_info *ring_info)
 	}
 }
 
-static void hikp_core_ring_dump(struct major_cmd_ctrl *self)
+static int hikp_core_ring_query(struct core_ring_info *ring_info)
 {
 	struct hikp_cmd_header req_header = {0};
 	struct core_ring_req cmd_req = {0};
 	struct hikp_cmd_ret *cmd_ret;
+	int ret;
 
 	hikp_cmd_init(&req_header, CORE_RING_MOD, CORE_RING_DUMP, RING_INFO_DUMP);
 	cmd_ret = hikp_cmd_alloc(&req_header, &cmd_req, sizeof(cmd_req));
-	self->err_no = hikp_rsp_normal_check(cmd_ret);
+	ret = hikp_rsp_normal_check(cmd_ret);
+	if (ret != 0) {
+		hikp_cmd_free(&cmd_ret);
+		return ret;
+	}
+
+	memset(ring_info, 0, sizeof(*ring_info));
+	memcpy(ring_info, cmd_ret->rsp_data,
+	       HIKP_MIN(sizeof(*ring_info), cmd_ret->rsp_data_num * sizeof(uint32_t)));
+	hikp_cmd_free(&cmd_ret);
+
+	return 0;
+}
+
+static void hikp_core_ring_dump(struct major_cmd_ctrl *self)
+{
+	struct core_ring_info ring_info;
+
+	self->err_no = hikp_core_ring_query(&ring_info);
 	if (self->err_no != 0) {
 		snprintf(self->err_str, sizeof(self->err_str), "get core ring info failed.");
-		hikp_cmd_free(&cmd_ret);
 		return;
 	}
 
-	hikp_core_ring_print_info((struct core_ring_info *)cmd_ret->rsp_data);
+	hikp_core_ring_print_info(&ring_info);
+}
 
-	hikp_cmd_free(&cmd_ret);
+static uint32_t hikp_core_ring_data_num(const struct core_ring_info *ring_info)
+{
+	return HIKP_MIN((uint32_t)ring_info->chip_num * ring_info->per_cluster_num,
+			(uint32_t)RING_DATA_MAX);
+}
+
+static void hikp_core_ring_print_change(const struct core_ring_info *ring_info, uint32_t idx,
+					uint64_t old_data, uint64_t now)
+{
+	uint64_t prev = g_ring_watch.last_change[idx];
+
+	printf("%" PRIu64 ".%03" PRIu64 " chip%u cluster%u 0x%" PRIx64 " -> 0x%" PRIx64
+	       " changes=%u", (uint64_t)(now / HIKP_NSEC_PER_SEC),
+	       (uint64_t)((now % HIKP_NSEC_PER_SEC) / HIKP_NSEC_PER_MSEC),
+	       idx / ring_info->per_cluster_num, idx % ring_info->per_cluster_num, old_data,
+	       ring_info->ring_data[idx], g_ring_watch.trans[idx]);
+	if (prev != 0)
+		printf(" since_last=%.3fs\n", (double)(now - prev) / HIKP_NSEC_PER_SEC);
+	else
+		printf(" since_last=-\n");
+}
+
+static void hikp_core_ring_watch(struct major_cmd_ctrl *self)
+{
+	uint64_t period_ns = (uint64_t)g_ring_watch.interval * HIKP_NSEC_PER_MSEC;
+	struct core_ring_info last, cur;
+	uint64_t deadline, now;
+	uint32_t data_num, i;
+	uint32_t round;
+
+	self->err_no = hikp_core_ring_query(&last);
+	if (self->err_no != 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "get core ring info failed.");
+		return;
+	}
+	data_num = hikp_core_ring_data_num(&last);
+	printf("# watching %u chip(s) x %u cluster(s) every %u ms, only changes are shown\n",
+	       last.chip_num, last.per_cluster_num, g_ring_watch.interval);
+	(void)fflush(stdout);
+
+	deadline = tool_get_time_ns();
+	for (round = 0; g_ring_watch.count == 0 || round < g_ring_watch.count; round++) {
+		deadline += period_ns;
+		self->err_no = cmd_sleep_until(deadline);
+		if (self->err_no != 0) {
+			snprintf(self->err_str, sizeof(self->err_str), "retake the lock failed.");
+			return;
+		}
+
+		if (hikp_core_ring_query(&cur) != 0) {
+			printf("# get core ring info failed, retry next round\n");
+			continue;
+		}
+		/* The layout is fixed for a running system, a new one only resets the baseline */
+		if (cur.chip_num != last.chip_num || cur.per_cluster_num != last.per_cluster_num) {
+			printf("# ring layout changed to %u chip(s) x %u cluster(s)\n",
+			       cur.chip_num, cur.per_cluster_num);
+			data_num = hikp_core_ring_data_num(&cur);
+			last = cur;
+			continue;
+		}
+
+		now = tool_get_wall_time_ns();
+		for (i = 0; i < data_num; i++) {
+			if (cur.ring_data[i] == last.ring_data[i])
+				continue;
+			g_ring_watch.trans[i]++;
+			hikp_core_ring_print_change(&cur, i, last.ring_data[i], now);
+			g_ring_watch.last_change[i] = now;
+		}
+		last = cur;
+		(void)fflush(stdout);
+	}
 }
 
 static void hikp_core_ring_cmd_execute(struct major_cmd_ctrl *self)
 {
+	if ((g_cmd_param_mask & PARAM_WATCH_MASK) != 0) {
+		hikp_core_ring_watch(self);
+		return;
+	}
+
 	if ((g_cmd_param_mask & PARAM_DUMP_MASK) == 0) {
-		snprintf(self->err_str, sizeof(self->err_str), "Need input -d param!");
+		snprintf(self->err_str, sizeof(self->err_str), "Need input -d or -w param!");
 		self->err_no = -EINVAL;
 		return;
 	}
@@ -101,6 +236,8 @@ static void cmd_core_ring_info_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_core_ring_help);
 	cmd_option_register("-d", "--dump", false, hikp_core_ring_get_info);
+	cmd_option_register("-w", "--watch", true, hikp_core_ring_watch_interval);
+	cmd_option_register("-n", "--count", true, hikp_core_ring_watch_count);
 }
 
 HIKP_CMD_DECLARE("cpu_ring", "dump cpu core ring info.", cmd_core_ring_info_init);
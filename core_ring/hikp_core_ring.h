@@ -17,6 +17,10 @@
 #include "tool_lib.h"
 
 #define PARAM_DUMP_MASK		HI_BIT(0)
+#define PARAM_WATCH_MASK	HI_BIT(1)
+
+#define RING_WATCH_MIN_INTERVAL	10 /* ms */
+#define RING_WATCH_MAX_INTERVAL	3600000 /* ms */
 
 enum core_ring_cmd_type {
 	CORE_RING_DUMP = 1,
@@ -35,6 +39,14 @@ struct core_ring_info {
 	uint64_t ring_data[RING_DATA_MAX];
 };
 
+/* Per cluster state kept by cpu_ring --watch */
+struct core_ring_watch {
+	uint32_t interval; /* ms */
+	uint32_t count; /* rounds, 0 means until interrupted */
+	uint32_t trans[RING_DATA_MAX];
+	uint64_t last_change[RING_DATA_MAX]; /* tool_get_wall_time_ns(), 0 if never changed */
+};
+
 struct core_ring_req {
 	uint32_t cmd_flag; /* Reserved in the current version */
 };
@@ -154,7 +154,7 @@ static void cmd_cxl_cpa_init(void)
 	cmd_option_register("-i", "--interface", true, cxl_port_id_set);
 	cmd_option_register("-e", "--error", false, cxl_cpa_err_status_show);
 	cmd_option_register("-d", "--dump", false, cxl_cpa_dump);
-	cmd_option_register("-c", "--config", false, cxl_cpa_config);
+	cmd_writer_option_register("-c", "--config", false, cxl_cpa_config);
 	cmd_option_register("-m", "--mmrg", false, cxl_cpa_mmrg_show);
 }
 
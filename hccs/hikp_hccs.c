@@ -16,9 +16,12 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <inttypes.h>
 #include "tool_cmd.h"
+#include "op_logs.h"
 #include "hikpt_rciep.h"
 #include "hikp_hccs.h"
 
@@ -53,6 +56,7 @@ static int hikp_hccs_get_port_dfx_info(struct hccs_param *param,
 static void hikp_hccs_show_port_dfx_info(union hccs_feature_info *feature_info);
 static int hikp_plat_hccs_hw_info(struct hikp_plat_hccs_info *hccs_info);
 static int hikp_hccs_get_die_num(uint8_t chip_id, struct hikp_plat_hccs_info *hccs_info);
+static void hikp_plat_hccs_free(struct hikp_plat_hccs_info *hccs_info);
 
 static const struct hikp_hccs_feature_cmd g_hccs_feature_cmd[] = {
 	{"topo", HCCS_GET_PORT_IDS_ON_DIE, hikp_hccs_get_plat_topo,
@@ -74,13 +78,16 @@ static int hikp_hccs_cmd_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-c", "--chip_id=<chip_id>", "target chip ID which is from 'X' in chipX");
 	printf("    %s, %-25s %s\n", "-d", "--die_id=<die_id>", "target die ID which is from 'Y' in dieY");
 	printf("    %s, %-25s %s\n", "-p", "--port_id=<port_id>", "target port ID which from 'Z' in hccsZ");
+	printf("    %s, %-25s %s\n", "-a", "--all", "sweep all ports of all chips and dies (dfx_info only)");
 	printf("      %s\n",
 	       "[-g/--get <options>]\n"
 	       "          topo : get HCCS topology information, no target specified.\n"
 	       "          fixed_attr : get fixed attributes of one port specified by -c X -d Y -p Z.\n"
-	       "          dfx_info : get dfx info of one port specified by -c X -d Y -p Z.\n"
+	       "          dfx_info : get dfx info of one port specified by -c X -d Y -p Z,\n"
+	       "                     or of all ports in one table with -a.\n"
 	       "\n"
-	       "     eg: hikptool hccs -g dfx_info -c 0 -d 2 -p 1\n");
+	       "     eg: hikptool hccs -g dfx_info -c 0 -d 2 -p 1\n"
+	       "         hikptool hccs -g dfx_info -a\n");
 	return 0;
 }
 
@@ -311,7 +318,9 @@ static int hikp_hccs_get_all_port_info(struct hikp_plat_hccs_info *hccs_info)
 			has_port = true;
 			die_info->port_ids = (uint8_t *)calloc(die_info->port_num,
 							       sizeof(uint8_t));
-			if (die_info->port_ids == NULL)
+			die_info->lane_modes = (uint8_t *)calloc(die_info->port_num,
+								 sizeof(uint8_t));
+			if (die_info->port_ids == NULL || die_info->lane_modes == NULL)
 				return -ENOMEM;
 
 			ret = hikp_hccs_get_ports_on_die(die_info->port_ids, die_info->port_num,
@@ -333,10 +342,13 @@ static int hikp_hccs_get_chip_info(struct hikp_plat_hccs_info *hccs_info)
 	uint8_t chip_id;
 	int ret;
 
-	ret = hikp_hccs_get_chip_num(hccs_info);
-	if (ret < 0) {
-		HIKP_ERROR_PRINT("Failed to get chip num!\n");
-		return ret;
+	/* The chip number may have been queried already by the caller. */
+	if (hccs_info->chip_num == 0) {
+		ret = hikp_hccs_get_chip_num(hccs_info);
+		if (ret < 0) {
+			HIKP_ERROR_PRINT("Failed to get chip num!\n");
+			return ret;
+		}
 	}
 
 	hccs_info->chip_info = (struct hccs_chip_info *)calloc(hccs_info->chip_num,
@@ -381,6 +393,240 @@ static int hikp_plat_hccs_hw_info(struct hikp_plat_hccs_info *hccs_info)
 	return 0;
 }
 
+static int hikp_hccs_read_boot_id(char *boot_id, size_t len)
+{
+	FILE *fp;
+	size_t i;
+
+	fp = fopen(HCCS_BOOT_ID_PATH, "r");
+	if (fp == NULL)
+		return -errno;
+
+	memset(boot_id, 0, len);
+	if (fgets(boot_id, (int)len, fp) == NULL) {
+		fclose(fp);
+		return -EIO;
+	}
+	fclose(fp);
+
+	for (i = 0; i < len && boot_id[i] != '\0'; i++) {
+		if (boot_id[i] == '\n') {
+			boot_id[i] = '\0';
+			break;
+		}
+	}
+
+	return boot_id[0] == '\0' ? -EINVAL : 0;
+}
+
+static uint32_t hikp_hccs_topo_cache_data_len(const struct hikp_plat_hccs_info *hccs_info)
+{
+	struct hccs_chip_info *chip_info;
+	uint8_t chip_id, die_idx;
+	uint32_t len = 0;
+
+	for (chip_id = 0; chip_id < hccs_info->chip_num; chip_id++) {
+		chip_info = &hccs_info->chip_info[chip_id];
+		len += sizeof(uint8_t);
+		for (die_idx = 0; die_idx < chip_info->die_num; die_idx++)
+			len += sizeof(uint8_t) + sizeof(uint16_t) +
+			       chip_info->die_info[die_idx].port_num * 2U;
+	}
+
+	return len;
+}
+
+static void hikp_hccs_topo_cache_save(const struct hikp_plat_hccs_info *hccs_info)
+{
+	char tmp_file[OP_LOG_FILE_PATH_MAXLEN] = {0};
+	struct hccs_topo_cache_head *head;
+	struct hccs_chip_info *chip_info;
+	struct hccs_die_info *die_info;
+	uint8_t chip_id, die_idx;
+	uint8_t *buf, *pos;
+	uint32_t buf_len;
+	ssize_t wr_len;
+	int fd;
+
+	buf_len = sizeof(struct hccs_topo_cache_head) +
+		  hikp_hccs_topo_cache_data_len(hccs_info);
+	if (buf_len > HCCS_TOPO_CACHE_MAX_SIZE)
+		return;
+
+	buf = (uint8_t *)calloc(1, buf_len);
+	if (buf == NULL)
+		return;
+
+	head = (struct hccs_topo_cache_head *)buf;
+	if (hikp_hccs_read_boot_id(head->boot_id, sizeof(head->boot_id)) != 0)
+		goto out;
+	head->magic = HCCS_TOPO_CACHE_MAGIC;
+	head->version = HCCS_TOPO_CACHE_VER;
+	head->data_len = buf_len - sizeof(struct hccs_topo_cache_head);
+	head->chip_num = hccs_info->chip_num;
+
+	pos = buf + sizeof(struct hccs_topo_cache_head);
+	for (chip_id = 0; chip_id < hccs_info->chip_num; chip_id++) {
+		chip_info = &hccs_info->chip_info[chip_id];
+		*pos++ = chip_info->die_num;
+		for (die_idx = 0; die_idx < chip_info->die_num; die_idx++) {
+			die_info = &chip_info->die_info[die_idx];
+			*pos++ = die_info->die_id;
+			memcpy(pos, &die_info->port_num, sizeof(uint16_t));
+			pos += sizeof(uint16_t);
+			memcpy(pos, die_info->port_ids, die_info->port_num);
+			pos += die_info->port_num;
+			memcpy(pos, die_info->lane_modes, die_info->port_num);
+			pos += die_info->port_num;
+		}
+	}
+
+	/* Write a temporary file and rename it, so no reader sees a partial cache. */
+	(void)snprintf(tmp_file, sizeof(tmp_file), "%s.tmp", HCCS_TOPO_CACHE_FILE);
+	fd = open(tmp_file, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) {
+		HIKP_WARN_PRINT("open %s failed, errno is %d\n", tmp_file, errno);
+		goto out;
+	}
+	wr_len = write(fd, buf, buf_len);
+	close(fd);
+	if (wr_len != (ssize_t)buf_len || rename(tmp_file, HCCS_TOPO_CACHE_FILE) != 0) {
+		HIKP_WARN_PRINT("Failed to save HCCS topology cache.\n");
+		(void)remove(tmp_file);
+	}
+
+out:
+	free(buf);
+}
+
+static int hikp_hccs_topo_cache_parse(struct hikp_plat_hccs_info *hccs_info,
+				      const uint8_t *data, uint32_t len)
+{
+	const uint8_t *end = data + len;
+	struct hccs_chip_info *chip_info;
+	struct hccs_die_info *die_info;
+	uint8_t chip_id, die_idx;
+
+	hccs_info->chip_info = (struct hccs_chip_info *)calloc(hccs_info->chip_num,
+							       sizeof(struct hccs_chip_info));
+	if (hccs_info->chip_info == NULL)
+		return -ENOMEM;
+
+	for (chip_id = 0; chip_id < hccs_info->chip_num; chip_id++) {
+		chip_info = &hccs_info->chip_info[chip_id];
+		if (data + sizeof(uint8_t) > end)
+			return -EINVAL;
+		chip_info->die_num = *data++;
+		if (chip_info->die_num == 0)
+			continue;
+
+		chip_info->die_info = (struct hccs_die_info *)calloc(chip_info->die_num,
+								     sizeof(struct hccs_die_info));
+		if (chip_info->die_info == NULL)
+			return -ENOMEM;
+
+		for (die_idx = 0; die_idx < chip_info->die_num; die_idx++) {
+			die_info = &chip_info->die_info[die_idx];
+			if (data + sizeof(uint8_t) + sizeof(uint16_t) > end)
+				return -EINVAL;
+			die_info->die_id = *data++;
+			memcpy(&die_info->port_num, data, sizeof(uint16_t));
+			data += sizeof(uint16_t);
+			if (die_info->port_num == 0)
+				continue;
+			if (data + die_info->port_num * 2U > end)
+				return -EINVAL;
+
+			die_info->port_ids = (uint8_t *)calloc(die_info->port_num, sizeof(uint8_t));
+			die_info->lane_modes = (uint8_t *)calloc(die_info->port_num,
+								 sizeof(uint8_t));
+			if (die_info->port_ids == NULL || die_info->lane_modes == NULL)
+				return -ENOMEM;
+			memcpy(die_info->port_ids, data, die_info->port_num);
+			data += die_info->port_num;
+			memcpy(die_info->lane_modes, data, die_info->port_num);
+			data += die_info->port_num;
+		}
+	}
+
+	return data == end ? 0 : -EINVAL;
+}
+
+static int hikp_hccs_topo_cache_load(struct hikp_plat_hccs_info *hccs_info)
+{
+	char boot_id[HCCS_BOOT_ID_LEN] = {0};
+	struct hccs_topo_cache_head *head;
+	struct stat file_stat = {0};
+	uint8_t *buf = NULL;
+	ssize_t rd_len;
+	int ret;
+	int fd;
+
+	ret = hikp_hccs_read_boot_id(boot_id, sizeof(boot_id));
+	if (ret != 0)
+		return ret;
+
+	fd = open(HCCS_TOPO_CACHE_FILE, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	if (fstat(fd, &file_stat) != 0 ||
+	    file_stat.st_size <= (off_t)sizeof(struct hccs_topo_cache_head) ||
+	    file_stat.st_size > HCCS_TOPO_CACHE_MAX_SIZE) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	buf = (uint8_t *)calloc(1, (size_t)file_stat.st_size);
+	if (buf == NULL) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	rd_len = read(fd, buf, (size_t)file_stat.st_size);
+	if (rd_len != (ssize_t)file_stat.st_size) {
+		ret = -EIO;
+		goto out;
+	}
+
+	head = (struct hccs_topo_cache_head *)buf;
+	if (head->magic != HCCS_TOPO_CACHE_MAGIC || head->version != HCCS_TOPO_CACHE_VER ||
+	    head->chip_num == 0 ||
+	    head->data_len != (uint32_t)rd_len - sizeof(struct hccs_topo_cache_head) ||
+	    strncmp(head->boot_id, boot_id, sizeof(boot_id)) != 0) {
+		ret = -ESTALE;
+		goto out;
+	}
+
+	hccs_info->chip_num = head->chip_num;
+	ret = hikp_hccs_topo_cache_parse(hccs_info, buf + sizeof(struct hccs_topo_cache_head),
+					 head->data_len);
+	if (ret != 0) {
+		hikp_plat_hccs_free(hccs_info);
+		hccs_info->chip_num = 0;
+	}
+
+out:
+	free(buf);
+	close(fd);
+	return ret;
+}
+
+static int hikp_hccs_get_topo(struct hikp_plat_hccs_info *hccs_info)
+{
+	int ret;
+
+	if (hccs_info->chip_info != NULL)
+		return 0;
+
+	ret = hikp_plat_hccs_hw_info(hccs_info);
+	if (ret != 0)
+		return ret;
+
+	hikp_hccs_topo_cache_save(hccs_info);
+	return 0;
+}
+
 static int hikp_hccs_get_plat_topo(struct hccs_param *param,
 				   union hccs_feature_info *info)
 {
@@ -389,7 +635,7 @@ static int hikp_hccs_get_plat_topo(struct hccs_param *param,
 	HIKP_SET_USED(param);
 	HIKP_SET_USED(info);
 
-	ret = hikp_plat_hccs_hw_info(&g_hccs_info);
+	ret = hikp_hccs_get_topo(&g_hccs_info);
 	if (ret < 0) {
 		HIKP_ERROR_PRINT("Failed to get HCCS hardware info, ret = %d!\n", ret);
 		return ret;
@@ -413,10 +659,10 @@ static void hikp_plat_hccs_free(struct hikp_plat_hccs_info *hccs_info)
 			continue;
 
 		for (die_idx = 0; die_idx < chip_info->die_num; die_idx++) {
-			if (die_info[die_idx].port_ids == NULL)
-				continue;
 			free(die_info[die_idx].port_ids);
 			die_info[die_idx].port_ids = NULL;
+			free(die_info[die_idx].lane_modes);
+			die_info[die_idx].lane_modes = NULL;
 		}
 		free(die_info);
 		chip_info->die_info = NULL;
@@ -488,15 +734,28 @@ static bool hikp_hccs_req_param_check(struct hikp_plat_hccs_info *hccs_info,
 	return true;
 }
 
-static int hikp_hccs_get_port_attr(struct hccs_param *param,
-				   union hccs_feature_info *info)
+static int hikp_hccs_query_port_attr(uint8_t chip_id, uint8_t die_id, uint8_t port_id,
+				     union hccs_feature_info *info)
 {
 	struct hccs_port_attr_req_para *req_para;
 	struct hikp_cmd_header req_header = {0};
 	struct hikp_hccs_req req = {0};
+
+	hikp_cmd_init(&req_header, HCCS_MOD, HCCS_GET_PORT_FIXED_ATTR, 0);
+	req_para = (struct hccs_port_attr_req_para *)&req.req_data;
+	req_para->chip_id = chip_id;
+	req_para->die_id = die_id;
+	req_para->port_id = port_id;
+	return hikp_hccs_query(&req_header, &req,
+			       info, sizeof(union hccs_feature_info));
+}
+
+static int hikp_hccs_get_port_attr(struct hccs_param *param,
+				   union hccs_feature_info *info)
+{
 	int ret;
 
-	ret = hikp_plat_hccs_hw_info(&g_hccs_info);
+	ret = hikp_hccs_get_topo(&g_hccs_info);
 	if (ret != 0) {
 		HIKP_ERROR_PRINT("Failed to get HCCS hardware info for "
 				 "port attributes, ret = %d.\n", ret);
@@ -506,43 +765,23 @@ static int hikp_hccs_get_port_attr(struct hccs_param *param,
 	if (!hikp_hccs_req_param_check(&g_hccs_info, param))
 		return -EINVAL;
 
-	hikp_cmd_init(&req_header, HCCS_MOD, HCCS_GET_PORT_FIXED_ATTR, 0);
-	req_para = (struct hccs_port_attr_req_para *)&req.req_data;
-	req_para->chip_id = param->chip_id;
-	req_para->die_id = param->die_id;
-	req_para->port_id = param->port_id;
-	ret = hikp_hccs_query(&req_header, &req,
-			      info, sizeof(union hccs_feature_info));
-	if (ret != 0)
-		return ret;
-	return 0;
+	return hikp_hccs_query_port_attr(param->chip_id, param->die_id,
+					 (uint8_t)param->port_id, info);
 }
 
-static int hikp_hccs_get_port_dfx_info(struct hccs_param *param,
-				       union hccs_feature_info *info)
+static int hikp_hccs_query_port_dfx(uint8_t chip_id, uint8_t die_id, uint8_t port_id,
+				    struct hccs_port_dfx_info_vld *dfx_info)
 {
 	struct hikp_hccs_rsp_head rsp_head = {0};
 	struct hikp_cmd_header req_header = {0};
-	struct hccs_port_dfx_info_vld *dfx_info;
 	struct hccs_port_dfx_req_para *dfx_req;
 	struct hikp_hccs_req req = {0};
 	int ret;
 
-	ret = hikp_plat_hccs_hw_info(&g_hccs_info);
-	if (ret != 0) {
-		HIKP_ERROR_PRINT("Failed to get HCCS hardware info for dfx info, ret = %d\n",
-				 ret);
-		return ret;
-	}
-
-	if (!hikp_hccs_req_param_check(&g_hccs_info, param))
-		return -EINVAL;
-
-	dfx_info = &info->dfx_info;
 	dfx_req = (struct hccs_port_dfx_req_para *)&req.req_data;
-	dfx_req->chip_id = param->chip_id;
-	dfx_req->port_id = param->port_id;
-	dfx_req->die_id = param->die_id;
+	dfx_req->chip_id = chip_id;
+	dfx_req->port_id = port_id;
+	dfx_req->die_id = die_id;
 	hikp_cmd_init(&req_header, HCCS_MOD, HCCS_GET_PORT_DFX_INFO, 0);
 	ret = hikp_hccs_cmd_send(&req_header, &req,
 				 &dfx_info->info,
@@ -556,6 +795,25 @@ static int hikp_hccs_get_port_dfx_info(struct hccs_param *param,
 	return 0;
 }
 
+static int hikp_hccs_get_port_dfx_info(struct hccs_param *param,
+				       union hccs_feature_info *info)
+{
+	int ret;
+
+	ret = hikp_hccs_get_topo(&g_hccs_info);
+	if (ret != 0) {
+		HIKP_ERROR_PRINT("Failed to get HCCS hardware info for dfx info, ret = %d\n",
+				 ret);
+		return ret;
+	}
+
+	if (!hikp_hccs_req_param_check(&g_hccs_info, param))
+		return -EINVAL;
+
+	return hikp_hccs_query_port_dfx(param->chip_id, param->die_id,
+					(uint8_t)param->port_id, &info->dfx_info);
+}
+
 static void hikp_hccs_show_topo(union hccs_feature_info *data)
 {
 	uint8_t chip_id, die_idx, die_num, port_idx, *port_ids;
@@ -645,6 +903,132 @@ static void hikp_hccs_show_port_dfx_info(union hccs_feature_info *feature_info)
 	}
 }
 
+#define HCCS_DFX_FIELD_VLD(vld_size, field) \
+	((vld_size) > offsetof(struct hccs_port_dfx_info, field))
+#define HCCS_DFX_STR_LEN 12
+
+static const char *hikp_hccs_dfx_cnt_str(char *buf, size_t len, bool vld, uint32_t val)
+{
+	if (!vld)
+		return "-";
+
+	(void)snprintf(buf, len, "%u", val);
+	return buf;
+}
+
+/*
+ * The lane mode is a fixed attribute, query it once per boot for the ports
+ * that do not have it yet and keep it in the topology cache.
+ */
+static void hikp_hccs_get_lane_modes(struct hikp_plat_hccs_info *hccs_info)
+{
+	union hccs_feature_info attr = {0};
+	struct hccs_chip_info *chip_info;
+	struct hccs_die_info *die_info;
+	uint8_t chip_id, die_idx;
+	bool updated = false;
+	uint16_t port_idx;
+
+	for (chip_id = 0; chip_id < hccs_info->chip_num; chip_id++) {
+		chip_info = &hccs_info->chip_info[chip_id];
+		for (die_idx = 0; die_idx < chip_info->die_num; die_idx++) {
+			die_info = &chip_info->die_info[die_idx];
+			for (port_idx = 0; port_idx < die_info->port_num; port_idx++) {
+				if (die_info->lane_modes[port_idx] != 0 ||
+				    hikp_hccs_query_port_attr(chip_id, die_info->die_id,
+							      die_info->port_ids[port_idx],
+							      &attr) != 0)
+					continue;
+				die_info->lane_modes[port_idx] = attr.attr.lane_mode;
+				updated = true;
+			}
+		}
+	}
+
+	if (updated)
+		hikp_hccs_topo_cache_save(hccs_info);
+}
+
+static int hikp_hccs_show_one_port_dfx(uint8_t chip_id, uint8_t die_id, uint8_t port_id,
+				       uint8_t lane_mode)
+{
+	char crc_str[HCCS_DFX_STR_LEN], retry_str[HCCS_DFX_STR_LEN];
+	char reinit_str[HCCS_DFX_STR_LEN], lane_str[HCCS_DFX_STR_LEN];
+	struct hccs_port_dfx_info_vld dfx = {0};
+	struct hccs_port_dfx_info *info = &dfx.info;
+	size_t vld;
+	int ret;
+
+	ret = hikp_hccs_query_port_dfx(chip_id, die_id, port_id, &dfx);
+	if (ret != 0) {
+		printf("%-6u%-6u%-6u query failed, ret = %d\n", chip_id, die_id, port_id, ret);
+		return ret;
+	}
+
+	/* The lane mode column is informative only, do not fail the sweep on it. */
+	if (lane_mode != 0)
+		(void)snprintf(lane_str, sizeof(lane_str), "x%u", lane_mode);
+	else
+		(void)snprintf(lane_str, sizeof(lane_str), "-");
+
+	vld = (size_t)dfx.vld_size;
+	printf("%-6u%-6u%-6u%-10s%-11s%-10u0x%-10x%-13s%-11s%s\n",
+	       chip_id, die_id, port_id,
+	       HCCS_DFX_FIELD_VLD(vld, link_fsm) ?
+			hikp_hccs_link_fsm_to_str(info->link_fsm) : "-",
+	       lane_str,
+	       HCCS_DFX_FIELD_VLD(vld, cur_lane_num) ? info->cur_lane_num : 0,
+	       HCCS_DFX_FIELD_VLD(vld, lane_mask) ? info->lane_mask : 0,
+	       hikp_hccs_dfx_cnt_str(crc_str, sizeof(crc_str),
+				     HCCS_DFX_FIELD_VLD(vld, crc_err_cnt), info->crc_err_cnt),
+	       hikp_hccs_dfx_cnt_str(retry_str, sizeof(retry_str),
+				     HCCS_DFX_FIELD_VLD(vld, retry_cnt), info->retry_cnt),
+	       hikp_hccs_dfx_cnt_str(reinit_str, sizeof(reinit_str),
+				     HCCS_DFX_FIELD_VLD(vld, phy_reinit_cnt),
+				     info->phy_reinit_cnt));
+
+	return 0;
+}
+
+static int hikp_hccs_show_all_port_dfx(struct hikp_plat_hccs_info *hccs_info)
+{
+	struct hccs_chip_info *chip_info;
+	struct hccs_die_info *die_info;
+	uint8_t chip_id, die_idx;
+	uint16_t port_idx;
+	int result = 0;
+	int ret;
+
+	ret = hikp_hccs_get_topo(hccs_info);
+	if (ret != 0) {
+		HIKP_ERROR_PRINT("Failed to get HCCS hardware info, ret = %d!\n", ret);
+		return ret;
+	}
+	hikp_hccs_get_lane_modes(hccs_info);
+
+	printf("############## HCCS: all port dfx_info ############\n");
+	printf("%-6s%-6s%-6s%-10s%-11s%-10s%-12s%-13s%-11s%s\n",
+	       "chip", "die", "port", "link_fsm", "lane_mode", "lane_num", "lane_mask",
+	       "crc_err_cnt", "retry_cnt", "phy_reinit_cnt");
+	for (chip_id = 0; chip_id < hccs_info->chip_num; chip_id++) {
+		chip_info = &hccs_info->chip_info[chip_id];
+		for (die_idx = 0; die_idx < chip_info->die_num; die_idx++) {
+			die_info = &chip_info->die_info[die_idx];
+			for (port_idx = 0; port_idx < die_info->port_num; port_idx++) {
+				/* Keep sweeping the other ports if one of them fails. */
+				ret = hikp_hccs_show_one_port_dfx(chip_id, die_info->die_id,
+								  die_info->port_ids[port_idx],
+								  die_info->lane_modes[port_idx]);
+				if (ret != 0)
+					result = ret;
+			}
+		}
+	}
+	printf("#################### END #######################\n");
+
+	return result;
+}
+
 static void hikp_hccs_cmd_execute(struct major_cmd_ctrl *self)
 {
 	const struct hikp_hccs_feature_cmd *hccs_cmd;
@@ -659,23 +1043,46 @@ static void hikp_hccs_cmd_execute(struct major_cmd_ctrl *self)
 	}
 
 	hccs_cmd = &g_hccs_feature_cmd[g_hccs_param.feature_idx];
-	if (g_hccs_param.param_mask != hccs_cmd->param_needed) {
+	if (g_hccs_param.all_port) {
+		if (hccs_cmd->cmd_code != HCCS_GET_PORT_DFX_INFO || g_hccs_param.param_mask != 0) {
+			hikp_hccs_cmd_help(self, NULL);
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "-a/--all only works with dfx_info and without -c/-d/-p!");
+			self->err_no = -EINVAL;
+			return;
+		}
+	} else if (g_hccs_param.param_mask != hccs_cmd->param_needed) {
 		hikp_hccs_cmd_help(self, NULL);
 		snprintf(self->err_str, sizeof(self->err_str), "Parameter mismatched!");
 		self->err_no = -EINVAL;
 		return;
 	}
 
-	ret = hikp_hccs_get_chip_num(&g_hccs_info);
-	if (ret < 0) {
-		self->err_no = ret;
-		return;
+	/* A valid topology cache of this boot saves the whole discovery. */
+	if (hikp_hccs_topo_cache_load(&g_hccs_info) != 0) {
+		ret = hikp_hccs_get_chip_num(&g_hccs_info);
+		if (ret < 0) {
+			self->err_no = ret;
+			return;
+		}
 	}
 
 	if (g_hccs_info.chip_num == 1) {
 		snprintf(self->err_str, sizeof(self->err_str),
 			 "The command is just supported on multi-sockets!\n");
 		self->err_no = -EINVAL;
+		hikp_plat_hccs_free(&g_hccs_info);
+		return;
+	}
+
+	if (g_hccs_param.all_port) {
+		ret = hikp_hccs_show_all_port_dfx(&g_hccs_info);
+		if (ret != 0) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "Failed to query dfx_info of some ports, ret = %d.", ret);
+			self->err_no = ret;
+		}
+		hikp_plat_hccs_free(&g_hccs_info);
 		return;
 	}
 
@@ -784,6 +1191,15 @@ static int hikp_hccs_cmd_parse_port(struct major_cmd_ctrl *self, const char *arg
 	return 0;
 }
 
+static int hikp_hccs_cmd_parse_all(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(self);
+	HIKP_SET_USED(argv);
+
+	g_hccs_param.all_port = true;
+	return 0;
+}
+
 static void hikp_hccs_cmd_init(void)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
@@ -798,6 +1214,7 @@ static void hikp_hccs_cmd_init(void)
 	cmd_option_register("-c", "--chip_id", true, hikp_hccs_cmd_parse_chip);
 	cmd_option_register("-d", "--die_id", true, hikp_hccs_cmd_parse_die);
 	cmd_option_register("-p", "--port_id", true, hikp_hccs_cmd_parse_port);
+	cmd_option_register("-a", "--all", false, hikp_hccs_cmd_parse_all);
 }
 
 HIKP_CMD_DECLARE("hccs", "dump HCCS information.", hikp_hccs_cmd_init);
@@ -15,6 +15,7 @@
 #define HIKP_HCCS_H
 
 #include <stdint.h>
+#include "tool_lib.h"
 
 enum hikp_hccs_cmd_type {
 	HCCS_GET_CHIP_NUM = 0,
@@ -29,6 +30,7 @@ struct hccs_die_info {
 	uint8_t die_id;
 	uint16_t port_num;
 	uint8_t *port_ids;
+	uint8_t *lane_modes; /* fixed lane mode of each port, 0 if not queried yet */
 };
 
 struct hccs_chip_info {
@@ -142,6 +144,8 @@ struct hccs_param {
 	uint32_t port_id;
 	/* mask for param passed by user, see HCCS_ENABLE_XXX. */
 	uint16_t param_mask;
+	/* query all ports instead of the one specified by -c/-d/-p. */
+	bool all_port;
 };
 
 struct hikp_plat_hccs_info {
@@ -149,6 +153,27 @@ struct hikp_plat_hccs_info {
 	struct hccs_chip_info *chip_info;
 };
 
+/*
+ * The topology is static for one boot, so it is saved to a cache file keyed
+ * by the kernel boot id. Layout of the file: the head below followed by, for
+ * each chip, die_num (u8) and for each die, die_id (u8), port_num (u16),
+ * port_num port ids (u8) and port_num lane modes (u8).
+ */
+#define HCCS_TOPO_CACHE_FILE	HIKP_LOG_DIR_PATH"hccs_topo.cache"
+#define HCCS_BOOT_ID_PATH	"/proc/sys/kernel/random/boot_id"
+#define HCCS_TOPO_CACHE_MAGIC	0x53434348 /* "HCCS" */
+#define HCCS_TOPO_CACHE_VER	2
+#define HCCS_BOOT_ID_LEN	40
+#define HCCS_TOPO_CACHE_MAX_SIZE	0x10000
+struct hccs_topo_cache_head {
+	uint32_t magic;
+	uint32_t version;
+	char boot_id[HCCS_BOOT_ID_LEN];
+	uint32_t data_len;
+	uint8_t chip_num;
+	uint8_t rsv[3];
+};
+
 #define HIKP_HCCS_FEATURE_NAME_LEN 20
 struct hikp_hccs_feature_cmd {
 	const char feature_name[HIKP_HCCS_FEATURE_NAME_LEN];
@@ -12,13 +12,12 @@
  */
 
 #include <unistd.h>
+#include <ctype.h>
+#include <sys/wait.h>
 #include "tool_cmd.h"
 #include "op_logs.h"
 #include "hikptdev_plug.h"
 
-/* hikptool command adapter */
-struct cmd_adapter g_tool = { 0 };
-
 static const char *g_cxl_cmd_list[] = {
 	"cxl_cpa",          "cxl_dl",        "cxl_membar",     "cxl_rcrb",
 };
@@ -210,6 +209,7 @@ static void show_tool_help(const struct cmd_adapter *adapter)
 	printf("\n  Usage: %s <major_cmd> [option]\n\n", adapter->name);
 	printf("    -h, --help    show help information\n");
 	printf("    -v, --version show version information\n");
+	printf("    -f, --file    run the command lines of a file, '-' for stdin\n");
 	printf("\n  Major Commands:\n\n");
 
 	/* We should first sort by dictionary to
@@ -259,20 +259,207 @@ static int parse_and_init_cmd(const char *arg)
 		if (strnlen(cmd_ptr->name, MAX_CMD_LEN) != strnlen(arg, MAX_CMD_LEN))
 			continue;
 
+		if ((strncmp(arg, cmd_ptr->name,
+		    strnlen(cmd_ptr->name, MAX_CMD_LEN - 1) + 1) != 0) || !cmd_ptr->cmd_init)
+			continue;
+
 		if (!check_cmd_is_support(cmd_ptr->name))
 			continue;
 
-		if ((strncmp(arg, cmd_ptr->name,
-		    strnlen(cmd_ptr->name, MAX_CMD_LEN - 1) + 1) == 0) && cmd_ptr->cmd_init) {
-			g_tool.p_major_cmd.cmd_ptr = cmd_ptr;
-			cmd_ptr->cmd_init();
-			return 0;
-		}
+		g_tool.p_major_cmd.cmd_ptr = cmd_ptr;
+		cmd_ptr->cmd_init();
+		return 0;
 	}
 
 	return -EINVAL;
 }
 
+/*
+ * Batch mode: one device session for many command lines. Each line runs in
+ * a child forked from this still pristine process, so every command starts
+ * from a clean major_cmd_ctrl and clean module state, as in a fresh run,
+ * while the device init, op log and chip detection are done only once.
+ */
+#define BATCH_MAX_ARGS 64
+#define ARG_NUM_FOR_BATCH 3
+
+static bool is_batch_mode(const int argc, const char **argv)
+{
+	return argc == ARG_NUM_FOR_BATCH && is_specified_option(argv[1], "-f", "--file");
+}
+
+/* Split a line in place into argv[1..], honouring '' and "" quoting. */
+static int hikp_batch_split_line(char *line, const char **argv, int max_args)
+{
+	char *out, *p = line;
+	char quote;
+	int argc = 1;
+
+	argv[0] = get_tool_name();
+	for (;;) {
+		while (isspace((unsigned char)*p))
+			p++;
+		if (*p == '\0' || *p == '#')
+			break;
+		if (argc >= max_args)
+			return -E2BIG;
+
+		out = p;
+		argv[argc++] = out;
+		quote = 0;
+		while (*p != '\0' && (quote != 0 || !isspace((unsigned char)*p))) {
+			if ((*p == '\'' || *p == '"') && (quote == 0 || quote == *p)) {
+				quote = quote == 0 ? *p : 0;
+				p++;
+				continue;
+			}
+			*out++ = *p++;
+		}
+		if (quote != 0)
+			return -EINVAL;
+		if (*p != '\0')
+			p++;
+		*out = '\0';
+	}
+
+	/* Lines may be copied from a shell, skip a leading tool name */
+	if (argc > 1 && strcmp(argv[1], TOOL_NAME) == 0) {
+		for (int i = 1; i < argc - 1; i++)
+			argv[i] = argv[i + 1];
+		argc--;
+	}
+
+	return argc;
+}
+
+static void hikp_batch_child(int argc, const char **argv, int status_fd)
+{
+	struct major_cmd_ctrl *major_cmd = get_major_cmd();
+
+	/* The parent records this line from the status it gets back */
+	op_log_detach();
+	if (parse_and_init_cmd(argv[1]) != 0) {
+		major_cmd->err_no = -EINVAL;
+		HIKP_ERROR_PRINT("Unknown major command, try '%s -h' for help.\n", g_tool.name);
+	} else {
+		command_parse_and_excute(argc, argv);
+	}
+	(void)fflush(stdout);
+
+	if (write(status_fd, &major_cmd->err_no, sizeof(major_cmd->err_no)) < 0)
+		_exit(1);
+	/* Skip atexit handlers, they belong to the parent's session */
+	_exit(0);
+}
+
+static int hikp_batch_exec_line(int argc, const char **argv)
+{
+	int err_no = -EIO;
+	int status = 0;
+	int fds[2];
+	pid_t pid;
+
+	if (pipe(fds) != 0)
+		return -errno;
+
+	op_log_record_input(argc, argv);
+	(void)fflush(stdout);
+	(void)fflush(stderr);
+	pid = fork();
+	if (pid < 0) {
+		err_no = -errno;
+		(void)close(fds[0]);
+		(void)close(fds[1]);
+		op_log_record_result(err_no, get_tool_name());
+		return err_no;
+	}
+	if (pid == 0) {
+		(void)close(fds[0]);
+		hikp_batch_child(argc, argv, fds[1]);
+	}
+
+	(void)close(fds[1]);
+	if (read(fds[0], &err_no, sizeof(err_no)) != (ssize_t)sizeof(err_no))
+		err_no = -EIO;
+	(void)close(fds[0]);
+
+	while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+		;
+	if (WIFSIGNALED(status)) {
+		printf("### killed by signal %d\n", WTERMSIG(status));
+		err_no = -EINTR;
+	}
+	op_log_record_result(err_no, get_tool_name());
+
+	return err_no;
+}
+
+static void hikp_batch_print_line(uint32_t line_no, int argc, const char **argv)
+{
+	printf("### [%u]", line_no);
+	for (int i = 1; i < argc; i++)
+		printf(" %s", argv[i]);
+	printf("\n");
+}
+
+static int hikp_batch_run(const char *path)
+{
+	const char *argv[BATCH_MAX_ARGS];
+	uint32_t line_no = 0, run_num = 0, fail_num = 0;
+	uint64_t start_ns, line_ns;
+	int first_err = 0;
+	char *line = NULL;
+	size_t cap = 0;
+	FILE *fp;
+	int argc;
+	int ret;
+
+	fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+	if (fp == NULL) {
+		HIKP_ERROR_PRINT("open %s failed, errno is %d\n", path, errno);
+		return -errno;
+	}
+
+	/* Detected once here, every child inherits the cached result */
+	(void)get_chip_type();
+	/* One record per line, written out together rather than one write() each */
+	op_log_save_input();
+	op_log_set_buffered(true);
+	start_ns = tool_get_time_ns();
+	while (getline(&line, &cap, fp) >= 0) {
+		line_no++;
+		argc = hikp_batch_split_line(line, argv, BATCH_MAX_ARGS);
+		if (argc == 1)
+			continue;
+
+		if (argc < 0) {
+			printf("### [%u] rc=%d invalid line\n", line_no, argc);
+			ret = argc;
+		} else {
+			hikp_batch_print_line(line_no, argc, argv);
+			line_ns = tool_get_time_ns();
+			ret = hikp_batch_exec_line(argc, argv);
+			printf("### [%u] rc=%d time=%.3f ms\n", line_no, ret,
+			       (double)(tool_get_time_ns() - line_ns) / HIKP_NSEC_PER_MSEC);
+		}
+		run_num++;
+		if (ret != 0) {
+			fail_num++;
+			first_err = first_err != 0 ? first_err : ret;
+		}
+	}
+
+	printf("### batch done: %u command(s), %u failed, %.3f ms\n", run_num, fail_num,
+	       (double)(tool_get_time_ns() - start_ns) / HIKP_NSEC_PER_MSEC);
+	op_log_set_buffered(false);
+	op_log_restore_input();
+	free(line);
+	if (fp != stdin)
+		(void)fclose(fp);
+
+	return first_err;
+}
+
 int main(const int argc, const char **argv)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
@@ -298,6 +485,11 @@ int main(const int argc, const char **argv)
 		goto IEP_INIT_FAIL;
 	}
 
+	if (is_batch_mode(argc, argv)) {
+		major_cmd->err_no = hikp_batch_run(argv[2]);
+		goto BATCH_OUT;
+	}
+
 	ret = parse_and_init_cmd(argv[1]);
 	if (ret != 0) {
 		major_cmd->err_no = ret;
@@ -306,10 +498,11 @@ int main(const int argc, const char **argv)
 		command_parse_and_excute(argc, argv);
 	}
 
+BATCH_OUT:
 	hikp_dev_uninit();
 
 IEP_INIT_FAIL:
-	op_log_record_result(major_cmd->err_no, get_tool_name(), HIKP_LOG_DIR_PATH);
+	op_log_record_result(major_cmd->err_no, get_tool_name());
 
 	return major_cmd->err_no;
 }
@@ -14,13 +14,11 @@
 #include "hikp_collect_lib.h"
 #include "hikp_collect.h"
 #include "tool_lib.h"
+#include "hikp_collect_sysinfo.h"
 
 static int software_version_exec(void *data)
 {
 	const struct info_collect_cmd software_version_cmds[] = {
-		{
-			.args = {"uname", "-a", NULL},
-		},
 		{
 			.log_name = "os-release",
 			.args = {"cat", "/etc/*release", NULL},
@@ -34,6 +32,8 @@ static int software_version_exec(void *data)
 	size_t i, size;
 	int ret;
 
+	hikp_sysinfo_show_uname();
+
 	size = HIKP_ARRAY_SIZE(software_version_cmds);
 	for (i = 0; i < size; i++) {
 		if (!strcmp(software_version_cmds[i].args[ARGS_IDX0], "cat"))
@@ -51,61 +51,34 @@ static int software_version_exec(void *data)
 
 static int mem_info_exec(void *data)
 {
-	const struct info_collect_cmd mem_info_cmds[] = {
-		{
-			.args = {"cat", "/proc/meminfo", NULL},
-		},
-		{
-			.args = {"free", "-m", NULL},
-		},
-		{
-			.args = {"vmstat", NULL},
-		},
-		{
-			.args = {"cat", "/proc/iomem", NULL},
-		},
-	};
 	HIKP_SET_USED(data);
-	size_t i, size;
-	int ret;
 
-	size = HIKP_ARRAY_SIZE(mem_info_cmds);
-	for (i = 0; i < size; i++) {
-		ret = hikp_collect_exec((void *)&mem_info_cmds[i]);
-		if (ret)
-			HIKP_ERROR_PRINT("collect mem_info_cmds[%zu] log failed: %d\n", i, ret);
-	}
+	(void)hikp_sysinfo_dump_file("/proc/meminfo");
+	hikp_sysinfo_show_free();
+	hikp_sysinfo_show_vmstat();
+	(void)hikp_sysinfo_dump_file("/proc/vmstat");
+	(void)hikp_sysinfo_dump_file("/proc/iomem");
 
 	return 0;
 }
 
 static int process_info_exec(void *data)
 {
-	const struct info_collect_cmd process_info_cmds[] = {
-		{
-			.args = {"ps", "euf", NULL},
-		},
-		{
-			.args = {"ps", "aux", NULL},
-		},
-		{
-			.args = {"top", "-bn", "1", NULL},
-		},
-		{
-			.args = {"mpstat", NULL},
-		},
-	};
 	HIKP_SET_USED(data);
-	size_t i, size;
-	int ret;
 
-	size = HIKP_ARRAY_SIZE(process_info_cmds);
-	for (i = 0; i < size; i++) {
-		ret = hikp_collect_exec((void *)&process_info_cmds[i]);
-		if (ret)
-			HIKP_ERROR_PRINT("collect process_info_cmds[%zu] log failed: %d\n",
-					 i, ret);
-	}
+	hikp_sysinfo_show_cpu_usage();
+	(void)hikp_sysinfo_dump_file("/proc/stat");
+	hikp_sysinfo_show_process();
+
+	return 0;
+}
+
+static int irq_info_exec(void *data)
+{
+	HIKP_SET_USED(data);
+
+	(void)hikp_sysinfo_dump_file("/proc/interrupts");
+	(void)hikp_sysinfo_dump_file("/proc/softirqs");
 
 	return 0;
 }
@@ -113,12 +86,6 @@ static int process_info_exec(void *data)
 static int config_info_exec(void *data)
 {
 	struct info_collect_cmd config_info_cmds[] = {
-		{
-			.args = {"cat", "/proc/cmdline", NULL},
-		},
-		{
-			.args = {"getconf", "PAGE_SIZE", NULL},
-		},
 		{
 			.group = GROUP_COMMON,
 			.log_name = "config",
@@ -134,6 +101,9 @@ static int config_info_exec(void *data)
 	size_t i, size;
 	int ret;
 
+	(void)hikp_sysinfo_dump_file("/proc/cmdline");
+	hikp_sysinfo_show_page_size();
+
 	size = HIKP_ARRAY_SIZE(config_info_cmds);
 	for (i = 0; i < size; i++) {
 		char *log_name = config_info_cmds[i].log_name;
@@ -182,6 +152,9 @@ static void collect_software_info(void)
 {
 	int ret;
 
+	/* One sample pair serves the cpu, vmstat and process reports. */
+	(void)hikp_sysinfo_sample();
+
 	ret = hikp_collect_log(GROUP_COMMON, "software_version", software_version_exec, (void *)NULL);
 	if (ret)
 		HIKP_ERROR_PRINT("software_version_exec failed: %d\n", ret);
@@ -194,6 +167,12 @@ static void collect_software_info(void)
 	if (ret)
 		HIKP_ERROR_PRINT("process_info_exec failed: %d\n", ret);
 
+	ret = hikp_collect_log(GROUP_COMMON, "irq_info", irq_info_exec, (void *)NULL);
+	if (ret)
+		HIKP_ERROR_PRINT("irq_info_exec failed: %d\n", ret);
+
+	hikp_sysinfo_release();
+
 	ret = hikp_collect_log(GROUP_COMMON, "config_info", config_info_exec, (void *)NULL);
 	if (ret)
 		HIKP_ERROR_PRINT("config_info_exec failed: %d\n", ret);
@@ -206,15 +185,6 @@ static void collect_software_info(void)
 static int hardware_info_exec(void *data)
 {
 	const struct info_collect_cmd hardware_cmds[] = {
-		{
-			.args = {"cat", MIDR_EL1_PATH, NULL},
-		},
-		{
-			.args = {"cat", "/sys/bus/cpu/devices/cpu0/cpufreq/scaling_governor", NULL},
-		},
-		{
-			.args = {"cat", "/sys/devices/system/cpu/online", NULL},
-		},
 		{
 			.args = {"numactl", "-H", NULL},
 		},
@@ -232,6 +202,10 @@ static int hardware_info_exec(void *data)
 	size_t i, size;
 	int ret;
 
+	(void)hikp_sysinfo_dump_file(MIDR_EL1_PATH);
+	(void)hikp_sysinfo_dump_file("/sys/bus/cpu/devices/cpu0/cpufreq/scaling_governor");
+	(void)hikp_sysinfo_dump_file("/sys/devices/system/cpu/online");
+
 	size = HIKP_ARRAY_SIZE(hardware_cmds);
 	for (i = 0; i < size; i++) {
 		ret = hikp_collect_exec((void *)&hardware_cmds[i]);
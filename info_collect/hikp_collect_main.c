@@ -13,6 +13,7 @@
 
 #include "hikp_collect_lib.h"
 #include "hikp_collect.h"
+#include "hikp_collect_sysinfo.h"
 #include "tool_lib.h"
 #include "tool_cmd.h"
 
@@ -126,6 +127,24 @@ static int info_collect_all(struct major_cmd_ctrl *self, const char *argv)
 	return 0;
 }
 
+static int info_collect_window(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t window_ms;
+	int ret;
+
+	ret = string_toui(argv, &window_ms);
+	if (ret || window_ms < SYSINFO_WINDOW_MIN_MS || window_ms > SYSINFO_WINDOW_MAX_MS) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "invalid window %s, should be %u~%u ms.", argv,
+			 SYSINFO_WINDOW_MIN_MS, SYSINFO_WINDOW_MAX_MS);
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	hikp_sysinfo_set_window(window_ms);
+	return 0;
+}
+
 static void collect_all_log_hip09_10(void)
 {
 	collect_pcie_info();
@@ -300,6 +319,8 @@ static int info_collect_help_hip09_10(struct major_cmd_ctrl *self, const char *a
 	printf("    %-10s, %-25s %s\n", "-serdes", "--serdes", "collect serdes info");
 	printf("    %-10s, %-25s %s\n", "-socip", "--socip", "collect socip info");
 	printf("    %-10s, %-25s %s\n", "-all", "--all", "collect all info");
+	printf("    %-10s, %-25s %s\n", "-w", "--window=<ms>",
+	       "cpu/process sampling window of the common log (default 200ms)");
 	printf("\n");
 
 	return 0;
@@ -318,6 +339,7 @@ static void info_collect_cmd_register_hip09_10(void)
 	cmd_option_register("-serdes", "--serdes", false, info_collect_serdes);
 	cmd_option_register("-socip", "--socip", false, info_collect_socip);
 	cmd_option_register("-all", "--all", false, info_collect_all);
+	cmd_option_register("-w", "--window", true, info_collect_window);
 }
 
 static int info_collect_help_hip11(struct major_cmd_ctrl *self, const char *argv)
@@ -337,6 +359,8 @@ static int info_collect_help_hip11(struct major_cmd_ctrl *self, const char *argv
 	printf("    %-10s, %-25s %s\n", "-socip", "--socip", "collect socip info");
 	printf("    %-10s, %-25s %s\n", "-sdma", "--sdma", "collect sdma info");
 	printf("    %-10s, %-25s %s\n", "-all", "--all", "collect all info");
+	printf("    %-10s, %-25s %s\n", "-w", "--window=<ms>",
+	       "cpu/process sampling window of the common log (default 200ms)");
 	printf("\n");
 
 	return 0;
@@ -354,6 +378,7 @@ static void info_collect_cmd_register_hip11(void)
 	cmd_option_register("-socip", "--socip", false, info_collect_socip);
 	cmd_option_register("-sdma", "--sdma", false, info_collect_sdma);
 	cmd_option_register("-all", "--all", false, info_collect_all);
+	cmd_option_register("-w", "--window", true, info_collect_window);
 }
 
 static int info_collect_help_hip12(struct major_cmd_ctrl *self, const char *argv)
@@ -369,6 +394,8 @@ static int info_collect_help_hip12(struct major_cmd_ctrl *self, const char *argv
 	printf("    %-10s, %-25s %s\n", "-serdes", "--serdes", "collect serdes info");
 	printf("    %-10s, %-25s %s\n", "-socip", "--socip", "collect socip info");
 	printf("    %-10s, %-25s %s\n", "-all", "--all", "collect all info");
+	printf("    %-10s, %-25s %s\n", "-w", "--window=<ms>",
+	       "cpu/process sampling window of the common log (default 200ms)");
 	printf("\n");
 
 	return 0;
@@ -382,6 +409,7 @@ static void info_collect_cmd_register_hip12(void)
 	cmd_option_register("-serdes", "--serdes", false, info_collect_serdes);
 	cmd_option_register("-socip", "--socip", false, info_collect_socip);
 	cmd_option_register("-all", "--all", false, info_collect_all);
+	cmd_option_register("-w", "--window", true, info_collect_window);
 }
 
 static void cmd_info_collect_init(void)
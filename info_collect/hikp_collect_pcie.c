@@ -12,6 +12,10 @@
  */
 
 #include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include "hikp_collect_lib.h"
@@ -25,8 +29,58 @@
 
 #define PCIE_DEV_LEN 512
 #define PCIE_DEV_PATH "/sys/bus/pci/devices"
+#define PCIE_SYS_DEVICES_PATH "/sys/devices/"
 #define MAX_NIMBUS_NUM_ALL 8
 
+#define PCIE_CFG_SPACE_SIZE		4096
+#define PCIE_CFG_STD_SIZE		256
+#define PCIE_CFG_DUMP_LINE_LEN		16
+#define PCIE_CFG_READ_THREAD_MAX	8
+#define PCIE_DEV_NAME_LEN		32
+#define PCIE_SYSFS_ATTR_LEN		64
+
+/* Standard config header registers */
+#define PCI_VENDOR_ID_REG		0x00
+#define PCI_DEVICE_ID_REG		0x02
+#define PCI_STATUS_REG			0x06
+#define PCI_REVISION_ID_REG		0x08
+#define PCI_CLASS_PROG_REG		0x09
+#define PCI_HEADER_TYPE_REG		0x0e
+#define PCI_CAP_LIST_REG		0x34
+#define PCI_STATUS_CAP_LIST		0x10
+#define PCI_CAP_PTR_MASK		0xfc
+#define PCI_CAP_MAX_NUM			48
+
+/* Capability IDs */
+#define PCI_CAP_ID_EXP			0x10
+#define PCI_EXT_CAP_ID_AER		0x0001
+#define PCI_EXT_CAP_ID_DPC		0x001d
+#define PCI_EXT_CAP_MAX_NUM		((PCIE_CFG_SPACE_SIZE - PCIE_CFG_STD_SIZE) / 8)
+
+/* PCI Express capability registers, offsets from the capability base */
+#define PCI_EXP_DEVSTA			0x0a
+#define PCI_EXP_LNKCAP			0x0c
+#define PCI_EXP_LNKSTA			0x12
+#define PCI_EXP_LNK_SPEED_MASK		0xf
+#define PCI_EXP_LNK_WIDTH_SHIFT		4
+#define PCI_EXP_LNK_WIDTH_MASK		0x3f
+#define PCI_EXP_LNKSTA_LT		11
+#define PCI_EXP_LNKSTA_DLLLA		13
+
+/* AER capability registers */
+#define PCI_ERR_UNCOR_STATUS		0x04
+#define PCI_ERR_UNCOR_MASK		0x08
+#define PCI_ERR_UNCOR_SEVER		0x0c
+#define PCI_ERR_COR_STATUS		0x10
+#define PCI_ERR_COR_MASK		0x14
+#define PCI_ERR_CAP			0x18
+
+/* DPC capability registers */
+#define PCI_DPC_CAP			0x04
+#define PCI_DPC_CTL			0x06
+#define PCI_DPC_STATUS			0x08
+#define PCI_DPC_SOURCE_ID		0x0a
+
 /* Optimization barrier */
 #ifndef barrier
 /* The "volatile" is due to gcc bugs */
@@ -38,62 +92,462 @@ struct pcie_id_info {
 	uint32_t port_id;
 };
 
-/* get pcie config space info */
-static void collect_pcie_common(char *pcie_dev_name)
+struct pcie_cfg_dev {
+	char name[PCIE_DEV_NAME_LEN];
+	uint8_t cfg[PCIE_CFG_SPACE_SIZE];
+	uint32_t cfg_len;
+	int err;
+};
+
+struct pcie_cfg_dev_list {
+	struct pcie_cfg_dev *devs;
+	uint32_t num;
+};
+
+struct pcie_cfg_read_work {
+	struct pcie_cfg_dev *devs;
+	uint32_t start;
+	uint32_t end;
+};
+
+struct pcie_cap_name {
+	uint16_t id;
+	const char *name;
+};
+
+static const struct pcie_cap_name g_pcie_cap_names[] = {
+	{0x01, "Power Management"},
+	{0x05, "MSI"},
+	{0x09, "Vendor Specific"},
+	{0x0d, "Subsystem ID"},
+	{0x10, "Express"},
+	{0x11, "MSI-X"},
+	{0x12, "SATA HBA"},
+	{0x13, "PCI Advanced Features"},
+};
+
+static const struct pcie_cap_name g_pcie_ext_cap_names[] = {
+	{0x0001, "Advanced Error Reporting"},
+	{0x0002, "Virtual Channel"},
+	{0x0003, "Device Serial Number"},
+	{0x0004, "Power Budgeting"},
+	{0x000b, "Vendor Specific"},
+	{0x000d, "Access Control Services"},
+	{0x000e, "Alternative Routing-ID"},
+	{0x000f, "Address Translation Service"},
+	{0x0010, "Single Root I/O Virtualization"},
+	{0x0013, "Page Request Interface"},
+	{0x0015, "Resizable BAR"},
+	{0x0017, "TPH Requester"},
+	{0x0018, "Latency Tolerance Reporting"},
+	{0x0019, "Secondary PCI Express"},
+	{0x001b, "Process Address Space ID"},
+	{0x001d, "Downstream Port Containment"},
+	{0x001e, "L1 PM Substates"},
+	{0x0025, "Data Link Feature"},
+	{0x0026, "Physical Layer 16.0 GT/s"},
+	{0x0027, "Lane Margining at the Receiver"},
+	{0x002a, "Physical Layer 32.0 GT/s"},
+};
+
+static const char *g_pcie_link_speed[] = {
+	"unknown", "2.5GT/s", "5GT/s", "8GT/s", "16GT/s", "32GT/s", "64GT/s",
+};
+
+static const char *pcie_cap_name_get(const struct pcie_cap_name *names, size_t num, uint16_t id)
+{
+	size_t i;
+
+	for (i = 0; i < num; i++) {
+		if (names[i].id == id)
+			return names[i].name;
+	}
+
+	return "Unknown";
+}
+
+static const char *pcie_link_speed_str(uint32_t speed)
+{
+	if (speed >= HIKP_ARRAY_SIZE(g_pcie_link_speed))
+		return g_pcie_link_speed[0];
+
+	return g_pcie_link_speed[speed];
+}
+
+static uint16_t pcie_cfg_read16(const struct pcie_cfg_dev *dev, uint32_t offset)
+{
+	uint16_t val;
+
+	memcpy(&val, dev->cfg + offset, sizeof(val));
+	return val;
+}
+
+static uint32_t pcie_cfg_read32(const struct pcie_cfg_dev *dev, uint32_t offset)
+{
+	uint32_t val;
+
+	memcpy(&val, dev->cfg + offset, sizeof(val));
+	return val;
+}
+
+static int pcie_cfg_read_one(struct pcie_cfg_dev *dev)
 {
-	struct info_collect_cmd pcie_cmd_arr = {0};
+	char path[PCIE_DEV_LEN] = {0};
+	ssize_t len;
 	int ret;
+	int fd;
 
-	pcie_cmd_arr.group = GROUP_PCIE;
-	pcie_cmd_arr.log_name = pcie_dev_name;
-	pcie_cmd_arr.args[ARGS_IDX0] = "lspci";
-	pcie_cmd_arr.args[ARGS_IDX1] = "-vvvxxxx";
-	pcie_cmd_arr.args[ARGS_IDX2] = "-s";
-	pcie_cmd_arr.args[ARGS_IDX3] = pcie_dev_name;
-	pcie_cmd_arr.args[ARGS_IDX4] = NULL;
-	ret = hikp_collect_log(pcie_cmd_arr.group, pcie_cmd_arr.log_name,
-					 hikp_collect_exec, (void *)&pcie_cmd_arr);
-	if (ret)
-		HIKP_ERROR_PRINT("collect_pcie_common failed: %d\n", ret);
+	ret = snprintf(path, sizeof(path), "%s/%s/config", PCIE_DEV_PATH, dev->name);
+	if (ret < 0 || (size_t)ret >= sizeof(path))
+		return -EINVAL;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	/* Without CAP_SYS_ADMIN only the first 64 bytes are readable. */
+	dev->cfg_len = 0;
+	while (dev->cfg_len < PCIE_CFG_SPACE_SIZE) {
+		len = pread(fd, dev->cfg + dev->cfg_len, PCIE_CFG_SPACE_SIZE - dev->cfg_len,
+			    dev->cfg_len);
+		if (len <= 0)
+			break;
+		dev->cfg_len += (uint32_t)len;
+	}
+	close(fd);
+
+	return dev->cfg_len == 0 ? -EIO : 0;
+}
+
+static void *pcie_cfg_read_worker(void *arg)
+{
+	struct pcie_cfg_read_work *work = (struct pcie_cfg_read_work *)arg;
+	uint32_t i;
+
+	for (i = work->start; i < work->end; i++)
+		work->devs[i].err = pcie_cfg_read_one(&work->devs[i]);
+
+	return NULL;
 }
 
-static void collect_pcie_single_cfg(void)
+/*
+ * Reading config space goes through the kernel config accessors, which may
+ * be slow for each dword, so split the devices into a few threads.
+ */
+static void pcie_cfg_read_all(struct pcie_cfg_dev_list *list)
+{
+	struct pcie_cfg_read_work work[PCIE_CFG_READ_THREAD_MAX] = {0};
+	bool created[PCIE_CFG_READ_THREAD_MAX] = {0};
+	pthread_t tid[PCIE_CFG_READ_THREAD_MAX];
+	uint32_t thread_num, per_thread;
+	long cpu_num;
+	uint32_t i;
+
+	cpu_num = sysconf(_SC_NPROCESSORS_ONLN);
+	thread_num = cpu_num > 0 ? (uint32_t)cpu_num : 1;
+	thread_num = HIKP_MIN(thread_num, PCIE_CFG_READ_THREAD_MAX);
+	thread_num = HIKP_MIN(thread_num, list->num);
+	if (thread_num == 0)
+		return;
+
+	per_thread = HIKP_DIV_ROUND_UP(list->num, thread_num);
+	for (i = 0; i < thread_num; i++) {
+		work[i].devs = list->devs;
+		work[i].start = i * per_thread;
+		work[i].end = HIKP_MIN(work[i].start + per_thread, list->num);
+		if (work[i].start >= work[i].end)
+			break;
+		created[i] = pthread_create(&tid[i], NULL, pcie_cfg_read_worker, &work[i]) == 0;
+		/* Fall back to reading in the caller if the thread can not be created. */
+		if (!created[i])
+			(void)pcie_cfg_read_worker(&work[i]);
+	}
+
+	for (i = 0; i < thread_num; i++) {
+		if (created[i])
+			(void)pthread_join(tid[i], NULL);
+	}
+}
+
+static int pcie_cfg_dev_cmp(const void *a, const void *b)
+{
+	const struct pcie_cfg_dev *x = (const struct pcie_cfg_dev *)a;
+	const struct pcie_cfg_dev *y = (const struct pcie_cfg_dev *)b;
+
+	return strcmp(x->name, y->name);
+}
+
+static int pcie_cfg_dev_list_get(struct pcie_cfg_dev_list *list)
 {
-	char dev_name[PCIE_DEV_LEN];
 	struct dirent *ptr = NULL;
+	uint32_t max_num = 0;
 	DIR *dir = NULL;
 
 	if ((dir = opendir(PCIE_DEV_PATH)) == NULL) {
-		perror("failed to open path \n");
-		return;
+		HIKP_ERROR_PRINT("failed to open %s\n", PCIE_DEV_PATH);
+		return -ENOENT;
 	}
 
 	while ((ptr = readdir(dir)) != NULL) {
-		if ((strcmp(ptr->d_name, ".") == 0) || (strcmp(ptr->d_name, "..") == 0)) {
-			continue;
-		} else if (ptr->d_type == DT_LNK) {
-			memset(dev_name, 0, sizeof(dev_name));
-			strncpy(dev_name, ptr->d_name, sizeof(dev_name) - 1);
-			dev_name[sizeof(dev_name) - 1] = '\0';
-			collect_pcie_common(dev_name);
-		}
+		if (ptr->d_type == DT_LNK)
+			max_num++;
 	}
 
+	list->num = 0;
+	list->devs = max_num ? (struct pcie_cfg_dev *)calloc(max_num, sizeof(*list->devs)) : NULL;
+	if (list->devs == NULL) {
+		closedir(dir);
+		return max_num ? -ENOMEM : -ENODEV;
+	}
+
+	rewinddir(dir);
+	while ((ptr = readdir(dir)) != NULL && list->num < max_num) {
+		if (ptr->d_type != DT_LNK || strlen(ptr->d_name) >= PCIE_DEV_NAME_LEN)
+			continue;
+		strncpy(list->devs[list->num].name, ptr->d_name, PCIE_DEV_NAME_LEN - 1);
+		list->num++;
+	}
 	closedir(dir);
+
+	qsort(list->devs, list->num, sizeof(*list->devs), pcie_cfg_dev_cmp);
+	return 0;
+}
+
+static void pcie_sysfs_attr_print(const char *dev_name, const char *attr)
+{
+	char val[PCIE_SYSFS_ATTR_LEN] = {0};
+	char path[PCIE_DEV_LEN] = {0};
+	FILE *fp;
+	char *pos;
+	int ret;
+
+	ret = snprintf(path, sizeof(path), "%s/%s/%s", PCIE_DEV_PATH, dev_name, attr);
+	if (ret < 0 || (size_t)ret >= sizeof(path))
+		return;
+
+	fp = fopen(path, "r");
+	if (fp == NULL)
+		return;
+
+	if (fgets(val, sizeof(val), fp) != NULL) {
+		pos = strchr(val, '\n');
+		if (pos != NULL)
+			*pos = '\0';
+		printf("\t%-20s: %s\n", attr, val);
+	}
+	fclose(fp);
+}
+
+static void pcie_driver_print(const char *dev_name)
+{
+	char link[PCIE_DEV_LEN] = {0};
+	char path[PCIE_DEV_LEN] = {0};
+	const char *drv;
+	ssize_t len;
+	int ret;
+
+	ret = snprintf(path, sizeof(path), "%s/%s/driver", PCIE_DEV_PATH, dev_name);
+	if (ret < 0 || (size_t)ret >= sizeof(path))
+		return;
+
+	len = readlink(path, link, sizeof(link) - 1);
+	if (len <= 0)
+		return;
+
+	link[len] = '\0';
+	drv = strrchr(link, DIR_BREAK_CHAR);
+	printf("\t%-20s: %s\n", "driver", drv ? drv + 1 : link);
+}
+
+static void pcie_cfg_show_hex(const struct pcie_cfg_dev *dev)
+{
+	uint32_t i, j;
+
+	for (i = 0; i < dev->cfg_len; i += PCIE_CFG_DUMP_LINE_LEN) {
+		printf("%02x:", i);
+		for (j = i; j < i + PCIE_CFG_DUMP_LINE_LEN && j < dev->cfg_len; j++)
+			printf(" %02x", dev->cfg[j]);
+		printf("\n");
+	}
+}
+
+static void pcie_cfg_show_exp_cap(const struct pcie_cfg_dev *dev, uint32_t pos)
+{
+	uint32_t lnkcap, lnksta, devsta;
+
+	if (pos + PCI_EXP_LNKSTA + sizeof(uint16_t) > dev->cfg_len)
+		return;
+
+	devsta = pcie_cfg_read16(dev, pos + PCI_EXP_DEVSTA);
+	lnkcap = pcie_cfg_read32(dev, pos + PCI_EXP_LNKCAP);
+	lnksta = pcie_cfg_read16(dev, pos + PCI_EXP_LNKSTA);
+	printf("\t\tDevSta: CorrErr%c NonFatalErr%c FatalErr%c UnsupReq%c\n",
+	       hikp_get_bit(devsta, 0) ? '+' : '-', hikp_get_bit(devsta, 1) ? '+' : '-',
+	       hikp_get_bit(devsta, 2) ? '+' : '-', hikp_get_bit(devsta, 3) ? '+' : '-');
+	printf("\t\tLnkCap: Speed %s, Width x%u\n",
+	       pcie_link_speed_str(lnkcap & PCI_EXP_LNK_SPEED_MASK),
+	       (lnkcap >> PCI_EXP_LNK_WIDTH_SHIFT) & PCI_EXP_LNK_WIDTH_MASK);
+	printf("\t\tLnkSta: Speed %s, Width x%u, Training%c DLActive%c\n",
+	       pcie_link_speed_str(lnksta & PCI_EXP_LNK_SPEED_MASK),
+	       (lnksta >> PCI_EXP_LNK_WIDTH_SHIFT) & PCI_EXP_LNK_WIDTH_MASK,
+	       hikp_get_bit(lnksta, PCI_EXP_LNKSTA_LT) ? '+' : '-',
+	       hikp_get_bit(lnksta, PCI_EXP_LNKSTA_DLLLA) ? '+' : '-');
+}
+
+static void pcie_cfg_show_caps(const struct pcie_cfg_dev *dev)
+{
+	uint32_t pos, cnt;
+	uint8_t id;
+
+	if (dev->cfg_len <= PCI_CAP_LIST_REG ||
+	    !(pcie_cfg_read16(dev, PCI_STATUS_REG) & PCI_STATUS_CAP_LIST))
+		return;
+
+	pos = dev->cfg[PCI_CAP_LIST_REG] & PCI_CAP_PTR_MASK;
+	for (cnt = 0; pos != 0 && cnt < PCI_CAP_MAX_NUM; cnt++) {
+		if (pos + sizeof(uint16_t) > dev->cfg_len)
+			break;
+		id = dev->cfg[pos];
+		printf("\tCapabilities: [%02x] %s (id 0x%02x)\n", pos,
+		       pcie_cap_name_get(g_pcie_cap_names, HIKP_ARRAY_SIZE(g_pcie_cap_names), id),
+		       id);
+		if (id == PCI_CAP_ID_EXP)
+			pcie_cfg_show_exp_cap(dev, pos);
+		pos = dev->cfg[pos + 1] & PCI_CAP_PTR_MASK;
+	}
+}
+
+static void pcie_cfg_show_aer(const struct pcie_cfg_dev *dev, uint32_t pos)
+{
+	if (pos + PCI_ERR_CAP + sizeof(uint32_t) > dev->cfg_len)
+		return;
+
+	printf("\t\tUESta: 0x%08x UEMsk: 0x%08x UESvrt: 0x%08x\n",
+	       pcie_cfg_read32(dev, pos + PCI_ERR_UNCOR_STATUS),
+	       pcie_cfg_read32(dev, pos + PCI_ERR_UNCOR_MASK),
+	       pcie_cfg_read32(dev, pos + PCI_ERR_UNCOR_SEVER));
+	printf("\t\tCESta: 0x%08x CEMsk: 0x%08x AERCap: 0x%08x\n",
+	       pcie_cfg_read32(dev, pos + PCI_ERR_COR_STATUS),
+	       pcie_cfg_read32(dev, pos + PCI_ERR_COR_MASK),
+	       pcie_cfg_read32(dev, pos + PCI_ERR_CAP));
+}
+
+static void pcie_cfg_show_dpc(const struct pcie_cfg_dev *dev, uint32_t pos)
+{
+	if (pos + PCI_DPC_SOURCE_ID + sizeof(uint16_t) > dev->cfg_len)
+		return;
+
+	printf("\t\tDpcCap: 0x%04x DpcCtl: 0x%04x DpcSta: 0x%04x DpcSrcId: 0x%04x\n",
+	       pcie_cfg_read16(dev, pos + PCI_DPC_CAP),
+	       pcie_cfg_read16(dev, pos + PCI_DPC_CTL),
+	       pcie_cfg_read16(dev, pos + PCI_DPC_STATUS),
+	       pcie_cfg_read16(dev, pos + PCI_DPC_SOURCE_ID));
+}
+
+static void pcie_cfg_show_ext_caps(const struct pcie_cfg_dev *dev)
+{
+	uint32_t pos = PCIE_CFG_STD_SIZE;
+	uint32_t header, cnt;
+	uint16_t id;
+
+	for (cnt = 0; cnt < PCI_EXT_CAP_MAX_NUM; cnt++) {
+		if (pos < PCIE_CFG_STD_SIZE || pos + sizeof(uint32_t) > dev->cfg_len)
+			break;
+		header = pcie_cfg_read32(dev, pos);
+		if (header == 0 || header == UINT32_MAX)
+			break;
+
+		id = (uint16_t)(header & 0xffff);
+		printf("\tCapabilities: [%03x] %s (id 0x%04x, v%u)\n", pos,
+		       pcie_cap_name_get(g_pcie_ext_cap_names,
+					 HIKP_ARRAY_SIZE(g_pcie_ext_cap_names), id),
+		       id, (header >> 16) & 0xf);
+		if (id == PCI_EXT_CAP_ID_AER)
+			pcie_cfg_show_aer(dev, pos);
+		else if (id == PCI_EXT_CAP_ID_DPC)
+			pcie_cfg_show_dpc(dev, pos);
+
+		pos = (header >> 20) & 0xffc;
+		if (pos == 0)
+			break;
+	}
+}
+
+/* get pcie config space info */
+static int collect_pcie_common(void *data)
+{
+	const struct pcie_cfg_dev *dev = (const struct pcie_cfg_dev *)data;
+	uint32_t class_code;
+
+	if (dev->err) {
+		printf("%s: failed to read config space, ret = %d\n", dev->name, dev->err);
+		return 0;
+	}
+
+	if (dev->cfg_len > PCI_HEADER_TYPE_REG) {
+		class_code = pcie_cfg_read32(dev, PCI_REVISION_ID_REG) >> HIKP_BITS_PER_BYTE;
+		printf("%s Class %06x: Vendor %04x Device %04x (rev %02x) Header Type %02x\n",
+		       dev->name, class_code, pcie_cfg_read16(dev, PCI_VENDOR_ID_REG),
+		       pcie_cfg_read16(dev, PCI_DEVICE_ID_REG), dev->cfg[PCI_REVISION_ID_REG],
+		       dev->cfg[PCI_HEADER_TYPE_REG] & 0x7f);
+	}
+	pcie_driver_print(dev->name);
+	pcie_sysfs_attr_print(dev->name, "numa_node");
+	pcie_sysfs_attr_print(dev->name, "current_link_speed");
+	pcie_sysfs_attr_print(dev->name, "current_link_width");
+	pcie_sysfs_attr_print(dev->name, "max_link_speed");
+	pcie_sysfs_attr_print(dev->name, "max_link_width");
+	pcie_cfg_show_caps(dev);
+	pcie_cfg_show_ext_caps(dev);
+	printf("\n");
+	pcie_cfg_show_hex(dev);
+
+	return 0;
+}
+
+static void collect_pcie_single_cfg(const struct pcie_cfg_dev_list *list)
+{
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < list->num; i++) {
+		ret = hikp_collect_log(GROUP_PCIE, list->devs[i].name,
+				       collect_pcie_common, (void *)&list->devs[i]);
+		if (ret)
+			HIKP_ERROR_PRINT("collect_pcie_common failed: %d\n", ret);
+	}
+}
+
+static int pcie_cfg_tree_show(void *data)
+{
+	const struct pcie_cfg_dev_list *list = (const struct pcie_cfg_dev_list *)data;
+	char real_path[PATH_MAX] = {0};
+	char path[PCIE_DEV_LEN] = {0};
+	const char *topo;
+	uint32_t i;
+	int ret;
+
+	/* The sysfs device path holds every bridge from the root port down. */
+	for (i = 0; i < list->num; i++) {
+		ret = snprintf(path, sizeof(path), "%s/%s", PCIE_DEV_PATH, list->devs[i].name);
+		if (ret < 0 || (size_t)ret >= sizeof(path) || realpath(path, real_path) == NULL)
+			continue;
+
+		topo = real_path;
+		if (strncmp(real_path, PCIE_SYS_DEVICES_PATH, strlen(PCIE_SYS_DEVICES_PATH)) == 0)
+			topo += strlen(PCIE_SYS_DEVICES_PATH);
+		printf("%s\n", topo);
+	}
+
+	return 0;
 }
 
 /* get pcie config tree info */
-static void collect_pcie_cfg_tree(void)
+static void collect_pcie_cfg_tree(struct pcie_cfg_dev_list *list)
 {
-	struct info_collect_cmd pcie_cmd_arr = {
-		.group = GROUP_PCIE,
-		.log_name = "pcie_tree",
-		.args = {"lspci", "-tv", NULL},
-	};
 	int ret;
 
-	ret = hikp_collect_log(pcie_cmd_arr.group, pcie_cmd_arr.log_name,
-					 hikp_collect_exec, (void *)&pcie_cmd_arr);
+	ret = hikp_collect_log(GROUP_PCIE, "pcie_tree", pcie_cfg_tree_show, (void *)list);
 	if (ret)
 		HIKP_ERROR_PRINT("collect_pcie_cfg_tree failed: %d\n", ret);
 }
@@ -207,9 +661,14 @@ static void collect_pcie_local(void)
 
 void collect_pcie_info(void)
 {
-	collect_pcie_cfg_tree();
+	struct pcie_cfg_dev_list list = {0};
 
-	collect_pcie_single_cfg();
+	if (pcie_cfg_dev_list_get(&list) == 0) {
+		pcie_cfg_read_all(&list);
+		collect_pcie_cfg_tree(&list);
+		collect_pcie_single_cfg(&list);
+		free(list.devs);
+	}
 
 	collect_pcie_local();
 }
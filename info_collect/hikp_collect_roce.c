@@ -11,6 +11,7 @@
  * See the Mulan PSL v2 for more details.
  */
 
+#include <dirent.h>
 #include "hikp_collect_lib.h"
 #include "hikp_collect.h"
 #include "tool_lib.h"
@@ -27,6 +28,7 @@
 #include "hikp_roce_scc.h"
 #include "hikp_roce_gmv.h"
 #include "hikp_roce_dfx_sta.h"
+#include "hikp_roce_ctx.h"
 
 static void collect_roce_devinfo_log(void)
 {
@@ -102,6 +104,43 @@ static void collect_roce_res_stats_log(void)
 				 roce_res_stats_cmd.log_name, ret);
 }
 
+static int collect_roce_ctx_dump(void *dev_name)
+{
+	int ret;
+
+	ret = hikp_roce_ctx_dump((const char *)dev_name, ROCE_CTX_RES_ALL, stdout);
+	/* the log records which contexts the kernel can not read */
+	return ret < 0 && ret != -EOPNOTSUPP ? ret : 0;
+}
+
+/* Raw driver contexts of every rdma device, one log per device */
+static void collect_roce_ctx_log(void)
+{
+	char log_name[MAX_LOG_NAME_LEN];
+	struct dirent *entry;
+	DIR *dir;
+	int ret;
+
+	dir = opendir(ROCE_CTX_IB_DEV_DIR);
+	if (!dir)
+		return;
+
+	while ((entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.')
+			continue;
+
+		ret = snprintf(log_name, sizeof(log_name), "rdma_ctx_%s", entry->d_name);
+		if (ret < 0 || ret >= (int)sizeof(log_name))
+			continue;
+
+		ret = hikp_collect_log(GROUP_ROCE, log_name, collect_roce_ctx_dump,
+				       (void *)entry->d_name);
+		if (ret)
+			HIKP_ERROR_PRINT("collect %s log failed: %d\n", log_name, ret);
+	}
+	closedir(dir);
+}
+
 static int collect_hikp_roce_gmv_log(void *nic_name)
 {
 	struct major_cmd_ctrl self = {0};
@@ -228,9 +267,17 @@ static int collect_hikp_roce_tsp_log(void *nic_name)
 
 static int collect_hikp_roce_trp_log(void *nic_name)
 {
+	static const struct {
+		uint32_t module;
+		const char *name;
+	} trp_bank_module[] = {
+		{TRP_COMMON, "COMMON"},
+		{GEN_AC, "GEN_AC"},
+		{PAYL, "PAYL"},
+	};
 	struct major_cmd_ctrl self = {0};
 	struct hikp_cmd_type type = {0};
-	uint32_t bankid;
+	size_t i;
 	int ret;
 
 	self.cmd_ptr = &type;
@@ -241,34 +288,21 @@ static int collect_hikp_roce_trp_log(void *nic_name)
 		return ret;
 	}
 
-	hikp_roce_set_trp_submodule(TRP_COMMON);
-	for (bankid = 0; bankid <= TRP_MAX_BANK_NUM; bankid++) {
-		hikp_roce_set_trp_bankid(bankid);
-
-		printf("hikptool roce_trp -i %s -m COMMON -b %u\n", (char *)nic_name, bankid);
+	/* Every bank of a module in one sweep */
+	hikp_roce_set_trp_bank_all(true);
+	for (i = 0; i < HIKP_ARRAY_SIZE(trp_bank_module); i++) {
+		hikp_roce_set_trp_submodule(trp_bank_module[i].module);
+		printf("hikptool roce_trp -i %s -m %s -b all\n", (char *)nic_name,
+		       trp_bank_module[i].name);
 		hikp_roce_trp_execute(&self);
 	}
 
+	hikp_roce_set_trp_bank_all(false);
+	hikp_roce_set_trp_bankid(0);
 	printf("hikptool roce_trp -i %s -m TRP_RX\n", (char *)nic_name);
 	hikp_roce_set_trp_submodule(TRP_RX);
 	hikp_roce_trp_execute(&self);
 
-	hikp_roce_set_trp_submodule(GEN_AC);
-	for (bankid = 0; bankid <= GAC_MAX_BANK_NUM; bankid++) {
-		hikp_roce_set_trp_bankid(bankid);
-
-		printf("hikptool roce_trp -i %s -m GEN_AC -b %u\n", (char *)nic_name, bankid);
-		hikp_roce_trp_execute(&self);
-	}
-
-	hikp_roce_set_trp_submodule(PAYL);
-	for (bankid = 0; bankid <= PAYL_MAX_BANK_NUM; bankid++) {
-		hikp_roce_set_trp_bankid(bankid);
-
-		printf("hikptool roce_trp -i %s -m PAYL -b %u\n", (char *)nic_name, bankid);
-		hikp_roce_trp_execute(&self);
-	}
-
 	return 0;
 }
 
@@ -276,7 +310,6 @@ static int collect_hikp_roce_qmm_log(void *nic_name)
 {
 	struct major_cmd_ctrl self = {0};
 	struct hikp_cmd_type type = {0};
-	uint32_t bankid;
 	int ret;
 
 	self.cmd_ptr = &type;
@@ -287,17 +320,14 @@ static int collect_hikp_roce_qmm_log(void *nic_name)
 		return ret;
 	}
 
-	for (bankid = 0; bankid <= QMM_BANK_NUM; bankid++) {
-		hikp_roce_set_qmm_bankid(bankid);
-
-		printf("hikptool roce_qmm -i %s -b %u\n", (char *)nic_name, bankid);
-		hikp_roce_set_qmm_ext_flag(false);
-		hikp_roce_qmm_execute(&self);
+	hikp_roce_set_qmm_bank_all(true);
+	printf("hikptool roce_qmm -i %s -b all\n", (char *)nic_name);
+	hikp_roce_set_qmm_ext_flag(false);
+	hikp_roce_qmm_execute(&self);
 
-		printf("hikptool roce_qmm -i %s -b %u -e\n", (char *)nic_name, bankid);
-		hikp_roce_set_qmm_ext_flag(true);
-		hikp_roce_qmm_execute(&self);
-	}
+	printf("hikptool roce_qmm -i %s -b all -e\n", (char *)nic_name);
+	hikp_roce_set_qmm_ext_flag(true);
+	hikp_roce_qmm_execute(&self);
 
 	return 0;
 }
@@ -507,5 +537,6 @@ void collect_roce_log(void)
 	collect_roce_cc_param_log();
 	collect_roce_sw_stats_log();
 	collect_roce_res_stats_log();
+	collect_roce_ctx_log();
 	hikp_collect_all_nic_cmd_log(collect_one_roce_hikp_log);
 }
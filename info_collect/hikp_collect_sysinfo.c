@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2025 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+#include "hikp_collect_sysinfo.h"
+#include "tool_lib.h"
+
+#define SYSINFO_PROC_PATH	"/proc"
+#define SYSINFO_STAT_PATH	"/proc/stat"
+#define SYSINFO_VMSTAT_PATH	"/proc/vmstat"
+#define SYSINFO_MEMINFO_PATH	"/proc/meminfo"
+
+#define SYSINFO_LINE_LEN	1024
+#define SYSINFO_PATH_LEN	64
+#define SYSINFO_FILE_BUF_LEN	4096
+#define SYSINFO_KB_PER_MB	1024
+#define SYSINFO_BYTES_PER_KB	1024
+#define SYSINFO_PERCENT		100.0
+
+static uint32_t g_sysinfo_window_ms = SYSINFO_WINDOW_DEF_MS;
+/* Two samples taken g_sysinfo_window_ms apart, [0] is the older one */
+static struct sysinfo_sample g_sysinfo_samples[2];
+static bool g_sysinfo_sampled;
+
+void hikp_sysinfo_set_window(uint32_t window_ms)
+{
+	g_sysinfo_window_ms = window_ms;
+}
+
+static uint64_t sysinfo_delta(uint64_t old_val, uint64_t new_val)
+{
+	/* Counters may go backwards on cpu hotplug, report no activity then */
+	return new_val >= old_val ? new_val - old_val : 0;
+}
+
+static double sysinfo_pct(uint64_t part, uint64_t total)
+{
+	return total != 0 ? (double)part * SYSINFO_PERCENT / (double)total : 0.0;
+}
+
+static double sysinfo_rate(uint64_t delta, uint64_t time_ns)
+{
+	return time_ns != 0 ? (double)delta * (double)HIKP_NSEC_PER_SEC / (double)time_ns : 0.0;
+}
+
+/*
+ * Read one whole line into buf. Lines longer than buf (e.g. "intr" in
+ * /proc/stat) are truncated, the rest is dropped so that the next call
+ * always starts at the beginning of a line.
+ */
+static bool sysinfo_read_line(FILE *fp, char *buf, int len)
+{
+	int c;
+
+	if (fgets(buf, len, fp) == NULL)
+		return false;
+
+	if (strchr(buf, '\n') == NULL) {
+		do {
+			c = fgetc(fp);
+		} while (c != '\n' && c != EOF);
+	}
+
+	return true;
+}
+
+static int sysinfo_add_cpu(struct sysinfo_sample *sample, const char *line)
+{
+	struct sysinfo_cpu_stat *cpus;
+	struct sysinfo_cpu_stat *cpu;
+	int ret;
+
+	cpus = (struct sysinfo_cpu_stat *)realloc(sample->cpus,
+						  (sample->cpu_num + 1) * sizeof(*cpus));
+	if (cpus == NULL)
+		return -ENOMEM;
+
+	sample->cpus = cpus;
+	cpu = &cpus[sample->cpu_num];
+	memset(cpu, 0, sizeof(*cpu));
+	cpu->id = -1;
+	if (isdigit((unsigned char)line[strlen("cpu")]))
+		cpu->id = (int32_t)strtol(line + strlen("cpu"), NULL, 10);
+
+	ret = sscanf(line, "%*s %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64
+		     " %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64,
+		     &cpu->user, &cpu->nice, &cpu->system, &cpu->idle,
+		     &cpu->iowait, &cpu->irq, &cpu->softirq, &cpu->steal);
+	if (ret < 4) /* 4: user nice system idle exist on all kernels */
+		return -EINVAL;
+
+	sample->cpu_num++;
+	return 0;
+}
+
+static int sysinfo_read_stat(struct sysinfo_sample *sample)
+{
+	char line[SYSINFO_LINE_LEN];
+	int ret = 0;
+	FILE *fp;
+
+	fp = fopen(SYSINFO_STAT_PATH, "r");
+	if (fp == NULL)
+		return -errno;
+
+	while (sysinfo_read_line(fp, line, sizeof(line))) {
+		if (strncmp(line, "cpu", strlen("cpu")) == 0)
+			ret = sysinfo_add_cpu(sample, line);
+		else if (strncmp(line, "intr ", strlen("intr ")) == 0)
+			ret = sscanf(line, "intr %" SCNu64, &sample->intr) == 1 ? 0 : -EINVAL;
+		else if (strncmp(line, "ctxt ", strlen("ctxt ")) == 0)
+			ret = sscanf(line, "ctxt %" SCNu64, &sample->ctxt) == 1 ? 0 : -EINVAL;
+		else if (strncmp(line, "procs_running ", strlen("procs_running ")) == 0)
+			ret = sscanf(line, "procs_running %" SCNu64,
+				     &sample->procs_running) == 1 ? 0 : -EINVAL;
+		else if (strncmp(line, "procs_blocked ", strlen("procs_blocked ")) == 0)
+			ret = sscanf(line, "procs_blocked %" SCNu64,
+				     &sample->procs_blocked) == 1 ? 0 : -EINVAL;
+		if (ret != 0)
+			break;
+	}
+	fclose(fp);
+
+	return ret;
+}
+
+static void sysinfo_read_vmstat(struct sysinfo_sample *sample)
+{
+	char name[SYSINFO_PATH_LEN];
+	char line[SYSINFO_LINE_LEN];
+	uint64_t val;
+	FILE *fp;
+
+	fp = fopen(SYSINFO_VMSTAT_PATH, "r");
+	if (fp == NULL)
+		return;
+
+	while (sysinfo_read_line(fp, line, sizeof(line))) {
+		if (sscanf(line, "%63s %" SCNu64, name, &val) != 2)
+			continue;
+		if (strcmp(name, "pgpgin") == 0)
+			sample->pgpgin = val;
+		else if (strcmp(name, "pgpgout") == 0)
+			sample->pgpgout = val;
+		else if (strcmp(name, "pswpin") == 0)
+			sample->pswpin = val;
+		else if (strcmp(name, "pswpout") == 0)
+			sample->pswpout = val;
+	}
+	fclose(fp);
+}
+
+static int sysinfo_read_proc(int pid, struct sysinfo_proc_stat *proc)
+{
+	char path[SYSINFO_PATH_LEN] = {0};
+	char line[SYSINFO_LINE_LEN] = {0};
+	uint64_t utime, stime;
+	char *comm_start;
+	char *comm_end;
+	size_t comm_len;
+	FILE *fp;
+	int ret;
+
+	(void)snprintf(path, sizeof(path), SYSINFO_PROC_PATH "/%d/stat", pid);
+	fp = fopen(path, "r");
+	if (fp == NULL)
+		return -errno;
+
+	if (fgets(line, sizeof(line), fp) == NULL) {
+		fclose(fp);
+		return -EIO;
+	}
+	fclose(fp);
+
+	/* comm may contain spaces and parentheses, so use the last ')' */
+	comm_start = strchr(line, '(');
+	comm_end = strrchr(line, ')');
+	if (comm_start == NULL || comm_end == NULL || comm_end < comm_start)
+		return -EINVAL;
+
+	comm_len = HIKP_MIN((size_t)(comm_end - comm_start - 1), sizeof(proc->comm) - 1);
+	memcpy(proc->comm, comm_start + 1, comm_len);
+	proc->comm[comm_len] = '\0';
+	proc->pid = pid;
+
+	ret = sscanf(comm_end + 1, " %c %d %*d %*d %*d %*d %*u %*u %*u %*u %*u"
+		     " %" SCNu64 " %" SCNu64 " %*d %*d %*d %" SCNd64 " %" SCNd64
+		     " %*d %*u %" SCNu64 " %" SCNd64,
+		     &proc->state, &proc->ppid, &utime, &stime, &proc->nice,
+		     &proc->threads, &proc->vsize, &proc->rss);
+	if (ret != 8) /* 8: number of the fields converted above */
+		return -EINVAL;
+
+	proc->ticks = utime + stime;
+	return 0;
+}
+
+static int sysinfo_proc_cmp(const void *a, const void *b)
+{
+	const struct sysinfo_proc_stat *x = (const struct sysinfo_proc_stat *)a;
+	const struct sysinfo_proc_stat *y = (const struct sysinfo_proc_stat *)b;
+
+	return (x->pid > y->pid) - (x->pid < y->pid);
+}
+
+static int sysinfo_read_procs(struct sysinfo_sample *sample)
+{
+	struct sysinfo_proc_stat *procs;
+	uint32_t max_num = 0;
+	struct dirent *ptr;
+	DIR *dir;
+
+	dir = opendir(SYSINFO_PROC_PATH);
+	if (dir == NULL)
+		return -errno;
+
+	while ((ptr = readdir(dir)) != NULL) {
+		if (isdigit((unsigned char)ptr->d_name[0]))
+			max_num++;
+	}
+	if (max_num == 0) {
+		closedir(dir);
+		return 0;
+	}
+
+	procs = (struct sysinfo_proc_stat *)calloc(max_num, sizeof(*procs));
+	if (procs == NULL) {
+		closedir(dir);
+		return -ENOMEM;
+	}
+
+	rewinddir(dir);
+	while ((ptr = readdir(dir)) != NULL && sample->proc_num < max_num) {
+		if (!isdigit((unsigned char)ptr->d_name[0]))
+			continue;
+		/* The process may exit at any time, just skip it */
+		if (sysinfo_read_proc(atoi(ptr->d_name), &procs[sample->proc_num]) == 0)
+			sample->proc_num++;
+	}
+	closedir(dir);
+
+	qsort(procs, sample->proc_num, sizeof(*procs), sysinfo_proc_cmp);
+	sample->procs = procs;
+	return 0;
+}
+
+static void sysinfo_sample_free(struct sysinfo_sample *sample)
+{
+	free(sample->cpus);
+	free(sample->procs);
+	memset(sample, 0, sizeof(*sample));
+}
+
+static int sysinfo_sample_one(struct sysinfo_sample *sample)
+{
+	int ret;
+
+	sample->time_ns = tool_get_time_ns();
+	ret = sysinfo_read_stat(sample);
+	if (ret != 0)
+		return ret;
+
+	sysinfo_read_vmstat(sample);
+	return sysinfo_read_procs(sample);
+}
+
+int hikp_sysinfo_sample(void)
+{
+	int ret;
+
+	hikp_sysinfo_release();
+
+	ret = sysinfo_sample_one(&g_sysinfo_samples[0]);
+	if (ret != 0)
+		goto err_out;
+
+	tool_sleep_until(g_sysinfo_samples[0].time_ns +
+			 (uint64_t)g_sysinfo_window_ms * HIKP_NSEC_PER_MSEC);
+
+	ret = sysinfo_sample_one(&g_sysinfo_samples[1]);
+	if (ret != 0)
+		goto err_out;
+
+	g_sysinfo_sampled = true;
+	return 0;
+
+err_out:
+	HIKP_ERROR_PRINT("failed to sample system statistics: %d\n", ret);
+	hikp_sysinfo_release();
+	return ret;
+}
+
+void hikp_sysinfo_release(void)
+{
+	sysinfo_sample_free(&g_sysinfo_samples[0]);
+	sysinfo_sample_free(&g_sysinfo_samples[1]);
+	g_sysinfo_sampled = false;
+}
+
+int hikp_sysinfo_dump_file(const char *path)
+{
+	char buf[SYSINFO_FILE_BUF_LEN];
+	size_t len;
+	FILE *fp;
+
+	printf("# %s\n", path);
+	fp = fopen(path, "r");
+	if (fp == NULL) {
+		printf("open %s failed: %d\n", path, errno);
+		return -errno;
+	}
+
+	while ((len = fread(buf, 1, sizeof(buf), fp)) > 0)
+		(void)fwrite(buf, 1, len, stdout);
+	fclose(fp);
+	printf("\n");
+
+	return 0;
+}
+
+void hikp_sysinfo_show_uname(void)
+{
+	struct utsname uts = {0};
+
+	if (uname(&uts) != 0) {
+		printf("uname failed: %d\n", errno);
+		return;
+	}
+
+	printf("# uname\n%s %s %s %s %s\n\n", uts.sysname, uts.nodename, uts.release,
+	       uts.version, uts.machine);
+}
+
+void hikp_sysinfo_show_page_size(void)
+{
+	printf("# page size\n%ld\n\n", sysconf(_SC_PAGESIZE));
+}
+
+static uint64_t sysinfo_meminfo_kb(const char *buf, const char *key)
+{
+	size_t key_len = strlen(key);
+	const char *pos = buf;
+	uint64_t val = 0;
+
+	while (pos != NULL && *pos != '\0') {
+		if (strncmp(pos, key, key_len) == 0 && pos[key_len] == ':') {
+			(void)sscanf(pos + key_len + 1, "%" SCNu64, &val);
+			return val;
+		}
+		pos = strchr(pos, '\n');
+		if (pos != NULL)
+			pos++;
+	}
+
+	return 0;
+}
+
+void hikp_sysinfo_show_free(void)
+{
+	uint64_t total, mem_free, buffers, cached, shared, avail, used;
+	uint64_t swap_total, swap_free;
+	char buf[SYSINFO_FILE_BUF_LEN] = {0};
+	size_t len;
+	FILE *fp;
+
+	fp = fopen(SYSINFO_MEMINFO_PATH, "r");
+	if (fp == NULL)
+		return;
+	len = fread(buf, 1, sizeof(buf) - 1, fp);
+	buf[len] = '\0';
+	fclose(fp);
+
+	total = sysinfo_meminfo_kb(buf, "MemTotal");
+	mem_free = sysinfo_meminfo_kb(buf, "MemFree");
+	buffers = sysinfo_meminfo_kb(buf, "Buffers");
+	cached = sysinfo_meminfo_kb(buf, "Cached") + sysinfo_meminfo_kb(buf, "SReclaimable");
+	shared = sysinfo_meminfo_kb(buf, "Shmem");
+	avail = sysinfo_meminfo_kb(buf, "MemAvailable");
+	swap_total = sysinfo_meminfo_kb(buf, "SwapTotal");
+	swap_free = sysinfo_meminfo_kb(buf, "SwapFree");
+	used = sysinfo_delta(mem_free + buffers + cached, total);
+
+	printf("# free -m\n");
+	printf("%-7s%12s%12s%12s%12s%12s%12s\n", "", "total", "used", "free",
+	       "shared", "buff/cache", "available");
+	printf("%-7s%12" PRIu64 "%12" PRIu64 "%12" PRIu64 "%12" PRIu64 "%12" PRIu64
+	       "%12" PRIu64 "\n", "Mem:", total / SYSINFO_KB_PER_MB, used / SYSINFO_KB_PER_MB,
+	       mem_free / SYSINFO_KB_PER_MB, shared / SYSINFO_KB_PER_MB,
+	       (buffers + cached) / SYSINFO_KB_PER_MB, avail / SYSINFO_KB_PER_MB);
+	printf("%-7s%12" PRIu64 "%12" PRIu64 "%12" PRIu64 "\n\n", "Swap:",
+	       swap_total / SYSINFO_KB_PER_MB,
+	       sysinfo_delta(swap_free, swap_total) / SYSINFO_KB_PER_MB,
+	       swap_free / SYSINFO_KB_PER_MB);
+}
+
+static uint64_t sysinfo_cpu_total(const struct sysinfo_cpu_stat *cpu)
+{
+	return cpu->user + cpu->nice + cpu->system + cpu->idle + cpu->iowait +
+	       cpu->irq + cpu->softirq + cpu->steal;
+}
+
+static void sysinfo_cpu_delta(const struct sysinfo_cpu_stat *old_cpu,
+			      const struct sysinfo_cpu_stat *new_cpu,
+			      struct sysinfo_cpu_stat *delta)
+{
+	delta->id = new_cpu->id;
+	delta->user = sysinfo_delta(old_cpu->user, new_cpu->user);
+	delta->nice = sysinfo_delta(old_cpu->nice, new_cpu->nice);
+	delta->system = sysinfo_delta(old_cpu->system, new_cpu->system);
+	delta->idle = sysinfo_delta(old_cpu->idle, new_cpu->idle);
+	delta->iowait = sysinfo_delta(old_cpu->iowait, new_cpu->iowait);
+	delta->irq = sysinfo_delta(old_cpu->irq, new_cpu->irq);
+	delta->softirq = sysinfo_delta(old_cpu->softirq, new_cpu->softirq);
+	delta->steal = sysinfo_delta(old_cpu->steal, new_cpu->steal);
+}
+
+void hikp_sysinfo_show_vmstat(void)
+{
+	const struct sysinfo_sample *old_s = &g_sysinfo_samples[0];
+	const struct sysinfo_sample *new_s = &g_sysinfo_samples[1];
+	struct sysinfo_cpu_stat cpu = {0};
+	uint64_t time_ns, total;
+	long page_kb;
+
+	if (!g_sysinfo_sampled || old_s->cpu_num == 0 || new_s->cpu_num == 0)
+		return;
+
+	time_ns = sysinfo_delta(old_s->time_ns, new_s->time_ns);
+	page_kb = sysconf(_SC_PAGESIZE) / SYSINFO_BYTES_PER_KB;
+	sysinfo_cpu_delta(&old_s->cpus[0], &new_s->cpus[0], &cpu);
+	total = sysinfo_cpu_total(&cpu);
+
+	printf("# vmstat, rates per second over %u ms\n", g_sysinfo_window_ms);
+	printf("%4s %4s %8s %8s %8s %8s %8s %8s %3s %3s %3s %3s %3s\n",
+	       "r", "b", "si", "so", "bi", "bo", "in", "cs", "us", "sy", "id", "wa", "st");
+	printf("%4" PRIu64 " %4" PRIu64 " %8.0f %8.0f %8.0f %8.0f %8.0f %8.0f"
+	       " %3.0f %3.0f %3.0f %3.0f %3.0f\n\n",
+	       new_s->procs_running, new_s->procs_blocked,
+	       sysinfo_rate(sysinfo_delta(old_s->pswpin, new_s->pswpin) * (uint64_t)page_kb,
+			    time_ns),
+	       sysinfo_rate(sysinfo_delta(old_s->pswpout, new_s->pswpout) * (uint64_t)page_kb,
+			    time_ns),
+	       sysinfo_rate(sysinfo_delta(old_s->pgpgin, new_s->pgpgin), time_ns),
+	       sysinfo_rate(sysinfo_delta(old_s->pgpgout, new_s->pgpgout), time_ns),
+	       sysinfo_rate(sysinfo_delta(old_s->intr, new_s->intr), time_ns),
+	       sysinfo_rate(sysinfo_delta(old_s->ctxt, new_s->ctxt), time_ns),
+	       sysinfo_pct(cpu.user + cpu.nice, total),
+	       sysinfo_pct(cpu.system + cpu.irq + cpu.softirq, total),
+	       sysinfo_pct(cpu.idle, total), sysinfo_pct(cpu.iowait, total),
+	       sysinfo_pct(cpu.steal, total));
+}
+
+static void sysinfo_show_one_cpu(const struct sysinfo_cpu_stat *old_cpu,
+				 const struct sysinfo_cpu_stat *new_cpu)
+{
+	struct sysinfo_cpu_stat cpu = {0};
+	char name[SYSINFO_PATH_LEN] = "all";
+	uint64_t total;
+
+	sysinfo_cpu_delta(old_cpu, new_cpu, &cpu);
+	total = sysinfo_cpu_total(&cpu);
+	if (cpu.id >= 0)
+		(void)snprintf(name, sizeof(name), "%d", cpu.id);
+
+	printf("%-5s %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f\n", name,
+	       sysinfo_pct(cpu.user, total), sysinfo_pct(cpu.nice, total),
+	       sysinfo_pct(cpu.system, total), sysinfo_pct(cpu.iowait, total),
+	       sysinfo_pct(cpu.irq, total), sysinfo_pct(cpu.softirq, total),
+	       sysinfo_pct(cpu.steal, total), sysinfo_pct(cpu.idle, total));
+}
+
+void hikp_sysinfo_show_cpu_usage(void)
+{
+	const struct sysinfo_sample *old_s = &g_sysinfo_samples[0];
+	const struct sysinfo_sample *new_s = &g_sysinfo_samples[1];
+	uint32_t i, j;
+
+	if (!g_sysinfo_sampled)
+		return;
+
+	printf("# cpu usage over %u ms\n", g_sysinfo_window_ms);
+	printf("%-5s %7s %7s %7s %7s %7s %7s %7s %7s\n", "CPU", "%usr", "%nice", "%sys",
+	       "%iowait", "%irq", "%soft", "%steal", "%idle");
+	/* Lines of offline cpus are absent, so match both samples by cpu id */
+	for (i = 0, j = 0; i < old_s->cpu_num && j < new_s->cpu_num;) {
+		if (old_s->cpus[i].id < new_s->cpus[j].id) {
+			i++;
+		} else if (old_s->cpus[i].id > new_s->cpus[j].id) {
+			j++;
+		} else {
+			sysinfo_show_one_cpu(&old_s->cpus[i], &new_s->cpus[j]);
+			i++;
+			j++;
+		}
+	}
+	printf("\n");
+}
+
+struct sysinfo_proc_usage {
+	const struct sysinfo_proc_stat *proc;
+	double cpu_pct;
+};
+
+static int sysinfo_proc_usage_cmp(const void *a, const void *b)
+{
+	const struct sysinfo_proc_usage *x = (const struct sysinfo_proc_usage *)a;
+	const struct sysinfo_proc_usage *y = (const struct sysinfo_proc_usage *)b;
+
+	if (x->cpu_pct > y->cpu_pct)
+		return -1;
+	if (x->cpu_pct < y->cpu_pct)
+		return 1;
+	return sysinfo_proc_cmp(x->proc, y->proc);
+}
+
+static void sysinfo_read_cmdline(int pid, char *cmd, size_t len)
+{
+	char path[SYSINFO_PATH_LEN] = {0};
+	size_t rd_len = 0;
+	size_t i;
+	FILE *fp;
+
+	(void)snprintf(path, sizeof(path), SYSINFO_PROC_PATH "/%d/cmdline", pid);
+	fp = fopen(path, "r");
+	if (fp != NULL) {
+		rd_len = fread(cmd, 1, len - 1, fp);
+		fclose(fp);
+	}
+
+	cmd[rd_len] = '\0';
+	for (i = 0; rd_len > 0 && i < rd_len - 1; i++) {
+		if (cmd[i] == '\0')
+			cmd[i] = ' ';
+	}
+}
+
+void hikp_sysinfo_show_process(void)
+{
+	const struct sysinfo_sample *old_s = &g_sysinfo_samples[0];
+	const struct sysinfo_sample *new_s = &g_sysinfo_samples[1];
+	const struct sysinfo_proc_stat *old_proc;
+	char cmd[SYSINFO_PROC_CMD_LEN] = {0};
+	struct sysinfo_proc_usage *usage;
+	const struct sysinfo_proc_stat *proc;
+	uint64_t time_ns, ticks;
+	long clk_tck, page_kb;
+	uint32_t i;
+
+	if (!g_sysinfo_sampled || new_s->proc_num == 0)
+		return;
+
+	usage = (struct sysinfo_proc_usage *)calloc(new_s->proc_num, sizeof(*usage));
+	if (usage == NULL)
+		return;
+
+	clk_tck = sysconf(_SC_CLK_TCK);
+	page_kb = sysconf(_SC_PAGESIZE) / SYSINFO_BYTES_PER_KB;
+	time_ns = sysinfo_delta(old_s->time_ns, new_s->time_ns);
+	for (i = 0; i < new_s->proc_num; i++) {
+		proc = &new_s->procs[i];
+		old_proc = (const struct sysinfo_proc_stat *)bsearch(proc, old_s->procs,
+			old_s->proc_num, sizeof(*proc), sysinfo_proc_cmp);
+		/* A process started inside the window is charged from zero */
+		ticks = old_proc ? sysinfo_delta(old_proc->ticks, proc->ticks) : proc->ticks;
+		usage[i].proc = proc;
+		usage[i].cpu_pct = clk_tck > 0 ?
+			sysinfo_rate(ticks, time_ns) * SYSINFO_PERCENT / (double)clk_tck : 0.0;
+	}
+	qsort(usage, new_s->proc_num, sizeof(*usage), sysinfo_proc_usage_cmp);
+
+	printf("# processes, %%CPU over %u ms\n", g_sysinfo_window_ms);
+	printf("%8s %8s %1s %4s %5s %12s %10s %6s %10s  %s\n", "PID", "PPID", "S", "NI",
+	       "THR", "VSZ(KB)", "RSS(KB)", "%CPU", "TIME(s)", "COMMAND");
+	for (i = 0; i < new_s->proc_num; i++) {
+		proc = usage[i].proc;
+		sysinfo_read_cmdline(proc->pid, cmd, sizeof(cmd));
+		printf("%8d %8d %c %4" PRId64 " %5" PRId64 " %12" PRIu64 " %10" PRId64
+		       " %6.1f %10" PRIu64 "  %s%s%s\n",
+		       proc->pid, proc->ppid, proc->state, proc->nice, proc->threads,
+		       proc->vsize / SYSINFO_BYTES_PER_KB, proc->rss * page_kb, usage[i].cpu_pct,
+		       clk_tck > 0 ? proc->ticks / (uint64_t)clk_tck : 0,
+		       cmd[0] ? "" : "[", cmd[0] ? cmd : proc->comm, cmd[0] ? "" : "]");
+	}
+	printf("\n");
+
+	free(usage);
+}
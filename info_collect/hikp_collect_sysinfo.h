@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2025 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef HIKP_COLLECT_SYSINFO_H
+#define HIKP_COLLECT_SYSINFO_H
+
+#include <stdint.h>
+
+#define SYSINFO_WINDOW_DEF_MS	200
+#define SYSINFO_WINDOW_MIN_MS	10
+#define SYSINFO_WINDOW_MAX_MS	10000
+
+#define SYSINFO_PROC_COMM_LEN	32
+#define SYSINFO_PROC_CMD_LEN	128
+
+struct sysinfo_cpu_stat {
+	int32_t id; /* -1 for the summary line */
+	uint64_t user;
+	uint64_t nice;
+	uint64_t system;
+	uint64_t idle;
+	uint64_t iowait;
+	uint64_t irq;
+	uint64_t softirq;
+	uint64_t steal;
+};
+
+struct sysinfo_proc_stat {
+	int pid;
+	int ppid;
+	char state;
+	char comm[SYSINFO_PROC_COMM_LEN];
+	int64_t nice;
+	int64_t threads;
+	uint64_t ticks; /* utime + stime */
+	uint64_t vsize;
+	int64_t rss;
+};
+
+/* One sample of /proc/stat, /proc/vmstat and every /proc/[pid]/stat */
+struct sysinfo_sample {
+	uint64_t time_ns;
+	/* cpus[0] is the summary line, cpus[i + 1] is cpu i */
+	struct sysinfo_cpu_stat *cpus;
+	uint32_t cpu_num;
+	uint64_t intr;
+	uint64_t ctxt;
+	uint64_t procs_running;
+	uint64_t procs_blocked;
+	uint64_t pgpgin;
+	uint64_t pgpgout;
+	uint64_t pswpin;
+	uint64_t pswpout;
+	struct sysinfo_proc_stat *procs;
+	uint32_t proc_num;
+};
+
+void hikp_sysinfo_set_window(uint32_t window_ms);
+int hikp_sysinfo_sample(void);
+void hikp_sysinfo_release(void);
+
+int hikp_sysinfo_dump_file(const char *path);
+void hikp_sysinfo_show_uname(void);
+void hikp_sysinfo_show_page_size(void);
+void hikp_sysinfo_show_free(void);
+void hikp_sysinfo_show_vmstat(void);
+void hikp_sysinfo_show_cpu_usage(void);
+void hikp_sysinfo_show_process(void);
+
+#endif /* HIKP_COLLECT_SYSINFO_H */
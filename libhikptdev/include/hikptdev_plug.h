@@ -51,7 +51,9 @@ enum cmd_module_type {
 	HCCS_MOD = 16,
 	SDMA_MOD = 17,
 	CORE_RING_MOD = 18,
-	RAS_MOD = 19
+	RAS_MOD = 19,
+	/* keep last, the number of module codes */
+	HIKP_MOD_NUM
 };
 
 void hikp_unlock(void);
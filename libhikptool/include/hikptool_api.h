@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef HIKPTOOL_API_H
+#define HIKPTOOL_API_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * libhikptool: the hikptool queries as plain functions filling caller owned
+ * structs, for agents that poll in-process instead of forking hikptool.
+ *
+ * Call hikp_api_init() once before any query and hikp_api_uninit() at the
+ * end. Queries share one mailbox and are not thread safe, callers serialize
+ * them. Every query holds the same shared module lock as the CLI, so it never
+ * overlaps a state changing command such as "hikptool ... --clear" on that
+ * module. All functions return 0 on success or a negative errno.
+ *
+ * Experimental: the API and ABI may still change, the library keeps SOVERSION
+ * 0 until it covers what agents poll today. Not there yet:
+ *  - nic queue state and statistics (nic_queue)
+ *  - ppp mac, vlan and manager tables (nic_ppp, unic_ppp)
+ *  - ras black box dumps (bbox_export)
+ * Use the CLI for those meanwhile. HIKP_API_VERSION is bumped on every change.
+ */
+
+#define HIKP_API __attribute__((visibility("default")))
+
+#define HIKP_API_VERSION		1
+#define HIKP_API_DEV_NAME_LEN		16
+#define HIKP_API_MAX_PF_NUM		8
+#define HIKP_API_REVISION_LEN		8
+#define HIKP_API_FEC_MAX_LANES		8
+#define HIKP_API_SERDES_MAX_LANES	32
+
+/* A resolved network function, see hikp_api_dev_resolve(). */
+struct hikp_api_dev {
+	uint32_t domain;
+	uint8_t bus_id;
+	uint8_t dev_id;
+	uint8_t fun_id;
+	uint8_t rsv;
+	char dev_name[HIKP_API_DEV_NAME_LEN]; /* empty when no netdev is bound */
+};
+
+struct hikp_api_nic_pf {
+	uint8_t pf_mode; /* 0: ARM, 1: X86 */
+	uint8_t mac_id;
+	uint8_t mac_type; /* 0: ETH, 1: ROH, 2: UB */
+	uint8_t rsv;
+	uint16_t func_num;
+	uint16_t tqp_num;
+	uint32_t pf_cap_flag;
+};
+
+struct hikp_api_nic_info {
+	uint8_t mac_mode;
+	uint8_t chip_id;
+	uint8_t die_id;
+	uint8_t pf_num;
+	uint32_t cap_flag;
+	uint8_t numvfs;
+	uint8_t rsv[3];
+	char revision_id[HIKP_API_REVISION_LEN];
+	struct hikp_api_nic_pf pf[HIKP_API_MAX_PF_NUM];
+};
+
+enum hikp_api_fec_mode {
+	HIKP_API_FEC_NOFEC = 0,
+	HIKP_API_FEC_BASEFEC,
+	HIKP_API_FEC_RSFEC,
+	HIKP_API_FEC_LLRSFEC,
+};
+
+/* BASE-FEC counts blocks and has per lane counters, RS-FEC counts codewords. */
+struct hikp_api_nic_fec {
+	uint32_t fec_mode; /* enum hikp_api_fec_mode */
+	uint32_t corr_cnt;
+	uint32_t uncorr_cnt;
+	uint32_t err_cw_cnt; /* RS-FEC only */
+	uint32_t lane_num; /* BASE-FEC only */
+	uint32_t lane_corr_cnt[HIKP_API_FEC_MAX_LANES];
+	uint32_t lane_uncorr_cnt[HIKP_API_FEC_MAX_LANES];
+};
+
+struct hikp_api_pcie_err_state {
+	uint32_t phy_lane_err_cnt;
+	uint32_t symbol_unlock_cnt;
+	uint32_t loop_back_link_data_err_cnt;
+	uint32_t mac_int_status;
+	uint32_t pcs_rx_err_cnt;
+	uint32_t framing_err_cnt;
+	uint32_t dl_lcrc_err_num;
+	uint32_t dl_dcrc_err_num;
+};
+
+struct hikp_api_serdes_lane {
+	uint8_t tx_cs_sel;
+	uint8_t rx_cs_sel;
+	uint8_t tx_pn;
+	uint8_t rx_pn;
+	uint8_t tx_power;
+	uint8_t rx_power;
+	uint8_t refclk_sel;
+	uint8_t use_mode;
+	uint8_t ssc_type;
+	uint8_t rsv[3];
+	uint32_t tx_data_rate_mhz;
+	uint32_t rx_data_rate_mhz;
+};
+
+HIKP_API int hikp_api_version(void);
+HIKP_API int hikp_api_init(void);
+HIKP_API void hikp_api_uninit(void);
+
+/* name is a netdev name such as "eth0" or a bdf such as "0000:35:00.0". */
+HIKP_API int hikp_api_dev_resolve(const char *name, struct hikp_api_dev *dev);
+
+HIKP_API int hikp_api_nic_info(const struct hikp_api_dev *dev, struct hikp_api_nic_info *info);
+HIKP_API int hikp_api_nic_fec(const struct hikp_api_dev *dev, struct hikp_api_nic_fec *fec);
+HIKP_API int hikp_api_pcie_err_state(uint32_t port_id, struct hikp_api_pcie_err_state *state);
+
+/* Brief info of lane_num lanes from start_lane, lanes[] holds lane_num entries. */
+HIKP_API int hikp_api_serdes_info(uint8_t chip_id, uint8_t macro_id, uint8_t start_lane,
+				  uint8_t lane_num, struct hikp_api_serdes_lane *lanes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HIKPTOOL_API_H */
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "tool_cmd.h"
+#include "hikptdev_plug.h"
+#include "hikp_net_lib.h"
+#include "hikp_nic_info.h"
+#include "hikp_nic_fec.h"
+#include "pcie_statistics.h"
+#include "hikp_serdes.h"
+#include "hikptool_api.h"
+
+#define HIKP_API_LOCK_NAME_LEN	64
+
+_Static_assert(HIKP_API_MAX_PF_NUM == HIKP_MAX_PF_NUM, "pf table size mismatch");
+_Static_assert(HIKP_API_FEC_MAX_LANES == NIC_FEC_MAX_LANES, "fec lane table size mismatch");
+_Static_assert(HIKP_API_DEV_NAME_LEN == IFNAMSIZ, "dev name size mismatch");
+
+static bool g_api_inited;
+
+static int hikp_api_lock(uint32_t mod_code, int *fd)
+{
+	char name[HIKP_API_LOCK_NAME_LEN] = {0};
+
+	if (!g_api_inited)
+		return -EPERM;
+
+	/* The same lock file as the CLI execute lock of this module */
+	snprintf(name, sizeof(name), "%s_%u", CMD_EXECUTE_LOCK_NAME, mod_code);
+	return tool_flock(name, UDA_FLOCK_SHARED_BLOCK, fd, HIKP_LOG_DIR_PATH);
+}
+
+static void hikp_api_unlock(int *fd)
+{
+	tool_unlock(fd, UDA_FLOCK_SHARED_BLOCK);
+}
+
+static void hikp_api_dev_to_bdf(const struct hikp_api_dev *dev, struct bdf_t *bdf)
+{
+	memset(bdf, 0, sizeof(*bdf));
+	bdf->domain = dev->domain;
+	bdf->bus_id = dev->bus_id;
+	bdf->dev_id = dev->dev_id;
+	bdf->fun_id = dev->fun_id;
+}
+
+int hikp_api_version(void)
+{
+	return HIKP_API_VERSION;
+}
+
+int hikp_api_init(void)
+{
+	int ret;
+
+	if (g_api_inited)
+		return 0;
+
+	ret = hikp_dev_init();
+	if (ret != 0)
+		return ret;
+	/* a library caller lives across hotplug, keep the resolver in sync */
+	(void)hikp_net_dev_cache_watch();
+	g_api_inited = true;
+
+	return 0;
+}
+
+void hikp_api_uninit(void)
+{
+	if (!g_api_inited)
+		return;
+
+	hikp_net_lib_uninit();
+	hikp_dev_uninit();
+	g_api_inited = false;
+}
+
+int hikp_api_dev_resolve(const char *name, struct hikp_api_dev *dev)
+{
+	struct tool_target target = { 0 };
+	int ret;
+
+	if (name == NULL || dev == NULL)
+		return -EINVAL;
+
+	ret = tool_check_and_get_valid_bdf_id(name, &target);
+	if (ret != 0)
+		return ret;
+
+	memset(dev, 0, sizeof(*dev));
+	dev->domain = target.bdf.domain;
+	dev->bus_id = target.bdf.bus_id;
+	dev->dev_id = target.bdf.dev_id;
+	dev->fun_id = target.bdf.fun_id;
+	if (get_dev_name_by_bdf(&target.bdf, target.dev_name, sizeof(target.dev_name)) == 0)
+		snprintf(dev->dev_name, sizeof(dev->dev_name), "%s", target.dev_name);
+
+	return 0;
+}
+
+int hikp_api_nic_info(const struct hikp_api_dev *dev, struct hikp_api_nic_info *info)
+{
+	struct nic_info_rsp_t rsp = { 0 };
+	char revision_id[MAX_PCI_ID_LEN + 1] = { 0 };
+	struct bdf_t bdf;
+	uint32_t i;
+	int fd;
+	int ret;
+
+	if (dev == NULL || info == NULL)
+		return -EINVAL;
+
+	hikp_api_dev_to_bdf(dev, &bdf);
+	ret = hikp_api_lock(NIC_MOD, &fd);
+	if (ret != 0)
+		return ret;
+	ret = hikp_nic_info_query(&bdf, &rsp);
+	hikp_api_unlock(&fd);
+	if (ret != 0)
+		return ret;
+
+	memset(info, 0, sizeof(*info));
+	info->mac_mode = rsp.mac_mode;
+	info->chip_id = rsp.chip_id;
+	info->die_id = rsp.die_id;
+	info->pf_num = rsp.pf_num;
+	info->cap_flag = rsp.cap_flag;
+	for (i = 0; i < HIKP_API_MAX_PF_NUM; i++) {
+		info->pf[i].pf_mode = rsp.pf_info[i].pf_mode;
+		info->pf[i].mac_id = rsp.pf_info[i].mac_id;
+		info->pf[i].mac_type = rsp.pf_info[i].mac_type;
+		info->pf[i].func_num = rsp.pf_info[i].func_num;
+		info->pf[i].tqp_num = rsp.pf_info[i].tqp_num;
+		info->pf[i].pf_cap_flag = rsp.pf_info[i].pf_cap_flag;
+	}
+
+	/* sysfs attributes, missing ones are left empty as the CLI does for numvfs */
+	if (get_revision_id_by_bdf(&bdf, revision_id, sizeof(revision_id)) == 0)
+		snprintf(info->revision_id, sizeof(info->revision_id), "%s", revision_id);
+	(void)get_numvfs_by_bdf(&bdf, &info->numvfs);
+
+	return 0;
+}
+
+int hikp_api_nic_fec(const struct hikp_api_dev *dev, struct hikp_api_nic_fec *fec)
+{
+	struct nic_fec_err_info err_info = { 0 };
+	struct bdf_t bdf;
+	uint32_t i;
+	int fd;
+	int ret;
+
+	if (dev == NULL || fec == NULL)
+		return -EINVAL;
+
+	hikp_api_dev_to_bdf(dev, &bdf);
+	ret = hikp_api_lock(NIC_MOD, &fd);
+	if (ret != 0)
+		return ret;
+	ret = hikp_nic_fec_err_query(&bdf, &err_info);
+	hikp_api_unlock(&fd);
+	if (ret != 0)
+		return ret;
+
+	memset(fec, 0, sizeof(*fec));
+	fec->fec_mode = err_info.fec_mode;
+	switch (err_info.fec_mode) {
+	case NIC_FEC_MODE_BASEFEC:
+		fec->corr_cnt = err_info.basefec.corr_block_cnt;
+		fec->uncorr_cnt = err_info.basefec.uncorr_block_cnt;
+		fec->lane_num = HIKP_MIN(err_info.basefec.lane_num, HIKP_API_FEC_MAX_LANES);
+		for (i = 0; i < fec->lane_num; i++) {
+			fec->lane_corr_cnt[i] = err_info.basefec.lane_corr_block_cnt[i];
+			fec->lane_uncorr_cnt[i] = err_info.basefec.lane_uncorr_block_cnt[i];
+		}
+		break;
+	case NIC_FEC_MODE_RSFEC:
+	case NIC_FEC_MODE_LLRSFEC:
+		fec->corr_cnt = err_info.rsfec.corr_cw_cnt;
+		fec->uncorr_cnt = err_info.rsfec.uncorr_cw_cnt;
+		fec->err_cw_cnt = err_info.rsfec.err_cw_cnt;
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+int hikp_api_pcie_err_state(uint32_t port_id, struct hikp_api_pcie_err_state *state)
+{
+	struct pcie_err_state err_state;
+	int fd;
+	int ret;
+
+	if (state == NULL)
+		return -EINVAL;
+
+	ret = hikp_api_lock(PCIE_MOD, &fd);
+	if (ret != 0)
+		return ret;
+	ret = pcie_error_state_query(port_id, &err_state);
+	hikp_api_unlock(&fd);
+	if (ret != 0)
+		return ret;
+
+	state->phy_lane_err_cnt = err_state.test_cnt.bits.phy_lane_err_counter;
+	state->symbol_unlock_cnt = err_state.symbol_unlock_cnt.bits.symbol_unlock_counter;
+	state->loop_back_link_data_err_cnt =
+		err_state.loop_link_data_err_cnt.bits.loop_back_link_data_err_cnt;
+	state->mac_int_status = err_state.mac_int_status;
+	state->pcs_rx_err_cnt = err_state.rx_err_cnt.bits.pcs_rx_err_cnt;
+	state->framing_err_cnt = err_state.framing_err_cnt.bits.reg_framing_err_count;
+	state->dl_lcrc_err_num = err_state.lcrc_err_num.bits.dl_lcrc_err_num;
+	state->dl_dcrc_err_num = err_state.dcrc_err_num.bits.dl_dcrc_err_num;
+
+	return 0;
+}
+
+int hikp_api_serdes_info(uint8_t chip_id, uint8_t macro_id, uint8_t start_lane,
+			 uint8_t lane_num, struct hikp_api_serdes_lane *lanes)
+{
+	struct cmd_serdes_param cmd = { 0 };
+	uint32_t buf[SERDES_OUTPUT_MAX_SIZE / sizeof(uint32_t)] = { 0 };
+	struct hilink_cmd_out out = { 0 };
+	const struct hilink_brief_info *brief;
+	uint32_t i;
+	int fd;
+	int ret;
+
+	if (lanes == NULL || lane_num == 0 || lane_num > HIKP_API_SERDES_MAX_LANES)
+		return -EINVAL;
+
+	cmd.chip_id = chip_id;
+	cmd.macro_id = macro_id;
+	cmd.start_sds_id = start_lane;
+	cmd.sds_num = lane_num;
+	cmd.sub_cmd = 0; /* brief info */
+	cmd.cmd_type = SERDES_KEY_INFO;
+	out.out_str = (char *)buf;
+	out.str_len = sizeof(buf);
+
+	ret = hikp_api_lock(SERDES_MOD, &fd);
+	if (ret != 0)
+		return ret;
+	ret = hikp_serdes_query(&cmd, &out);
+	hikp_api_unlock(&fd);
+	if (ret != 0)
+		return ret;
+
+	if (out.result_offset != lane_num * sizeof(struct hilink_brief_info))
+		return -EPROTO;
+
+	brief = (const struct hilink_brief_info *)buf;
+	for (i = 0; i < lane_num; i++) {
+		memset(&lanes[i], 0, sizeof(lanes[i]));
+		lanes[i].tx_cs_sel = brief[i].tx_cs_sel;
+		lanes[i].rx_cs_sel = brief[i].rx_cs_sel;
+		lanes[i].tx_pn = brief[i].tx_pn;
+		lanes[i].rx_pn = brief[i].rx_pn;
+		lanes[i].tx_power = brief[i].tx_power;
+		lanes[i].rx_power = brief[i].rx_power;
+		lanes[i].refclk_sel = brief[i].refclk_sel;
+		lanes[i].use_mode = brief[i].usemode;
+		lanes[i].ssc_type = brief[i].ssc_type;
+		lanes[i].tx_data_rate_mhz = brief[i].tx_data_rate_mhz;
+		lanes[i].rx_data_rate_mhz = brief[i].rx_data_rate_mhz;
+	}
+
+	return 0;
+}
@@ -11,18 +11,25 @@
  * See the Mulan PSL v2 for more details.
  */
 #include "hikp_net_lib.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <linux/ethtool.h>
 #include <linux/if.h>
 #include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 #include <linux/sockios.h>
 #include "tool_lib.h"
 #include "hikptdev_plug.h"
 
+static struct hikp_net_dev_cache g_net_dev_cache = { .watch_fd = -1 };
+static int g_net_ctrl_sockfd = -1;
+
 static int hikp_read_net_pci_info(const char *file_path, char *content, size_t len)
 {
 	char path[PATH_MAX] = { 0 }; /* PATH_MAX includes the \0 so +1 is not required */
@@ -78,6 +85,24 @@ int hikp_net_creat_sock(void)
 	return sockfd;
 }
 
+/* The ethtool control socket shared by every lookup of this process. */
+int hikp_net_ctrl_sock(void)
+{
+	int sockfd;
+
+	if (g_net_ctrl_sockfd >= 0)
+		return g_net_ctrl_sockfd;
+
+	sockfd = hikp_net_creat_sock();
+	if (sockfd < 0)
+		return sockfd;
+
+	(void)fcntl(sockfd, F_SETFD, FD_CLOEXEC);
+	g_net_ctrl_sockfd = sockfd;
+
+	return sockfd;
+}
+
 static void fill_bdf_id(struct bdf_t *bdf, uint8_t bus, uint8_t dev, uint8_t func)
 {
 	bdf->bus_id = bus;
@@ -168,8 +193,220 @@ static bool interface_is_bdf_id(const char *dev_name, struct tool_target *target
 	return check_and_parse_simple_bdf_id(dev_name, &(target->bdf));
 }
 
+static bool hikp_net_bdf_equal(const struct bdf_t *a, const struct bdf_t *b)
+{
+	return a->domain == b->domain && a->bus_id == b->bus_id &&
+	       a->dev_id == b->dev_id && a->fun_id == b->fun_id;
+}
+
+static int hikp_net_read_revision_id(const struct bdf_t *bdf, char *revision_id, size_t id_len);
+static int hikp_net_read_numvfs(const struct bdf_t *bdf, uint8_t *numvfs);
+
+static void hikp_net_dev_probe_vf(struct hikp_net_dev *dev)
+{
+	char link_path[MAX_BUS_PCI_DIR_LEN] = { 0 };
+	char link[MAX_BUS_PCI_DIR_LEN] = { 0 };
+	const char *pf_name;
+	ssize_t len;
+	int ret;
+
+	ret = snprintf(link_path, sizeof(link_path), "%s%s%s", HIKP_NET_DEV_PATH, dev->name,
+		       HIKP_NET_PHYSFN_LINK);
+	if (ret < 0 || ret >= (int)sizeof(link_path))
+		return;
+
+	/* physfn links to "../0000:35:00.0" */
+	len = readlink(link_path, link, sizeof(link) - 1);
+	if (len <= 0)
+		return;
+	link[len] = '\0';
+	pf_name = strrchr(link, '/');
+	pf_name = pf_name == NULL ? link : pf_name + 1;
+	dev->is_vf = check_and_parse_domain_bdf_id(pf_name, &dev->pf_bdf);
+}
+
+static void hikp_net_dev_probe(int sockfd, struct hikp_net_dev *dev)
+{
+	struct ethtool_drvinfo drvinfo = { 0 };
+	struct ifreq ifr = { 0 };
+
+	ifr.ifr_data = (char *)&drvinfo;
+	drvinfo.cmd = ETHTOOL_GDRVINFO;
+	strncpy(ifr.ifr_name, dev->name, IFNAMSIZ);
+	ifr.ifr_name[IFNAMSIZ - 1] = '\0';
+	if (ioctl(sockfd, SIOCETHTOOL, &ifr) < 0)
+		return;
+
+	dev->has_bdf = check_and_parse_domain_bdf_id(drvinfo.bus_info, &dev->bdf);
+	dev->is_hns3 = strncmp(drvinfo.driver, HNS3_DRIVER_NAME, sizeof(HNS3_DRIVER_NAME)) == 0;
+	if (!dev->has_bdf || !dev->is_hns3)
+		return;
+
+	if (hikp_net_read_revision_id(&dev->bdf, dev->revision_id, sizeof(dev->revision_id)))
+		dev->revision_id[0] = '\0';
+	dev->has_numvfs = hikp_net_read_numvfs(&dev->bdf, &dev->numvfs) == 0;
+	hikp_net_dev_probe_vf(dev);
+}
+
+static int hikp_net_dev_cache_grow(struct hikp_net_dev_cache *cache)
+{
+	uint32_t max_num = cache->max_num != 0 ? cache->max_num * 2 : HIKP_NET_DEV_CACHE_INIT_NUM;
+	struct hikp_net_dev *dev;
+
+	dev = (struct hikp_net_dev *)realloc(cache->dev, max_num * sizeof(*dev));
+	if (dev == NULL) {
+		HIKP_ERROR_PRINT("failed to grow the net device cache to %u entries.\n", max_num);
+		return -ENOMEM;
+	}
+	cache->dev = dev;
+	cache->max_num = max_num;
+
+	return 0;
+}
+
+static int hikp_net_dev_cache_fill(struct hikp_net_dev_cache *cache)
+{
+	struct hikp_net_dev *dev;
+	struct dirent *ptr;
+	DIR *dir;
+	int sockfd;
+
+	sockfd = hikp_net_ctrl_sock();
+	if (sockfd < 0)
+		return sockfd;
+
+	dir = opendir(HIKP_NET_DEV_PATH);
+	if (dir == NULL)
+		return -errno;
+
+	cache->num = 0;
+	while ((ptr = readdir(dir)) != NULL) {
+		if (ptr->d_name[0] == '.' || strlen(ptr->d_name) >= IFNAMSIZ)
+			continue;
+
+		if (cache->num == cache->max_num && hikp_net_dev_cache_grow(cache) != 0) {
+			closedir(dir);
+			return -ENOMEM;
+		}
+		dev = &cache->dev[cache->num++];
+		memset(dev, 0, sizeof(*dev));
+		(void)snprintf(dev->name, sizeof(dev->name), "%s", ptr->d_name);
+		hikp_net_dev_probe(sockfd, dev);
+	}
+	closedir(dir);
+	cache->valid = true;
+
+	return 0;
+}
+
+/* Only link events are multicast to RTMGRP_LINK, any message drops the cache. */
+static void hikp_net_dev_cache_check_watch(struct hikp_net_dev_cache *cache)
+{
+	uint8_t buf[HIKP_NET_WATCH_BUF_LEN];
+	ssize_t len;
+
+	if (cache->watch_fd < 0)
+		return;
+
+	for (;;) {
+		len = recv(cache->watch_fd, buf, sizeof(buf), MSG_DONTWAIT);
+		if (len > 0 || (len < 0 && errno == ENOBUFS)) {
+			cache->valid = false;
+			cache->miss_refilled = false;
+			continue;
+		}
+		break;
+	}
+}
+
+static const struct hikp_net_dev_cache *hikp_net_dev_cache_get(void)
+{
+	struct hikp_net_dev_cache *cache = &g_net_dev_cache;
+
+	hikp_net_dev_cache_check_watch(cache);
+	if (!cache->valid && hikp_net_dev_cache_fill(cache) != 0)
+		return NULL;
+
+	return cache;
+}
+
+static const struct hikp_net_dev *hikp_net_dev_find_name(const char *name)
+{
+	const struct hikp_net_dev_cache *cache = hikp_net_dev_cache_get();
+	uint32_t i;
+
+	for (i = 0; cache != NULL && i < cache->num; i++) {
+		if (strncmp(cache->dev[i].name, name, IFNAMSIZ) == 0)
+			return &cache->dev[i];
+	}
+
+	return NULL;
+}
+
+static const struct hikp_net_dev *hikp_net_dev_find_bdf(const struct bdf_t *bdf)
+{
+	const struct hikp_net_dev_cache *cache = hikp_net_dev_cache_get();
+	uint32_t i;
+
+	for (i = 0; cache != NULL && i < cache->num; i++) {
+		if (cache->dev[i].has_bdf && hikp_net_bdf_equal(&cache->dev[i].bdf, bdf))
+			return &cache->dev[i];
+	}
+
+	return NULL;
+}
+
+int hikp_net_dev_cache_watch(void)
+{
+	struct sockaddr_nl addr = { 0 };
+	int ret;
+	int fd;
+
+	if (g_net_dev_cache.watch_fd >= 0)
+		return 0;
+
+	fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+	if (fd < 0)
+		return -errno;
+
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = RTMGRP_LINK;
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		ret = -errno;
+		close(fd);
+		return ret;
+	}
+
+	g_net_dev_cache.watch_fd = fd;
+	/* events before the subscription are lost, start from a fresh pass */
+	g_net_dev_cache.valid = false;
+	g_net_dev_cache.miss_refilled = false;
+
+	return 0;
+}
+
+void hikp_net_lib_uninit(void)
+{
+	if (g_net_dev_cache.watch_fd >= 0) {
+		close(g_net_dev_cache.watch_fd);
+		g_net_dev_cache.watch_fd = -1;
+	}
+	free(g_net_dev_cache.dev);
+	g_net_dev_cache.dev = NULL;
+	g_net_dev_cache.max_num = 0;
+	g_net_dev_cache.num = 0;
+	g_net_dev_cache.valid = false;
+	g_net_dev_cache.miss_refilled = false;
+
+	if (g_net_ctrl_sockfd >= 0) {
+		close(g_net_ctrl_sockfd);
+		g_net_ctrl_sockfd = -1;
+	}
+}
+
 static int tool_get_bdf_by_dev_name(const char *name, struct tool_target *target)
 {
+	const struct hikp_net_dev *dev;
 	int sockfd;
 
 	if (strlen(name) >= IFNAMSIZ) {
@@ -179,16 +416,30 @@ static int tool_get_bdf_by_dev_name(const char *name, struct tool_target *target
 	strncpy(target->dev_name, name, sizeof(target->dev_name));
 	target->dev_name[sizeof(target->dev_name) - 1] = '\0';
 
-	sockfd = hikp_net_creat_sock();
+	dev = hikp_net_dev_find_name(name);
+	if (dev == NULL && g_net_dev_cache.valid && !g_net_dev_cache.miss_refilled) {
+		/* may have appeared after the pass, a netlink drop allows the next retry */
+		g_net_dev_cache.valid = false;
+		g_net_dev_cache.miss_refilled = true;
+		dev = hikp_net_dev_find_name(name);
+	}
+	if (dev != NULL) {
+		if (!dev->has_bdf || !dev->is_hns3) {
+			HIKP_ERROR_PRINT("device name error or unsupported.\n");
+			return -EINVAL;
+		}
+		target->bdf = dev->bdf;
+		return 0;
+	}
+
+	sockfd = hikp_net_ctrl_sock();
 	if (sockfd < 0)
 		return sockfd;
 
 	if (!check_dev_name_and_get_bdf(sockfd, target)) {
 		HIKP_ERROR_PRINT("device name error or unsupported.\n");
-		close(sockfd);
 		return -EINVAL;
 	}
-	close(sockfd);
 
 	return 0;
 }
@@ -216,14 +467,11 @@ bool is_dev_valid_and_special(int sockfd, struct tool_target *target)
 	return true;
 }
 
-int get_revision_id_by_bdf(const struct bdf_t *bdf, char *revision_id, size_t id_len)
+static int hikp_net_read_revision_id(const struct bdf_t *bdf, char *revision_id, size_t id_len)
 {
 	char revision_dir[MAX_BUS_PCI_DIR_LEN] = { 0 };
 	int ret;
 
-	if (id_len < MAX_PCI_ID_LEN + 1)
-		return -EINVAL;
-
 	ret = snprintf(revision_dir, sizeof(revision_dir), "%s%04x:%02x:%02x.%u%s",
 		       HIKP_BUS_PCI_DEV_DIR, bdf->domain, bdf->bus_id, bdf->dev_id,
 		       bdf->fun_id, HIKP_PCI_REVISION_DIR);
@@ -238,6 +486,22 @@ int get_revision_id_by_bdf(const struct bdf_t *bdf, char *revision_id, size_t id
 	return 0;
 }
 
+int get_revision_id_by_bdf(const struct bdf_t *bdf, char *revision_id, size_t id_len)
+{
+	const struct hikp_net_dev *dev;
+
+	if (id_len < MAX_PCI_ID_LEN + 1)
+		return -EINVAL;
+
+	dev = hikp_net_dev_find_bdf(bdf);
+	if (dev != NULL && dev->revision_id[0] != '\0') {
+		(void)snprintf(revision_id, id_len, "%s", dev->revision_id);
+		return 0;
+	}
+
+	return hikp_net_read_revision_id(bdf, revision_id, id_len);
+}
+
 static int hikp_get_dir_name_of_device(const char *path, size_t len, char *dir_name)
 {
 	char file_path[PATH_MAX] = { 0 }; /* PATH_MAX includes the \0 so +1 is not required */
@@ -276,6 +540,7 @@ static int hikp_get_dir_name_of_device(const char *path, size_t len, char *dir_n
 int get_dev_name_by_bdf(const struct bdf_t *bdf, char *dev_name, size_t name_len)
 {
 	char dev_name_dir[MAX_BUS_PCI_DIR_LEN] = { 0 };
+	const struct hikp_net_dev *dev;
 	int ret;
 
 	if (!dev_name || !bdf || name_len < IFNAMSIZ)
@@ -285,6 +550,12 @@ int get_dev_name_by_bdf(const struct bdf_t *bdf, char *dev_name, size_t name_len
 	if (dev_name[0] != 0)
 		return 0;
 
+	dev = hikp_net_dev_find_bdf(bdf);
+	if (dev != NULL) {
+		(void)snprintf(dev_name, name_len, "%s", dev->name);
+		return 0;
+	}
+
 	ret = snprintf(dev_name_dir, sizeof(dev_name_dir), "%s%04x:%02x:%02x.%u%s",
 		       HIKP_BUS_PCI_DEV_DIR, bdf->domain, bdf->bus_id, bdf->dev_id,
 		       bdf->fun_id, HIKP_NET_PATH);
@@ -326,11 +597,23 @@ int get_vf_dev_info_by_pf_dev_name(const char *pf_dev_name,
 int get_pf_dev_info_by_vf_dev_name(const char *vf_dev_name, struct tool_target *pf_target)
 {
 	char dev_name_dir[MAX_BUS_PCI_DIR_LEN] = { 0 };
+	const struct hikp_net_dev *pf_dev = NULL;
+	const struct hikp_net_dev *dev;
 	int ret;
 
 	if (!vf_dev_name || !pf_target)
 		return -EINVAL;
 
+	dev = hikp_net_dev_find_name(vf_dev_name);
+	if (dev != NULL && dev->is_vf)
+		pf_dev = hikp_net_dev_find_bdf(&dev->pf_bdf);
+	if (pf_dev != NULL && pf_dev->is_hns3) {
+		(void)snprintf(pf_target->dev_name, sizeof(pf_target->dev_name), "%s",
+			       pf_dev->name);
+		pf_target->bdf = pf_dev->bdf;
+		return 0;
+	}
+
 	ret = snprintf(dev_name_dir, sizeof(dev_name_dir), "%s%s%s", HIKP_NET_DEV_PATH,
 		       vf_dev_name, HIKP_PHYSFN_PATH);
 	if (ret < 0 || ret >= MAX_BUS_PCI_DIR_LEN) {
@@ -348,15 +631,28 @@ int get_pf_dev_info_by_vf_dev_name(const char *vf_dev_name, struct tool_target *
 }
 
 int get_numvfs_by_bdf(const struct bdf_t *bdf, uint8_t *numvfs)
+{
+	const struct hikp_net_dev *dev;
+
+	if (!bdf || !numvfs)
+		return -EINVAL;
+
+	dev = hikp_net_dev_find_bdf(bdf);
+	if (dev != NULL && dev->has_numvfs) {
+		*numvfs = dev->numvfs;
+		return 0;
+	}
+
+	return hikp_net_read_numvfs(bdf, numvfs);
+}
+
+static int hikp_net_read_numvfs(const struct bdf_t *bdf, uint8_t *numvfs)
 {
 #define MAX_STR_LEN_OF_NUMVFS 8
 	char numvfs_dir[MAX_BUS_PCI_DIR_LEN] = { 0 };
 	char numvf[MAX_STR_LEN_OF_NUMVFS] = { 0 };
 	int ret;
 
-	if (!bdf || !numvfs)
-		return -EINVAL;
-
 	ret = snprintf(numvfs_dir, sizeof(numvfs_dir), "%s%04x:%02x:%02x.%u%s",
 		       HIKP_BUS_PCI_DEV_DIR, bdf->domain, bdf->bus_id, bdf->dev_id,
 		       bdf->fun_id, HIKP_SRIOV_NUMVFS_PATH);
@@ -397,3 +693,35 @@ void hikp_ether_format_addr(char *buf, uint16_t size, const uint8_t *mac_addr, u
 	if (len < 0 || len >= size)
 		HIKP_WARN_PRINT("fail to get ether format addr.\n");
 }
+
+/*
+ * Parse mac_len hex bytes like "xx:xx:xx:xx:xx:xx", '-' is accepted as
+ * separator as well. Also used for the 16 byte GUIDs of unic.
+ */
+int hikp_ether_parse_addr(const char *str, uint8_t *mac_addr, uint8_t mac_len)
+{
+	unsigned long val;
+	char *end = NULL;
+	uint8_t i;
+
+	if (str == NULL || mac_addr == NULL || mac_len == 0)
+		return -EINVAL;
+
+	for (i = 0; i < mac_len; i++) {
+		if (!isxdigit((unsigned char)*str))
+			return -EINVAL;
+
+		val = strtoul(str, &end, 16); /* 16: hex */
+		if (end - str > 2 || val > UINT8_MAX) /* 2: at most two digits per byte */
+			return -EINVAL;
+		mac_addr[i] = (uint8_t)val;
+
+		if (i + 1 == mac_len)
+			return *end == '\0' ? 0 : -EINVAL;
+		if (*end != ':' && *end != '-')
+			return -EINVAL;
+		str = end + 1;
+	}
+
+	return 0;
+}
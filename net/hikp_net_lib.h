@@ -67,6 +67,38 @@ struct tool_target {
 
 #define MIN_SOCKFD 3
 
+#define HIKP_NET_DEV_CACHE_INIT_NUM 64
+#define HIKP_NET_PHYSFN_LINK "/device/physfn"
+#define HIKP_NET_WATCH_BUF_LEN 4096
+
+/* One netdev as seen by the resolver cache. */
+struct hikp_net_dev {
+	char name[IFNAMSIZ];
+	struct bdf_t bdf;
+	struct bdf_t pf_bdf; /* VF only */
+	bool has_bdf; /* bus_info is a PCI address */
+	bool is_hns3;
+	bool is_vf;
+	bool has_numvfs; /* SR-IOV capable PF */
+	uint8_t numvfs;
+	char revision_id[MAX_PCI_ID_LEN + 1]; /* empty if unreadable */
+};
+
+/*
+ * Process wide name/BDF resolver, filled by one pass over /sys/class/net on
+ * first use. Long-lived users call hikp_net_dev_cache_watch(), then any
+ * RTM_NEWLINK/RTM_DELLINK drops the cache and the next lookup refills it.
+ * A name lookup miss refills it once more until the next drop.
+ */
+struct hikp_net_dev_cache {
+	bool valid;
+	bool miss_refilled;
+	uint32_t num;
+	uint32_t max_num; /* dev entries allocated, doubled as needed */
+	int watch_fd;
+	struct hikp_net_dev *dev;
+};
+
 enum nic_cmd_type {
 	GET_CHIP_INFO_CMD = 0x1,
 	GET_FW_LOG_INFO_CMD,
@@ -139,6 +171,9 @@ enum nic_get_ncsi_entry_sub_cmd {
 #define HIKP_NIC_ETH_ADDR_FMT_SIZE  18
 
 int hikp_net_creat_sock(void);
+int hikp_net_ctrl_sock(void);
+int hikp_net_dev_cache_watch(void);
+void hikp_net_lib_uninit(void);
 int tool_check_and_get_valid_bdf_id(const char *name, struct tool_target *target);
 bool is_dev_valid_and_special(int sockfd, struct tool_target *target);
 int get_revision_id_by_bdf(const struct bdf_t *bdf, char *revision_id, size_t id_len);
@@ -148,5 +183,6 @@ int get_vf_dev_info_by_pf_dev_name(const char *pf_dev_name,
 				   struct tool_target *vf_target, uint8_t vf_id);
 int get_pf_dev_info_by_vf_dev_name(const char *vf_dev_name, struct tool_target *pf_target);
 void hikp_ether_format_addr(char *buf, uint16_t size, const uint8_t *mac_addr, uint8_t mac_len);
+int hikp_ether_parse_addr(const char *str, uint8_t *mac_addr, uint8_t mac_len);
 
 #endif /* HIKP_NET_LIB_H */
@@ -422,6 +422,10 @@ static void dfx_help_info(const struct major_cmd_ctrl *self)
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0~7");
 	printf("    %s\n", "	[-m/--module SSU/IGU_EGU/PPP/NCSI/BIOS/RCB/TXDMA/MASTER] :"
 	       "this is necessary param\n");
+	printf("    %s, %-25s %s\n", "-s", "--save=<file>",
+	       "save the raw registers of the module to a snapshot file");
+	printf("    %s, %-25s %s\n", "-d", "--diff=<file>",
+	       "only show registers changed since the snapshot, with delta and rate");
 }
 
 static int hikp_cmd_dfx_help(struct major_cmd_ctrl *self, const char *argv)
@@ -555,33 +559,51 @@ static int cmd_dfx_module_select(struct major_cmd_ctrl *self, const char *argv)
 	return -EINVAL;
 }
 
-static const struct dfx_reg_name *hikp_nic_get_ssu_list(uint8_t type_id, uint32_t reg_num)
+static uint32_t g_dfx_ssu_name_next[HIKP_ARRAY_SIZE(g_dfx_ssu_name_parse)];
+static struct dfx_type_name_index g_dfx_ssu_name_idx = {
+	.table = g_dfx_ssu_name_parse,
+	.table_size = HIKP_ARRAY_SIZE(g_dfx_ssu_name_parse),
+	.next = g_dfx_ssu_name_next,
+};
+
+static uint32_t g_dfx_ppp_name_next[HIKP_ARRAY_SIZE(g_dfx_ppp_name_parse)];
+static struct dfx_type_name_index g_dfx_ppp_name_idx = {
+	.table = g_dfx_ppp_name_parse,
+	.table_size = HIKP_ARRAY_SIZE(g_dfx_ppp_name_parse),
+	.next = g_dfx_ppp_name_next,
+};
+
+/* position + 1 of each type_id in g_dfx_type_parse, 0 if the type is unknown */
+static uint8_t g_dfx_type_idx[DFX_TYPE_ID_NUM];
+static bool g_dfx_type_idx_built;
+
+static void hikp_nic_dfx_build_name_index(struct dfx_type_name_index *idx)
 {
-	uint32_t i;
+	uint32_t i, pos;
 
-	for (i = 0; i < HIKP_ARRAY_SIZE(g_dfx_ssu_name_parse); i++) {
-		if (g_dfx_ssu_name_parse[i].type_id != type_id)
-			continue;
-		if (reg_num != g_dfx_ssu_name_parse[i].reg_num)
-			continue;
+	if (idx->built)
+		return;
 
-		return g_dfx_ssu_name_parse[i].reg_list;
+	/* Insert backwards so that each chain keeps the table order. */
+	for (i = idx->table_size; i > 0; i--) {
+		pos = i - 1;
+		idx->next[pos] = idx->head[idx->table[pos].type_id];
+		idx->head[idx->table[pos].type_id] = i;
 	}
-	return NULL;
+	idx->built = true;
 }
 
-static const struct dfx_reg_name *hikp_nic_get_ppp_list(uint8_t type_id, uint32_t reg_num)
+static const struct dfx_reg_name *hikp_nic_dfx_lookup_name(struct dfx_type_name_index *idx,
+							   uint8_t type_id, uint32_t reg_num)
 {
-	uint32_t i;
-
-	for (i = 0; i < HIKP_ARRAY_SIZE(g_dfx_ppp_name_parse); i++) {
-		if (g_dfx_ppp_name_parse[i].type_id != type_id)
-			continue;
-		if (reg_num != g_dfx_ppp_name_parse[i].reg_num)
-			continue;
+	uint32_t pos;
 
-		return g_dfx_ppp_name_parse[i].reg_list;
+	hikp_nic_dfx_build_name_index(idx);
+	for (pos = idx->head[type_id]; pos != 0; pos = idx->next[pos - 1]) {
+		if (idx->table[pos - 1].reg_num == reg_num)
+			return idx->table[pos - 1].reg_list;
 	}
+
 	return NULL;
 }
 
@@ -590,9 +612,9 @@ static const struct dfx_reg_name *hikp_nic_dfx_get_reg_list(uint8_t type_id,
 							    uint32_t reg_num)
 {
 	if (sub_cmd_code == SSU_DFX_REG_DUMP)
-		return hikp_nic_get_ssu_list(type_id, reg_num);
+		return hikp_nic_dfx_lookup_name(&g_dfx_ssu_name_idx, type_id, reg_num);
 	else if (sub_cmd_code == PPP_DFX_REG_DUMP)
-		return hikp_nic_get_ppp_list(type_id, reg_num);
+		return hikp_nic_dfx_lookup_name(&g_dfx_ppp_name_idx, type_id, reg_num);
 	return NULL;
 }
 
@@ -648,29 +670,32 @@ static void hikp_nic_dfx_print_b64(struct nic_dfx_type_head *type_head, uint32_t
 	}
 }
 
-static bool is_type_found(uint16_t type_id, uint32_t *index)
+static const struct dfx_type_parse *hikp_nic_dfx_get_type(uint8_t type_id)
 {
 	size_t arr_size = HIKP_ARRAY_SIZE(g_dfx_type_parse);
 	size_t i;
 
-	for (i = 0; i < arr_size; i++) {
-		if (g_dfx_type_parse[i].type_id == type_id) {
-			*index = i;
-			return true;
-		}
+	if (!g_dfx_type_idx_built) {
+		for (i = arr_size; i > 0; i--)
+			g_dfx_type_idx[g_dfx_type_parse[i - 1].type_id] = (uint8_t)i;
+		g_dfx_type_idx_built = true;
 	}
 
-	return false;
+	if (g_dfx_type_idx[type_id] == 0)
+		return NULL;
+
+	return &g_dfx_type_parse[g_dfx_type_idx[type_id] - 1];
 }
 
 static void hikp_nic_dfx_print_type_head(uint8_t type_id, uint8_t *last_type_id)
 {
-	uint32_t index = 0;
+	const struct dfx_type_parse *type;
 
 	if (type_id != *last_type_id) {
 		printf("-----------------------------------------------------\n");
-		if (is_type_found(type_id, &index))
-			printf("type name: %s\n\n", g_dfx_type_parse[index].type_name);
+		type = hikp_nic_dfx_get_type(type_id);
+		if (type != NULL)
+			printf("type name: %s\n\n", type->type_name);
 		else
 			HIKP_WARN_PRINT("type name: unknown type, type id is %u\n\n", type_id);
 
@@ -678,29 +703,44 @@ static void hikp_nic_dfx_print_type_head(uint8_t type_id, uint8_t *last_type_id)
 	}
 }
 
-static void hikp_nic_dfx_print(const struct nic_dfx_rsp_head_t *rsp_head, uint32_t *reg_data)
+static int hikp_nic_dfx_check_size(uint8_t total_type_num, const uint32_t *reg_data,
+				   uint32_t max_size)
 {
-	struct nic_dfx_type_head *type_head;
-	uint8_t last_type_id = 0;
-	uint32_t *ptr = reg_data;
-	uint32_t max_size;
+	const struct nic_dfx_type_head *type_head;
+	const uint32_t *ptr = reg_data;
 	uint32_t num_u32;
-	bool show_title;
 	uint8_t i;
 
-	max_size = dfx_get_max_reg_bffer_size(rsp_head);
-	for (i = 0; i < rsp_head->total_type_num; i++) {
-		type_head = (struct nic_dfx_type_head *)ptr;
+	for (i = 0; i < total_type_num; i++) {
+		if (max_size < sizeof(uint32_t)) {
+			HIKP_ERROR_PRINT("register real size exceeds the max size\n");
+			return -EINVAL;
+		}
+		type_head = (const struct nic_dfx_type_head *)ptr;
 		num_u32 = type_head->reg_num * WORD_NUM_PER_REG + 1; /* including type_head */
 		if (max_size < num_u32 * sizeof(uint32_t)) {
 			HIKP_ERROR_PRINT("register real size exceeds the max size\n");
-			return;
+			return -EINVAL;
 		}
 		ptr += num_u32;
 		max_size -= num_u32 * sizeof(uint32_t);
 	}
 
-	ptr = reg_data;
+	return 0;
+}
+
+static void hikp_nic_dfx_print(const struct nic_dfx_rsp_head_t *rsp_head, uint32_t *reg_data)
+{
+	struct nic_dfx_type_head *type_head;
+	uint8_t last_type_id = 0;
+	uint32_t *ptr = reg_data;
+	bool show_title;
+	uint8_t i;
+
+	if (hikp_nic_dfx_check_size(rsp_head->total_type_num, reg_data,
+				    dfx_get_max_reg_bffer_size(rsp_head)) != 0)
+		return;
+
 	printf("****************** module %s reg dump start ********************\n",
 		g_dfx_module_parse[g_dfx_param.module_idx].module_name);
 	for (i = 0; i < rsp_head->total_type_num; i++) {
@@ -727,6 +767,198 @@ static void hikp_nic_dfx_print(const struct nic_dfx_rsp_head_t *rsp_head, uint32
 	printf("################### ====== dump end ====== ######################\n");
 }
 
+static int hikp_nic_dfx_snap_key_check(const void *saved_key, const void *key)
+{
+	const struct nic_dfx_snap_key *saved = saved_key;
+	const struct nic_dfx_snap_key *cur = key;
+
+	if (saved->sub_cmd_code != cur->sub_cmd_code ||
+	    saved->bdf.domain != cur->bdf.domain || saved->bdf.bdf_id != cur->bdf.bdf_id) {
+		HIKP_ERROR_PRINT("%s was saved for another device or module.\n",
+				 g_dfx_param.snap_file);
+		return -EINVAL;
+	}
+
+	return TOOL_SNAP_KEY_MATCH;
+}
+
+static void hikp_nic_dfx_snap_init(struct tool_snap *snap, struct nic_dfx_snap_key *key,
+				   uint8_t total_type_num, uint32_t version)
+{
+	key->sub_cmd_code = g_dfx_param.sub_cmd_code;
+	key->dfx_version = version;
+	key->bdf = g_dfx_param.target.bdf;
+	key->total_type_num = total_type_num;
+
+	snap->file = g_dfx_param.snap_file;
+	snap->name = "nic_dfx";
+	snap->type = NIC_DFX_SNAP_MAGIC;
+	snap->version = NIC_DFX_SNAP_VER;
+	snap->key = key;
+	snap->key_len = sizeof(*key);
+	snap->max_data_len = NIC_DFX_SNAP_MAX_DATA_LEN;
+	snap->key_check = hikp_nic_dfx_snap_key_check;
+}
+
+static int hikp_nic_dfx_snap_save(const struct nic_dfx_rsp_head_t *rsp_head,
+				  const uint32_t *reg_data, uint32_t data_len, uint32_t version)
+{
+	struct nic_dfx_snap_key key = {0};
+	struct tool_snap snap = {0};
+	int ret;
+
+	hikp_nic_dfx_snap_init(&snap, &key, rsp_head->total_type_num, version);
+	ret = tool_snap_save(&snap, reg_data, data_len, false);
+	if (ret == 0)
+		printf("module %s dfx snapshot saved to %s.\n",
+		       g_dfx_module_parse[g_dfx_param.module_idx].module_name,
+		       g_dfx_param.snap_file);
+
+	return ret;
+}
+
+static int hikp_nic_dfx_snap_load(struct nic_dfx_snap_key *saved, struct tool_snap_head *head,
+				  uint32_t **reg_data)
+{
+	struct nic_dfx_snap_key key = {0};
+	struct tool_snap snap = {0};
+	void *data = NULL;
+	int ret;
+
+	hikp_nic_dfx_snap_init(&snap, &key, 0, 0);
+	ret = tool_snap_load(&snap, head, saved, &data);
+	if (ret != 0)
+		return ret;
+
+	ret = hikp_nic_dfx_check_size(saved->total_type_num, data, head->data_len);
+	if (ret != 0) {
+		free(data);
+		return ret;
+	}
+	*reg_data = data;
+
+	return 0;
+}
+
+static uint64_t hikp_nic_dfx_get_reg(const uint32_t *reg, uint8_t bit_width, uint16_t *offset)
+{
+	*offset = (uint16_t)HI_GET_BITFIELD(reg[0], 0, DFX_REG_ADDR_MASK);
+	if (bit_width == WIDTH_32_BIT)
+		return reg[1];
+
+	return (uint64_t)reg[1] | (HI_GET_BITFIELD((uint64_t)reg[0], DFX_REG_VALUE_OFF,
+				   DFX_REG_VALUE_MASK) << BIT_NUM_OF_WORD);
+}
+
+static bool hikp_nic_dfx_is_status_type(uint8_t type_id)
+{
+	return type_id >= TYPE_32_ERROR_STATUS && type_id <= TYPE_32_PORT_CFG_STATUS;
+}
+
+static uint32_t hikp_nic_dfx_diff_type(const struct nic_dfx_type_head *type_head,
+				       const uint32_t *old_reg, const uint32_t *new_reg,
+				       double interval)
+{
+	uint32_t num = (uint32_t)type_head->reg_num;
+	const struct dfx_reg_name *reg_list;
+	uint64_t old_val, new_val, delta;
+	uint32_t changed = 0;
+	uint16_t offset;
+	uint64_t mask;
+	uint32_t i;
+
+	mask = type_head->bit_width == WIDTH_32_BIT ? UINT32_MAX :
+	       (HI_BIT(DFX_REG_B64_VALUE_BITS) - 1);
+	reg_list = hikp_nic_dfx_get_reg_list(type_head->type_id, g_dfx_param.sub_cmd_code, num);
+	for (i = 0; i < num; i++) {
+		old_val = hikp_nic_dfx_get_reg(old_reg + i * WORD_NUM_PER_REG,
+					       type_head->bit_width, &offset);
+		new_val = hikp_nic_dfx_get_reg(new_reg + i * WORD_NUM_PER_REG,
+					       type_head->bit_width, &offset);
+		if (old_val == new_val)
+			continue;
+
+		changed++;
+		if (hikp_nic_dfx_is_status_type(type_head->type_id)) {
+			printf("%-30s\t0x%04x\t0x%" PRIx64 " -> 0x%" PRIx64 "\n",
+			       reg_list != NULL ? reg_list[i].name : "", offset, old_val, new_val);
+			continue;
+		}
+		if (tool_cnt_delta(old_val, new_val, mask, &delta) == TOOL_CNT_DOWN) {
+			printf("%-30s\t0x%04x\t-%-20" PRIu64 "\t(cleared or reset)\n",
+			       reg_list != NULL ? reg_list[i].name : "", offset, delta);
+			continue;
+		}
+		printf("%-30s\t0x%04x\t+%-20" PRIu64 "\t%.1f/s\n",
+		       reg_list != NULL ? reg_list[i].name : "", offset, delta,
+		       interval > 0 ? (double)delta / interval : 0.0);
+	}
+
+	return changed;
+}
+
+static int hikp_nic_dfx_diff(const struct nic_dfx_rsp_head_t *rsp_head,
+			     const uint32_t *reg_data, uint32_t data_len)
+{
+	const struct nic_dfx_type_head *old_head, *new_head;
+	struct nic_dfx_snap_key saved = {0};
+	struct tool_snap_head head = {0};
+	const uint32_t *old_ptr, *new_ptr;
+	uint32_t *old_data = NULL;
+	uint32_t changed = 0;
+	uint8_t last_type_id = 0;
+	double interval;
+	int ret;
+	uint8_t i;
+
+	ret = hikp_nic_dfx_snap_load(&saved, &head, &old_data);
+	if (ret != 0)
+		return ret;
+
+	ret = hikp_nic_dfx_check_size(rsp_head->total_type_num, reg_data, data_len);
+	if (ret != 0)
+		goto out;
+	if (saved.total_type_num != rsp_head->total_type_num || head.data_len != data_len) {
+		HIKP_ERROR_PRINT("register layout differs from %s, firmware changed?\n",
+				 g_dfx_param.snap_file);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	interval = tool_snap_age(&head);
+	printf("****************** module %s reg diff over %.3fs ********************\n",
+	       g_dfx_module_parse[g_dfx_param.module_idx].module_name, interval);
+
+	old_ptr = old_data;
+	new_ptr = reg_data;
+	for (i = 0; i < rsp_head->total_type_num; i++) {
+		old_head = (const struct nic_dfx_type_head *)old_ptr;
+		new_head = (const struct nic_dfx_type_head *)new_ptr;
+		if (old_head->type_id != new_head->type_id ||
+		    old_head->reg_num != new_head->reg_num ||
+		    old_head->bit_width != new_head->bit_width) {
+			HIKP_ERROR_PRINT("No.%u type differs from the snapshot.\n", i + 1u);
+			ret = -EINVAL;
+			break;
+		}
+		if (new_head->bit_width != WIDTH_32_BIT && new_head->bit_width != WIDTH_64_BIT) {
+			HIKP_ERROR_PRINT("type%u's bit width error.\n", new_head->type_id);
+			ret = -EINVAL;
+			break;
+		}
+		hikp_nic_dfx_print_type_head(new_head->type_id, &last_type_id);
+		changed += hikp_nic_dfx_diff_type(new_head, old_ptr + 1, new_ptr + 1, interval);
+		old_ptr += (uint32_t)old_head->reg_num * WORD_NUM_PER_REG + 1;
+		new_ptr += (uint32_t)new_head->reg_num * WORD_NUM_PER_REG + 1;
+	}
+	printf("%u register(s) changed.\n", changed);
+	printf("################### ====== diff end ====== ######################\n");
+
+out:
+	free(old_data);
+	return ret;
+}
+
 void hikp_nic_dfx_cmd_execute(struct major_cmd_ctrl *self)
 {
 	struct nic_dfx_rsp_head_t rsp_head = { 0 };
@@ -743,6 +975,12 @@ void hikp_nic_dfx_cmd_execute(struct major_cmd_ctrl *self)
 		dfx_help_info(self);
 		return;
 	}
+	if ((g_dfx_param.flag & SNAP_SAVE_FLAG) && (g_dfx_param.flag & SNAP_DIFF_FLAG)) {
+		self->err_no = -EINVAL;
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-s/--save and -d/--diff can not be used together.");
+		return;
+	}
 	self->err_no = hikp_nic_get_first_blk_dfx(&rsp_head, &reg_data, &max_dfx_size, &version);
 	if (self->err_no != 0) {
 		snprintf(self->err_str, sizeof(self->err_str), "get the first block dfx fail.");
@@ -764,10 +1002,44 @@ void hikp_nic_dfx_cmd_execute(struct major_cmd_ctrl *self)
 	}
 
 	printf("DFX cmd version: 0x%x\n\n", version);
-	hikp_nic_dfx_print((const struct nic_dfx_rsp_head_t *)&rsp_head, reg_data);
+	if (g_dfx_param.flag & SNAP_SAVE_FLAG) {
+		self->err_no = hikp_nic_dfx_snap_save(&rsp_head, reg_data, real_reg_size, version);
+		if (self->err_no != 0)
+			snprintf(self->err_str, sizeof(self->err_str), "save dfx snapshot fail.");
+	} else if (g_dfx_param.flag & SNAP_DIFF_FLAG) {
+		self->err_no = hikp_nic_dfx_diff(&rsp_head, reg_data, real_reg_size);
+		if (self->err_no != 0)
+			snprintf(self->err_str, sizeof(self->err_str), "diff dfx snapshot fail.");
+	} else {
+		hikp_nic_dfx_print((const struct nic_dfx_rsp_head_t *)&rsp_head, reg_data);
+	}
 	free(reg_data);
 }
 
+static int hikp_nic_dfx_snap_file(struct major_cmd_ctrl *self, const char *argv, uint8_t flag)
+{
+	if (strlen(argv) >= sizeof(g_dfx_param.snap_file)) {
+		snprintf(self->err_str, sizeof(self->err_str), "snapshot file name is too long.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	(void)snprintf(g_dfx_param.snap_file, sizeof(g_dfx_param.snap_file), "%s", argv);
+	g_dfx_param.flag |= flag;
+
+	return 0;
+}
+
+static int hikp_nic_cmd_dfx_save(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_nic_dfx_snap_file(self, argv, SNAP_SAVE_FLAG);
+}
+
+static int hikp_nic_cmd_dfx_diff(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_nic_dfx_snap_file(self, argv, SNAP_DIFF_FLAG);
+}
+
 static void cmd_nic_dfx_init(void)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
@@ -778,6 +1050,8 @@ static void cmd_nic_dfx_init(void)
 	cmd_option_register("-h", "--help", false, hikp_cmd_dfx_help);
 	cmd_option_register("-i", "--interface", true, hikp_nic_cmd_dfx_target);
 	cmd_option_register("-m", "--module", true, cmd_dfx_module_select);
+	cmd_option_register("-s", "--save", true, hikp_nic_cmd_dfx_save);
+	cmd_option_register("-d", "--diff", true, hikp_nic_cmd_dfx_diff);
 }
 
 HIKP_CMD_DECLARE("nic_dfx", "dump dfx info of hardware", cmd_nic_dfx_init);
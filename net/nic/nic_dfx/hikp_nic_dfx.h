@@ -103,14 +103,19 @@ struct nic_dfx_req_para {
 	uint8_t block_id;
 };
 
+#define NIC_DFX_SNAP_PATH_LEN 256
+
 struct nic_dfx_param {
 	struct tool_target target;
 	uint32_t sub_cmd_code;
 	uint8_t module_idx;
 	uint8_t flag;
+	char snap_file[NIC_DFX_SNAP_PATH_LEN];
 };
 
 #define MODULE_SET_FLAG 0x1
+#define SNAP_SAVE_FLAG 0x2
+#define SNAP_DIFF_FLAG 0x4
 
 #define MAX_DFX_DATA_NUM 59
 
@@ -149,6 +154,39 @@ struct dfx_type_name_parse {
 	uint32_t reg_num;
 };
 
+#define DFX_TYPE_ID_NUM 256
+
+/*
+ * type_id indexed view of a name table. One type_id may have several reg
+ * lists told apart by reg_num, they are chained through next[], which has
+ * one entry per table entry. Positions are stored plus one so that zero
+ * means none.
+ */
+struct dfx_type_name_index {
+	const struct dfx_type_name_parse *table;
+	uint32_t table_size;
+	bool built;
+	uint32_t head[DFX_TYPE_ID_NUM];
+	uint32_t *next;
+};
+
+/* 64bit registers carry a 48bit value, see the layout above. */
+#define DFX_REG_B64_VALUE_BITS 48
+
+#define NIC_DFX_SNAP_MAGIC 0x58464444 /* "DDFX" */
+#define NIC_DFX_SNAP_VER 2
+/* Maximum register data a module can return: 255 blocks of MAX_DFX_DATA_NUM words. */
+#define NIC_DFX_SNAP_MAX_DATA_LEN (UINT8_MAX * MAX_DFX_DATA_NUM * sizeof(uint32_t))
+
+/* Snapshot key of nic_dfx --save, the payload is the raw reg_data from firmware. */
+struct nic_dfx_snap_key {
+	uint32_t sub_cmd_code;
+	uint32_t dfx_version;
+	struct bdf_t bdf;
+	uint8_t total_type_num;
+	uint8_t rsv[3];
+};
+
 int hikp_nic_cmd_dfx_target(struct major_cmd_ctrl *self, const char *argv);
 void hikp_nic_dfx_cmd_execute(struct major_cmd_ctrl *self);
 void hikp_nic_dfx_set_cmd_para(int idx);
@@ -12,10 +12,12 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <inttypes.h>
+#include <arpa/inet.h>
 #include "hikp_nic_fd.h"
 
 struct key_info {
@@ -84,6 +86,8 @@ struct nic_fd_action {
 
 static struct nic_fd_param g_fd_param = {0};
 static struct nic_fd_hw_info g_fd_hw_info = {0};
+static struct nic_fd_hw_info_cache g_fd_hw_info_cache[NIC_FD_HW_INFO_CACHE_NUM];
+static uint32_t g_fd_hw_info_cache_next;
 
 static int hikp_nic_query_fd_hw_info(struct hikp_cmd_header *req_header, const struct bdf_t *bdf,
 				     uint8_t stage, void *data, size_t len);
@@ -132,7 +136,12 @@ static int hikp_nic_fd_cmd_help(struct major_cmd_ctrl *self, const char *argv)
 	       "      [-du/--dump rules -st/--stage <stage_no> -id/--index <rule_id> ]\n"
 	       "              dump all rules or one rule info of certain stage fd.\n"
 	       "      [-du/--dump counter -st/--stage <stage_no> -id/--index <counter_id> ]\n"
-	       "              dump all counters or one counter stats of certain stage fd.\n");
+	       "              dump all counters or one counter stats of certain stage fd.\n"
+	       "      [-du/--dump rules -st/--stage <stage_no> -m/--match <key>=<value>[,...] ]\n"
+	       "              dump the rules whose key accepts these values, e.g. in_dip=192.168.1.2,in_dp=80.\n"
+	       "              key is a tuple name of hw_info, unused tuples of a rule match any value.\n"
+	       "      [-du/--dump rules -st/--stage <stage_no> -r/--rate <seconds> ]\n"
+	       "              sample the counters twice and show the hit rate of every rule, busiest first.\n");
 	printf("    Note: dump all entries without '-id/--index'\n");
 
 	return 0;
@@ -356,6 +365,65 @@ static void hikp_nic_print_meta_data(uint16_t type, uint32_t val)
 	printf("\n");
 }
 
+/* Value and mask of one tuple of a rule key, false if the stage key has no such tuple. */
+static bool hikp_nic_fd_get_tuple(const struct nic_fd_rule_info *rule,
+				  const struct nic_fd_key_cfg *key_cfg, uint16_t max_key_bytes,
+				  uint16_t tuple, uint64_t *value, uint64_t *mask)
+{
+	const uint8_t *key_x = rule->tcam_data;
+	const uint8_t *key_y = rule->tcam_data + max_key_bytes;
+	uint32_t tcam_offset = 0;
+	uint16_t len;
+	uint16_t i;
+
+	if (hikp_get_bit(key_cfg->tuple_mask, tuple) != 0)
+		return false;
+
+	for (i = 0; i < tuple; i++) {
+		if (hikp_get_bit(key_cfg->tuple_mask, i) == 0)
+			tcam_offset += g_tuple_key_info[i].key_length / HIKP_BITS_PER_BYTE;
+	}
+
+	len = HIKP_DIV_ROUND_UP(g_tuple_key_info[tuple].key_length, HIKP_BITS_PER_BYTE);
+	if (tcam_offset + len > max_key_bytes)
+		return false;
+
+	*value = 0;
+	*mask = 0;
+	for (i = 0; i < len; i++) {
+		*mask |= (uint64_t)(key_x[tcam_offset + i] ^ key_y[tcam_offset + i]) <<
+			 (i * HIKP_BITS_PER_BYTE);
+		*value |= (uint64_t)key_y[tcam_offset + i] << (i * HIKP_BITS_PER_BYTE);
+	}
+
+	return true;
+}
+
+/*
+ * A rule matches when its TCAM key accepts every -m/--match value, i.e. the
+ * value equals the key on the bits the rule masks in. A tuple that the rule
+ * or the stage key doesn't use matches any value, as the hardware does.
+ */
+static bool hikp_nic_fd_rule_match(const struct nic_fd_rule_info *rule,
+				   const struct nic_fd_key_cfg *key_cfg, uint16_t max_key_bytes)
+{
+	const struct nic_fd_match *match;
+	uint64_t value;
+	uint64_t mask;
+	uint32_t i;
+
+	for (i = 0; i < g_fd_param.match_num; i++) {
+		match = &g_fd_param.match[i];
+		if (!hikp_nic_fd_get_tuple(rule, key_cfg, max_key_bytes, match->tuple,
+					   &value, &mask))
+			continue;
+		if ((match->value & mask) != (value & mask))
+			return false;
+	}
+
+	return true;
+}
+
 static void hikp_nic_fd_print_key(const struct nic_fd_rule_info *rule,
 				  const struct nic_fd_key_cfg *key_cfg, uint16_t max_key_bytes)
 {
@@ -507,6 +575,34 @@ static void hikp_nic_fd_print_ad_data(struct nic_fd_rule_info *rule)
 		       action.qid, 1u << action.queue_region_size);
 }
 
+static size_t hikp_nic_fd_get_one_rule_size(void)
+{
+	uint16_t max_key_bytes = hikp_nic_get_tcam_data_size(g_fd_hw_info.key_max_bit);
+
+	return sizeof(struct nic_fd_rule_info) +
+	       sizeof(uint8_t) * max_key_bytes * HIKP_NIC_KEY_DIR_NUM;
+}
+
+static struct nic_fd_rule_info *hikp_nic_fd_get_rule(const struct nic_fd_rules *stage_rules,
+						     uint32_t i)
+{
+	return (struct nic_fd_rule_info *)((uint8_t *)(stage_rules->rule) +
+	       i * hikp_nic_fd_get_one_rule_size());
+}
+
+static void hikp_nic_fd_print_rule(struct nic_fd_rule_info *rule,
+				   const struct nic_fd_key_cfg *key_cfg, uint16_t max_key_bytes)
+{
+	hikp_nic_fd_print_key(rule, key_cfg, max_key_bytes);
+
+	/* The meta data position is unknown if fd mode is unknown. */
+	if (g_fd_hw_info.mode <= FD_MODE_DEPTH_2K_WIDTH_200B_STAGE_2)
+		hikp_nic_fd_print_meta_data(rule);
+
+	hikp_nic_fd_print_ad_data(rule);
+	printf("\n");
+}
+
 static void hikp_nic_show_fd_rules(const void *data)
 {
 	struct nic_fd_rules *rules = ((union nic_fd_feature_info *)data)->rules;
@@ -515,35 +611,33 @@ static void hikp_nic_show_fd_rules(const void *data)
 	struct nic_fd_key_cfg *key_cfg;
 	struct nic_fd_rule_info *rule;
 	uint16_t max_key_bytes;
-	size_t one_rule_size;
+	uint32_t matched = 0;
 	uint32_t i;
 
 	key_cfg = &g_fd_hw_info.key_cfg[stage_no];
 	stage_rules = &rules[stage_no];
 
 	max_key_bytes = hikp_nic_get_tcam_data_size(g_fd_hw_info.key_max_bit);
-	one_rule_size = sizeof(struct nic_fd_rule_info) +
-			sizeof(uint8_t) * max_key_bytes * HIKP_NIC_KEY_DIR_NUM;
 
 	printf("fd stage%d rules info[rule_num=%u]:\n", g_fd_param.stage_no, stage_rules->rule_cnt);
 	for (i = 0; i < stage_rules->rule_cnt; i++) {
-		rule = (struct nic_fd_rule_info *)((uint8_t *)(stage_rules->rule) +
-		       i * one_rule_size);
+		rule = hikp_nic_fd_get_rule(stage_rules, i);
+		if (rule->valid != 0 && g_fd_param.match_num != 0 &&
+		    !hikp_nic_fd_rule_match(rule, key_cfg, max_key_bytes))
+			continue;
+
 		printf(" rule_idx: %u\n", rule->idx);
 		if (rule->valid == 0) {
 			printf("\tDriver doesn't configure the rule with this id!\n");
 			return;
 		}
 
-		hikp_nic_fd_print_key(rule, key_cfg, max_key_bytes);
-
-		/* The meta data position is unknown if fd mode is unknown. */
-		if (g_fd_hw_info.mode <= FD_MODE_DEPTH_2K_WIDTH_200B_STAGE_2)
-			hikp_nic_fd_print_meta_data(rule);
-
-		hikp_nic_fd_print_ad_data(rule);
-		printf("\n");
+		hikp_nic_fd_print_rule(rule, key_cfg, max_key_bytes);
+		matched++;
 	}
+
+	if (g_fd_param.match_num != 0)
+		printf("%u of %u rules match\n", matched, stage_rules->rule_cnt);
 }
 
 static void hikp_nic_show_fd_counter(const void *data)
@@ -755,16 +849,211 @@ static int hikp_nic_query_fd_counter(struct hikp_cmd_header *req_header, const s
 	return ret;
 }
 
+static struct nic_fd_hw_info_cache *hikp_nic_fd_hw_info_cache_find(const struct bdf_t *bdf)
+{
+	struct nic_fd_hw_info_cache *cache;
+	uint32_t i;
+
+	for (i = 0; i < NIC_FD_HW_INFO_CACHE_NUM; i++) {
+		cache = &g_fd_hw_info_cache[i];
+		if (cache->valid && cache->bdf.domain == bdf->domain &&
+		    cache->bdf.bus_id == bdf->bus_id && cache->bdf.dev_id == bdf->dev_id &&
+		    cache->bdf.fun_id == bdf->fun_id)
+			return cache;
+	}
+
+	return NULL;
+}
+
+static void hikp_nic_fd_hw_info_cache_store(const struct bdf_t *bdf,
+					    const struct nic_fd_hw_info *hw_info)
+{
+	struct nic_fd_hw_info_cache *cache;
+
+	cache = hikp_nic_fd_hw_info_cache_find(bdf);
+	if (cache == NULL) {
+		cache = &g_fd_hw_info_cache[g_fd_hw_info_cache_next];
+		g_fd_hw_info_cache_next = (g_fd_hw_info_cache_next + 1) % NIC_FD_HW_INFO_CACHE_NUM;
+	}
+
+	cache->bdf = *bdf;
+	cache->hw_info = *hw_info;
+	cache->valid = true;
+}
+
 static int hikp_nic_get_fd_hw_info(const struct bdf_t *bdf, struct nic_fd_hw_info *hw_info)
 {
 	struct hikp_cmd_header req_header = {0};
+	struct nic_fd_hw_info_cache *cache;
+	int ret;
 
 	if (!g_fd_feature_cmd[g_fd_param.feature_idx].need_query_hw_spec)
 		return 0;
 
+	/* info_collect runs hw_info, rules and counter of a port in one process */
+	cache = hikp_nic_fd_hw_info_cache_find(bdf);
+	if (cache != NULL) {
+		*hw_info = cache->hw_info;
+		return 0;
+	}
+
 	hikp_cmd_init(&req_header, NIC_MOD, GET_FD_INFO_CMD, NIC_FD_HW_INFO_DUMP);
-	return hikp_nic_query_fd_hw_info(&req_header, bdf, NIC_FD_STAGE_1, (void *)hw_info,
-					 sizeof(*hw_info));
+	ret = hikp_nic_query_fd_hw_info(&req_header, bdf, NIC_FD_STAGE_1, (void *)hw_info,
+					sizeof(*hw_info));
+	if (ret == 0)
+		hikp_nic_fd_hw_info_cache_store(bdf, hw_info);
+
+	return ret;
+}
+
+static int hikp_nic_fd_rate_cmp(const void *a, const void *b)
+{
+	const struct nic_fd_rate_entry *x = (const struct nic_fd_rate_entry *)a;
+	const struct nic_fd_rate_entry *y = (const struct nic_fd_rate_entry *)b;
+
+	if (x->delta != y->delta)
+		return x->delta < y->delta ? 1 : -1;
+
+	return x->rule->idx < y->rule->idx ? -1 : (x->rule->idx > y->rule->idx);
+}
+
+/* Counter values indexed by counter id, the firmware returns them by entry. */
+static int hikp_nic_fd_rate_sample(const struct bdf_t *bdf, uint8_t stage,
+				   struct nic_fd_counter *counter, uint64_t *value)
+{
+	uint16_t cnt_num = g_fd_hw_info.alloc.stage_counter_num[stage];
+	struct hikp_cmd_header req_header = {0};
+	struct nic_counter_entry *entry;
+	uint32_t i;
+	int ret;
+
+	hikp_cmd_init(&req_header, NIC_MOD, GET_FD_INFO_CMD, NIC_FD_COUNTER_STATS_DUMP);
+	ret = hikp_nic_query_fd_counter(&req_header, bdf, stage, counter, 0);
+	if (ret != 0)
+		return ret;
+
+	memset(value, 0, cnt_num * sizeof(*value));
+	for (i = 0; i < counter[stage].counter_size; i++) {
+		entry = &counter[stage].entry[i];
+		if (entry->idx < cnt_num)
+			value[entry->idx] = entry->value;
+	}
+
+	return 0;
+}
+
+static void hikp_nic_fd_rate_show(const struct nic_fd_rate_entry *rate, uint32_t num,
+				  const uint16_t *cnt_users, double seconds)
+{
+	uint16_t stage_no = g_fd_param.stage_no - 1;
+	const struct nic_fd_key_cfg *key_cfg = &g_fd_hw_info.key_cfg[stage_no];
+	uint16_t max_key_bytes = hikp_nic_get_tcam_data_size(g_fd_hw_info.key_max_bit);
+	uint32_t i;
+
+	printf("fd stage%d rule hit rate over %.3f s:\n", g_fd_param.stage_no, seconds);
+	printf(" rule_idx | cnt_id | cnt_users | %-20s | hits/s\n", "hits");
+	for (i = 0; i < num; i++)
+		printf(" %8u | %6u | %9u | %20" PRIu64 " | %.1f\n", rate[i].rule->idx,
+		       rate[i].cnt_id, cnt_users[rate[i].cnt_id], rate[i].delta,
+		       (double)rate[i].delta / seconds);
+
+	for (i = 0; i < num && rate[i].delta != 0; i++) {
+		printf(" rule_idx: %u\n", rate[i].rule->idx);
+		hikp_nic_fd_print_rule((struct nic_fd_rule_info *)rate[i].rule, key_cfg,
+				       max_key_bytes);
+	}
+}
+
+/*
+ * Rules carry their counter id in the action, so one rules walk plus two
+ * counter walks give the hits of every rule over the window. A counter
+ * shared by several rules is reported for each of them, see cnt_users.
+ */
+static int hikp_nic_fd_rate(const struct bdf_t *bdf, const union nic_fd_feature_info *fd_data)
+{
+	uint16_t stage_no = g_fd_param.stage_no - 1;
+	uint16_t cnt_num = g_fd_hw_info.alloc.stage_counter_num[stage_no];
+	const struct nic_fd_rules *stage_rules = &fd_data->rules[stage_no];
+	const struct nic_fd_key_cfg *key_cfg = &g_fd_hw_info.key_cfg[stage_no];
+	struct nic_fd_counter counter[NIC_FD_STAGE_NUM] = {0};
+	struct nic_fd_action action = {0};
+	struct nic_fd_rate_entry *rate = NULL;
+	uint64_t *value[2] = {NULL, NULL};
+	uint16_t *cnt_users = NULL;
+	struct nic_fd_rule_info *rule;
+	uint32_t no_cnt = 0;
+	uint32_t num = 0;
+	uint64_t start_ns;
+	uint64_t end_ns;
+	uint16_t max_key_bytes;
+	uint32_t i;
+	int ret = -ENOMEM;
+
+	if (cnt_num == 0) {
+		HIKP_ERROR_PRINT("The stage%d has no counter.\n", g_fd_param.stage_no);
+		return -EOPNOTSUPP;
+	}
+
+	counter[stage_no].entry = (struct nic_counter_entry *)calloc(cnt_num,
+								     sizeof(struct nic_counter_entry));
+	value[0] = (uint64_t *)calloc(cnt_num, sizeof(uint64_t));
+	value[1] = (uint64_t *)calloc(cnt_num, sizeof(uint64_t));
+	cnt_users = (uint16_t *)calloc(cnt_num, sizeof(uint16_t));
+	rate = (struct nic_fd_rate_entry *)calloc(stage_rules->rule_cnt + 1, sizeof(*rate));
+	if (counter[stage_no].entry == NULL || value[0] == NULL || value[1] == NULL ||
+	    cnt_users == NULL || rate == NULL) {
+		HIKP_ERROR_PRINT("Fail to alloc fd rate memory.\n");
+		goto out;
+	}
+
+	max_key_bytes = hikp_nic_get_tcam_data_size(g_fd_hw_info.key_max_bit);
+	for (i = 0; i < stage_rules->rule_cnt; i++) {
+		rule = hikp_nic_fd_get_rule(stage_rules, i);
+		if (rule->valid == 0 || !hikp_nic_fd_rule_match(rule, key_cfg, max_key_bytes))
+			continue;
+
+		hikp_nic_parse_ad_data(rule, &action);
+		if (!action.cnt_vld || action.cnt_id >= cnt_num) {
+			no_cnt++;
+			continue;
+		}
+		rate[num].rule = rule;
+		rate[num].cnt_id = action.cnt_id;
+		cnt_users[action.cnt_id]++;
+		num++;
+	}
+
+	ret = hikp_nic_fd_rate_sample(bdf, stage_no, counter, value[0]);
+	if (ret != 0)
+		goto out;
+	start_ns = tool_get_time_ns();
+	ret = cmd_sleep_until(start_ns + (uint64_t)g_fd_param.rate_interval * HIKP_NSEC_PER_SEC);
+	if (ret != 0)
+		goto out;
+	ret = hikp_nic_fd_rate_sample(bdf, stage_no, counter, value[1]);
+	if (ret != 0)
+		goto out;
+	end_ns = tool_get_time_ns();
+
+	/* a counter cleared in the window restarts from zero */
+	for (i = 0; i < num; i++)
+		rate[i].delta = value[1][rate[i].cnt_id] >= value[0][rate[i].cnt_id] ?
+				value[1][rate[i].cnt_id] - value[0][rate[i].cnt_id] :
+				value[1][rate[i].cnt_id];
+	qsort(rate, num, sizeof(*rate), hikp_nic_fd_rate_cmp);
+
+	hikp_nic_fd_rate_show(rate, num, cnt_users,
+			      (double)(end_ns - start_ns) / HIKP_NSEC_PER_SEC);
+	if (no_cnt != 0)
+		printf("%u matching rules have no counter\n", no_cnt);
+
+out:
+	free(rate);
+	free(cnt_users);
+	free(value[1]);
+	free(value[0]);
+	free(counter[stage_no].entry);
+	return ret;
 }
 
 static int hikp_nic_fd_alloc_rules_buf(struct nic_fd_rules *rules,
@@ -943,6 +1232,19 @@ static int hikp_nic_fd_check_input_param(struct major_cmd_ctrl *self,
 		return -EINVAL;
 	}
 
+	if (fd_cmd->sub_cmd_code != NIC_FD_RULES_INFO_DUMP &&
+	    (fd_param->match_num != 0 || fd_param->rate_interval != 0)) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-m/--match and -r/--rate are only supported by '-du rules'.");
+		return -EINVAL;
+	}
+
+	if (fd_param->rate_interval != 0 && fd_param->id != -1) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-r/--rate samples all rules, no need '-id/--index' parameter.");
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
@@ -998,8 +1300,20 @@ void hikp_nic_fd_cmd_execute(struct major_cmd_ctrl *self)
 		goto out;
 	}
 
+	if (fd_cmd->sub_cmd_code == NIC_FD_HW_INFO_DUMP)
+		hikp_nic_fd_hw_info_cache_store(bdf, &fd_data->hw_info);
+
 	printf("############## NIC FD: %s info ############\n", fd_cmd->feature_name);
-	fd_cmd->show(fd_data);
+	if (g_fd_param.rate_interval != 0) {
+		ret = hikp_nic_fd_rate(bdf, fd_data);
+		if (ret != 0) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "failed to sample fd rule hit rate, ret = %d.", ret);
+			self->err_no = ret;
+		}
+	} else {
+		fd_cmd->show(fd_data);
+	}
 	printf("#################### END #######################\n");
 
 out:
@@ -1090,6 +1404,117 @@ static int hikp_nic_cmd_fd_parse_stage(struct major_cmd_ctrl *self, const char *
 	return 0;
 }
 
+static int hikp_nic_fd_parse_match_value(const struct key_info *tuple_key, const char *str,
+					 uint64_t *value)
+{
+	uint8_t mac[HIKP_NIC_ETH_MAC_ADDR_LEN];
+	struct in_addr addr;
+	char *end = NULL;
+	uint8_t i;
+
+	switch (tuple_key->key_type) {
+	case OUTER_DST_MAC:
+	case OUTER_SRC_MAC:
+	case INNER_DST_MAC:
+	case INNER_SRC_MAC:
+		if (hikp_ether_parse_addr(str, mac, HIKP_NIC_ETH_MAC_ADDR_LEN) != 0)
+			return -EINVAL;
+		/* the key holds the last MAC byte first, as printed */
+		*value = 0;
+		for (i = 0; i < HIKP_NIC_ETH_MAC_ADDR_LEN; i++)
+			*value = *value << HIKP_BITS_PER_BYTE | mac[i];
+		return 0;
+	case OUTER_SRC_IP:
+	case OUTER_DST_IP:
+	case INNER_SRC_IP:
+	case INNER_DST_IP:
+		if (inet_pton(AF_INET, str, &addr) != 1)
+			return -EINVAL;
+		*value = ntohl(addr.s_addr);
+		return 0;
+	default:
+		errno = 0;
+		*value = strtoull(str, &end, 0);
+		if (errno != 0 || end == str || *end != '\0' ||
+		    (tuple_key->key_length < 64 && /* 64: width of the value */
+		     *value >> tuple_key->key_length != 0))
+			return -EINVAL;
+		return 0;
+	}
+}
+
+static int hikp_nic_fd_parse_one_match(const char *str, struct nic_fd_match *match)
+{
+	const char *eq = strchr(str, '=');
+	size_t name_len;
+	size_t i;
+
+	if (eq == NULL)
+		return -EINVAL;
+
+	name_len = (size_t)(eq - str);
+	for (i = 0; i < HIKP_ARRAY_SIZE(g_tuple_key_info); i++) {
+		if (strlen(g_tuple_key_info[i].key_name) == name_len &&
+		    strncmp(g_tuple_key_info[i].key_name, str, name_len) == 0)
+			break;
+	}
+	if (i == HIKP_ARRAY_SIZE(g_tuple_key_info))
+		return -EINVAL;
+
+	match->tuple = g_tuple_key_info[i].key_type;
+	return hikp_nic_fd_parse_match_value(&g_tuple_key_info[i], eq + 1, &match->value);
+}
+
+static int hikp_nic_cmd_fd_parse_match(struct major_cmd_ctrl *self, const char *argv)
+{
+	char *save_ptr = NULL;
+	char *str;
+	char *tok;
+
+	str = strdup(argv);
+	if (str == NULL) {
+		snprintf(self->err_str, sizeof(self->err_str), "parse -m/--match parameter failed.");
+		self->err_no = -ENOMEM;
+		return self->err_no;
+	}
+
+	for (tok = strtok_r(str, ",", &save_ptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &save_ptr)) {
+		if (g_fd_param.match_num >= NIC_FD_MAX_MATCH) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "-m/--match takes at most %u tuples.", NIC_FD_MAX_MATCH);
+			self->err_no = -EINVAL;
+			break;
+		}
+		if (hikp_nic_fd_parse_one_match(tok, &g_fd_param.match[g_fd_param.match_num])) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "invalid -m/--match tuple '%.32s', use <key>=<value>.", tok);
+			self->err_no = -EINVAL;
+			break;
+		}
+		g_fd_param.match_num++;
+	}
+	free(str);
+
+	return self->err_no;
+}
+
+static int hikp_nic_cmd_fd_parse_rate(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t interval;
+
+	self->err_no = string_toui(argv, &interval);
+	if (self->err_no != 0 || interval == 0 || interval > NIC_FD_RATE_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "rate interval should be 1~%u seconds.", NIC_FD_RATE_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	g_fd_param.rate_interval = interval;
+
+	return 0;
+}
+
 static void cmd_nic_get_fd_init(void)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
@@ -1105,6 +1530,8 @@ static void cmd_nic_get_fd_init(void)
 	cmd_option_register("-du", "--dump", true, hikp_nic_cmd_fd_feature_select);
 	cmd_option_register("-id", "--index", true, hikp_nic_cmd_fd_parse_index);
 	cmd_option_register("-st", "--stage", true, hikp_nic_cmd_fd_parse_stage);
+	cmd_option_register("-m", "--match", true, hikp_nic_cmd_fd_parse_match);
+	cmd_option_register("-r", "--rate", true, hikp_nic_cmd_fd_parse_rate);
 }
 
 HIKP_CMD_DECLARE("nic_fd", "dump fd info of nic!", cmd_nic_get_fd_init);
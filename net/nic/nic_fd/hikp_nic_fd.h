@@ -206,6 +206,16 @@ struct nic_fd_req_para {
 	uint32_t cur_entry_idx;
 };
 
+#define NIC_FD_MAX_MATCH 8
+#define NIC_FD_RATE_MAX_INTERVAL 3600 /* seconds */
+#define NIC_FD_HW_INFO_CACHE_NUM 8
+
+/* One -m/--match tuple, the value is in the byte order of the decoded key. */
+struct nic_fd_match {
+	uint16_t tuple; /* enum nic_fd_tuple */
+	uint64_t value;
+};
+
 struct nic_fd_param {
 	struct tool_target target;
 	int feature_idx;
@@ -213,6 +223,23 @@ struct nic_fd_param {
 	int id;
 	int stage_no;
 	bool query_single_entry;
+	/* rules whose key accepts all of these tuple values */
+	struct nic_fd_match match[NIC_FD_MAX_MATCH];
+	uint32_t match_num;
+	uint32_t rate_interval; /* seconds, 0 means rate mode is off */
+};
+
+/* hw_info is fixed once the driver is up, so one query per BDF is enough. */
+struct nic_fd_hw_info_cache {
+	bool valid;
+	struct bdf_t bdf;
+	struct nic_fd_hw_info hw_info;
+};
+
+struct nic_fd_rate_entry {
+	const struct nic_fd_rule_info *rule;
+	uint16_t cnt_id;
+	uint64_t delta;
 };
 
 #define HIKP_FD_MAX_FEATURE_NAME_LEN   20
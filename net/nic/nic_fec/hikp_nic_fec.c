@@ -16,11 +16,14 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <inttypes.h>
+#include <ifaddrs.h>
 #include "hikp_nic_fec.h"
 
-static struct tool_target g_fec_target;
+static struct nic_fec_param g_fec_param;
 
-static int hikp_nic_fec_err_query(const struct bdf_t *bdf, struct nic_fec_err_info *info)
+static int hikp_nic_fec_cmd_help(struct major_cmd_ctrl *self, const char *argv);
+
+int hikp_nic_fec_err_query(const struct bdf_t *bdf, struct nic_fec_err_info *info)
 {
 	struct hikp_cmd_header header = { 0 };
 	struct nic_fec_req_para req = { 0 };
@@ -108,12 +111,314 @@ static void hikp_nic_fec_err_show(const struct nic_fec_err_info *info)
 	printf("#################### END #######################\n");
 }
 
+static int64_t hikp_nic_fec_get_speed(const char *dev_name)
+{
+	char path[MAX_BUS_PCI_DIR_LEN];
+	char buf[MAX_PCI_ID_LEN * 2] = {0};
+	FILE *fp;
+
+	if (dev_name[0] == '\0')
+		return -1;
+
+	(void)snprintf(path, sizeof(path), "%s%s/speed", HIKP_NET_DEV_PATH, dev_name);
+	fp = fopen(path, "r");
+	if (fp == NULL)
+		return -1;
+	/* reading speed fails with EINVAL while the link is down */
+	if (fgets(buf, sizeof(buf), fp) == NULL) {
+		fclose(fp);
+		return -1;
+	}
+	fclose(fp);
+
+	return strtoll(buf, NULL, 10);
+}
+
+static bool hikp_nic_fec_port_exist(const struct nic_fec_port *ports, uint32_t port_num,
+				    const struct bdf_t *bdf)
+{
+	uint32_t i;
+
+	for (i = 0; i < port_num; i++) {
+		if (ports[i].target.bdf.domain == bdf->domain &&
+		    ports[i].target.bdf.bdf_id == bdf->bdf_id)
+			return true;
+	}
+
+	return false;
+}
+
+/* Collect every hns3 PF once, the monitor loop only queries these. */
+static int hikp_nic_fec_get_all_ports(struct nic_fec_port *ports, uint32_t *port_num)
+{
+	struct tool_target target;
+	struct ifaddrs *ifa_node;
+	struct ifaddrs *ifa_lst;
+	int sockfd;
+	int ret;
+
+	sockfd = hikp_net_creat_sock();
+	if (sockfd < MIN_SOCKFD) {
+		HIKP_ERROR_PRINT("create sockfd failed, sockfd is %d.\n", sockfd);
+		return -EIO;
+	}
+	ret = getifaddrs(&ifa_lst);
+	if (ret < 0) {
+		HIKP_ERROR_PRINT("getifaddrs failed.\n");
+		close(sockfd);
+		return -EIO;
+	}
+
+	*port_num = 0;
+	for (ifa_node = ifa_lst; ifa_node != NULL; ifa_node = ifa_node->ifa_next) {
+		if (ifa_node->ifa_addr == NULL || ifa_node->ifa_addr->sa_family != AF_PACKET)
+			continue;
+
+		memset(&target, 0, sizeof(target));
+		strncpy(target.dev_name, ifa_node->ifa_name, sizeof(target.dev_name) - 1);
+		if (!is_dev_valid_and_special(sockfd, &target))
+			continue;
+		if (hikp_nic_fec_port_exist(ports, *port_num, &target.bdf))
+			continue;
+		if (*port_num >= NIC_FEC_MAX_PORT_NUM) {
+			HIKP_WARN_PRINT("only the first %u ports are monitored.\n",
+					NIC_FEC_MAX_PORT_NUM);
+			break;
+		}
+		ports[(*port_num)++].target = target;
+	}
+	freeifaddrs(ifa_lst);
+	close(sockfd);
+
+	return *port_num == 0 ? -ENODEV : 0;
+}
+
+/*
+ * Every corrected block or codeword holds at least one bit error, so the
+ * corrected count over the bits carried in the interval is a lower bound of
+ * the pre-FEC BER.
+ */
+static double hikp_nic_fec_ber(uint64_t corrected, int64_t speed, double interval,
+			       uint32_t lane_num)
+{
+	double bits;
+
+	if (speed <= 0 || interval <= 0 || lane_num == 0)
+		return -1;
+
+	bits = (double)speed * 1e6 * interval / lane_num;
+	return (double)corrected / bits;
+}
+
+static void hikp_nic_fec_print_ber(const char *key, double ber)
+{
+	if (ber < 0)
+		printf(" %s=-", key);
+	else
+		printf(" %s=%.3e", key, ber);
+}
+
+static uint64_t hikp_nic_fec_show_basefec_delta(const struct nic_fec_port *port,
+						const struct nic_fec_err_info *info,
+						double interval)
+{
+	uint32_t lane_num = HIKP_MIN(info->basefec.lane_num, NIC_FEC_MAX_LANES);
+	uint32_t corr[NIC_FEC_MAX_LANES] = {0};
+	uint32_t uncorr[NIC_FEC_MAX_LANES] = {0};
+	uint64_t corr_total = 0, uncorr_total = 0;
+	double ber, lane_ber_max = -1;
+	uint32_t i;
+
+	for (i = 0; i < lane_num; i++) {
+		/* 32bit hardware counters, a clear was ruled out so this is a wrap */
+		corr[i] = info->basefec.lane_corr_block_cnt[i] -
+			  port->last.basefec.lane_corr_block_cnt[i];
+		uncorr[i] = info->basefec.lane_uncorr_block_cnt[i] -
+			    port->last.basefec.lane_uncorr_block_cnt[i];
+		corr_total += corr[i];
+		uncorr_total += uncorr[i];
+		ber = hikp_nic_fec_ber(corr[i], port->speed, interval, lane_num);
+		lane_ber_max = HIKP_MAX(lane_ber_max, ber);
+	}
+
+	printf(" corr=%" PRIu64 " uncorr=%" PRIu64 " corr_rate=%.1f uncorr_rate=%.1f",
+	       corr_total, uncorr_total, (double)corr_total / interval,
+	       (double)uncorr_total / interval);
+	hikp_nic_fec_print_ber("ber", hikp_nic_fec_ber(corr_total, port->speed, interval, 1));
+	hikp_nic_fec_print_ber("lane_ber_max", lane_ber_max);
+	printf(" lane_corr=");
+	for (i = 0; i < lane_num; i++)
+		printf("%s%u", i == 0 ? "" : ",", corr[i]);
+	printf(" lane_uncorr=");
+	for (i = 0; i < lane_num; i++)
+		printf("%s%u", i == 0 ? "" : ",", uncorr[i]);
+
+	return uncorr_total;
+}
+
+static uint64_t hikp_nic_fec_show_rsfec_delta(const struct nic_fec_port *port,
+					      const struct nic_fec_err_info *info,
+					      double interval)
+{
+	uint32_t corr = info->rsfec.corr_cw_cnt - port->last.rsfec.corr_cw_cnt;
+	uint32_t uncorr = info->rsfec.uncorr_cw_cnt - port->last.rsfec.uncorr_cw_cnt;
+
+	printf(" corr=%u uncorr=%u corr_rate=%.1f uncorr_rate=%.1f", corr, uncorr,
+	       (double)corr / interval, (double)uncorr / interval);
+	hikp_nic_fec_print_ber("ber", hikp_nic_fec_ber(corr, port->speed, interval, 1));
+
+	return uncorr;
+}
+
+static bool hikp_nic_fec_cnt_down(uint32_t old_val, uint32_t new_val)
+{
+	uint64_t delta;
+
+	return tool_cnt_delta(old_val, new_val, UINT32_MAX, &delta) == TOOL_CNT_DOWN;
+}
+
+/* A link reset or a driver reload clears the counters, that is not a wrap. */
+static bool hikp_nic_fec_cnt_cleared(const struct nic_fec_err_info *last,
+				     const struct nic_fec_err_info *info)
+{
+	uint32_t lane_num = HIKP_MIN(info->basefec.lane_num, NIC_FEC_MAX_LANES);
+	uint32_t i;
+
+	if (info->fec_mode != NIC_FEC_MODE_BASEFEC)
+		return hikp_nic_fec_cnt_down(last->rsfec.corr_cw_cnt, info->rsfec.corr_cw_cnt) ||
+		       hikp_nic_fec_cnt_down(last->rsfec.uncorr_cw_cnt,
+					     info->rsfec.uncorr_cw_cnt);
+
+	for (i = 0; i < lane_num; i++) {
+		if (hikp_nic_fec_cnt_down(last->basefec.lane_corr_block_cnt[i],
+					  info->basefec.lane_corr_block_cnt[i]) ||
+		    hikp_nic_fec_cnt_down(last->basefec.lane_uncorr_block_cnt[i],
+					  info->basefec.lane_uncorr_block_cnt[i]))
+			return true;
+	}
+
+	return false;
+}
+
+static void hikp_nic_fec_monitor_port(struct nic_fec_port *port, uint64_t wall_ns,
+				      double interval)
+{
+	const struct bdf_t *bdf = &port->target.bdf;
+	struct nic_fec_err_info info = {0};
+	uint64_t uncorr = 0;
+	int ret;
+
+	printf("%" PRIu64 ".%03" PRIu64 " dev=%s bdf=%04x:%02x:%02x.%u",
+	       (uint64_t)(wall_ns / HIKP_NSEC_PER_SEC),
+	       (uint64_t)(wall_ns % HIKP_NSEC_PER_SEC / HIKP_NSEC_PER_MSEC),
+	       port->target.dev_name[0] != '\0' ? port->target.dev_name : "-",
+	       bdf->domain, bdf->bus_id, bdf->dev_id, bdf->fun_id);
+
+	ret = hikp_nic_fec_err_query(bdf, &info);
+	if (ret != 0) {
+		printf(" err=%d\n", ret);
+		port->has_last = false;
+		return;
+	}
+
+	port->speed = hikp_nic_fec_get_speed(port->target.dev_name);
+	printf(" fec=%s speed=%" PRId64, hikp_nic_fec_mode_name(info.fec_mode), port->speed);
+	/* A fec mode change or a counter clear restarts the counters, take a new baseline. */
+	if (!port->has_last || port->last.fec_mode != info.fec_mode) {
+		printf(" baseline\n");
+	} else if (hikp_nic_fec_cnt_cleared(&port->last, &info)) {
+		printf(" cleared baseline\n");
+	} else {
+		if (info.fec_mode == NIC_FEC_MODE_BASEFEC)
+			uncorr = hikp_nic_fec_show_basefec_delta(port, &info, interval);
+		else if (info.fec_mode == NIC_FEC_MODE_RSFEC ||
+			 info.fec_mode == NIC_FEC_MODE_LLRSFEC)
+			uncorr = hikp_nic_fec_show_rsfec_delta(port, &info, interval);
+		printf("%s\n", uncorr != 0 ? " ALERT=uncorrectable" : "");
+	}
+
+	port->last = info;
+	port->has_last = true;
+}
+
+static int hikp_nic_fec_monitor(void)
+{
+	uint64_t period_ns = (uint64_t)g_fec_param.interval * HIKP_NSEC_PER_SEC;
+	struct nic_fec_port *ports;
+	uint64_t now_ns, last_ns = 0;
+	uint64_t wall_ns;
+	uint32_t port_num = 0;
+	uint64_t deadline;
+	double interval;
+	uint32_t round;
+	uint32_t i;
+	int ret;
+
+	ports = (struct nic_fec_port *)calloc(NIC_FEC_MAX_PORT_NUM, sizeof(*ports));
+	if (ports == NULL)
+		return -ENOMEM;
+
+	if (g_fec_param.have_interface) {
+		ports[0].target = g_fec_param.target;
+		if (ports[0].target.dev_name[0] == '\0')
+			(void)get_dev_name_by_bdf(&ports[0].target.bdf, ports[0].target.dev_name,
+						  sizeof(ports[0].target.dev_name));
+		port_num = 1;
+	} else {
+		ret = hikp_nic_fec_get_all_ports(ports, &port_num);
+		if (ret != 0) {
+			HIKP_ERROR_PRINT("no hns3 port is found.\n");
+			free(ports);
+			return ret;
+		}
+	}
+
+	printf("# monitoring fec of %u port(s) every %us\n", port_num, g_fec_param.interval);
+	deadline = tool_get_time_ns();
+	/* Round 0 only takes the baseline, count rounds report a delta. */
+	for (round = 0; ; round++) {
+		now_ns = tool_get_time_ns();
+		interval = last_ns != 0 ? (double)(now_ns - last_ns) / HIKP_NSEC_PER_SEC : 0;
+		last_ns = now_ns;
+		wall_ns = tool_get_wall_time_ns();
+		for (i = 0; i < port_num; i++)
+			hikp_nic_fec_monitor_port(&ports[i], wall_ns, interval);
+		(void)fflush(stdout);
+
+		if (g_fec_param.count != 0 && round == g_fec_param.count)
+			break;
+		deadline += period_ns;
+		ret = cmd_sleep_until(deadline);
+		if (ret != 0)
+			break;
+	}
+
+	free(ports);
+	return ret;
+}
+
 void hikp_nic_fec_cmd_execute(struct major_cmd_ctrl *self)
 {
-	struct bdf_t *bdf = &g_fec_target.bdf;
+	struct bdf_t *bdf = &g_fec_param.target.bdf;
 	struct nic_fec_err_info info = { 0 };
 	int ret;
 
+	if (g_fec_param.interval != 0) {
+		ret = hikp_nic_fec_monitor();
+		if (ret != 0) {
+			snprintf(self->err_str, sizeof(self->err_str), "fail to monitor fec.");
+			self->err_no = ret;
+		}
+		return;
+	}
+
+	if (!g_fec_param.have_interface) {
+		hikp_nic_fec_cmd_help(self, NULL);
+		snprintf(self->err_str, sizeof(self->err_str), "please specify a device.");
+		self->err_no = -EINVAL;
+		return;
+	}
+
 	ret = hikp_nic_fec_err_query(bdf, &info);
 	if (ret != 0) {
 		snprintf(self->err_str, sizeof(self->err_str), "fail to obtain fec err info.");
@@ -134,23 +439,57 @@ static int hikp_nic_fec_cmd_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>",
 	       "device target or bdf id, e.g. eth0~7 or 0000:35:00.0");
+	printf("    %s, %-25s %s\n", "-m", "--monitor=<seconds>",
+	       "sample fec counters of the device, or of all hns3 ports without -i,");
+	printf("    %s  %-25s %s\n", "  ", "",
+	       "and print one line of deltas, rates and pre-FEC BER per port and period");
+	printf("    %s, %-25s %s\n", "-n", "--count=<num>",
+	       "number of monitor periods, default 0 means until interrupted");
 
 	return 0;
 }
 
 int hikp_nic_fec_get_target(struct major_cmd_ctrl *self, const char *argv)
 {
-	self->err_no = tool_check_and_get_valid_bdf_id(argv, &g_fec_target);
+	self->err_no = tool_check_and_get_valid_bdf_id(argv, &g_fec_param.target);
 	if (self->err_no != 0) {
 		snprintf(self->err_str, sizeof(self->err_str), "unknown device!");
 		return self->err_no;
 	}
 
-	if (g_fec_target.bdf.dev_id != 0) {
+	if (g_fec_param.target.bdf.dev_id != 0) {
 		snprintf(self->err_str, sizeof(self->err_str), "VF is not supported!");
 		self->err_no = -EINVAL;
 		return self->err_no;
 	}
+	g_fec_param.have_interface = true;
+
+	return 0;
+}
+
+static int hikp_nic_fec_get_interval(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t interval;
+
+	self->err_no = string_toui(argv, &interval);
+	if (self->err_no != 0 || interval == 0 || interval > NIC_FEC_MONITOR_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "monitor interval should be 1~%u seconds.", NIC_FEC_MONITOR_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	g_fec_param.interval = interval;
+
+	return 0;
+}
+
+static int hikp_nic_fec_get_count(struct major_cmd_ctrl *self, const char *argv)
+{
+	self->err_no = string_toui(argv, &g_fec_param.count);
+	if (self->err_no != 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "parse monitor count failed.");
+		return self->err_no;
+	}
 
 	return 0;
 }
@@ -164,6 +503,8 @@ static void cmd_nic_fec_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_nic_fec_cmd_help);
 	cmd_option_register("-i", "--interface", true, hikp_nic_fec_get_target);
+	cmd_option_register("-m", "--monitor", true, hikp_nic_fec_get_interval);
+	cmd_option_register("-n", "--count", true, hikp_nic_fec_get_count);
 }
 
 HIKP_CMD_DECLARE("nic_fec", "dump fec info of nic!", cmd_nic_fec_init);
@@ -69,6 +69,24 @@ struct nic_fec_err_info {
 	};
 };
 
+#define NIC_FEC_MONITOR_MAX_INTERVAL	3600 /* seconds */
+#define NIC_FEC_MAX_PORT_NUM		64
+
+struct nic_fec_port {
+	struct tool_target target;
+	int64_t speed; /* Mb/s, <= 0 if unknown */
+	bool has_last;
+	struct nic_fec_err_info last;
+};
+
+struct nic_fec_param {
+	struct tool_target target;
+	bool have_interface;
+	uint32_t interval; /* monitor period in seconds, 0 means one-shot dump */
+	uint32_t count; /* monitor rounds, 0 means until interrupted */
+};
+
+int hikp_nic_fec_err_query(const struct bdf_t *bdf, struct nic_fec_err_info *info);
 int hikp_nic_fec_get_target(struct major_cmd_ctrl *self, const char *argv);
 void hikp_nic_fec_cmd_execute(struct major_cmd_ctrl *self);
 #endif /* HIKP_NIC_FEC_H */
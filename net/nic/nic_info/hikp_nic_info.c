@@ -51,33 +51,35 @@ int hikp_nic_cmd_get_info_target(struct major_cmd_ctrl *self, const char *argv)
 	return 0;
 }
 
-static int hikp_nic_get_hw_info(struct hikp_cmd_ret **cmd_ret)
+int hikp_nic_info_query(const struct bdf_t *bdf, struct nic_info_rsp_t *info)
 {
 	struct nic_info_req_para req_data = { 0 };
 	struct hikp_cmd_header req_header = { 0 };
+	struct hikp_cmd_ret *cmd_ret;
+	int ret;
 
-	req_data.bdf = g_info_param.target.bdf;
+	req_data.bdf = *bdf;
 	hikp_cmd_init(&req_header, NIC_MOD, GET_CHIP_INFO_CMD, CHIP_INFO_DUMP);
-	*cmd_ret = hikp_cmd_alloc(&req_header, &req_data, sizeof(req_data));
+	cmd_ret = hikp_cmd_alloc(&req_header, &req_data, sizeof(req_data));
+	ret = hikp_rsp_normal_check(cmd_ret);
+	if (ret != 0) {
+		HIKP_ERROR_PRINT("Get chip info fail.\n");
+		hikp_cmd_free(&cmd_ret);
+		return ret;
+	}
+	*info = *(struct nic_info_rsp_t *)(cmd_ret->rsp_data);
+	hikp_cmd_free(&cmd_ret);
 
-	return hikp_rsp_normal_check(*cmd_ret);
+	return 0;
 }
 
 static int hikp_nic_get_curr_die_info(void)
 {
-	struct nic_info_rsp_t *info_rsp = NULL;
-	struct hikp_cmd_ret *cmd_ret = NULL;
 	int ret;
 
-	ret = hikp_nic_get_hw_info(&cmd_ret);
-	if (ret != 0) {
-		HIKP_ERROR_PRINT("Get chip info fail.\n");
-		hikp_cmd_free(&cmd_ret);
+	ret = hikp_nic_info_query(&g_info_param.target.bdf, &g_info_param.info);
+	if (ret != 0)
 		return ret;
-	}
-	info_rsp = (struct nic_info_rsp_t *)(cmd_ret->rsp_data);
-	g_info_param.info = *info_rsp;
-	hikp_cmd_free(&cmd_ret);
 
 	ret = get_revision_id_by_bdf(&g_info_param.target.bdf, g_info_param.revision_id,
 				     sizeof(g_info_param.revision_id));
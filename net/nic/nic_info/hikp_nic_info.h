@@ -77,6 +77,7 @@ enum nic_info_mac_type {
 	MAC_TYPE_MAX,
 };
 
+int hikp_nic_info_query(const struct bdf_t *bdf, struct nic_info_rsp_t *info);
 void hikp_nic_info_cmd_execute(struct major_cmd_ctrl *self);
 int hikp_nic_cmd_get_info_target(struct major_cmd_ctrl *self, const char *argv);
 #endif /* HIKP_NIC_INFO_H */
@@ -12,6 +12,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -44,6 +45,9 @@ static int hikp_nic_query_ppp_by_entryid(struct hikp_cmd_header *req_header,
 
 #define HIKP_PPP_MAX_MAC_ID_NUM	8
 
+#define NIC_PPP_MAC_INDEX_MIN_SIZE	64
+#define NIC_PPP_SNAP_MAX_REC	(1U << 20)
+
 static const struct ppp_feature_cmd g_ppp_feature_cmd[] = {
 	{NIC_PPP_MAC_TBL_NAME, NIC_MAC_TBL_DUMP,  true,
 	 hikp_nic_query_ppp_by_entryid, hikp_nic_ppp_show_mac_tbl},
@@ -61,6 +65,7 @@ void hikp_nic_ppp_set_cmd_param(int feature_idx)
 {
 	g_ppp_param.func_id = -1;
 	g_ppp_param.is_uc = -1;
+	g_ppp_param.vlan_id = -1;
 	g_ppp_param.feature_idx = feature_idx;
 }
 
@@ -78,6 +83,10 @@ static int hikp_nic_ppp_cmd_help(struct major_cmd_ctrl *self, const char *argv)
 	       "      [-du/--dump mac -func/--func_id <func_id> -uc/--unicast <1/0>]\n"
 	       "              dump MAC table info.\n"
 	       "              dump unicast/multicast MAC address for a function.\n"
+	       "      [-du/--dump mac -fd/--find <mac>[,<mac>...] [-vl/--vlan <vlan_id>]]\n"
+	       "              look up MAC entries, -vl alone lists the unicast entries of a VLAN.\n"
+	       "      [-du/--dump mac -s/--save <file>] or [-du/--dump mac -d/--diff <file>]\n"
+	       "              save the MAC table, or show entries added/removed since a save.\n"
 	       "      [-du/--dump vlan -func/--function <func_no>]\n"
 	       "              dump VLAN table info.\n"
 	       "              dump VLAN of a function.\n"
@@ -990,12 +999,373 @@ static void hikp_nic_ppp_data_free(union nic_ppp_feature_info *ppp_data)
 	ppp_data = NULL;
 }
 
+static void hikp_nic_ppp_mac_rec_build(const struct nic_mac_tbl *tbl, struct nic_ppp_mac_rec *rec)
+{
+	const struct mac_vlan_uc_entry *uc_entry;
+	const struct mac_vlan_mc_entry *mc_entry;
+	uint32_t num = 0;
+	uint32_t i;
+
+	for (i = 0; i < tbl->uc_tbl.entry_size; i++, num++) {
+		uc_entry = &tbl->uc_tbl.entry[i];
+		memcpy(rec[num].key.mac_addr, uc_entry->mac_addr, HIKP_NIC_ETH_MAC_ADDR_LEN);
+		rec[num].key.vlan_id = uc_entry->vlan_id;
+		rec[num].key.is_uc = 1;
+		rec[num].e_vport = uc_entry->e_vport;
+		rec[num].idx = uc_entry->idx;
+	}
+
+	for (i = 0; i < tbl->mc_tbl.entry_size; i++, num++) {
+		mc_entry = &tbl->mc_tbl.entry[i];
+		memcpy(rec[num].key.mac_addr, mc_entry->mac_addr, HIKP_NIC_ETH_MAC_ADDR_LEN);
+		memcpy(rec[num].func_bitmap, mc_entry->function_bitmap,
+		       sizeof(rec[num].func_bitmap));
+		rec[num].idx = mc_entry->idx;
+	}
+}
+
+static void hikp_nic_ppp_mac_index_free(struct nic_ppp_mac_index *index)
+{
+	free(index->slot);
+	index->slot = NULL;
+	free(index->rec);
+	index->rec = NULL;
+	index->rec_num = 0;
+}
+
+/* Takes over rec, which is freed with the index. */
+static int hikp_nic_ppp_mac_index_build(struct nic_ppp_mac_index *index,
+					struct nic_ppp_mac_rec *rec, uint32_t rec_num)
+{
+	uint32_t size = NIC_PPP_MAC_INDEX_MIN_SIZE;
+	uint32_t pos;
+	uint32_t i;
+
+	index->rec = rec;
+	index->rec_num = rec_num;
+	/* at most half full, so every probe run ends at an empty slot */
+	while (size < rec_num * 2)
+		size <<= 1;
+
+	index->slot = (uint32_t *)calloc(size, sizeof(uint32_t));
+	if (index->slot == NULL) {
+		HIKP_ERROR_PRINT("Fail to alloc MAC index memory.\n");
+		hikp_nic_ppp_mac_index_free(index);
+		return -ENOMEM;
+	}
+	index->mask = size - 1;
+
+	for (i = 0; i < rec_num; i++) {
+		pos = tool_fnv1a(rec[i].key.mac_addr, HIKP_NIC_ETH_MAC_ADDR_LEN) & index->mask;
+		while (index->slot[pos] != 0)
+			pos = (pos + 1) & index->mask;
+		index->slot[pos] = i + 1;
+	}
+
+	return 0;
+}
+
+static int hikp_nic_ppp_mac_index_from_tbl(struct nic_ppp_mac_index *index,
+					   const struct nic_mac_tbl *tbl)
+{
+	uint32_t rec_num = tbl->uc_tbl.entry_size + tbl->mc_tbl.entry_size;
+	struct nic_ppp_mac_rec *rec;
+
+	rec = (struct nic_ppp_mac_rec *)calloc(rec_num + 1, sizeof(struct nic_ppp_mac_rec));
+	if (rec == NULL) {
+		HIKP_ERROR_PRINT("Fail to alloc MAC record memory.\n");
+		return -ENOMEM;
+	}
+	hikp_nic_ppp_mac_rec_build(tbl, rec);
+
+	return hikp_nic_ppp_mac_index_build(index, rec, rec_num);
+}
+
+/*
+ * Walk the probe run of mac_addr from *pos, which starts at UINT32_MAX, and
+ * return the next entry of that MAC, NULL at the end of the run. With a
+ * vlan_id other than -1 only unicast entries of that VLAN match.
+ */
+static const struct nic_ppp_mac_rec *hikp_nic_ppp_mac_index_next(
+	const struct nic_ppp_mac_index *index, const uint8_t *mac_addr, int vlan_id, uint32_t *pos)
+{
+	const struct nic_ppp_mac_rec *rec;
+
+	if (*pos == UINT32_MAX)
+		*pos = tool_fnv1a(mac_addr, HIKP_NIC_ETH_MAC_ADDR_LEN) & index->mask;
+
+	while (index->slot[*pos] != 0) {
+		rec = &index->rec[index->slot[*pos] - 1];
+		*pos = (*pos + 1) & index->mask;
+		if (memcmp(rec->key.mac_addr, mac_addr, HIKP_NIC_ETH_MAC_ADDR_LEN) != 0)
+			continue;
+		if (vlan_id == -1 || (rec->key.is_uc && rec->key.vlan_id == vlan_id))
+			return rec;
+	}
+
+	return NULL;
+}
+
+static const struct nic_ppp_mac_rec *hikp_nic_ppp_mac_index_lookup(
+	const struct nic_ppp_mac_index *index, const struct nic_ppp_mac_key *key)
+{
+	const struct nic_ppp_mac_rec *rec;
+	uint32_t pos = UINT32_MAX;
+
+	while ((rec = hikp_nic_ppp_mac_index_next(index, key->mac_addr, -1, &pos)) != NULL) {
+		if (rec->key.is_uc == key->is_uc && rec->key.vlan_id == key->vlan_id)
+			return rec;
+	}
+
+	return NULL;
+}
+
+static void hikp_nic_ppp_show_mac_rec_head(void)
+{
+	printf("   type | index | mac_addr          | vlan_id | E_vPort / func bitMap[255  <--  0]\n");
+}
+
+static void hikp_nic_ppp_show_mac_rec(const char *tag, const struct nic_ppp_mac_rec *rec)
+{
+	char mac_str[HIKP_NIC_ETH_ADDR_FMT_SIZE] = {0};
+	const uint32_t *bitmap = rec->func_bitmap;
+
+	hikp_ether_format_addr(mac_str, HIKP_NIC_ETH_ADDR_FMT_SIZE, rec->key.mac_addr,
+			       HIKP_NIC_ETH_MAC_ADDR_LEN);
+	if (rec->key.is_uc) {
+		printf("%-2s uc   | %04u  | %s | %04u    | %06x\n",
+		       tag, rec->idx, mac_str, rec->key.vlan_id, rec->e_vport);
+		return;
+	}
+
+	printf("%-2s mc   | %04u  | %s | -       | %08x:%08x:%08x:%08x:%08x:%08x:%08x:%08x\n",
+	       tag, rec->idx, mac_str, bitmap[7], bitmap[6], bitmap[5], bitmap[4],
+	       bitmap[3], bitmap[2], bitmap[1], bitmap[0]);
+}
+
+static void hikp_nic_ppp_show_mac_find(const struct nic_ppp_mac_index *index,
+				       const struct nic_ppp_param *ppp_param)
+{
+	char mac_str[HIKP_NIC_ETH_ADDR_FMT_SIZE] = {0};
+	const struct nic_ppp_mac_rec *rec;
+	uint32_t match = 0;
+	uint32_t pos;
+	uint32_t i;
+
+	hikp_nic_ppp_show_mac_rec_head();
+	for (i = 0; i < ppp_param->find_num; i++) {
+		pos = UINT32_MAX;
+		match = 0;
+		while ((rec = hikp_nic_ppp_mac_index_next(index, ppp_param->find_mac[i],
+							  ppp_param->vlan_id, &pos)) != NULL) {
+			hikp_nic_ppp_show_mac_rec("", rec);
+			match++;
+		}
+		if (match == 0) {
+			hikp_ether_format_addr(mac_str, HIKP_NIC_ETH_ADDR_FMT_SIZE,
+					       ppp_param->find_mac[i], HIKP_NIC_ETH_MAC_ADDR_LEN);
+			printf("   %s is not programmed\n", mac_str);
+		}
+	}
+}
+
+/* Without a MAC there is nothing to hash, -vl alone is a plain filter. */
+static void hikp_nic_ppp_show_mac_vlan(const struct nic_ppp_mac_index *index, int vlan_id)
+{
+	uint32_t match = 0;
+	uint32_t i;
+
+	hikp_nic_ppp_show_mac_rec_head();
+	for (i = 0; i < index->rec_num; i++) {
+		if (index->rec[i].key.is_uc && index->rec[i].key.vlan_id == vlan_id) {
+			hikp_nic_ppp_show_mac_rec("", &index->rec[i]);
+			match++;
+		}
+	}
+	printf("unicast entries in VLAN %d: %u\n", vlan_id, match);
+}
+
+static int hikp_nic_ppp_snap_key_check(const void *saved_key, const void *key)
+{
+	const struct nic_ppp_snap_key *saved = saved_key;
+	const struct nic_ppp_snap_key *cur = key;
+
+	if (saved->bdf.domain != cur->bdf.domain || saved->bdf.bdf_id != cur->bdf.bdf_id) {
+		HIKP_ERROR_PRINT("%s was saved for another device.\n", g_ppp_param.snap_file);
+		return -EINVAL;
+	}
+
+	return TOOL_SNAP_KEY_MATCH;
+}
+
+static void hikp_nic_ppp_snap_init(struct tool_snap *snap, struct nic_ppp_snap_key *key,
+				   const struct nic_ppp_param *ppp_param)
+{
+	key->bdf = ppp_param->target.bdf;
+
+	snap->file = ppp_param->snap_file;
+	snap->name = "nic_ppp MAC table";
+	snap->type = NIC_PPP_SNAP_MAGIC;
+	snap->version = NIC_PPP_SNAP_VER;
+	snap->key = key;
+	snap->key_len = sizeof(*key);
+	snap->max_data_len = NIC_PPP_SNAP_MAX_REC * sizeof(struct nic_ppp_mac_rec);
+	snap->key_check = hikp_nic_ppp_snap_key_check;
+}
+
+static int hikp_nic_ppp_snap_save(const struct nic_ppp_mac_index *index,
+				  const struct nic_ppp_param *ppp_param)
+{
+	struct nic_ppp_snap_key key = {0};
+	struct tool_snap snap = {0};
+	int ret;
+
+	hikp_nic_ppp_snap_init(&snap, &key, ppp_param);
+	ret = tool_snap_save(&snap, index->rec, index->rec_num * sizeof(*index->rec), false);
+	if (ret == 0)
+		printf("saved %u MAC entries to %s\n", index->rec_num, ppp_param->snap_file);
+
+	return ret;
+}
+
+static int hikp_nic_ppp_snap_load(struct nic_ppp_mac_index *index, struct tool_snap_head *head,
+				  const struct nic_ppp_param *ppp_param)
+{
+	struct nic_ppp_snap_key saved = {0};
+	struct nic_ppp_snap_key key = {0};
+	struct tool_snap snap = {0};
+	void *rec = NULL;
+	int ret;
+
+	hikp_nic_ppp_snap_init(&snap, &key, ppp_param);
+	ret = tool_snap_load(&snap, head, &saved, &rec);
+	if (ret != 0)
+		return ret;
+
+	if (head->data_len % sizeof(struct nic_ppp_mac_rec) != 0) {
+		HIKP_ERROR_PRINT("%s is not a nic_ppp MAC table snapshot.\n", ppp_param->snap_file);
+		free(rec);
+		return -EINVAL;
+	}
+
+	return hikp_nic_ppp_mac_index_build(index, rec,
+					    head->data_len / sizeof(struct nic_ppp_mac_rec));
+}
+
+static bool hikp_nic_ppp_mac_rec_changed(const struct nic_ppp_mac_rec *old,
+					 const struct nic_ppp_mac_rec *cur)
+{
+	if (old->key.is_uc)
+		return old->e_vport != cur->e_vport;
+
+	return memcmp(old->func_bitmap, cur->func_bitmap, sizeof(old->func_bitmap)) != 0;
+}
+
+static int hikp_nic_ppp_snap_diff(const struct nic_ppp_mac_index *index,
+				  const struct nic_ppp_param *ppp_param)
+{
+	uint32_t added = 0, removed = 0, changed = 0;
+	struct nic_ppp_mac_index old_index = {0};
+	struct tool_snap_head head = {0};
+	const struct nic_ppp_mac_rec *rec;
+	uint32_t i;
+	int ret;
+
+	ret = hikp_nic_ppp_snap_load(&old_index, &head, ppp_param);
+	if (ret != 0)
+		return ret;
+
+	printf("MAC table changes since %s (%.3f s ago, %u -> %u entries):\n",
+	       ppp_param->snap_file, tool_snap_age(&head), old_index.rec_num, index->rec_num);
+	hikp_nic_ppp_show_mac_rec_head();
+	for (i = 0; i < index->rec_num; i++) {
+		rec = hikp_nic_ppp_mac_index_lookup(&old_index, &index->rec[i].key);
+		if (rec == NULL) {
+			hikp_nic_ppp_show_mac_rec("+", &index->rec[i]);
+			added++;
+		} else if (hikp_nic_ppp_mac_rec_changed(rec, &index->rec[i])) {
+			hikp_nic_ppp_show_mac_rec("-", rec);
+			hikp_nic_ppp_show_mac_rec("+", &index->rec[i]);
+			changed++;
+		}
+	}
+	for (i = 0; i < old_index.rec_num; i++) {
+		if (hikp_nic_ppp_mac_index_lookup(index, &old_index.rec[i].key) == NULL) {
+			hikp_nic_ppp_show_mac_rec("-", &old_index.rec[i]);
+			removed++;
+		}
+	}
+	printf("added %u, removed %u, changed %u\n", added, removed, changed);
+
+	hikp_nic_ppp_mac_index_free(&old_index);
+	return 0;
+}
+
+static bool hikp_nic_ppp_mac_opt_active(const struct nic_ppp_param *ppp_param)
+{
+	return ppp_param->find_num != 0 || ppp_param->vlan_id != -1 || ppp_param->snap_flag != 0;
+}
+
+/*
+ * -fd/-vl/-s/-d of the MAC table: the block walk result is indexed once,
+ * every lookup and the diff in both directions are then hash probes.
+ */
+static int hikp_nic_ppp_mac_opt_run(const struct nic_mac_tbl *tbl,
+				    const struct nic_ppp_param *ppp_param)
+{
+	struct nic_ppp_mac_index index = {0};
+	int ret;
+
+	ret = hikp_nic_ppp_mac_index_from_tbl(&index, tbl);
+	if (ret != 0)
+		return ret;
+
+	if (ppp_param->snap_flag & NIC_PPP_SNAP_DIFF_FLAG) {
+		ret = hikp_nic_ppp_snap_diff(&index, ppp_param);
+		goto out;
+	}
+
+	if (ppp_param->find_num != 0)
+		hikp_nic_ppp_show_mac_find(&index, ppp_param);
+	else if (ppp_param->vlan_id != -1)
+		hikp_nic_ppp_show_mac_vlan(&index, ppp_param->vlan_id);
+	else
+		hikp_nic_ppp_show_mac_tbl(tbl);
+
+	if (ppp_param->snap_flag & NIC_PPP_SNAP_SAVE_FLAG)
+		ret = hikp_nic_ppp_snap_save(&index, ppp_param);
+
+out:
+	hikp_nic_ppp_mac_index_free(&index);
+	return ret;
+}
+
 static int hikp_nic_ppp_check_optional_param(struct major_cmd_ctrl *self,
 					     const struct nic_ppp_param *ppp_param,
 					     const struct ppp_feature_cmd *ppp_cmd)
 {
+	if (ppp_cmd->sub_cmd_code != NIC_MAC_TBL_DUMP && hikp_nic_ppp_mac_opt_active(ppp_param)) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-fd/-vl/-s/-d are only supported by '-du mac'.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
 	switch (ppp_cmd->sub_cmd_code) {
 	case NIC_MAC_TBL_DUMP:
+		if (ppp_param->func_id != -1 && hikp_nic_ppp_mac_opt_active(ppp_param)) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "-fd/-vl/-s/-d can't be used with -func/--func_id.");
+			self->err_no = -EINVAL;
+			return self->err_no;
+		}
+		if ((ppp_param->snap_flag & NIC_PPP_SNAP_DIFF_FLAG) &&
+		    (ppp_param->find_num != 0 || ppp_param->vlan_id != -1)) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "-d/--diff can't be used with -fd/--find or -vl/--vlan.");
+			self->err_no = -EINVAL;
+			return self->err_no;
+		}
 		if ((ppp_param->func_id != -1 && ppp_param->is_uc == -1) ||
 			(ppp_param->func_id == -1 && ppp_param->is_uc != -1)) {
 			snprintf(self->err_str, sizeof(self->err_str),
@@ -1161,7 +1531,16 @@ void hikp_nic_ppp_cmd_execute(struct major_cmd_ctrl *self)
 	}
 
 	printf("############## NIC PPP: %s info ############\n", ppp_cmd->feature_name);
-	ppp_cmd->show(ppp_data);
+	if (ppp_cmd->sub_cmd_code == NIC_MAC_TBL_DUMP && hikp_nic_ppp_mac_opt_active(&g_ppp_param)) {
+		ret = hikp_nic_ppp_mac_opt_run(&ppp_data->mac_tbl, &g_ppp_param);
+		if (ret != 0) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "failed to look up or snapshot the MAC table, ret = %d.", ret);
+			self->err_no = ret;
+		}
+	} else {
+		ppp_cmd->show(ppp_data);
+	}
 	printf("#################### END #######################\n");
 
 out:
@@ -1244,12 +1623,97 @@ static int hikp_nic_cmd_ppp_parse_unicast(struct major_cmd_ctrl *self, const cha
 	return 0;
 }
 
+static int hikp_nic_cmd_ppp_parse_find(struct major_cmd_ctrl *self, const char *argv)
+{
+	char *save_ptr = NULL;
+	char *str;
+	char *tok;
+
+	str = strdup(argv);
+	if (str == NULL) {
+		snprintf(self->err_str, sizeof(self->err_str), "parse -fd/--find parameter failed.");
+		self->err_no = -ENOMEM;
+		return self->err_no;
+	}
+
+	for (tok = strtok_r(str, ",", &save_ptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &save_ptr)) {
+		if (g_ppp_param.find_num >= NIC_PPP_MAX_FIND_MAC) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "-fd/--find takes at most %u MAC addresses.", NIC_PPP_MAX_FIND_MAC);
+			self->err_no = -EINVAL;
+			break;
+		}
+		if (hikp_ether_parse_addr(tok, g_ppp_param.find_mac[g_ppp_param.find_num],
+					  HIKP_NIC_ETH_MAC_ADDR_LEN) != 0) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "please input MAC addresses like 00:18:2d:00:00:01 for -fd/--find.");
+			self->err_no = -EINVAL;
+			break;
+		}
+		g_ppp_param.find_num++;
+	}
+	free(str);
+
+	return self->err_no;
+}
+
+static int hikp_nic_cmd_ppp_parse_vlan(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t val;
+
+	self->err_no = string_toui(argv, &val);
+	if (self->err_no || val > NIC_PPP_MAX_VLAN_ID) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "please input 0~%u for -vl/--vlan parameter.", NIC_PPP_MAX_VLAN_ID);
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	g_ppp_param.vlan_id = (int)val;
+
+	return 0;
+}
+
+static int hikp_nic_cmd_ppp_snap_file(struct major_cmd_ctrl *self, const char *argv,
+				      uint8_t flag)
+{
+	if (g_ppp_param.snap_flag & ~flag) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-s/--save and -d/--diff can't be used together.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	if (strlen(argv) >= sizeof(g_ppp_param.snap_file)) {
+		snprintf(self->err_str, sizeof(self->err_str), "snapshot file name is too long.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	(void)snprintf(g_ppp_param.snap_file, sizeof(g_ppp_param.snap_file), "%s", argv);
+	g_ppp_param.snap_flag |= flag;
+
+	return 0;
+}
+
+static int hikp_nic_cmd_ppp_snap_save_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_nic_cmd_ppp_snap_file(self, argv, NIC_PPP_SNAP_SAVE_FLAG);
+}
+
+static int hikp_nic_cmd_ppp_snap_diff_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_nic_cmd_ppp_snap_file(self, argv, NIC_PPP_SNAP_DIFF_FLAG);
+}
+
 static void cmd_nic_get_ppp_init(void)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
 
 	g_ppp_param.func_id = -1;
 	g_ppp_param.is_uc = -1;
+	g_ppp_param.vlan_id = -1;
 	g_ppp_param.feature_idx = -1;
 	major_cmd->option_count = 0;
 	major_cmd->execute = hikp_nic_ppp_cmd_execute;
@@ -1259,6 +1723,10 @@ static void cmd_nic_get_ppp_init(void)
 	cmd_option_register("-du", "--dump", true, hikp_nic_cmd_ppp_feature_select);
 	cmd_option_register("-func", "--func_id", true, hikp_nic_cmd_ppp_parse_func_id);
 	cmd_option_register("-uc", "--unicast", true, hikp_nic_cmd_ppp_parse_unicast);
+	cmd_option_register("-fd", "--find", true, hikp_nic_cmd_ppp_parse_find);
+	cmd_option_register("-vl", "--vlan", true, hikp_nic_cmd_ppp_parse_vlan);
+	cmd_option_register("-s", "--save", true, hikp_nic_cmd_ppp_snap_save_set);
+	cmd_option_register("-d", "--diff", true, hikp_nic_cmd_ppp_snap_diff_set);
 }
 
 HIKP_CMD_DECLARE("nic_ppp", "dump ppp info of nic!", cmd_nic_get_ppp_init);
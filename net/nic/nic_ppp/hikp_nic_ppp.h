@@ -222,6 +222,46 @@ struct nic_ppp_req_para {
 	uint32_t cur_entry_idx; /* firmware queries MAC/VLAN/MNG table from the valuue. */
 };
 
+#define NIC_PPP_MAX_FIND_MAC 32
+#define NIC_PPP_MAX_VLAN_ID 4095
+#define NIC_PPP_SNAP_PATH_LEN 256
+#define NIC_PPP_SNAP_SAVE_FLAG 0x1
+#define NIC_PPP_SNAP_DIFF_FLAG 0x2
+#define NIC_PPP_SNAP_MAGIC 0x50505053 /* "SPPP" */
+#define NIC_PPP_SNAP_VER 2
+
+/* Lookup key of a MAC table entry, multicast entries carry no VLAN. */
+struct nic_ppp_mac_key {
+	uint8_t mac_addr[HIKP_NIC_ETH_MAC_ADDR_LEN];
+	uint16_t vlan_id;
+	uint8_t is_uc;
+	uint8_t rsv;
+};
+
+/* One MAC table entry, both as indexed and as stored in a --save file. */
+struct nic_ppp_mac_rec {
+	struct nic_ppp_mac_key key;
+	uint16_t e_vport; /* unicast only */
+	uint32_t idx;
+	uint32_t func_bitmap[HIKP_NIC_ENTRY_FUNC_BITMAP_CNT]; /* multicast only */
+};
+
+/*
+ * Open addressing over rec[], a slot holds the rec index + 1 or 0 if empty.
+ * Only the MAC is hashed, so the probe run of a MAC holds all of its VLANs.
+ */
+struct nic_ppp_mac_index {
+	struct nic_ppp_mac_rec *rec;
+	uint32_t rec_num;
+	uint32_t *slot;
+	uint32_t mask;
+};
+
+/* Snapshot key of a --save file, the payload is an array of struct nic_ppp_mac_rec. */
+struct nic_ppp_snap_key {
+	struct bdf_t bdf;
+};
+
 struct nic_ppp_param {
 	struct tool_target target;
 	int feature_idx;
@@ -234,6 +274,12 @@ struct nic_ppp_param {
 	 */
 	int func_id;
 	int is_uc; /* Must be specified when query one function entry for mac or vlan cmd. */
+	/* MAC table lookup and snapshot, -1/0 when unused */
+	uint8_t find_mac[NIC_PPP_MAX_FIND_MAC][HIKP_NIC_ETH_MAC_ADDR_LEN];
+	uint32_t find_num;
+	int vlan_id;
+	uint8_t snap_flag;
+	char snap_file[NIC_PPP_SNAP_PATH_LEN];
 };
 
 #define HIKP_PPP_MAX_FEATURE_NAME_LEN   20
@@ -13,6 +13,8 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
+#include <dirent.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -35,6 +37,7 @@ static const struct queue_feature_cmd g_queue_feature_cmd[] = {
 void hikp_nic_queue_cmd_set_param(int feature_idx, int qid, enum nic_queue_dir dir)
 {
 	g_queue_param.is_display_all = true;
+	g_queue_param.correlate = false;
 	g_queue_param.qid = qid;
 	g_queue_param.dir = dir;
 	g_queue_param.feature_idx = feature_idx;
@@ -57,6 +60,10 @@ static int hikp_nic_queue_cmd_help(struct major_cmd_ctrl *self, const char *argv
 	       "              dump Rx & Tx queue enable info\n"
 	       "      [-du/--dump intr_map -d/--dir <rx/tx> -a/--all <on/off>]\n"
 	       "              dump all Rx/Tx queue intr map.\n"
+	       "      [-du/--dump intr_map -d/--dir <rx/tx> -c/--correlate]\n"
+	       "              join the intr map with the irq, cpu affinity, numa node and\n"
+	       "              /proc/interrupts count of each vector, flag queues whose irqs\n"
+	       "              share a cpu or cross numa node.\n"
 	       "      [-du/--dump func_map]\n"
 	       "              display the queue mapping between the function and "
 	       "the global queue on the port.\n");
@@ -216,6 +223,413 @@ static void hikp_nic_queue_show_func_map(const void *data)
 	}
 }
 
+#define NIC_QUEUE_PATH_LEN	128
+#define NIC_QUEUE_NUM_STR_LEN	16
+#define NIC_QUEUE_CPU_DIR	"/sys/devices/system/cpu/cpu"
+#define NIC_QUEUE_PROC_INTR	"/proc/interrupts"
+#define NIC_QUEUE_PROC_IRQ	"/proc/irq/"
+
+static int hikp_nic_queue_irq_cmp(const void *a, const void *b)
+{
+	const struct nic_queue_irq_info *ia = (const struct nic_queue_irq_info *)a;
+	const struct nic_queue_irq_info *ib = (const struct nic_queue_irq_info *)b;
+
+	return ia->irq < ib->irq ? -1 : (ia->irq > ib->irq ? 1 : 0);
+}
+
+static int hikp_nic_queue_read_line(const char *path, char *buf, size_t len)
+{
+	FILE *fp;
+
+	fp = fopen(path, "r");
+	if (fp == NULL)
+		return -errno;
+
+	if (fgets(buf, (int)len, fp) == NULL) {
+		fclose(fp);
+		return -EIO;
+	}
+	fclose(fp);
+	buf[strcspn(buf, "\n")] = '\0';
+
+	return 0;
+}
+
+static int hikp_nic_queue_read_int(const char *path, int *val)
+{
+	char buf[NIC_QUEUE_NUM_STR_LEN];
+	char *end = NULL;
+	long num;
+	int ret;
+
+	ret = hikp_nic_queue_read_line(path, buf, sizeof(buf));
+	if (ret != 0)
+		return ret;
+
+	num = strtol(buf, &end, 10);
+	if (end == buf)
+		return -EINVAL;
+	*val = (int)num;
+
+	return 0;
+}
+
+/*
+ * The IRQs of the function are listed in msi_irqs. MSI-X vectors are allocated
+ * in table order, so once sorted, the vector id indexes this list directly.
+ */
+static int hikp_nic_queue_read_msi_irqs(struct nic_queue_irq_ctx *ctx, const struct bdf_t *bdf)
+{
+	char path[NIC_QUEUE_PATH_LEN];
+	struct dirent *entry;
+	char *end = NULL;
+	uint32_t num = 0;
+	unsigned long irq;
+	DIR *dir;
+
+	(void)snprintf(path, sizeof(path), "%s%04x:%02x:%02x.%u/numa_node", HIKP_BUS_PCI_DEV_DIR,
+		       bdf->domain, bdf->bus_id, bdf->dev_id, bdf->fun_id);
+	if (hikp_nic_queue_read_int(path, &ctx->dev_node) != 0)
+		ctx->dev_node = -1;
+
+	(void)snprintf(path, sizeof(path), "%s%04x:%02x:%02x.%u/msi_irqs", HIKP_BUS_PCI_DEV_DIR,
+		       bdf->domain, bdf->bus_id, bdf->dev_id, bdf->fun_id);
+	dir = opendir(path);
+	if (dir == NULL) {
+		HIKP_ERROR_PRINT("failed to open %s, errno = %d.\n", path, errno);
+		return -errno;
+	}
+
+	while ((entry = readdir(dir)) != NULL)
+		num++;
+	ctx->irqs = (struct nic_queue_irq_info *)calloc(num, sizeof(*ctx->irqs));
+	if (ctx->irqs == NULL) {
+		closedir(dir);
+		return -ENOMEM;
+	}
+
+	rewinddir(dir);
+	while ((entry = readdir(dir)) != NULL && ctx->irq_num < num) {
+		irq = strtoul(entry->d_name, &end, 10);
+		if (end == entry->d_name || *end != '\0')
+			continue;
+		ctx->irqs[ctx->irq_num].irq = (uint32_t)irq;
+		ctx->irqs[ctx->irq_num].cpu = -1;
+		ctx->irqs[ctx->irq_num].node = -1;
+		ctx->irq_num++;
+	}
+	closedir(dir);
+
+	if (ctx->irq_num == 0) {
+		HIKP_ERROR_PRINT("no msi irq is allocated, is the driver loaded?\n");
+		return -ENOENT;
+	}
+	qsort(ctx->irqs, ctx->irq_num, sizeof(*ctx->irqs), hikp_nic_queue_irq_cmp);
+
+	/*
+	 * sysfs does not tell which MSI-X entry an irq serves. The vectors are
+	 * allocated as one block, so entry i gets the i-th irq as long as the irq
+	 * numbers have no hole; otherwise the position says nothing.
+	 */
+	ctx->vec_mapped = ctx->irqs[ctx->irq_num - 1].irq - ctx->irqs[0].irq == ctx->irq_num - 1;
+
+	return 0;
+}
+
+/* The header line of /proc/interrupts names the cpu of each column, e.g. "CPU0 CPU2". */
+static int hikp_nic_queue_parse_intr_head(const char *line, int **cpus, uint32_t *cpu_num)
+{
+	const char *pos = line;
+	uint32_t num = 0;
+	int *ids;
+
+	while ((pos = strstr(pos, "CPU")) != NULL) {
+		num++;
+		pos += strlen("CPU");
+	}
+	if (num == 0)
+		return -EINVAL;
+
+	ids = (int *)calloc(num, sizeof(int));
+	if (ids == NULL)
+		return -ENOMEM;
+
+	num = 0;
+	pos = line;
+	while ((pos = strstr(pos, "CPU")) != NULL) {
+		pos += strlen("CPU");
+		ids[num++] = (int)strtol(pos, NULL, 10);
+	}
+	*cpus = ids;
+	*cpu_num = num;
+
+	return 0;
+}
+
+static void hikp_nic_queue_parse_intr_line(struct nic_queue_irq_ctx *ctx, const char *line,
+					   const int *cpus, uint32_t cpu_num)
+{
+	struct nic_queue_irq_info key = {0};
+	struct nic_queue_irq_info *info;
+	uint64_t cnt, max_cnt = 0;
+	const char *name;
+	char *end = NULL;
+	uint32_t col;
+
+	key.irq = (uint32_t)strtoul(line, &end, 10);
+	if (end == line || *end != ':')
+		return;
+
+	info = (struct nic_queue_irq_info *)bsearch(&key, ctx->irqs, ctx->irq_num,
+						    sizeof(*ctx->irqs), hikp_nic_queue_irq_cmp);
+	if (info == NULL)
+		return;
+
+	line = end + 1;
+	for (col = 0; col < cpu_num; col++) {
+		cnt = strtoull(line, &end, 10);
+		if (end == line)
+			break;
+		line = end;
+		info->count += cnt;
+		/* Without a single-cpu affinity the busiest cpu is where it lands. */
+		if (cnt > max_cnt) {
+			max_cnt = cnt;
+			info->cpu = cpus[col];
+		}
+	}
+
+	/* The action name, e.g. "eth0-TxRx-3", is the last field of the line. */
+	end = (char *)line + strlen(line);
+	while (end > line && (end[-1] == '\n' || end[-1] == ' '))
+		end--;
+	name = end;
+	while (name > line && name[-1] != ' ')
+		name--;
+	(void)snprintf(info->name, sizeof(info->name), "%.*s", (int)(end - name), name);
+}
+
+static int hikp_nic_queue_read_proc_intr(struct nic_queue_irq_ctx *ctx)
+{
+	uint32_t cpu_num = 0;
+	int *cpus = NULL;
+	char *line = NULL;
+	size_t len = 0;
+	uint32_t i;
+	FILE *fp;
+	int ret;
+
+	fp = fopen(NIC_QUEUE_PROC_INTR, "r");
+	if (fp == NULL) {
+		HIKP_ERROR_PRINT("failed to open %s, errno = %d.\n", NIC_QUEUE_PROC_INTR, errno);
+		return -errno;
+	}
+
+	if (getline(&line, &len, fp) < 0) {
+		ret = -EIO;
+		goto out;
+	}
+	ret = hikp_nic_queue_parse_intr_head(line, &cpus, &cpu_num);
+	if (ret != 0)
+		goto out;
+
+	ctx->cpu_max = 0;
+	for (i = 0; i < cpu_num; i++)
+		ctx->cpu_max = HIKP_MAX(ctx->cpu_max, cpus[i]);
+
+	while (getline(&line, &len, fp) >= 0)
+		hikp_nic_queue_parse_intr_line(ctx, line + strspn(line, " "), cpus, cpu_num);
+
+out:
+	free(cpus);
+	free(line);
+	fclose(fp);
+	return ret;
+}
+
+static int hikp_nic_queue_cpu_node(int cpu)
+{
+	char path[NIC_QUEUE_PATH_LEN];
+	struct dirent *entry;
+	char *end = NULL;
+	int node = -1;
+	long id;
+	DIR *dir;
+
+	(void)snprintf(path, sizeof(path), "%s%d", NIC_QUEUE_CPU_DIR, cpu);
+	dir = opendir(path);
+	if (dir == NULL)
+		return -1;
+
+	while ((entry = readdir(dir)) != NULL) {
+		if (strncmp(entry->d_name, "node", strlen("node")) != 0)
+			continue;
+		id = strtol(entry->d_name + strlen("node"), &end, 10);
+		if (end != entry->d_name + strlen("node") && *end == '\0') {
+			node = (int)id;
+			break;
+		}
+	}
+	closedir(dir);
+
+	return node;
+}
+
+static void hikp_nic_queue_read_affinity(struct nic_queue_irq_info *info)
+{
+	char path[NIC_QUEUE_PATH_LEN];
+	char *end = NULL;
+	long cpu;
+
+	/* effective_affinity_list is where the irq really goes, if the kernel has it. */
+	(void)snprintf(path, sizeof(path), "%s%u/effective_affinity_list", NIC_QUEUE_PROC_IRQ,
+		       info->irq);
+	if (hikp_nic_queue_read_line(path, info->affinity, sizeof(info->affinity)) != 0) {
+		(void)snprintf(path, sizeof(path), "%s%u/smp_affinity_list", NIC_QUEUE_PROC_IRQ,
+			       info->irq);
+		if (hikp_nic_queue_read_line(path, info->affinity, sizeof(info->affinity)) != 0)
+			(void)snprintf(info->affinity, sizeof(info->affinity), "-");
+	}
+
+	cpu = strtol(info->affinity, &end, 10);
+	if (end != info->affinity && *end == '\0')
+		info->cpu = (int)cpu;
+	if (info->cpu >= 0)
+		info->node = hikp_nic_queue_cpu_node(info->cpu);
+}
+
+static int hikp_nic_queue_irq_ctx_init(struct nic_queue_irq_ctx *ctx, const struct bdf_t *bdf)
+{
+	uint32_t i;
+	int ret;
+
+	ret = hikp_nic_queue_read_msi_irqs(ctx, bdf);
+	if (ret != 0)
+		return ret;
+
+	ret = hikp_nic_queue_read_proc_intr(ctx);
+	if (ret != 0)
+		return ret;
+
+	for (i = 0; i < ctx->irq_num; i++) {
+		hikp_nic_queue_read_affinity(&ctx->irqs[i]);
+		ctx->cpu_max = HIKP_MAX(ctx->cpu_max, ctx->irqs[i].cpu);
+	}
+
+	return 0;
+}
+
+static const struct nic_queue_irq_info *
+hikp_nic_queue_vec_to_irq(const struct nic_queue_irq_ctx *ctx, uint16_t vec_id)
+{
+	if (!ctx->vec_mapped || vec_id >= ctx->irq_num)
+		return NULL;
+
+	return &ctx->irqs[vec_id];
+}
+
+static bool hikp_nic_queue_intr_shown(const struct queue_intr_cfg *intr_cfg)
+{
+	bool intr_en = intr_cfg->tqp_intr_en && intr_cfg->rcb_intr.intr_dis == 0;
+
+	return intr_en || g_queue_param.is_display_all;
+}
+
+/*
+ * Count the distinct irqs of the shown queues on each cpu, queues sharing one
+ * vector are expected to share the cpu and are not a conflict.
+ */
+static uint16_t *hikp_nic_queue_count_cpu_irqs(const struct nic_queue_intr_map *map,
+					       const struct nic_queue_irq_ctx *ctx)
+{
+	const struct nic_queue_irq_info *info;
+	uint16_t *cpu_irqs;
+	bool *counted;
+	uint16_t qid;
+
+	cpu_irqs = (uint16_t *)calloc((size_t)ctx->cpu_max + 1, sizeof(uint16_t));
+	counted = (bool *)calloc(ctx->irq_num, sizeof(bool));
+	if (cpu_irqs == NULL || counted == NULL) {
+		free(cpu_irqs);
+		free(counted);
+		return NULL;
+	}
+
+	for (qid = 0; qid < map->tqp_num && qid < HIKP_NIC_MAX_QUEUE_NUM; qid++) {
+		if (!hikp_nic_queue_intr_shown(&map->intr_cfg[qid]))
+			continue;
+		info = hikp_nic_queue_vec_to_irq(ctx, map->intr_cfg[qid].rcb_intr.intr_vector_id);
+		if (info == NULL || info->cpu < 0 || counted[info - ctx->irqs])
+			continue;
+		counted[info - ctx->irqs] = true;
+		cpu_irqs[info->cpu]++;
+	}
+	free(counted);
+
+	return cpu_irqs;
+}
+
+static int hikp_nic_queue_show_intr_correlate(const struct nic_queue_intr_map *map)
+{
+	struct nic_queue_irq_ctx ctx = {0};
+	uint32_t shared = 0, cross = 0;
+	const struct nic_queue_irq_info *info;
+	uint16_t *cpu_irqs = NULL;
+	bool is_shared, is_cross;
+	uint16_t qid, vec_id;
+	int ret;
+
+	ret = hikp_nic_queue_irq_ctx_init(&ctx, &g_queue_param.target.bdf);
+	if (ret != 0)
+		goto out;
+
+	cpu_irqs = hikp_nic_queue_count_cpu_irqs(map, &ctx);
+	if (cpu_irqs == NULL) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	printf("%s queue intr correlation[tqp_num=%u irq_num=%u dev_numa_node=%d]:\n",
+	       g_queue_param.dir == NIC_RX_QUEUE ? "Rx" : "Tx", map->tqp_num, ctx.irq_num,
+	       ctx.dev_node);
+	if (!ctx.vec_mapped)
+		printf("  msi irqs of the device are not contiguous, vector to irq is unknown.\n");
+	printf("  %-6s%-8s%-8s%-6s%-6s%-16s%-14s%-20s%s\n", "qid", "vec_id", "irq", "cpu",
+	       "node", "affinity", "count", "name", "flags");
+	for (qid = 0; qid < map->tqp_num; qid++) {
+		if (qid >= HIKP_NIC_MAX_QUEUE_NUM) {
+			HIKP_ERROR_PRINT("The cmd data is truncated.\n");
+			break;
+		}
+		if (!hikp_nic_queue_intr_shown(&map->intr_cfg[qid]))
+			continue;
+
+		vec_id = map->intr_cfg[qid].rcb_intr.intr_vector_id;
+		info = hikp_nic_queue_vec_to_irq(&ctx, vec_id);
+		if (info == NULL) {
+			printf("  %-6u%-8u%-8s%-6s%-6s%-16s%-14s%-20s%s\n", qid, vec_id, "-", "-",
+			       "-", "-", "-", "-", "NO_IRQ");
+			continue;
+		}
+
+		is_shared = info->cpu >= 0 && cpu_irqs[info->cpu] > 1;
+		is_cross = info->node >= 0 && ctx.dev_node >= 0 && info->node != ctx.dev_node;
+		shared += is_shared ? 1 : 0;
+		cross += is_cross ? 1 : 0;
+		printf("  %-6u%-8u%-8u%-6d%-6d%-16s%-14" PRIu64 "%-20s%s%s\n", qid, vec_id,
+		       info->irq, info->cpu, info->node, info->affinity, info->count,
+		       info->name, is_shared ? "SHARED_CPU" : "",
+		       is_shared && is_cross ? " CROSS_NUMA" : (is_cross ? "CROSS_NUMA" : ""));
+	}
+	printf("  %u queue(s) share a cpu with another irq, %u queue(s) cross numa node.\n",
+	       shared, cross);
+
+out:
+	free(cpu_irqs);
+	free(ctx.irqs);
+	return ret;
+}
+
 static void hikp_nic_queue_req_para_init(struct nic_queue_req_para *req_data,
 					 const struct bdf_t *bdf,
 					 const struct nic_queue_param *queue_param)
@@ -347,6 +761,11 @@ static bool hikp_nic_queue_check_feature_para_vaild(const struct queue_feature_c
 		break;
 	}
 
+	if (g_queue_param.correlate && cmd->sub_cmd_code != QUEUE_INTR_MAP) {
+		HIKP_ERROR_PRINT("-c/--correlate is only for intr_map sub cmd.\n");
+		valid = false;
+	}
+
 	return valid;
 }
 
@@ -390,7 +809,16 @@ void hikp_nic_queue_cmd_execute(struct major_cmd_ctrl *self)
 	}
 
 	printf("############## NIC Queue: %s info ############\n", queue_cmd->feature_name);
-	queue_cmd->show(queue_data);
+	if (g_queue_param.correlate) {
+		ret = hikp_nic_queue_show_intr_correlate(&queue_data->q_intr_map);
+		if (ret != 0) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "failed to correlate intr map with irqs, ret = %d.", ret);
+			self->err_no = ret;
+		}
+	} else {
+		queue_cmd->show(queue_data);
+	}
 	printf("#################### END #######################\n");
 
 out:
@@ -462,6 +890,16 @@ static int hikp_nic_cmd_queue_get_all_switch(struct major_cmd_ctrl *self, const
 	return self->err_no;
 }
 
+static int hikp_nic_cmd_queue_correlate(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(self);
+	HIKP_SET_USED(argv);
+
+	g_queue_param.correlate = true;
+
+	return 0;
+}
+
 static int hikp_nic_cmd_queue_feature_select(struct major_cmd_ctrl *self, const char *argv)
 {
 	size_t feat_size = HIKP_ARRAY_SIZE(g_queue_feature_cmd);
@@ -490,6 +928,7 @@ static void cmd_nic_get_queue_init(void)
 	g_queue_param.qid = -1;
 	g_queue_param.dir = NIC_QUEUE_DIR_UNKNOWN;
 	g_queue_param.is_display_all = false;
+	g_queue_param.correlate = false;
 
 	major_cmd->option_count = 0;
 	major_cmd->execute = hikp_nic_queue_cmd_execute;
@@ -500,6 +939,7 @@ static void cmd_nic_get_queue_init(void)
 	cmd_option_register("-d", "--dir", true, hikp_nic_cmd_queue_select_dir);
 	cmd_option_register("-q", "--qid", true, hikp_nic_cmd_queue_get_qid);
 	cmd_option_register("-a", "--all", true, hikp_nic_cmd_queue_get_all_switch);
+	cmd_option_register("-c", "--correlate", false, hikp_nic_cmd_queue_correlate);
 }
 
 HIKP_CMD_DECLARE("nic_queue", "dump queue info of nic!", cmd_nic_get_queue_init);
@@ -144,6 +144,29 @@ struct nic_queue_param {
 	 * only display enabled and used queues.
 	 */
 	bool is_display_all;
+	/* Join intr_map with the OS view of the vectors (IRQ, affinity, counts). */
+	bool correlate;
+};
+
+#define NIC_QUEUE_IRQ_NAME_LEN		32
+#define NIC_QUEUE_IRQ_AFFINITY_LEN	64
+
+/* OS view of one MSI-X vector of the function */
+struct nic_queue_irq_info {
+	uint32_t irq;
+	int cpu;	/* cpu the irq lands on, -1 if unknown */
+	int node;	/* numa node of that cpu, -1 if unknown */
+	uint64_t count;	/* total count over all cpus from /proc/interrupts */
+	char affinity[NIC_QUEUE_IRQ_AFFINITY_LEN];
+	char name[NIC_QUEUE_IRQ_NAME_LEN];
+};
+
+struct nic_queue_irq_ctx {
+	struct nic_queue_irq_info *irqs; /* sorted by irq */
+	uint32_t irq_num;
+	bool vec_mapped; /* irqs are contiguous, so the index is the vector id */
+	int dev_node;
+	int cpu_max;
 };
 
 #define HIKP_QUEUE_FEATURE_MAX_NAME_LEN 20
@@ -30,6 +30,7 @@ static int hikp_roce_bond_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("  Options:\n\n");
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0");
+	hikp_roce_ext_snap_help();
 	printf("\n");
 
 	return 0;
@@ -72,6 +73,7 @@ static int hikp_roce_bond_get_data(struct hikp_cmd_ret **cmd_ret,
 
 void hikp_roce_bond_execute(struct major_cmd_ctrl *self)
 {
+	hikp_roce_ext_snap_target(&g_roce_bond_param.target.bdf, g_roce_bond_param.sub_cmd, 0);
 	hikp_roce_ext_execute(self, GET_ROCEE_BOND_CMD, hikp_roce_bond_get_data);
 }
 
@@ -84,6 +86,7 @@ static void cmd_roce_bond_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_roce_bond_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_bond_target);
+	hikp_roce_ext_snap_register();
 }
 
 HIKP_CMD_DECLARE("roce_bond", "get roce_bond registers information", cmd_roce_bond_init);
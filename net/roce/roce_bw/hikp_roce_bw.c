@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/if.h>
+#include <linux/sockios.h>
+#include "hikp_roce_bw.h"
+
+#define ROCE_BW_BITS_PER_GBIT 1000000000.0
+#define ROCE_BW_BYTES_PER_MIB 1048576.0
+#define ROCE_BW_CNT_BUF_LEN 32
+
+static struct roce_bw_param g_roce_bw_param = {
+	.interval_ms = ROCE_BW_DEF_INTERVAL_MS,
+};
+static struct roce_bw_eth g_roce_bw_eth = {
+	.sockfd = -1,
+};
+static struct roce_bw_hw g_roce_bw_hw;
+
+/* DON'T change the order of this array, it follows enum roce_bw_eth_stat! */
+static const char *g_roce_bw_eth_stat_name[ROCE_BW_ETH_STAT_NUM] = {
+	"mac_tx_total_oct_num",
+	"mac_rx_total_oct_num",
+	"mac_tx_total_pkt_num",
+	"mac_rx_total_pkt_num",
+	"mac_tx_good_pkt_num",
+	"mac_rx_good_pkt_num",
+	"mac_tx_bad_pkt_num",
+	"mac_rx_bad_pkt_num",
+	"mac_tx_err_all_pkt_num",
+	"mac_rx_fcs_err_pkt_num",
+};
+
+static int hikp_roce_bw_ethtool(struct roce_bw_eth *eth, const char *dev_name, void *data)
+{
+	struct ifreq ifr = { 0 };
+
+	ifr.ifr_data = (char *)data;
+	strncpy(ifr.ifr_name, dev_name, IFNAMSIZ);
+	ifr.ifr_name[IFNAMSIZ - 1] = '\0';
+	if (ioctl(eth->sockfd, SIOCETHTOOL, &ifr) < 0)
+		return -errno;
+
+	return 0;
+}
+
+/* Look the wanted stats up in the ETH_SS_STATS string set once. */
+static int hikp_roce_bw_eth_lookup(struct roce_bw_eth *eth, const char *dev_name)
+{
+	struct ethtool_gstrings *strings;
+	const char *name;
+	uint32_t i, j;
+	int ret;
+
+	strings = (struct ethtool_gstrings *)calloc(1, sizeof(*strings) +
+						    eth->n_stats * ETH_GSTRING_LEN);
+	if (strings == NULL)
+		return -ENOMEM;
+
+	strings->cmd = ETHTOOL_GSTRINGS;
+	strings->string_set = ETH_SS_STATS;
+	strings->len = eth->n_stats;
+	ret = hikp_roce_bw_ethtool(eth, dev_name, strings);
+	if (ret) {
+		HIKP_ERROR_PRINT("get stats strings of %s failed, ret = %d.\n", dev_name, ret);
+		goto out;
+	}
+
+	for (i = 0; i < ROCE_BW_ETH_STAT_NUM; i++) {
+		eth->idx[i] = -1;
+		for (j = 0; j < strings->len && j < eth->n_stats; j++) {
+			name = (const char *)&strings->data[j * ETH_GSTRING_LEN];
+			if (strncmp(name, g_roce_bw_eth_stat_name[i], ETH_GSTRING_LEN) == 0) {
+				eth->idx[i] = (int32_t)j;
+				break;
+			}
+		}
+	}
+	if (eth->idx[ROCE_BW_TX_OCT] < 0 || eth->idx[ROCE_BW_RX_OCT] < 0) {
+		HIKP_ERROR_PRINT("%s has no mac octet counters.\n", dev_name);
+		ret = -EOPNOTSUPP;
+	}
+
+out:
+	free(strings);
+	return ret;
+}
+
+static int hikp_roce_bw_eth_init(struct roce_bw_eth *eth, const char *dev_name)
+{
+	struct ethtool_drvinfo drvinfo = { 0 };
+	int ret;
+
+	eth->sockfd = hikp_net_creat_sock();
+	if (eth->sockfd < 0)
+		return eth->sockfd;
+
+	drvinfo.cmd = ETHTOOL_GDRVINFO;
+	ret = hikp_roce_bw_ethtool(eth, dev_name, &drvinfo);
+	if (ret) {
+		HIKP_ERROR_PRINT("get driver info of %s failed, ret = %d.\n", dev_name, ret);
+		return ret;
+	}
+	if (drvinfo.n_stats == 0 || drvinfo.n_stats > ROCE_BW_MAX_ETH_STATS) {
+		HIKP_ERROR_PRINT("%s reports %u stats.\n", dev_name, drvinfo.n_stats);
+		return -EINVAL;
+	}
+	eth->n_stats = drvinfo.n_stats;
+
+	ret = hikp_roce_bw_eth_lookup(eth, dev_name);
+	if (ret)
+		return ret;
+
+	eth->stats = (struct ethtool_stats *)calloc(1, sizeof(*eth->stats) +
+						    eth->n_stats * sizeof(uint64_t));
+	if (eth->stats == NULL)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static int hikp_roce_bw_eth_read(struct roce_bw_eth *eth, const char *dev_name,
+				 uint64_t *val)
+{
+	uint32_t i;
+	int ret;
+
+	eth->stats->cmd = ETHTOOL_GSTATS;
+	eth->stats->n_stats = eth->n_stats;
+	ret = hikp_roce_bw_ethtool(eth, dev_name, eth->stats);
+	if (ret) {
+		HIKP_ERROR_PRINT("get stats of %s failed, ret = %d.\n", dev_name, ret);
+		return ret;
+	}
+
+	for (i = 0; i < ROCE_BW_ETH_STAT_NUM; i++)
+		val[i] = eth->idx[i] >= 0 ? eth->stats->data[eth->idx[i]] : 0;
+
+	return 0;
+}
+
+static void hikp_roce_bw_eth_uninit(struct roce_bw_eth *eth)
+{
+	free(eth->stats);
+	eth->stats = NULL;
+	if (eth->sockfd >= 0)
+		close(eth->sockfd);
+	eth->sockfd = -1;
+}
+
+static int hikp_roce_bw_cnt_read(int fd, uint64_t *val)
+{
+	char buf[ROCE_BW_CNT_BUF_LEN] = { 0 };
+	ssize_t len;
+
+	/* sysfs regenerates the value on every read from offset 0 */
+	len = pread(fd, buf, sizeof(buf) - 1, 0);
+	if (len <= 0)
+		return -EIO;
+
+	*val = strtoull(buf, NULL, 0);
+	return 0;
+}
+
+static void hikp_roce_bw_hw_add_port(struct roce_bw_hw *hw, const char *port_name)
+{
+	char path[ROCE_BW_PATH_LEN] = { 0 };
+	struct roce_bw_hw_cnt *cnt;
+	struct dirent *ptr;
+	DIR *dir;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s%s/ports/%s/hw_counters", ROCE_BW_IB_DEV_DIR,
+		 hw->ib_name, port_name);
+	dir = opendir(path);
+	if (dir == NULL)
+		return;
+
+	while ((ptr = readdir(dir)) != NULL) {
+		if (ptr->d_name[0] == '.' || strcmp(ptr->d_name, "lifespan") == 0)
+			continue;
+		if (hw->cnt_num == ROCE_BW_MAX_HW_CNT) {
+			HIKP_WARN_PRINT("only the first %u rdma counters are sampled.\n",
+					ROCE_BW_MAX_HW_CNT);
+			break;
+		}
+		cnt = &hw->cnt[hw->cnt_num];
+		/* Skip names that do not fit, every counter name is short */
+		if (snprintf(cnt->name, sizeof(cnt->name), "%s", ptr->d_name) >=
+		    (int)sizeof(cnt->name) ||
+		    snprintf(path, sizeof(path), "%s%s/ports/%s/hw_counters/%s", ROCE_BW_IB_DEV_DIR,
+			     hw->ib_name, port_name, ptr->d_name) >= (int)sizeof(path))
+			continue;
+		fd = open(path, O_RDONLY);
+		if (fd < 0)
+			continue;
+
+		cnt->port = (uint32_t)strtoul(port_name, NULL, 0);
+		cnt->fd = fd;
+		if (hikp_roce_bw_cnt_read(fd, &cnt->last)) {
+			close(fd);
+			continue;
+		}
+		hw->cnt_num++;
+	}
+	closedir(dir);
+}
+
+/* Open every hw_counters file of the rdma device bound to the netdev once. */
+static void hikp_roce_bw_hw_init(struct roce_bw_hw *hw, const char *dev_name)
+{
+	char path[ROCE_BW_PATH_LEN] = { 0 };
+	struct dirent *ptr;
+	DIR *dir;
+
+	snprintf(path, sizeof(path), "%s%s%s", HIKP_NET_DEV_PATH, dev_name, ROCE_BW_NET_IB_DIR);
+	dir = opendir(path);
+	if (dir == NULL)
+		return;
+	while ((ptr = readdir(dir)) != NULL) {
+		if (ptr->d_name[0] == '.')
+			continue;
+		if (snprintf(hw->ib_name, sizeof(hw->ib_name), "%s", ptr->d_name) >=
+		    (int)sizeof(hw->ib_name))
+			hw->ib_name[0] = '\0';
+		break;
+	}
+	closedir(dir);
+	if (hw->ib_name[0] == '\0')
+		return;
+
+	snprintf(path, sizeof(path), "%s%s/ports", ROCE_BW_IB_DEV_DIR, hw->ib_name);
+	dir = opendir(path);
+	if (dir == NULL)
+		return;
+	while ((ptr = readdir(dir)) != NULL) {
+		if (ptr->d_name[0] != '.')
+			hikp_roce_bw_hw_add_port(hw, ptr->d_name);
+	}
+	closedir(dir);
+}
+
+static void hikp_roce_bw_hw_uninit(struct roce_bw_hw *hw)
+{
+	uint32_t i;
+
+	for (i = 0; i < hw->cnt_num; i++)
+		close(hw->cnt[i].fd);
+	hw->cnt_num = 0;
+}
+
+static void hikp_roce_bw_show_rate(const char *tx_name, uint64_t tx, const char *rx_name,
+				   uint64_t rx, double interval)
+{
+	printf("%s: %" PRIu64 " (%.0f/s), %s: %" PRIu64 " (%.0f/s)\n", tx_name, tx,
+	       (double)tx / interval, rx_name, rx, (double)rx / interval);
+}
+
+static void hikp_roce_bw_show_eth(const uint64_t *delta, double interval)
+{
+	double tx = (double)delta[ROCE_BW_TX_OCT] / interval;
+	double rx = (double)delta[ROCE_BW_RX_OCT] / interval;
+	uint32_t i;
+
+	if (g_roce_bw_param.mib)
+		printf("tx_bw: %8.2f MiB/s, rx_bw: %8.2f MiB/s\n",
+		       tx / ROCE_BW_BYTES_PER_MIB, rx / ROCE_BW_BYTES_PER_MIB);
+	else
+		printf("tx_bw: %6.2f Gb/s, rx_bw: %6.2f Gb/s\n",
+		       tx * HIKP_BITS_PER_BYTE / ROCE_BW_BITS_PER_GBIT,
+		       rx * HIKP_BITS_PER_BYTE / ROCE_BW_BITS_PER_GBIT);
+	printf("tx_pps: %.0f, rx_pps: %.0f\n", (double)delta[ROCE_BW_TX_PKT] / interval,
+	       (double)delta[ROCE_BW_RX_PKT] / interval);
+
+	if (!g_roce_bw_param.all)
+		return;
+	/* tx and rx stats come in pairs, quiet pairs are skipped */
+	for (i = ROCE_BW_TX_GOOD_PKT; i + 1 < ROCE_BW_ETH_STAT_NUM; i += 2) {
+		if (delta[i] == 0 && delta[i + 1] == 0)
+			continue;
+		hikp_roce_bw_show_rate(g_roce_bw_eth_stat_name[i], delta[i],
+				       g_roce_bw_eth_stat_name[i + 1], delta[i + 1], interval);
+	}
+}
+
+static void hikp_roce_bw_show_hw(struct roce_bw_hw *hw, double interval)
+{
+	struct roce_bw_hw_cnt *cnt;
+	uint64_t val, delta;
+	uint32_t i;
+
+	for (i = 0; i < hw->cnt_num; i++) {
+		cnt = &hw->cnt[i];
+		if (hikp_roce_bw_cnt_read(cnt->fd, &val))
+			continue;
+		if (tool_cnt_delta(cnt->last, val, UINT64_MAX, &delta) == TOOL_CNT_DOWN)
+			printf("%s/%u %s: cleared\n", hw->ib_name, cnt->port, cnt->name);
+		else if (delta != 0)
+			printf("%s/%u %s: %" PRIu64 " (%.0f/s)\n", hw->ib_name, cnt->port,
+			       cnt->name, delta, (double)delta / interval);
+		cnt->last = val;
+	}
+}
+
+static int hikp_roce_bw_sample(const char *dev_name)
+{
+	uint64_t period_ns = (uint64_t)g_roce_bw_param.interval_ms * HIKP_NSEC_PER_MSEC;
+	uint64_t val[ROCE_BW_ETH_STAT_NUM];
+	uint64_t delta[ROCE_BW_ETH_STAT_NUM];
+	uint64_t now_ns, last_ns, deadline;
+	uint64_t wall_ns;
+	double interval;
+	bool cleared;
+	uint32_t round;
+	uint32_t i;
+	int ret;
+
+	ret = hikp_roce_bw_eth_read(&g_roce_bw_eth, dev_name, g_roce_bw_eth.last);
+	if (ret)
+		return ret;
+	last_ns = tool_get_time_ns();
+	deadline = last_ns;
+
+	printf("# sampling %s every %ums, rdma device %s\n", dev_name,
+	       g_roce_bw_param.interval_ms,
+	       g_roce_bw_hw.ib_name[0] != '\0' ? g_roce_bw_hw.ib_name : "not found");
+	for (round = 1; ; round++) {
+		deadline += period_ns;
+		ret = cmd_sleep_until(deadline);
+		if (ret)
+			return ret;
+		ret = hikp_roce_bw_eth_read(&g_roce_bw_eth, dev_name, val);
+		if (ret)
+			return ret;
+		now_ns = tool_get_time_ns();
+		interval = (double)(now_ns - last_ns) / HIKP_NSEC_PER_SEC;
+		last_ns = now_ns;
+
+		/* A driver reload clears the stats, that window has no rate. */
+		cleared = false;
+		for (i = 0; i < ROCE_BW_ETH_STAT_NUM; i++) {
+			cleared = tool_cnt_delta(g_roce_bw_eth.last[i], val[i], UINT64_MAX,
+						 &delta[i]) == TOOL_CNT_DOWN || cleared;
+			g_roce_bw_eth.last[i] = val[i];
+		}
+		wall_ns = tool_get_wall_time_ns();
+		printf("%" PRIu64 ".%03" PRIu64 " %s roce %.3fs\n",
+		       (uint64_t)(wall_ns / HIKP_NSEC_PER_SEC),
+		       (uint64_t)(wall_ns % HIKP_NSEC_PER_SEC / HIKP_NSEC_PER_MSEC),
+		       dev_name, interval);
+		if (cleared)
+			printf("stats cleared, new baseline\n");
+		else
+			hikp_roce_bw_show_eth(delta, interval);
+		hikp_roce_bw_show_hw(&g_roce_bw_hw, interval);
+		printf("************************************\n");
+		(void)fflush(stdout);
+
+		if (g_roce_bw_param.count != 0 && round == g_roce_bw_param.count)
+			break;
+	}
+
+	return 0;
+}
+
+static void hikp_roce_bw_execute(struct major_cmd_ctrl *self)
+{
+	struct tool_target *target = &g_roce_bw_param.target;
+
+	if (!g_roce_bw_param.have_interface) {
+		snprintf(self->err_str, sizeof(self->err_str), "please specify a device.");
+		self->err_no = -EINVAL;
+		return;
+	}
+	if (target->dev_name[0] == '\0' &&
+	    get_dev_name_by_bdf(&target->bdf, target->dev_name, sizeof(target->dev_name))) {
+		snprintf(self->err_str, sizeof(self->err_str), "no netdev is bound to the device.");
+		self->err_no = -ENODEV;
+		return;
+	}
+
+	self->err_no = hikp_roce_bw_eth_init(&g_roce_bw_eth, target->dev_name);
+	if (self->err_no == 0) {
+		hikp_roce_bw_hw_init(&g_roce_bw_hw, target->dev_name);
+		self->err_no = hikp_roce_bw_sample(target->dev_name);
+	}
+	if (self->err_no)
+		snprintf(self->err_str, sizeof(self->err_str), "roce_bw sample %s failed.",
+			 target->dev_name);
+
+	hikp_roce_bw_hw_uninit(&g_roce_bw_hw);
+	hikp_roce_bw_eth_uninit(&g_roce_bw_eth);
+}
+
+static int hikp_roce_bw_help(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(argv);
+
+	printf("\n  Usage: %s %s\n", self->cmd_ptr->name, "-i <interface>\n");
+	printf("\n         %s\n", self->cmd_ptr->help_info);
+	printf("  Options:\n\n");
+	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
+	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0");
+	printf("    %s, %-25s %s\n", "-t", "--time=<ms>",
+	       "sample interval in milliseconds, default 1000, at least 10");
+	printf("    %s, %-25s %s\n", "-n", "--count=<num>",
+	       "number of sample intervals, default 0 means until interrupted");
+	printf("    %s, %-25s %s\n", "-m", "--report_MiB", "report bandwidth in MiB/s");
+	printf("    %s, %-25s %s\n", "-a", "--all", "add the mac good/bad packet counters");
+	printf("\n");
+
+	return 0;
+}
+
+static int hikp_roce_bw_target(struct major_cmd_ctrl *self, const char *argv)
+{
+	self->err_no = tool_check_and_get_valid_bdf_id(argv, &g_roce_bw_param.target);
+	if (self->err_no) {
+		snprintf(self->err_str, sizeof(self->err_str), "Unknown device %s.", argv);
+		return self->err_no;
+	}
+	g_roce_bw_param.have_interface = true;
+
+	return 0;
+}
+
+static int hikp_roce_bw_interval_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t interval;
+
+	self->err_no = string_toui(argv, &interval);
+	if (self->err_no != 0 || interval < ROCE_BW_MIN_INTERVAL_MS ||
+	    interval > ROCE_BW_MAX_INTERVAL_MS) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "sample interval should be %u~%u ms.", ROCE_BW_MIN_INTERVAL_MS,
+			 ROCE_BW_MAX_INTERVAL_MS);
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	g_roce_bw_param.interval_ms = interval;
+
+	return 0;
+}
+
+static int hikp_roce_bw_count_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	self->err_no = string_toui(argv, &g_roce_bw_param.count);
+	if (self->err_no != 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "parse sample count failed.");
+		return self->err_no;
+	}
+
+	return 0;
+}
+
+static int hikp_roce_bw_mib_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(self);
+	HIKP_SET_USED(argv);
+
+	g_roce_bw_param.mib = true;
+
+	return 0;
+}
+
+static int hikp_roce_bw_all_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(self);
+	HIKP_SET_USED(argv);
+
+	g_roce_bw_param.all = true;
+
+	return 0;
+}
+
+static void cmd_roce_bw_init(void)
+{
+	struct major_cmd_ctrl *major_cmd = get_major_cmd();
+
+	major_cmd->option_count = 0;
+	major_cmd->execute = hikp_roce_bw_execute;
+
+	cmd_option_register("-h", "--help", false, hikp_roce_bw_help);
+	cmd_option_register("-i", "--interface", true, hikp_roce_bw_target);
+	cmd_option_register("-t", "--time", true, hikp_roce_bw_interval_set);
+	cmd_option_register("-n", "--count", true, hikp_roce_bw_count_set);
+	cmd_option_register("-m", "--report_MiB", false, hikp_roce_bw_mib_set);
+	cmd_option_register("-a", "--all", false, hikp_roce_bw_all_set);
+}
+
+HIKP_CMD_DECLARE("roce_bw", "sample roce bandwidth and rdma hw counters", cmd_roce_bw_init);
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef HIKP_ROCE_BW_H
+#define HIKP_ROCE_BW_H
+
+#include <linux/ethtool.h>
+#include "hikp_net_lib.h"
+
+#define ROCE_BW_DEF_INTERVAL_MS 1000
+#define ROCE_BW_MIN_INTERVAL_MS 10
+#define ROCE_BW_MAX_INTERVAL_MS 3600000
+#define ROCE_BW_MAX_ETH_STATS 4096
+#define ROCE_BW_MAX_HW_CNT 128
+#define ROCE_BW_CNT_NAME_LEN 64
+#define ROCE_BW_IB_NAME_LEN 64
+#define ROCE_BW_PATH_LEN 512
+#define ROCE_BW_IB_DEV_DIR "/sys/class/infiniband/"
+#define ROCE_BW_NET_IB_DIR "/device/infiniband/"
+
+enum roce_bw_eth_stat {
+	ROCE_BW_TX_OCT,
+	ROCE_BW_RX_OCT,
+	ROCE_BW_TX_PKT,
+	ROCE_BW_RX_PKT,
+	/* the rest is only shown with -a/--all */
+	ROCE_BW_TX_GOOD_PKT,
+	ROCE_BW_RX_GOOD_PKT,
+	ROCE_BW_TX_BAD_PKT,
+	ROCE_BW_RX_BAD_PKT,
+	ROCE_BW_TX_ERR_ALL_PKT,
+	ROCE_BW_RX_FCS_ERR_PKT,
+	ROCE_BW_ETH_STAT_NUM,
+};
+
+struct roce_bw_param {
+	struct tool_target target;
+	bool have_interface;
+	uint32_t interval_ms;
+	uint32_t count; /* sample periods, 0 means until interrupted */
+	bool mib; /* MiB/s instead of Gb/s */
+	bool all;
+};
+
+/* ETHTOOL_GSTATS on one socket, the string set is looked up once */
+struct roce_bw_eth {
+	int sockfd;
+	uint32_t n_stats;
+	int32_t idx[ROCE_BW_ETH_STAT_NUM]; /* -1 if the driver has no such stat */
+	uint64_t last[ROCE_BW_ETH_STAT_NUM];
+	struct ethtool_stats *stats;
+};
+
+/* One rdma hw_counters file, kept open and re-read with pread() */
+struct roce_bw_hw_cnt {
+	char name[ROCE_BW_CNT_NAME_LEN];
+	uint32_t port;
+	int fd;
+	uint64_t last;
+};
+
+struct roce_bw_hw {
+	char ib_name[ROCE_BW_IB_NAME_LEN];
+	uint32_t cnt_num;
+	struct roce_bw_hw_cnt cnt[ROCE_BW_MAX_HW_CNT];
+};
+
+#endif /* HIKP_ROCE_BW_H */
@@ -36,6 +36,7 @@ static int hikp_roce_caep_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0");
 	printf("    %s, %-25s %s\n", "-e", "--extend", "query extend caep registers");
+	hikp_roce_ext_snap_help();
 	printf("\n");
 
 	return 0;
@@ -119,11 +120,16 @@ exec_error:
 
 void hikp_roce_caep_execute(struct major_cmd_ctrl *self)
 {
-	if (g_roce_caep_param_t.sub_cmd == CAEP_ORIGIN)
+	if (g_roce_caep_param_t.sub_cmd == CAEP_ORIGIN) {
+		if (hikp_roce_ext_snap_need_ext(self))
+			return;
 		hikp_roce_caep_execute_origin(self);
-	else
+	} else {
+		hikp_roce_ext_snap_target(&g_roce_caep_param_t.target.bdf,
+					  g_roce_caep_param_t.sub_cmd, 0);
 		hikp_roce_ext_execute(self, GET_ROCEE_CAEP_CMD,
 				      hikp_roce_caep_get_data);
+	}
 }
 
 static int hikp_roce_caep_ext_set(struct major_cmd_ctrl *self, const char *argv)
@@ -146,6 +152,7 @@ static void cmd_roce_caep_init(void)
 	cmd_option_register("-h", "--help", false, hikp_roce_caep_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_caep_target);
 	cmd_option_register("-e", "--extend", false, hikp_roce_caep_ext_set);
+	hikp_roce_ext_snap_register();
 }
 
 HIKP_CMD_DECLARE("roce_caep", "get roce_caep registers information", cmd_roce_caep_init);
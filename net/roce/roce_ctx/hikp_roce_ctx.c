@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include "hikp_roce_ctx.h"
+
+#define ROCE_CTX_ID_INIT_SIZE 1024
+
+static struct roce_ctx_param g_roce_ctx_param = {
+	.res_mask = ROCE_CTX_RES_ALL,
+};
+
+static const struct roce_ctx_res_info {
+	const char *name;
+	const char *ctx_name;
+	uint32_t get_cmd;
+	uint32_t raw_cmd;
+	uint16_t table_attr;
+	uint16_t entry_attr;
+	uint16_t id_attr;
+} g_roce_ctx_res[ROCE_CTX_RES_NUM] = {
+	[ROCE_CTX_RES_QP] = {"qp", "qpc", RDMA_NLDEV_CMD_RES_QP_GET,
+			     ROCE_CTX_NLDEV_CMD_RES_QP_GET_RAW, RDMA_NLDEV_ATTR_RES_QP,
+			     RDMA_NLDEV_ATTR_RES_QP_ENTRY, RDMA_NLDEV_ATTR_RES_LQPN},
+	[ROCE_CTX_RES_CQ] = {"cq", "cqc", RDMA_NLDEV_CMD_RES_CQ_GET,
+			     ROCE_CTX_NLDEV_CMD_RES_CQ_GET_RAW, RDMA_NLDEV_ATTR_RES_CQ,
+			     RDMA_NLDEV_ATTR_RES_CQ_ENTRY, RDMA_NLDEV_ATTR_RES_CQN},
+	[ROCE_CTX_RES_MR] = {"mr", "mpt", RDMA_NLDEV_CMD_RES_MR_GET,
+			     ROCE_CTX_NLDEV_CMD_RES_MR_GET_RAW, RDMA_NLDEV_ATTR_RES_MR,
+			     RDMA_NLDEV_ATTR_RES_MR_ENTRY, RDMA_NLDEV_ATTR_RES_MRN},
+	[ROCE_CTX_RES_SRQ] = {"srq", "srqc", RDMA_NLDEV_CMD_RES_SRQ_GET,
+			      ROCE_CTX_NLDEV_CMD_RES_SRQ_GET_RAW, RDMA_NLDEV_ATTR_RES_SRQ,
+			      RDMA_NLDEV_ATTR_RES_SRQ_ENTRY, RDMA_NLDEV_ATTR_RES_SRQN},
+};
+
+typedef int (*roce_ctx_msg_cb)(const struct nlmsghdr *nlh, void *arg);
+
+static int roce_ctx_nl_open(struct roce_ctx_nl *nl)
+{
+	struct sockaddr_nl addr = { .nl_family = AF_NETLINK };
+	int rcvbuf = ROCE_CTX_NL_RCVBUF;
+
+	nl->buf = (uint8_t *)malloc(ROCE_CTX_NL_BUF_LEN);
+	if (nl->buf == NULL)
+		return -ENOMEM;
+
+	nl->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_RDMA);
+	if (nl->fd < 0) {
+		HIKP_ERROR_PRINT("open rdma netlink socket failed, errno = %d.\n", errno);
+		return -errno;
+	}
+	/* Big dumps come in bursts, FORCE needs CAP_NET_ADMIN which raw reads need anyway */
+	if (setsockopt(nl->fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) != 0)
+		(void)setsockopt(nl->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+	if (bind(nl->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+		HIKP_ERROR_PRINT("bind rdma netlink socket failed, errno = %d.\n", errno);
+		return -errno;
+	}
+
+	return 0;
+}
+
+static void roce_ctx_nl_close(struct roce_ctx_nl *nl)
+{
+	if (nl->fd >= 0)
+		close(nl->fd);
+	nl->fd = -1;
+	free(nl->buf);
+	nl->buf = NULL;
+}
+
+static void roce_ctx_nl_put_u32(struct nlmsghdr *nlh, uint16_t type, uint32_t val)
+{
+	struct nlattr *attr = (struct nlattr *)((uint8_t *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+
+	attr->nla_type = type;
+	attr->nla_len = NLA_HDRLEN + sizeof(val);
+	memcpy((uint8_t *)attr + NLA_HDRLEN, &val, sizeof(val));
+	nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + NLA_ALIGN(attr->nla_len);
+}
+
+/* id_attr 0 sends no resource id */
+static int roce_ctx_nl_send(struct roce_ctx_nl *nl, uint32_t cmd, uint16_t flags,
+			    uint32_t dev_idx, uint16_t id_attr, uint32_t id)
+{
+	uint32_t req[ROCE_CTX_NL_REQ_LEN / sizeof(uint32_t)] = { 0 };
+	struct nlmsghdr *nlh = (struct nlmsghdr *)req;
+
+	nlh->nlmsg_len = NLMSG_LENGTH(0);
+	nlh->nlmsg_type = RDMA_NL_GET_TYPE(RDMA_NL_NLDEV, cmd);
+	nlh->nlmsg_flags = NLM_F_REQUEST | flags;
+	nlh->nlmsg_seq = ++nl->seq;
+	if (cmd != RDMA_NLDEV_CMD_GET)
+		roce_ctx_nl_put_u32(nlh, RDMA_NLDEV_ATTR_DEV_INDEX, dev_idx);
+	if (id_attr != 0)
+		roce_ctx_nl_put_u32(nlh, id_attr, id);
+
+	if (send(nl->fd, nlh, nlh->nlmsg_len, 0) != (ssize_t)nlh->nlmsg_len)
+		return -errno;
+
+	return 0;
+}
+
+/*
+ * Receive the answer of the last request. A dump ends with NLMSG_DONE, a
+ * plain request with its one reply. Errors come back as NLMSG_ERROR.
+ */
+static int roce_ctx_nl_recv(struct roce_ctx_nl *nl, bool dump, roce_ctx_msg_cb cb, void *arg)
+{
+	const struct nlmsgerr *err;
+	struct nlmsghdr *nlh;
+	int len;
+	int ret;
+
+	for (;;) {
+		len = (int)recv(nl->fd, nl->buf, ROCE_CTX_NL_BUF_LEN, 0);
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+
+		for (nlh = (struct nlmsghdr *)nl->buf; NLMSG_OK(nlh, len);
+		     nlh = NLMSG_NEXT(nlh, len)) {
+			if (nlh->nlmsg_seq != nl->seq)
+				continue;
+			if (nlh->nlmsg_type == NLMSG_DONE)
+				return 0;
+			if (nlh->nlmsg_type == NLMSG_ERROR) {
+				err = (const struct nlmsgerr *)NLMSG_DATA(nlh);
+				return err->error;
+			}
+			ret = cb(nlh, arg);
+			if (ret)
+				return ret;
+			if (!dump)
+				return 0;
+		}
+	}
+}
+
+static void roce_ctx_attr_parse(const void *data, uint32_t len,
+				const struct nlattr **tb, uint16_t max)
+{
+	const struct nlattr *attr = (const struct nlattr *)data;
+	uint16_t type;
+
+	memset(tb, 0, sizeof(*tb) * (max + 1));
+	while (len >= NLA_HDRLEN && attr->nla_len >= NLA_HDRLEN && attr->nla_len <= len) {
+		type = attr->nla_type & NLA_TYPE_MASK;
+		if (type <= max)
+			tb[type] = attr;
+		len -= HIKP_MIN((uint32_t)NLA_ALIGN(attr->nla_len), len);
+		attr = (const struct nlattr *)((const uint8_t *)attr + NLA_ALIGN(attr->nla_len));
+	}
+}
+
+static const void *roce_ctx_attr_data(const struct nlattr *attr)
+{
+	return (const uint8_t *)attr + NLA_HDRLEN;
+}
+
+static uint32_t roce_ctx_attr_len(const struct nlattr *attr)
+{
+	return attr->nla_len - NLA_HDRLEN;
+}
+
+static uint32_t roce_ctx_attr_u32(const struct nlattr *attr)
+{
+	uint32_t val = 0;
+
+	if (roce_ctx_attr_len(attr) >= sizeof(val))
+		memcpy(&val, roce_ctx_attr_data(attr), sizeof(val));
+
+	return val;
+}
+
+struct roce_ctx_dev_match {
+	const char *name;
+	uint32_t idx;
+	bool found;
+};
+
+static int roce_ctx_dev_cb(const struct nlmsghdr *nlh, void *arg)
+{
+	const struct nlattr *tb[ROCE_CTX_NLDEV_ATTR_MAX] = { 0 };
+	struct roce_ctx_dev_match *match = arg;
+	const char *name;
+
+	roce_ctx_attr_parse(NLMSG_DATA(nlh), NLMSG_PAYLOAD(nlh, 0), tb,
+			    ROCE_CTX_NLDEV_ATTR_MAX - 1);
+	if (tb[RDMA_NLDEV_ATTR_DEV_INDEX] == NULL || tb[RDMA_NLDEV_ATTR_DEV_NAME] == NULL)
+		return 0;
+
+	name = (const char *)roce_ctx_attr_data(tb[RDMA_NLDEV_ATTR_DEV_NAME]);
+	if (strncmp(name, match->name, roce_ctx_attr_len(tb[RDMA_NLDEV_ATTR_DEV_NAME])) == 0) {
+		match->idx = roce_ctx_attr_u32(tb[RDMA_NLDEV_ATTR_DEV_INDEX]);
+		match->found = true;
+	}
+
+	return 0;
+}
+
+static int roce_ctx_get_dev_idx(struct roce_ctx_nl *nl, const char *dev_name, uint32_t *idx)
+{
+	struct roce_ctx_dev_match match = { .name = dev_name };
+	int ret;
+
+	ret = roce_ctx_nl_send(nl, RDMA_NLDEV_CMD_GET, NLM_F_DUMP, 0, 0, 0);
+	if (ret == 0)
+		ret = roce_ctx_nl_recv(nl, true, roce_ctx_dev_cb, &match);
+	if (ret)
+		return ret;
+	if (!match.found) {
+		HIKP_ERROR_PRINT("rdma device %s is not found.\n", dev_name);
+		return -ENODEV;
+	}
+	*idx = match.idx;
+
+	return 0;
+}
+
+struct roce_ctx_id_walk {
+	const struct roce_ctx_res_info *res;
+	struct roce_ctx_ids *ids;
+};
+
+static int roce_ctx_ids_add(struct roce_ctx_ids *ids, uint32_t id)
+{
+	uint32_t *grow;
+	uint32_t size;
+
+	if (ids->num == ids->size) {
+		size = ids->size != 0 ? ids->size * 2 : ROCE_CTX_ID_INIT_SIZE;
+		grow = (uint32_t *)realloc(ids->id, size * sizeof(uint32_t));
+		if (grow == NULL)
+			return -ENOMEM;
+		ids->id = grow;
+		ids->size = size;
+	}
+	ids->id[ids->num++] = id;
+
+	return 0;
+}
+
+static int roce_ctx_id_cb(const struct nlmsghdr *nlh, void *arg)
+{
+	const struct nlattr *tb[ROCE_CTX_NLDEV_ATTR_MAX] = { 0 };
+	const struct nlattr *etb[ROCE_CTX_NLDEV_ATTR_MAX] = { 0 };
+	struct roce_ctx_id_walk *walk = arg;
+	const struct nlattr *entry;
+	uint32_t len;
+	int ret;
+
+	roce_ctx_attr_parse(NLMSG_DATA(nlh), NLMSG_PAYLOAD(nlh, 0), tb,
+			    ROCE_CTX_NLDEV_ATTR_MAX - 1);
+	if (tb[walk->res->table_attr] == NULL)
+		return 0;
+
+	/* table -> entry -> id, the entries share one attribute type */
+	entry = (const struct nlattr *)roce_ctx_attr_data(tb[walk->res->table_attr]);
+	len = roce_ctx_attr_len(tb[walk->res->table_attr]);
+	while (len >= NLA_HDRLEN && entry->nla_len >= NLA_HDRLEN && entry->nla_len <= len) {
+		if ((entry->nla_type & NLA_TYPE_MASK) == walk->res->entry_attr) {
+			roce_ctx_attr_parse(roce_ctx_attr_data(entry), roce_ctx_attr_len(entry),
+					    etb, ROCE_CTX_NLDEV_ATTR_MAX - 1);
+			if (etb[walk->res->id_attr] != NULL) {
+				ret = roce_ctx_ids_add(walk->ids,
+						       roce_ctx_attr_u32(etb[walk->res->id_attr]));
+				if (ret)
+					return ret;
+			}
+		}
+		len -= HIKP_MIN((uint32_t)NLA_ALIGN(entry->nla_len), len);
+		entry = (const struct nlattr *)((const uint8_t *)entry + NLA_ALIGN(entry->nla_len));
+	}
+
+	return 0;
+}
+
+struct roce_ctx_raw_out {
+	const struct roce_ctx_res_info *res;
+	const char *dev_name;
+	uint32_t id;
+	FILE *fp;
+};
+
+static int roce_ctx_raw_cb(const struct nlmsghdr *nlh, void *arg)
+{
+	static const char hex[] = "0123456789abcdef";
+	const struct nlattr *tb[ROCE_CTX_NLDEV_ATTR_MAX] = { 0 };
+	struct roce_ctx_raw_out *out = arg;
+	const uint8_t *raw;
+	uint32_t len;
+	uint32_t i;
+
+	roce_ctx_attr_parse(NLMSG_DATA(nlh), NLMSG_PAYLOAD(nlh, 0), tb,
+			    ROCE_CTX_NLDEV_ATTR_MAX - 1);
+	if (tb[ROCE_CTX_NLDEV_ATTR_RES_RAW] == NULL)
+		return -ENODATA;
+
+	raw = (const uint8_t *)roce_ctx_attr_data(tb[ROCE_CTX_NLDEV_ATTR_RES_RAW]);
+	len = roce_ctx_attr_len(tb[ROCE_CTX_NLDEV_ATTR_RES_RAW]);
+	fprintf(out->fp, "%s %s %u %u ", out->res->ctx_name, out->dev_name, out->id, len);
+	for (i = 0; i < len; i++) {
+		fputc(hex[raw[i] >> 4], out->fp);
+		fputc(hex[raw[i] & 0xf], out->fp);
+	}
+	fputc('\n', out->fp);
+
+	return 0;
+}
+
+/* One dump for the ids, then a raw read per id on the same socket. */
+static int roce_ctx_dump_res(struct roce_ctx_nl *nl, const struct roce_ctx_res_info *res,
+			     const char *dev_name, uint32_t dev_idx, FILE *fp)
+{
+	struct roce_ctx_ids ids = { 0 };
+	struct roce_ctx_id_walk walk = { .res = res, .ids = &ids };
+	struct roce_ctx_raw_out out = { .res = res, .dev_name = dev_name, .fp = fp };
+	uint32_t failed = 0;
+	uint32_t i;
+	int ret;
+
+	ret = roce_ctx_nl_send(nl, res->get_cmd, NLM_F_DUMP, dev_idx, 0, 0);
+	if (ret == 0)
+		ret = roce_ctx_nl_recv(nl, true, roce_ctx_id_cb, &walk);
+	if (ret) {
+		HIKP_ERROR_PRINT("dump %s of %s failed, ret = %d.\n", res->name, dev_name, ret);
+		free(ids.id);
+		return ret;
+	}
+
+	for (i = 0; i < ids.num; i++) {
+		out.id = ids.id[i];
+		ret = roce_ctx_nl_send(nl, res->raw_cmd, 0, dev_idx, res->id_attr, ids.id[i]);
+		if (ret == 0)
+			ret = roce_ctx_nl_recv(nl, false, roce_ctx_raw_cb, &out);
+		if (ret == 0)
+			continue;
+		/* The resource may be gone since the id dump */
+		if (ret == -ENOENT) {
+			failed++;
+			continue;
+		}
+		/* Kernels or drivers without raw reads of this resource */
+		if (i == 0 && (ret == -EOPNOTSUPP || ret == -EINVAL)) {
+			HIKP_ERROR_PRINT("raw %s read is not supported on %s.\n",
+					 res->ctx_name, dev_name);
+			fprintf(fp, "# %s raw context is not supported\n", res->name);
+			free(ids.id);
+			return -EOPNOTSUPP;
+		}
+		HIKP_ERROR_PRINT("read %s %u of %s failed, ret = %d.\n", res->ctx_name,
+				 ids.id[i], dev_name, ret);
+		free(ids.id);
+		return ret;
+	}
+	if (failed != 0)
+		fprintf(fp, "# %u %s gone during the dump\n", failed, res->name);
+	ret = (int)(ids.num - failed);
+	free(ids.id);
+
+	return ret;
+}
+
+int hikp_roce_ctx_dump(const char *dev_name, uint32_t res_mask, FILE *fp)
+{
+	struct roce_ctx_nl nl = { .fd = -1 };
+	uint32_t unsupported = 0;
+	uint32_t wanted = 0;
+	uint32_t dev_idx = 0;
+	int total = 0;
+	uint32_t i;
+	int ret;
+
+	ret = roce_ctx_nl_open(&nl);
+	if (ret == 0)
+		ret = roce_ctx_get_dev_idx(&nl, dev_name, &dev_idx);
+	if (ret) {
+		roce_ctx_nl_close(&nl);
+		return ret;
+	}
+
+	fprintf(fp, "# roce_ctx v%u dev %s time %lld\n", ROCE_CTX_FORMAT_VER, dev_name,
+		(long long)time(NULL));
+	for (i = 0; i < ROCE_CTX_RES_NUM; i++) {
+		if (!(res_mask & HI_BIT(i)))
+			continue;
+		wanted++;
+		ret = roce_ctx_dump_res(&nl, &g_roce_ctx_res[i], dev_name, dev_idx, fp);
+		if (ret == -EOPNOTSUPP) {
+			unsupported++;
+			ret = 0;
+			continue;
+		}
+		if (ret < 0)
+			break;
+		total += ret;
+	}
+	roce_ctx_nl_close(&nl);
+	if (ret < 0)
+		return ret;
+
+	/* Nothing of what was asked for can be read on this kernel */
+	return wanted != 0 && unsupported == wanted ? -EOPNOTSUPP : total;
+}
+
+static void hikp_roce_ctx_execute(struct major_cmd_ctrl *self)
+{
+	FILE *fp = stdout;
+	int ret;
+
+	if (g_roce_ctx_param.dev_name[0] == '\0') {
+		snprintf(self->err_str, sizeof(self->err_str), "please specify a rdma device.");
+		self->err_no = -EINVAL;
+		return;
+	}
+
+	if (g_roce_ctx_param.output[0] != '\0') {
+		fp = fopen(g_roce_ctx_param.output, "w");
+		if (fp == NULL) {
+			self->err_no = -errno;
+			snprintf(self->err_str, sizeof(self->err_str), "open output file failed.");
+			return;
+		}
+	}
+
+	ret = hikp_roce_ctx_dump(g_roce_ctx_param.dev_name, g_roce_ctx_param.res_mask, fp);
+	if (fp != stdout && fclose(fp) != 0 && ret >= 0)
+		ret = -errno;
+	if (ret == -EOPNOTSUPP) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "raw context reads are not supported on %s.", g_roce_ctx_param.dev_name);
+		self->err_no = ret;
+		return;
+	}
+	if (ret < 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "dump contexts of %s failed.",
+			 g_roce_ctx_param.dev_name);
+		self->err_no = ret;
+		return;
+	}
+	if (fp != stdout)
+		printf("%d contexts of %s saved to %s.\n", ret, g_roce_ctx_param.dev_name,
+		       g_roce_ctx_param.output);
+}
+
+static int hikp_roce_ctx_help(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(argv);
+
+	printf("\n  Usage: %s %s\n", self->cmd_ptr->name, "-d <rdma device>\n");
+	printf("\n         %s\n", self->cmd_ptr->help_info);
+	printf("  Options:\n\n");
+	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
+	printf("    %s, %-25s %s\n", "-d", "--device=<device>", "rdma device, e.g. hns_0");
+	printf("    %s, %-25s %s\n", "-r", "--resource=<resource>",
+	       "qp/cq/mr/srq, default all of them");
+	printf("    %s, %-25s %s\n", "-o", "--output=<file>",
+	       "write to file instead of stdout, one \"<ctx> <dev> <id> <len> <hex>\" line each");
+	printf("\n");
+
+	return 0;
+}
+
+static int hikp_roce_ctx_device_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	if (strlen(argv) >= sizeof(g_roce_ctx_param.dev_name)) {
+		snprintf(self->err_str, sizeof(self->err_str), "rdma device name is too long.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	(void)snprintf(g_roce_ctx_param.dev_name, sizeof(g_roce_ctx_param.dev_name), "%s", argv);
+
+	return 0;
+}
+
+static int hikp_roce_ctx_resource_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t i;
+
+	for (i = 0; i < ROCE_CTX_RES_NUM; i++) {
+		if (strcmp(argv, g_roce_ctx_res[i].name) == 0) {
+			g_roce_ctx_param.res_mask = HI_BIT(i);
+			return 0;
+		}
+	}
+
+	snprintf(self->err_str, sizeof(self->err_str), "Invalid resource %s.", argv);
+	self->err_no = -EINVAL;
+	return self->err_no;
+}
+
+static int hikp_roce_ctx_output_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	if (strlen(argv) >= sizeof(g_roce_ctx_param.output)) {
+		snprintf(self->err_str, sizeof(self->err_str), "output file name is too long.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	(void)snprintf(g_roce_ctx_param.output, sizeof(g_roce_ctx_param.output), "%s", argv);
+
+	return 0;
+}
+
+static void cmd_roce_ctx_init(void)
+{
+	struct major_cmd_ctrl *major_cmd = get_major_cmd();
+
+	major_cmd->option_count = 0;
+	major_cmd->execute = hikp_roce_ctx_execute;
+
+	cmd_option_register("-h", "--help", false, hikp_roce_ctx_help);
+	cmd_option_register("-d", "--device", true, hikp_roce_ctx_device_set);
+	cmd_option_register("-r", "--resource", true, hikp_roce_ctx_resource_set);
+	cmd_option_register("-o", "--output", true, hikp_roce_ctx_output_set);
+}
+
+HIKP_CMD_DECLARE("roce_ctx", "dump raw rdma qp/cq/mr/srq contexts over netlink", cmd_roce_ctx_init);
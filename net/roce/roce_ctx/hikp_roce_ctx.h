@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef HIKP_ROCE_CTX_H
+#define HIKP_ROCE_CTX_H
+
+#include <stdio.h>
+#include <rdma/rdma_netlink.h>
+#include "hikp_net_lib.h"
+
+#define ROCE_CTX_DEV_NAME_LEN 64
+#define ROCE_CTX_PATH_LEN 256
+#define ROCE_CTX_NL_BUF_LEN (64 * 1024)
+#define ROCE_CTX_NL_RCVBUF (8 * 1024 * 1024)
+#define ROCE_CTX_NL_REQ_LEN 64
+#define ROCE_CTX_IB_DEV_DIR "/sys/class/infiniband/"
+#define ROCE_CTX_FORMAT_VER 1
+
+/*
+ * The raw resource reads are newer than many uapi headers, and enum values can
+ * not be tested by the preprocessor. These are the kernel ABI values of enum
+ * rdma_nldev_command and enum rdma_nldev_attr, a kernel without them answers
+ * -EINVAL or -EOPNOTSUPP.
+ */
+#ifndef ROCE_CTX_NLDEV_CMD_RES_QP_GET_RAW
+#define ROCE_CTX_NLDEV_CMD_RES_QP_GET_RAW 19
+#endif
+#ifndef ROCE_CTX_NLDEV_CMD_RES_CQ_GET_RAW
+#define ROCE_CTX_NLDEV_CMD_RES_CQ_GET_RAW 20
+#endif
+#ifndef ROCE_CTX_NLDEV_CMD_RES_MR_GET_RAW
+#define ROCE_CTX_NLDEV_CMD_RES_MR_GET_RAW 21
+#endif
+#ifndef ROCE_CTX_NLDEV_CMD_RES_SRQ_GET_RAW
+#define ROCE_CTX_NLDEV_CMD_RES_SRQ_GET_RAW 25
+#endif
+#ifndef ROCE_CTX_NLDEV_ATTR_RES_RAW
+#define ROCE_CTX_NLDEV_ATTR_RES_RAW 85
+#endif
+/* Attribute table size, an older header has a smaller RDMA_NLDEV_ATTR_MAX */
+#define ROCE_CTX_NLDEV_ATTR_MAX HIKP_MAX(RDMA_NLDEV_ATTR_MAX, ROCE_CTX_NLDEV_ATTR_RES_RAW + 1)
+
+enum roce_ctx_res {
+	ROCE_CTX_RES_QP,
+	ROCE_CTX_RES_CQ,
+	ROCE_CTX_RES_MR,
+	ROCE_CTX_RES_SRQ,
+	ROCE_CTX_RES_NUM,
+};
+
+#define ROCE_CTX_RES_ALL ((1U << ROCE_CTX_RES_NUM) - 1)
+
+struct roce_ctx_param {
+	char dev_name[ROCE_CTX_DEV_NAME_LEN]; /* rdma device, e.g. hns_0 */
+	uint32_t res_mask; /* bit per enum roce_ctx_res */
+	char output[ROCE_CTX_PATH_LEN];
+};
+
+/* The resource ids of a dump, then one raw context read per id */
+struct roce_ctx_ids {
+	uint32_t *id;
+	uint32_t num;
+	uint32_t size;
+};
+
+struct roce_ctx_nl {
+	int fd;
+	uint32_t seq;
+	uint8_t *buf;
+};
+
+/*
+ * Stream the raw driver contexts of the resources in res_mask of one rdma
+ * device to fp, one text line per context:
+ *   <ctx> <dev> <id> <len> <hex bytes>
+ * after a "# roce_ctx" header line. Returns the number of contexts or a
+ * negative errno.
+ */
+int hikp_roce_ctx_dump(const char *dev_name, uint32_t res_mask, FILE *fp);
+
+#endif /* HIKP_ROCE_CTX_H */
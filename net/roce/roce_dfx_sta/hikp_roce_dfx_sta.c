@@ -31,6 +31,8 @@ static int hikp_roce_dfx_sta_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0");
 	printf("    %s, %-25s %s\n", "-c", "--clear=<clear>", "clear param count registers");
+	hikp_roce_ext_snap_help();
+	hikp_roce_ext_rate_help();
 	printf("\n");
 
 	return 0;
@@ -89,9 +91,28 @@ static int hikp_roce_dfx_sta_get_data(struct hikp_cmd_ret **cmd_ret,
 	return ret;
 }
 
+static int hikp_roce_dfx_sta_fetch(struct roce_ext_res_output *output)
+{
+	return hikp_roce_ext_fetch(GET_ROCEE_DFX_STA_CMD, hikp_roce_dfx_sta_get_data, output);
+}
+
 void hikp_roce_dfx_sta_execute(struct major_cmd_ctrl *self)
 {
-	hikp_roce_ext_execute(self, GET_ROCEE_DFX_STA_CMD, hikp_roce_dfx_sta_get_data);
+	if (!hikp_roce_ext_rate_active()) {
+		hikp_roce_ext_snap_target(&g_roce_dfx_sta_param_t.target.bdf, 0, 0);
+		hikp_roce_ext_execute(self, GET_ROCEE_DFX_STA_CMD, hikp_roce_dfx_sta_get_data);
+		return;
+	}
+
+	if (g_roce_dfx_sta_param_t.reset_flag || hikp_roce_ext_snap_active()) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-r/--rate can not be used with -c/--clear, -s/--save or -d/--diff.");
+		self->err_no = -EINVAL;
+		return;
+	}
+	self->err_no = hikp_roce_ext_rate(GET_ROCEE_DFX_STA_CMD, hikp_roce_dfx_sta_fetch);
+	if (self->err_no)
+		snprintf(self->err_str, sizeof(self->err_str), "roce_dfx_sta rate sample failed.");
 }
 
 static void cmd_roce_dfx_sta_init(void)
@@ -103,7 +124,9 @@ static void cmd_roce_dfx_sta_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_roce_dfx_sta_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_dfx_sta_target);
-	cmd_option_register("-c", "--clear", false, hikp_roce_dfx_sta_clear_set);
+	cmd_writer_option_register("-c", "--clear", false, hikp_roce_dfx_sta_clear_set);
+	hikp_roce_ext_snap_register();
+	hikp_roce_ext_rate_register();
 }
 
 HIKP_CMD_DECLARE("roce_dfx_sta", "get or clear RoCE dfx statistics", cmd_roce_dfx_sta_init);
@@ -13,6 +13,13 @@
 
 #include "hikp_roce_ext_common.h"
 #include <stddef.h>
+#include <inttypes.h>
+
+static struct roce_ext_snap_param g_roce_ext_snap;
+static struct roce_ext_rate_param g_roce_ext_rate = {
+	.count = 1,
+	.top = ROCE_EXT_RATE_DEF_TOP,
+};
 
 static void hikp_roce_ext_reg_data_free(struct reg_data *reg)
 {
@@ -223,29 +230,511 @@ get_data_error:
 	return ret;
 }
 
-static void hikp_roce_ext_print(enum roce_cmd_type cmd_type,
-				struct roce_ext_res_output *output)
+static void hikp_roce_ext_print_rows(const struct roce_ext_res_output *output,
+				     uint32_t bank, bool bank_col)
 {
 	uint32_t total_block_num = output->res_head.total_block_num;
 	const char **reg_name = output->reg_name.reg_name;
-	const char *cmd_name = get_cmd_name(cmd_type);
 	uint8_t arr_len = output->reg_name.arr_len;
 	uint32_t *offset = output->reg.offset;
-	struct reg_data *reg = &output->reg;
+	const struct reg_data *reg = &output->reg;
 	const char *name;
 	uint32_t i;
 
-	printf("**************%s INFO*************\n", cmd_name);
-	printf("%-40s[addr_offset] : reg_data\n", "reg_name");
 	for (i = 0; i < total_block_num; i++) {
 		name = i < arr_len ? reg_name[i] : "";
+		if (bank_col)
+			printf("%-6u", bank);
 		printf("%-40s[0x%08X] : ", name, offset[i]);
 		if (output->res_head.flags & ROCE_HIKP_DATA_U64_FLAG)
 			printf("0x%016lX\n", reg->data_u64[i]);
 		else
 			printf("0x%08X\n", reg->data_u32[i]);
 	}
+}
+
+static void hikp_roce_ext_print(enum roce_cmd_type cmd_type,
+				const struct roce_ext_res_output *output)
+{
+	const char *cmd_name = get_cmd_name(cmd_type);
+
+	printf("**************%s INFO*************\n", cmd_name);
+	printf("%-40s[addr_offset] : reg_data\n", "reg_name");
+	hikp_roce_ext_print_rows(output, 0, false);
+	printf("************************************\n");
+}
+
+void hikp_roce_ext_print_banks(enum roce_cmd_type cmd_type,
+			       const struct roce_ext_res_output *output, uint32_t bank_num)
+{
+	const char *cmd_name = get_cmd_name(cmd_type);
+	uint32_t bank;
+
+	printf("**************%s INFO*************\n", cmd_name);
+	printf("%-6s%-40s[addr_offset] : reg_data\n", "bank", "reg_name");
+	for (bank = 0; bank < bank_num; bank++)
+		hikp_roce_ext_print_rows(&output[bank], bank, true);
+	printf("************************************\n");
+}
+
+static uint64_t hikp_roce_ext_reg_val(const struct roce_ext_res_output *output, uint32_t i)
+{
+	if (output->res_head.flags & ROCE_HIKP_DATA_U64_FLAG)
+		return output->reg.data_u64[i];
+
+	return output->reg.data_u32[i];
+}
+
+/* Index of the first unused register at offset, num if there is none. */
+static uint32_t hikp_roce_ext_reg_match(const uint32_t *offset, uint32_t num,
+					const bool *used, uint32_t target)
+{
+	uint32_t i;
+
+	for (i = 0; i < num; i++) {
+		if (!used[i] && offset[i] == target)
+			break;
+	}
+
+	return i;
+}
+
+static int hikp_roce_ext_snap_key_check(const void *saved_key, const void *key)
+{
+	const struct roce_ext_snap_key *saved = saved_key;
+	const struct roce_ext_snap_key *cur = key;
+
+	if (saved->cmd_type != cur->cmd_type || saved->seq != cur->seq)
+		return TOOL_SNAP_KEY_SKIP;
+
+	if (saved->bdf.domain != cur->bdf.domain || saved->bdf.bdf_id != cur->bdf.bdf_id ||
+	    saved->sub_cmd != cur->sub_cmd || saved->bank != cur->bank) {
+		HIKP_ERROR_PRINT("roce_%s table %u of %s was saved for another device, "
+				 "sub command or bank.\n", get_cmd_name(cur->cmd_type), cur->seq,
+				 g_roce_ext_snap.file);
+		return -EINVAL;
+	}
+
+	return TOOL_SNAP_KEY_MATCH;
+}
+
+static void hikp_roce_ext_snap_init(struct tool_snap *snap, struct roce_ext_snap_key *key,
+				    enum roce_cmd_type cmd_type, uint32_t seq, uint32_t flags)
+{
+	key->cmd_type = cmd_type;
+	key->seq = seq;
+	key->bdf = g_roce_ext_snap.bdf;
+	key->sub_cmd = g_roce_ext_snap.sub_cmd;
+	key->bank = g_roce_ext_snap.bank;
+	key->flags = flags;
+
+	snap->file = g_roce_ext_snap.file;
+	snap->name = "roce register";
+	snap->type = ROCE_EXT_SNAP_MAGIC;
+	snap->version = ROCE_EXT_SNAP_VER;
+	snap->key = key;
+	snap->key_len = sizeof(*key);
+	snap->max_data_len = ROCE_EXT_SNAP_MAX_DATA_LEN;
+	snap->key_check = hikp_roce_ext_snap_key_check;
+}
+
+static int hikp_roce_ext_snap_save(enum roce_cmd_type cmd_type, uint32_t seq,
+				   const struct roce_ext_res_output *output)
+{
+	uint32_t num = output->res_head.total_block_num;
+	uint8_t payload[ROCE_EXT_SNAP_MAX_DATA_LEN];
+	struct roce_ext_snap_key key = {0};
+	struct tool_snap snap = {0};
+	uint64_t val;
+	uint32_t i;
+	int ret;
+
+	memcpy(payload, output->reg.offset, num * sizeof(uint32_t));
+	for (i = 0; i < num; i++) {
+		val = hikp_roce_ext_reg_val(output, i);
+		memcpy(payload + num * sizeof(uint32_t) + i * sizeof(uint64_t), &val, sizeof(val));
+	}
+
+	hikp_roce_ext_snap_init(&snap, &key, cmd_type, seq, output->res_head.flags);
+	/* The first table of the run starts the file, later ones append */
+	ret = tool_snap_save(&snap, payload, num * (sizeof(uint32_t) + sizeof(uint64_t)),
+			     seq != 0);
+	if (ret == 0)
+		printf("roce_%s table %u: %u registers saved to %s.\n", get_cmd_name(cmd_type),
+		       seq, num, g_roce_ext_snap.file);
+
+	return ret;
+}
+
+static int hikp_roce_ext_snap_load(enum roce_cmd_type cmd_type, uint32_t seq,
+				   struct tool_snap_head *head, uint32_t *reg_num,
+				   uint32_t *offset, uint64_t *data)
+{
+	const size_t reg_size = sizeof(uint32_t) + sizeof(uint64_t);
+	struct roce_ext_snap_key saved = {0};
+	struct roce_ext_snap_key key = {0};
+	struct tool_snap snap = {0};
+	uint8_t *payload = NULL;
+	int ret;
+
+	hikp_roce_ext_snap_init(&snap, &key, cmd_type, seq, 0);
+	ret = tool_snap_load(&snap, head, &saved, (void **)&payload);
+	if (ret)
+		return ret;
+
+	if (head->data_len % reg_size != 0) {
+		HIKP_ERROR_PRINT("%s is not a roce register snapshot.\n", g_roce_ext_snap.file);
+		free(payload);
+		return -EINVAL;
+	}
+	*reg_num = (uint32_t)(head->data_len / reg_size);
+	memcpy(offset, payload, *reg_num * sizeof(uint32_t));
+	memcpy(data, payload + *reg_num * sizeof(uint32_t), *reg_num * sizeof(uint64_t));
+	free(payload);
+
+	return 0;
+}
+
+/* Match registers by offset, print the changed ones and the ones only on one side. */
+static int hikp_roce_ext_snap_diff(enum roce_cmd_type cmd_type, uint32_t seq,
+				   const struct roce_ext_res_output *output)
+{
+	uint32_t num = output->res_head.total_block_num;
+	const char **reg_name = output->reg_name.reg_name;
+	uint8_t arr_len = output->reg_name.arr_len;
+	struct tool_snap_head head = {0};
+	uint32_t old_offset[UINT8_MAX];
+	uint64_t old_data[UINT8_MAX];
+	bool old_used[UINT8_MAX] = {0};
+	uint64_t old_val, new_val, mask, delta;
+	enum tool_cnt_move move;
+	uint32_t changed = 0;
+	uint32_t old_num = 0;
+	uint32_t i, j;
+	int ret;
+
+	ret = hikp_roce_ext_snap_load(cmd_type, seq, &head, &old_num, old_offset, old_data);
+	if (ret)
+		return ret;
+
+	mask = (output->res_head.flags & ROCE_HIKP_DATA_U64_FLAG) ? UINT64_MAX : UINT32_MAX;
+	printf("**************%s DIFF table %u over %.3fs*************\n",
+	       get_cmd_name(cmd_type), seq, tool_snap_age(&head));
+	printf("%-40s[addr_offset] : old -> new (delta)\n", "reg_name");
+	for (i = 0; i < num; i++) {
+		new_val = hikp_roce_ext_reg_val(output, i);
+		j = hikp_roce_ext_reg_match(old_offset, old_num, old_used, output->reg.offset[i]);
+		if (j == old_num) {
+			changed++;
+			printf("%-40s[0x%08X] : (new) 0x%" PRIx64 "\n",
+			       i < arr_len ? reg_name[i] : "", output->reg.offset[i], new_val);
+			continue;
+		}
+		old_used[j] = true;
+		old_val = old_data[j];
+		if (old_val == new_val)
+			continue;
+
+		changed++;
+		move = tool_cnt_delta(old_val, new_val, mask, &delta);
+		printf("%-40s[0x%08X] : 0x%" PRIx64 " -> 0x%" PRIx64 " (%c%" PRIu64 ")\n",
+		       i < arr_len ? reg_name[i] : "", output->reg.offset[i], old_val, new_val,
+		       move == TOOL_CNT_DOWN ? '-' : '+', delta);
+	}
+	for (j = 0; j < old_num; j++) {
+		if (old_used[j])
+			continue;
+		changed++;
+		printf("%-40s[0x%08X] : (gone) 0x%" PRIx64 "\n", "", old_offset[j], old_data[j]);
+	}
+	printf("%u register(s) changed.\n", changed);
 	printf("************************************\n");
+
+	return 0;
+}
+
+int hikp_roce_ext_output_show(enum roce_cmd_type cmd_type,
+			      const struct roce_ext_res_output *output)
+{
+	uint32_t seq = g_roce_ext_snap.seq++;
+
+	if (g_roce_ext_snap.flag & ROCE_EXT_SNAP_SAVE_FLAG)
+		return hikp_roce_ext_snap_save(cmd_type, seq, output);
+	if (g_roce_ext_snap.flag & ROCE_EXT_SNAP_DIFF_FLAG)
+		return hikp_roce_ext_snap_diff(cmd_type, seq, output);
+
+	hikp_roce_ext_print(cmd_type, output);
+	return 0;
+}
+
+static int hikp_roce_ext_snap_file(struct major_cmd_ctrl *self, const char *argv, uint8_t flag)
+{
+	if (g_roce_ext_snap.flag & ~flag) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-s/--save and -d/--diff can not be used together.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	if (strlen(argv) >= sizeof(g_roce_ext_snap.file)) {
+		snprintf(self->err_str, sizeof(self->err_str), "snapshot file name is too long.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	(void)snprintf(g_roce_ext_snap.file, sizeof(g_roce_ext_snap.file), "%s", argv);
+	g_roce_ext_snap.flag |= flag;
+
+	return 0;
+}
+
+static int hikp_roce_ext_snap_save_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_roce_ext_snap_file(self, argv, ROCE_EXT_SNAP_SAVE_FLAG);
+}
+
+static int hikp_roce_ext_snap_diff_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_roce_ext_snap_file(self, argv, ROCE_EXT_SNAP_DIFF_FLAG);
+}
+
+void hikp_roce_ext_snap_register(void)
+{
+	cmd_option_register("-s", "--save", true, hikp_roce_ext_snap_save_set);
+	cmd_option_register("-d", "--diff", true, hikp_roce_ext_snap_diff_set);
+}
+
+void hikp_roce_ext_snap_help(void)
+{
+	printf("    %s, %-25s %s\n", "-s", "--save=<file>",
+	       "save the raw registers to a snapshot file");
+	printf("    %s, %-25s %s\n", "-d", "--diff=<file>",
+	       "only show registers changed since the snapshot, with counter delta");
+}
+
+bool hikp_roce_ext_snap_active(void)
+{
+	return g_roce_ext_snap.flag != 0;
+}
+
+/* Recorded in the snapshot key of the next tables, a diff against another target fails */
+void hikp_roce_ext_snap_target(const struct bdf_t *bdf, uint32_t sub_cmd, uint32_t bank)
+{
+	g_roce_ext_snap.bdf = *bdf;
+	g_roce_ext_snap.sub_cmd = sub_cmd;
+	g_roce_ext_snap.bank = bank;
+}
+
+/* Snapshots only cover the offset tagged ext tables, not the fixed origin layouts. */
+int hikp_roce_ext_snap_need_ext(struct major_cmd_ctrl *self)
+{
+	if (!hikp_roce_ext_snap_active())
+		return 0;
+
+	snprintf(self->err_str, sizeof(self->err_str),
+		 "-s/--save and -d/--diff need -e/--extend.");
+	self->err_no = -EINVAL;
+	return self->err_no;
+}
+
+static int hikp_roce_ext_rate_cmp(const void *a, const void *b)
+{
+	const struct roce_ext_rate_entry *x = a;
+	const struct roce_ext_rate_entry *y = b;
+
+	if (x->delta != y->delta)
+		return x->delta < y->delta ? 1 : -1;
+
+	return x->idx < y->idx ? -1 : (x->idx > y->idx);
+}
+
+static void hikp_roce_ext_rate_show(enum roce_cmd_type cmd_type,
+				    const struct roce_ext_res_output *old,
+				    const struct roce_ext_res_output *new, double interval)
+{
+	uint32_t old_num = old->res_head.total_block_num;
+	uint32_t num = new->res_head.total_block_num;
+	const char **reg_name = new->reg_name.reg_name;
+	uint8_t arr_len = new->reg_name.arr_len;
+	struct roce_ext_rate_entry entry[UINT8_MAX];
+	bool old_used[UINT8_MAX] = {0};
+	uint32_t down_num = 0;
+	uint32_t moved = 0;
+	uint32_t show;
+	uint64_t mask, delta;
+	uint32_t i, j;
+
+	mask = (new->res_head.flags & ROCE_HIKP_DATA_U64_FLAG) ? UINT64_MAX : UINT32_MAX;
+	for (i = 0; i < num; i++) {
+		j = hikp_roce_ext_reg_match(old->reg.offset, old_num, old_used,
+					    new->reg.offset[i]);
+		if (j == old_num)
+			continue;
+		old_used[j] = true;
+		/*
+		 * A decrease that is not a wrap has no rate, those fill entry
+		 * from the top and are listed on their own.
+		 */
+		if (tool_cnt_delta(hikp_roce_ext_reg_val(old, j), hikp_roce_ext_reg_val(new, i),
+				   mask, &delta) == TOOL_CNT_DOWN) {
+			down_num++;
+			entry[UINT8_MAX - down_num].delta = delta;
+			entry[UINT8_MAX - down_num].idx = i;
+			continue;
+		}
+		if (delta == 0)
+			continue;
+		entry[moved].delta = delta;
+		entry[moved++].idx = i;
+	}
+	qsort(entry, moved, sizeof(entry[0]), hikp_roce_ext_rate_cmp);
+
+	show = g_roce_ext_rate.top != 0 ? HIKP_MIN(g_roce_ext_rate.top, moved) : moved;
+	printf("**************%s RATE over %.3fs*************\n", get_cmd_name(cmd_type),
+	       interval);
+	printf("%-40s[addr_offset] : %-20s %s\n", "reg_name", "delta", "per_second");
+	for (i = 0; i < show; i++) {
+		j = entry[i].idx;
+		printf("%-40s[0x%08X] : %-20" PRIu64 " %.1f\n",
+		       j < arr_len ? reg_name[j] : "", new->reg.offset[j], entry[i].delta,
+		       interval > 0 ? (double)entry[i].delta / interval : 0.0);
+	}
+	for (i = UINT8_MAX - down_num; i < UINT8_MAX; i++) {
+		j = entry[i].idx;
+		printf("%-40s[0x%08X] : -%-19" PRIu64 " (cleared or reset)\n",
+		       j < arr_len ? reg_name[j] : "", new->reg.offset[j], entry[i].delta);
+	}
+	printf("%u of %u register(s) moved, %u went down.\n", moved, num, down_num);
+	printf("************************************\n");
+}
+
+/*
+ * Read the registers count + 1 times, interval seconds apart, and show the
+ * fastest moving ones of each window. Nothing is cleared on the device.
+ */
+int hikp_roce_ext_rate(enum roce_cmd_type cmd_type,
+		       int (*fetch)(struct roce_ext_res_output *output))
+{
+	uint64_t period_ns = (uint64_t)g_roce_ext_rate.interval * HIKP_NSEC_PER_SEC;
+	struct roce_ext_res_output output[2] = {0};
+	uint64_t last_ns, now_ns;
+	uint32_t cur = 0;
+	uint32_t round;
+	int ret;
+
+	ret = fetch(&output[cur]);
+	if (ret)
+		return ret;
+	last_ns = tool_get_time_ns();
+
+	for (round = 0; round < g_roce_ext_rate.count; round++) {
+		ret = cmd_sleep_until(last_ns + period_ns);
+		if (ret)
+			break;
+		ret = fetch(&output[cur ^ 1]);
+		if (ret)
+			break;
+		now_ns = tool_get_time_ns();
+		cur ^= 1;
+		hikp_roce_ext_rate_show(cmd_type, &output[cur ^ 1], &output[cur],
+					(double)(now_ns - last_ns) / HIKP_NSEC_PER_SEC);
+		hikp_roce_ext_reg_data_free(&output[cur ^ 1].reg);
+		last_ns = now_ns;
+	}
+	hikp_roce_ext_reg_data_free(&output[cur].reg);
+
+	return ret;
+}
+
+static int hikp_roce_ext_rate_interval_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t interval;
+
+	self->err_no = string_toui(argv, &interval);
+	if (self->err_no != 0 || interval == 0 || interval > ROCE_EXT_RATE_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "rate interval should be 1~%u seconds.", ROCE_EXT_RATE_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	g_roce_ext_rate.interval = interval;
+
+	return 0;
+}
+
+static int hikp_roce_ext_rate_count_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t count;
+
+	self->err_no = string_toui(argv, &count);
+	if (self->err_no != 0 || count == 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "rate count should be at least 1.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	g_roce_ext_rate.count = count;
+
+	return 0;
+}
+
+static int hikp_roce_ext_rate_top_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	self->err_no = string_toui(argv, &g_roce_ext_rate.top);
+	if (self->err_no != 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "parse rate top number failed.");
+		return self->err_no;
+	}
+
+	return 0;
+}
+
+void hikp_roce_ext_rate_register(void)
+{
+	cmd_option_register("-r", "--rate", true, hikp_roce_ext_rate_interval_set);
+	cmd_option_register("-n", "--count", true, hikp_roce_ext_rate_count_set);
+	cmd_option_register("-t", "--top", true, hikp_roce_ext_rate_top_set);
+}
+
+void hikp_roce_ext_rate_help(void)
+{
+	printf("    %s, %-25s %s\n", "-r", "--rate=<seconds>",
+	       "show counter deltas per second over the interval, without clearing");
+	printf("    %s, %-25s %s\n", "-n", "--count=<num>",
+	       "number of rate intervals, default 1");
+	printf("    %s, %-25s %s\n", "-t", "--top=<num>",
+	       "fastest counters shown per interval, default 10, 0 means all");
+}
+
+bool hikp_roce_ext_rate_active(void)
+{
+	return g_roce_ext_rate.interval != 0;
+}
+
+void hikp_roce_ext_output_free(struct roce_ext_res_output *output)
+{
+	hikp_roce_ext_reg_data_free(&output->reg);
+}
+
+int hikp_roce_ext_fetch(enum roce_cmd_type cmd_type,
+			int (*get_data)(struct hikp_cmd_ret **cmd_ret,
+					uint32_t block_id,
+					struct roce_ext_reg_name *reg_name),
+			struct roce_ext_res_output *output)
+{
+	uint32_t queried_block_id = 0;
+	int ret;
+
+	do {
+		ret = hikp_roce_ext_get_res(cmd_type, queried_block_id,
+					    output, get_data);
+		if (ret) {
+			hikp_roce_ext_reg_data_free(&output->reg);
+			return ret;
+		}
+
+		queried_block_id += output->res_head.cur_block_num;
+	} while (queried_block_id < output->res_head.total_block_num);
+
+	return 0;
 }
 
 void hikp_roce_ext_execute(struct major_cmd_ctrl *self,
@@ -255,18 +744,12 @@ void hikp_roce_ext_execute(struct major_cmd_ctrl *self,
 					   struct roce_ext_reg_name *reg_name))
 {
 	struct roce_ext_res_output output = { 0 };
-	uint32_t queried_block_id = 0;
-
-	do {
-		self->err_no = hikp_roce_ext_get_res(cmd_type, queried_block_id,
-						     &output, get_data);
-		if (self->err_no)
-			return;
 
-		queried_block_id += output.res_head.cur_block_num;
-	} while (queried_block_id < output.res_head.total_block_num);
+	self->err_no = hikp_roce_ext_fetch(cmd_type, get_data, &output);
+	if (self->err_no)
+		return;
 
-	hikp_roce_ext_print(cmd_type, &output);
+	self->err_no = hikp_roce_ext_output_show(cmd_type, &output);
 
 	hikp_roce_ext_reg_data_free(&output.reg);
 }
@@ -80,10 +80,79 @@ struct roce_ext_res_output {
 	struct roce_ext_reg_name reg_name;
 };
 
+#define ROCE_EXT_SNAP_PATH_LEN 256
+#define ROCE_EXT_SNAP_SAVE_FLAG 0x1
+#define ROCE_EXT_SNAP_DIFF_FLAG 0x2
+
+#define ROCE_EXT_SNAP_MAGIC 0x58455352 /* "RSEX" */
+#define ROCE_EXT_SNAP_VER 2
+#define ROCE_EXT_SNAP_MAX_DATA_LEN (UINT8_MAX * (sizeof(uint32_t) + sizeof(uint64_t)))
+
+/*
+ * A --save file holds one record per ext register table printed by the
+ * command, in print order. Each record has this key and offset[reg_num]
+ * as u32 followed by data[reg_num] as u64 as payload.
+ */
+struct roce_ext_snap_key {
+	uint32_t cmd_type;
+	uint32_t seq; /* n-th table of the command run */
+	struct bdf_t bdf;
+	uint32_t sub_cmd;
+	uint32_t bank;
+	uint32_t flags; /* roce_ext_head flags */
+};
+
+struct roce_ext_snap_param {
+	char file[ROCE_EXT_SNAP_PATH_LEN];
+	uint8_t flag;
+	uint32_t seq;
+	/* what the next table is read from, see hikp_roce_ext_snap_target() */
+	struct bdf_t bdf;
+	uint32_t sub_cmd;
+	uint32_t bank;
+};
+
+#define ROCE_EXT_RATE_MAX_INTERVAL 3600 /* seconds */
+#define ROCE_EXT_RATE_DEF_TOP 10
+
+struct roce_ext_rate_param {
+	uint32_t interval; /* sample window in seconds, 0 means rate mode is off */
+	uint32_t count; /* number of windows */
+	uint32_t top; /* fastest counters shown per window, 0 means all that moved */
+};
+
+struct roce_ext_rate_entry {
+	uint32_t idx;
+	uint64_t delta;
+};
+
+void hikp_roce_ext_snap_register(void);
+void hikp_roce_ext_snap_help(void);
+bool hikp_roce_ext_snap_active(void);
+void hikp_roce_ext_snap_target(const struct bdf_t *bdf, uint32_t sub_cmd, uint32_t bank);
+int hikp_roce_ext_snap_need_ext(struct major_cmd_ctrl *self);
+int hikp_roce_ext_output_show(enum roce_cmd_type cmd_type,
+			      const struct roce_ext_res_output *output);
+
+void hikp_roce_ext_rate_register(void);
+void hikp_roce_ext_rate_help(void);
+bool hikp_roce_ext_rate_active(void);
+int hikp_roce_ext_rate(enum roce_cmd_type cmd_type,
+		       int (*fetch)(struct roce_ext_res_output *output));
+
 void hikp_roce_ext_execute(struct major_cmd_ctrl *self,
 			   enum roce_cmd_type cmd_type,
 			   int (*get_data)(struct hikp_cmd_ret **cmd_ret,
 					   uint32_t block_id,
 					   struct roce_ext_reg_name *reg_name));
 
+int hikp_roce_ext_fetch(enum roce_cmd_type cmd_type,
+			int (*get_data)(struct hikp_cmd_ret **cmd_ret,
+					uint32_t block_id,
+					struct roce_ext_reg_name *reg_name),
+			struct roce_ext_res_output *output);
+void hikp_roce_ext_output_free(struct roce_ext_res_output *output);
+void hikp_roce_ext_print_banks(enum roce_cmd_type cmd_type,
+			       const struct roce_ext_res_output *output, uint32_t bank_num);
+
 #endif /* HIKP_ROCE_EXT_COMMON_H */
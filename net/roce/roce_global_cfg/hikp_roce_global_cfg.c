@@ -31,6 +31,7 @@ static int hikp_roce_global_cfg_help(struct major_cmd_ctrl *self,
 	printf("  Options:\n\n");
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0");
+	hikp_roce_ext_snap_help();
 	printf("\n");
 
 	return 0;
@@ -89,6 +90,7 @@ void hikp_roce_global_cfg_execute(struct major_cmd_ctrl *self)
 
 	for (i = 0; i < HIKP_ARRAY_SIZE(sub_cmds); i++) {
 		g_roce_global_cfg_param.sub_cmd = sub_cmds[i];
+		hikp_roce_ext_snap_target(&g_roce_global_cfg_param.target.bdf, sub_cmds[i], 0);
 		hikp_roce_ext_execute(self, GET_ROCEE_GLOBAL_CFG_CMD,
 				      hikp_roce_global_cfg_get_data);
 	}
@@ -103,6 +105,7 @@ static void cmd_roce_global_cfg_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_roce_global_cfg_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_global_cfg_target);
+	hikp_roce_ext_snap_register();
 }
 
 HIKP_CMD_DECLARE("roce_global_cfg", "get roce_global_cfg registers information", cmd_roce_global_cfg_init);
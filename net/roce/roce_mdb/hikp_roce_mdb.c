@@ -38,6 +38,7 @@ static int hikp_roce_mdb_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0");
 	printf("    %s, %-25s %s\n", "-c", "--clear=<clear>", "clear mdb registers");
 	printf("    %s, %-25s %s\n", "-e", "--extend", "query extend mdb registers");
+	hikp_roce_ext_snap_help();
 	printf("\n");
 
 	return 0;
@@ -177,9 +178,13 @@ void hikp_roce_mdb_execute(struct major_cmd_ctrl *self)
 	if (g_roce_mdb_param.flag & ROCE_MDB_CMD_EXT) {
 		g_roce_mdb_param.sub_cmd = (g_roce_mdb_param.flag & ROCE_MDB_CMD_CLEAR) ?
 					   MDB_CLEAR_EXT : MDB_EXT;
+		hikp_roce_ext_snap_target(&g_roce_mdb_param.target.bdf,
+					  g_roce_mdb_param.sub_cmd, 0);
 		hikp_roce_ext_execute(self, GET_ROCEE_MDB_CMD,
 				      hikp_roce_mdb_get_data);
 	} else {
+		if (hikp_roce_ext_snap_need_ext(self))
+			return;
 		g_roce_mdb_param.sub_cmd = (g_roce_mdb_param.flag & ROCE_MDB_CMD_CLEAR) ?
 					   MDB_CLEAR : MDB_SHOW;
 		hikp_roce_mdb_execute_origin(self);
@@ -205,8 +210,9 @@ static void cmd_roce_mdb_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_roce_mdb_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_mdb_target);
-	cmd_option_register("-c", "--clear", false, hikp_roce_mdb_clear_set);
+	cmd_writer_option_register("-c", "--clear", false, hikp_roce_mdb_clear_set);
 	cmd_option_register("-e", "--extend", false, hikp_roce_mdb_ext_set);
+	hikp_roce_ext_snap_register();
 }
 
 HIKP_CMD_DECLARE("roce_mdb", "get or clear roce_mdb registers information", cmd_roce_mdb_init);
@@ -147,7 +147,7 @@ static void cmd_roce_pkt_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_roce_pkt_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_pkt_target);
-	cmd_option_register("-c", "--clear", false, hikp_roce_pkt_clear_set);
+	cmd_writer_option_register("-c", "--clear", false, hikp_roce_pkt_clear_set);
 }
 
 HIKP_CMD_DECLARE("roce_pkt", "get or clear roce_pkt registers information", cmd_roce_pkt_init);
@@ -32,6 +32,11 @@ void hikp_roce_set_qmm_bankid(uint32_t bank_id)
 	g_roce_qmm_param.bank_id = bank_id;
 }
 
+void hikp_roce_set_qmm_bank_all(bool bank_all)
+{
+	g_roce_qmm_param.bank_all = bank_all;
+}
+
 static int hikp_roce_qmm_help(struct major_cmd_ctrl *self, const char *argv)
 {
 	HIKP_SET_USED(argv);
@@ -42,8 +47,9 @@ static int hikp_roce_qmm_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>", "device target, e.g. eth0");
 	printf("    %s, %-25s %s\n", "-b", "--bank=<bank>",
-	       "[option]bank number, e.g. 0~7. (default 0)");
+	       "[option]bank number, e.g. 0~7, or all. (default 0)");
 	printf("    %s, %-25s %s\n", "-e", "--extend", "query extend qmm registers");
+	hikp_roce_ext_snap_help();
 	printf("\n");
 
 	return 0;
@@ -65,6 +71,11 @@ static int hikp_roce_qmm_bank_get(struct major_cmd_ctrl *self, const char *argv)
 	char *endptr = NULL;
 	uint64_t bank_num;
 
+	if (strcmp(argv, "all") == 0) {
+		g_roce_qmm_param.bank_all = true;
+		return 0;
+	}
+
 	bank_num = strtoul(argv, &endptr, 0);
 	if ((endptr <= argv) || (*endptr != '\0') || bank_num > QMM_BANK_NUM) {
 		snprintf(self->err_str, sizeof(self->err_str), "Invalid bank number!\n");
@@ -72,6 +83,7 @@ static int hikp_roce_qmm_bank_get(struct major_cmd_ctrl *self, const char *argv)
 		return -EINVAL;
 	}
 
+	g_roce_qmm_param.bank_all = false;
 	g_roce_qmm_param.bank_id = (uint32_t)bank_num;
 	return 0;
 }
@@ -169,11 +181,13 @@ static const struct reg_name_info {
 	{QMM_SHOW_TOP_EXT, g_qmm_top_ext_reg_name, HIKP_ARRAY_SIZE(g_qmm_top_ext_reg_name)},
 };
 
-static void hikp_roce_qmm_print(struct roce_qmm_rsp_data *qmm_rsp)
+static void hikp_roce_qmm_print(const struct roce_qmm_rsp_data *qmm_rsp, uint32_t bank_num,
+				bool bank_col)
 {
 	const char **reg_name;
 	uint32_t index = 0;
 	uint8_t arr_len;
+	uint32_t bank;
 
 	for (index = 0; index < HIKP_ARRAY_SIZE(g_qmm_reg_name_info_table); index++) {
 		if (g_qmm_reg_name_info_table[index].sub_cmd != g_roce_qmm_param.sub_cmd)
@@ -191,14 +205,18 @@ static void hikp_roce_qmm_print(struct roce_qmm_rsp_data *qmm_rsp)
 
 	printf("**************QMM %s INFO*************\n",
 	       g_roce_qmm_param.sub_name);
+	if (bank_col)
+		printf("%-6s", "bank");
 	printf("%-40s[addr_offset] : reg_data\n", "reg_name");
-	index = 0;
-	while (index < qmm_rsp->reg_num) {
-		printf("%-40s[0x%08X] : 0x%08X\n",
-		       index < arr_len ? reg_name[index] : "",
-		       qmm_rsp->qmm_content[index][0],
-		       qmm_rsp->qmm_content[index][1]);
-		index++;
+	for (bank = 0; bank < bank_num; bank++) {
+		for (index = 0; index < qmm_rsp[bank].reg_num; index++) {
+			if (bank_col)
+				printf("%-6u", bank);
+			printf("%-40s[0x%08X] : 0x%08X\n",
+			       index < arr_len ? reg_name[index] : "",
+			       qmm_rsp[bank].qmm_content[index][0],
+			       qmm_rsp[bank].qmm_content[index][1]);
+		}
 	}
 	printf("***************************************\n");
 }
@@ -244,28 +262,92 @@ static int hikp_roce_qmm_get_data(struct hikp_cmd_ret **cmd_ret,
 	return ret;
 }
 
-static void hikp_roce_qmm_execute_origin(struct major_cmd_ctrl *self)
+static int hikp_roce_qmm_read_origin(struct hikp_cmd_header *req_header,
+				     const struct roce_qmm_req_para_ext *req_data,
+				     struct roce_qmm_rsp_data *qmm_rsp)
 {
-	struct roce_qmm_rsp_data *roce_qmm_res;
 	struct hikp_cmd_ret *cmd_ret;
+	size_t rsp_size;
+	int ret;
 
-	self->err_no = hikp_roce_qmm_get_data(&cmd_ret, 0, NULL);
-	if (self->err_no) {
-		printf("hikptool roce_qmm get data failed.\n");
+	cmd_ret = hikp_cmd_alloc(req_header, req_data, sizeof(*req_data));
+	ret = hikp_rsp_normal_check(cmd_ret);
+	if (ret) {
+		printf("hikptool roce_qmm cmd_ret malloc failed, sub_cmd = %u, ret = %d.\n",
+		       g_roce_qmm_param.sub_cmd, ret);
 		goto exec_error;
 	}
 
-	roce_qmm_res = (struct roce_qmm_rsp_data *)cmd_ret->rsp_data;
-	if (roce_qmm_res->reg_num > ROCE_HIKP_QMM_REG_NUM) {
+	memset(qmm_rsp, 0, sizeof(*qmm_rsp));
+	rsp_size = HIKP_MIN(cmd_ret->rsp_data_num * sizeof(uint32_t), sizeof(*qmm_rsp));
+	memcpy(qmm_rsp, cmd_ret->rsp_data, rsp_size);
+	if (qmm_rsp->reg_num > ROCE_HIKP_QMM_REG_NUM) {
 		printf("version might not match, adjust the reg num to %d.\n",
 		       ROCE_HIKP_QMM_REG_NUM);
-		roce_qmm_res->reg_num = ROCE_HIKP_QMM_REG_NUM;
+		qmm_rsp->reg_num = ROCE_HIKP_QMM_REG_NUM;
 	}
 
-	hikp_roce_qmm_print(roce_qmm_res);
-
 exec_error:
 	hikp_cmd_free(&cmd_ret);
+	return ret;
+}
+
+static void hikp_roce_qmm_execute_origin(struct major_cmd_ctrl *self,
+					 struct roce_qmm_rsp_data *qmm_rsp,
+					 uint32_t first_bank, uint32_t bank_num)
+{
+	struct roce_qmm_req_para_ext req_data = { 0 };
+	struct hikp_cmd_header req_header = { 0 };
+	uint32_t bank;
+
+	req_data.origin_param.bdf = g_roce_qmm_param.target.bdf;
+	hikp_cmd_init(&req_header, ROCE_MOD, GET_ROCEE_QMM_CMD, g_roce_qmm_param.sub_cmd);
+	for (bank = 0; bank < bank_num; bank++) {
+		req_data.origin_param.bank_id = first_bank + bank;
+		self->err_no = hikp_roce_qmm_read_origin(&req_header, &req_data, &qmm_rsp[bank]);
+		if (self->err_no) {
+			printf("hikptool roce_qmm get data failed.\n");
+			return;
+		}
+	}
+
+	hikp_roce_qmm_print(qmm_rsp, bank_num, g_roce_qmm_param.bank_all);
+}
+
+static void hikp_roce_qmm_execute_ext(struct major_cmd_ctrl *self, uint32_t bank_num)
+{
+	struct roce_ext_res_output output[QMM_BANK_NUM + 1] = { 0 };
+	uint32_t bank;
+
+	if (!g_roce_qmm_param.bank_all) {
+		hikp_roce_ext_snap_target(&g_roce_qmm_param.target.bdf, g_roce_qmm_param.sub_cmd,
+					  g_roce_qmm_param.bank_id);
+		hikp_roce_ext_execute(self, GET_ROCEE_QMM_CMD, hikp_roce_qmm_get_data);
+		return;
+	}
+
+	for (bank = 0; bank < bank_num; bank++) {
+		g_roce_qmm_param.bank_id = bank;
+		self->err_no = hikp_roce_ext_fetch(GET_ROCEE_QMM_CMD, hikp_roce_qmm_get_data,
+						   &output[bank]);
+		if (self->err_no)
+			goto free_output;
+	}
+
+	if (!hikp_roce_ext_snap_active()) {
+		hikp_roce_ext_print_banks(GET_ROCEE_QMM_CMD, output, bank_num);
+		goto free_output;
+	}
+	/* Each bank is its own snapshot table */
+	for (bank = 0; bank < bank_num && self->err_no == 0; bank++) {
+		hikp_roce_ext_snap_target(&g_roce_qmm_param.target.bdf, g_roce_qmm_param.sub_cmd,
+					  bank);
+		self->err_no = hikp_roce_ext_output_show(GET_ROCEE_QMM_CMD, &output[bank]);
+	}
+
+free_output:
+	for (bank = 0; bank < bank_num; bank++)
+		hikp_roce_ext_output_free(&output[bank]);
 }
 
 void hikp_roce_qmm_execute(struct major_cmd_ctrl *self)
@@ -279,16 +361,31 @@ void hikp_roce_qmm_execute(struct major_cmd_ctrl *self)
 		{QMM_SHOW_QPC, QMM_SHOW_QPC_EXT, "QPC"},
 		{QMM_SHOW_TOP, QMM_SHOW_TOP_EXT, "TOP"},
 	};
+	uint32_t bank_num = g_roce_qmm_param.bank_all ? QMM_BANK_NUM + 1 : 1;
+	uint32_t first_bank = g_roce_qmm_param.bank_all ? 0 : g_roce_qmm_param.bank_id;
+	struct roce_qmm_rsp_data *qmm_rsp = NULL;
+
+	if (!g_roce_qmm_param.ext_flag) {
+		if (hikp_roce_ext_snap_need_ext(self))
+			return;
+		/* One arena reused by every sub command and bank */
+		qmm_rsp = (struct roce_qmm_rsp_data *)calloc(bank_num, sizeof(*qmm_rsp));
+		if (qmm_rsp == NULL) {
+			self->err_no = -ENOMEM;
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "alloc roce_qmm bank data failed.");
+			return;
+		}
+	}
 
 	for (size_t i = 0; i < HIKP_ARRAY_SIZE(sub_cmd_info_table); i++) {
 		g_roce_qmm_param.sub_name = sub_cmd_info_table[i].sub_name;
 		if (g_roce_qmm_param.ext_flag) {
 			g_roce_qmm_param.sub_cmd = sub_cmd_info_table[i].sub_ext_cmd;
-			hikp_roce_ext_execute(self, GET_ROCEE_QMM_CMD,
-					      hikp_roce_qmm_get_data);
+			hikp_roce_qmm_execute_ext(self, bank_num);
 		} else {
 			g_roce_qmm_param.sub_cmd = sub_cmd_info_table[i].sub_cmd;
-			hikp_roce_qmm_execute_origin(self);
+			hikp_roce_qmm_execute_origin(self, qmm_rsp, first_bank, bank_num);
 		}
 		if (self->err_no) {
 			snprintf(self->err_str, sizeof(self->err_str),
@@ -297,6 +394,7 @@ void hikp_roce_qmm_execute(struct major_cmd_ctrl *self)
 			break;
 		}
 	}
+	free(qmm_rsp);
 }
 
 static int hikp_roce_qmm_ext_set(struct major_cmd_ctrl *self, const char *argv)
@@ -320,6 +418,7 @@ static void cmd_roce_qmm_init(void)
 	cmd_option_register("-i", "--interface", true, hikp_roce_qmm_target);
 	cmd_option_register("-b", "--bank", true, hikp_roce_qmm_bank_get);
 	cmd_option_register("-e", "--extend", false, hikp_roce_qmm_ext_set);
+	hikp_roce_ext_snap_register();
 }
 
 HIKP_CMD_DECLARE("roce_qmm", "get roce_qmm registers information", cmd_roce_qmm_init);
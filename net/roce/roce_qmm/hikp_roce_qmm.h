@@ -25,6 +25,7 @@ struct cmd_roce_qmm_param_t {
 	uint32_t sub_cmd;
 	const char *sub_name;
 	bool ext_flag;
+	bool bank_all;
 };
 
 struct roce_qmm_rsp_data {
@@ -54,6 +55,7 @@ enum roce_qmm_cmd_type {
 int hikp_roce_set_qmm_bdf(char *nic_name);
 void hikp_roce_set_qmm_ext_flag(bool ext_flag);
 void hikp_roce_set_qmm_bankid(uint32_t bank_id);
+void hikp_roce_set_qmm_bank_all(bool bank_all);
 void hikp_roce_qmm_execute(struct major_cmd_ctrl *self);
 
 #endif /* HIKP_ROCE_QMM_H */
@@ -54,6 +54,7 @@ static int hikp_roce_scc_help(struct major_cmd_ctrl *self, const char *argv)
 	       "[Only Work for COMMON]clear param count registers");
 	printf("    %s, %-25s %s\n", "-v", "--verbose=<verbose>",
 	       "[Only Work for CFG]see more information");
+	hikp_roce_ext_rate_help();
 	printf("\n");
 
 	return 0;
@@ -370,27 +371,33 @@ static void hikp_roce_scc_parse(const uint32_t *reg_arr, uint8_t reg_len, uint32
 				g_scc_parse_info[parse_id].shift_offset;
 }
 
-static void hikp_roce_scc_print(uint8_t total_block_num,
-				const uint32_t *offset, const uint32_t *data)
+static int hikp_roce_scc_reg_name_get(const char ***reg_name, uint8_t *arr_len)
 {
-	uint32_t parse_data[MAX_PARSE_NUM] = {0};
-	const char **reg_name;
-	uint8_t arr_len;
 	uint32_t i;
 
 	for (i = 0; i < HIKP_ARRAY_SIZE(g_scc_reg_name_info_table); i++) {
 		if (g_scc_reg_name_info_table[i].sub_cmd != g_roce_scc_param_t.sub_cmd)
 			continue;
-		arr_len = g_scc_reg_name_info_table[i].arr_len;
-		reg_name = g_scc_reg_name_info_table[i].reg_name;
-		break;
+		*arr_len = g_scc_reg_name_info_table[i].arr_len;
+		*reg_name = g_scc_reg_name_info_table[i].reg_name;
+		return 0;
 	}
 
-	if (i == HIKP_ARRAY_SIZE(g_scc_reg_name_info_table)) {
-		printf("can't find reg name table for roce_scc sub_cmd %u.\n",
-		       g_roce_scc_param_t.sub_cmd);
+	printf("can't find reg name table for roce_scc sub_cmd %u.\n",
+	       g_roce_scc_param_t.sub_cmd);
+	return -ENOENT;
+}
+
+static void hikp_roce_scc_print(uint8_t total_block_num,
+				const uint32_t *offset, const uint32_t *data)
+{
+	uint32_t parse_data[MAX_PARSE_NUM] = {0};
+	const char **reg_name;
+	uint8_t arr_len;
+	uint32_t i;
+
+	if (hikp_roce_scc_reg_name_get(&reg_name, &arr_len))
 		return;
-	}
 
 	printf("**************SCC INFO*************\n");
 	printf("%-40s[addr_offset] : reg_data\n", "reg_name");
@@ -408,55 +415,99 @@ static void hikp_roce_scc_print(uint8_t total_block_num,
 	printf("***********************************\n");
 }
 
-void hikp_roce_scc_execute(struct major_cmd_ctrl *self)
+/* Walk every block of the selected module into one offset/data array pair. */
+static int hikp_roce_scc_fetch(uint8_t *total_block_num, uint32_t **offset_start,
+			       uint32_t **data_start)
 {
 	struct roce_scc_head res_head;
-	uint32_t *offset_start = NULL;
-	uint32_t *data_start = NULL;
-	uint8_t total_block_num;
 	uint32_t *offset = NULL;
 	uint32_t *data = NULL;
-	uint32_t block_id;
+	uint32_t block_id = 0;
 	size_t data_size;
 	uint32_t times;
 	uint32_t i;
+	int ret;
 
-	block_id = 0;
-	if (g_roce_scc_param_t.reset_flag) {
-		self->err_no = hikp_roce_scc_clear_module_check();
-		if (self->err_no) {
-			snprintf(self->err_str, sizeof(self->err_str),
-				 "roce_scc clear function module selection error.");
-			return;
-		}
-	}
-	self->err_no = hikp_roce_scc_get_total_data_num(&res_head, &offset, &data, &block_id);
-	if (self->err_no) {
-		snprintf(self->err_str, sizeof(self->err_str),
-			 "get the first roce_scc block dfx fail.");
+	ret = hikp_roce_scc_get_total_data_num(&res_head, &offset, &data, &block_id);
+	if (ret) {
+		printf("get the first roce_scc block dfx fail.\n");
 		hikp_roce_scc_reg_data_free(&offset, &data);
-		return;
+		return ret;
 	}
-	total_block_num = res_head.total_block_num;
+	*total_block_num = res_head.total_block_num;
 	res_head.total_block_num = res_head.total_block_num - res_head.cur_block_num;
-	offset_start = offset;
-	data_start = data;
+	*offset_start = offset;
+	*data_start = data;
 	if (res_head.total_block_num) {
 		times = res_head.total_block_num / ROCE_HIKP_SCC_REG_NUM + 1;
 		for (i = 0; i < times; i++) {
 			offset = offset + res_head.cur_block_num;
 			data = data + res_head.cur_block_num;
 			data_size = res_head.total_block_num * sizeof(uint32_t);
-			self->err_no = hikp_roce_scc_get_next_data(&res_head, &offset,
-								   &data, &block_id, data_size);
-			if (self->err_no) {
-				snprintf(self->err_str, sizeof(self->err_str),
-					 "get multiple roce_scc block dfx fail.");
-				hikp_roce_scc_reg_data_free(&offset_start, &data_start);
-				return;
+			ret = hikp_roce_scc_get_next_data(&res_head, &offset,
+							  &data, &block_id, data_size);
+			if (ret) {
+				printf("get multiple roce_scc block dfx fail.\n");
+				hikp_roce_scc_reg_data_free(offset_start, data_start);
+				return ret;
 			}
 		}
 	}
+
+	return 0;
+}
+
+static int hikp_roce_scc_rate_fetch(struct roce_ext_res_output *output)
+{
+	uint8_t total_block_num;
+	int ret;
+
+	ret = hikp_roce_scc_fetch(&total_block_num, &output->reg.offset, &output->reg.data_u32);
+	if (ret)
+		return ret;
+
+	output->res_head.total_block_num = total_block_num;
+	output->per_val_size = sizeof(uint32_t);
+	if (hikp_roce_scc_reg_name_get(&output->reg_name.reg_name, &output->reg_name.arr_len))
+		output->reg_name.arr_len = 0;
+
+	return 0;
+}
+
+void hikp_roce_scc_execute(struct major_cmd_ctrl *self)
+{
+	uint32_t *offset_start = NULL;
+	uint32_t *data_start = NULL;
+	uint8_t total_block_num;
+
+	if (g_roce_scc_param_t.reset_flag) {
+		self->err_no = hikp_roce_scc_clear_module_check();
+		if (self->err_no) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "roce_scc clear function module selection error.");
+			return;
+		}
+	}
+
+	if (hikp_roce_ext_rate_active()) {
+		if (g_roce_scc_param_t.reset_flag) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "-r/--rate can not be used with -c/--clear.");
+			self->err_no = -EINVAL;
+			return;
+		}
+		self->err_no = hikp_roce_ext_rate(GET_ROCEE_SCC_CMD, hikp_roce_scc_rate_fetch);
+		if (self->err_no)
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "roce_scc rate sample failed.");
+		return;
+	}
+
+	self->err_no = hikp_roce_scc_fetch(&total_block_num, &offset_start, &data_start);
+	if (self->err_no) {
+		snprintf(self->err_str, sizeof(self->err_str), "get roce_scc block dfx fail.");
+		return;
+	}
 	hikp_roce_scc_print(total_block_num, offset_start, data_start);
 	hikp_roce_scc_reg_data_free(&offset_start, &data_start);
 }
@@ -471,8 +522,9 @@ static void cmd_roce_scc_init(void)
 	cmd_option_register("-h", "--help", false, hikp_roce_scc_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_scc_target);
 	cmd_option_register("-m", "--module", true, hikp_roce_scc_module_select);
-	cmd_option_register("-c", "--clear", false, hikp_roce_scc_clear_set);
+	cmd_writer_option_register("-c", "--clear", false, hikp_roce_scc_clear_set);
 	cmd_option_register("-v", "--verbose", false, hikp_roce_scc_verbose_set);
+	hikp_roce_ext_rate_register();
 }
 
 HIKP_CMD_DECLARE("roce_scc", "get or clear roce_scc registers information", cmd_roce_scc_init);
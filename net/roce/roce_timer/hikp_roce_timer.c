@@ -250,7 +250,7 @@ static void cmd_roce_timer_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_roce_timer_help);
 	cmd_option_register("-i", "--interface", true, hikp_roce_timer_target);
-	cmd_option_register("-c", "--clear", false, hikp_roce_timer_clear_set);
+	cmd_writer_option_register("-c", "--clear", false, hikp_roce_timer_clear_set);
 }
 
 HIKP_CMD_DECLARE("roce_timer", "get or clear roce_timer registers information",
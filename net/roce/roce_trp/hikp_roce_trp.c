@@ -32,6 +32,12 @@ void hikp_roce_set_trp_bankid(uint32_t bank_id)
 	g_roce_trp_param_t.bank_id = bank_id;
 }
 
+void hikp_roce_set_trp_bank_all(bool bank_all)
+{
+	g_roce_trp_param_t.bank_enter_flag = bank_all;
+	g_roce_trp_param_t.bank_all = bank_all;
+}
+
 void hikp_roce_set_trp_submodule(uint32_t module)
 {
 	g_roce_trp_param_t.sub_cmd = module;
@@ -49,7 +55,7 @@ static int hikp_roce_trp_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-m", "--module=<module>",
 	       "this is necessary param COMMON/TRP_RX/GEN_AC/PAYL");
 	printf("    %s, %-25s %s\n", "-b", "--bank=<bank>",
-	       "[option]set which bank to read. (default 0) "
+	       "[option]set which bank to read, or all. (default 0) "
 	       "COMMON : 0~3\n PAYL: 0~1\n GEN_AC : 0~3\n ");
 	printf("\n");
 
@@ -90,31 +96,34 @@ static int hikp_roce_trp_bank_get(struct major_cmd_ctrl *self, const char *argv)
 {
 	uint32_t temp;
 
+	g_roce_trp_param_t.bank_enter_flag = 1;
+	if (strcmp(argv, "all") == 0) {
+		g_roce_trp_param_t.bank_all = true;
+		return 0;
+	}
+
 	self->err_no = string_toui(argv, &temp);
 	if (self->err_no) {
 		snprintf(self->err_str, sizeof(self->err_str), "get roce_trp bank param failed.");
 		return self->err_no;
 	}
 
-	g_roce_trp_param_t.bank_enter_flag = 1;
+	g_roce_trp_param_t.bank_all = false;
 	g_roce_trp_param_t.bank_id = temp;
 	return 0;
 }
 
-static int hikp_roce_trp_bank_check(void)
+static int hikp_roce_trp_bank_max(uint32_t sub_cmd, uint32_t *bank_max)
 {
-	switch (g_roce_trp_param_t.sub_cmd) {
+	switch (sub_cmd) {
 	case (TRP_COMMON):
-		if (g_roce_trp_param_t.bank_id > TRP_MAX_BANK_NUM)
-			return -EINVAL;
+		*bank_max = TRP_MAX_BANK_NUM;
 		break;
 	case (PAYL):
-		if (g_roce_trp_param_t.bank_id > PAYL_MAX_BANK_NUM)
-			return -EINVAL;
+		*bank_max = PAYL_MAX_BANK_NUM;
 		break;
 	case (GEN_AC):
-		if (g_roce_trp_param_t.bank_id > GAC_MAX_BANK_NUM)
-			return -EINVAL;
+		*bank_max = GAC_MAX_BANK_NUM;
 		break;
 	default:
 		return -EINVAL;
@@ -123,129 +132,75 @@ static int hikp_roce_trp_bank_check(void)
 	return 0;
 }
 
-static int hikp_roce_trp_get_data(struct hikp_cmd_ret **cmd_ret, const uint32_t *block_id)
-{
-	struct roce_trp_req_param req_data = { 0 };
-	struct hikp_cmd_header req_header = { 0 };
-	int ret;
-
-	req_data.block_id = *block_id;
-	req_data.bdf = g_roce_trp_param_t.target.bdf;
-	req_data.bank_id = g_roce_trp_param_t.bank_id;
-	if (g_roce_trp_param_t.sub_cmd == 0) {
-		printf("please enter module name: -m/--modlue\n");
-		return -EINVAL;
-	}
-	hikp_cmd_init(&req_header, ROCE_MOD, GET_ROCEE_TRP_CMD, g_roce_trp_param_t.sub_cmd);
-	*cmd_ret = hikp_cmd_alloc(&req_header, &req_data, sizeof(req_data));
-	ret = hikp_rsp_normal_check(*cmd_ret);
-	if (ret) {
-		printf("hikptool roce_trp get cmd data failed, ret: %d\n", ret);
-		hikp_cmd_free(cmd_ret);
-	}
-
-	return ret;
-}
-
-static void hikp_roce_trp_reg_data_free(uint32_t **offset, uint32_t **data)
-{
-	if (*offset) {
-		free(*offset);
-		*offset = NULL;
-	}
-	if (*data) {
-		free(*data);
-		*data = NULL;
-	}
-}
-
-static int hikp_roce_trp_get_total_data_num(struct roce_trp_head *res_head,
-					    uint32_t **offset, uint32_t **data, uint32_t *block_id)
+static int hikp_roce_trp_bank_check(void)
 {
-	struct roce_trp_res_param *roce_trp_res;
-	struct hikp_cmd_ret *cmd_ret = NULL;
-	size_t max_size;
-	size_t cur_size;
+	uint32_t bank_max;
 	int ret;
 
-	ret = hikp_roce_trp_get_data(&cmd_ret, block_id);
-	if (ret) {
-		printf("hikptool roce_trp get total data failed\n");
+	ret = hikp_roce_trp_bank_max(g_roce_trp_param_t.sub_cmd, &bank_max);
+	if (ret)
 		return ret;
-	}
 
-	roce_trp_res = (struct roce_trp_res_param *)cmd_ret->rsp_data;
-	if (!roce_trp_res->head.total_block_num) {
-		printf("hikptool roce_trp total_block_num error!\n");
-		ret = -EINVAL;
-		goto get_data_error;
-	}
-
-	max_size = roce_trp_res->head.total_block_num * sizeof(uint32_t);
-	*offset = (uint32_t *)calloc(1, max_size);
-	*data = (uint32_t *)calloc(1, max_size);
-	if ((*offset == NULL) || (*data == NULL)) {
-		printf("hikptool roce_trp alloc log memory 0x%zx failed\n", max_size);
-		hikp_roce_trp_reg_data_free(offset, data);
-		ret = -ENOMEM;
-		goto get_data_error;
-	}
-
-	cur_size = roce_trp_res->head.cur_block_num * sizeof(uint32_t);
-	if (cur_size > max_size || roce_trp_res->head.cur_block_num > ROCE_HIKP_TRP_REG_NUM) {
-		printf("hikptool roce_trp log data copy size error, "
-		       "data size: 0x%zx, max size: 0x%zx, block_num: 0x%x\n",
-		       cur_size, max_size, roce_trp_res->head.cur_block_num);
-		hikp_roce_trp_reg_data_free(offset, data);
-		ret = -EINVAL;
-		goto get_data_error;
-	}
-	memcpy(*offset, roce_trp_res->reg_data.offset, cur_size);
-	memcpy(*data, roce_trp_res->reg_data.data, cur_size);
-
-	*res_head = roce_trp_res->head;
-	*block_id = roce_trp_res->block_id;
-	ret = 0;
+	if (!g_roce_trp_param_t.bank_all && g_roce_trp_param_t.bank_id > bank_max)
+		return -EINVAL;
 
-get_data_error:
-	hikp_cmd_free(&cmd_ret);
-	return ret;
+	return 0;
 }
 
-static int hikp_roce_trp_get_next_data(struct roce_trp_head *res_head,
-				       uint32_t **offset, uint32_t **data,
-				       uint32_t *block_id, size_t data_size)
+/*
+ * Walk the register blocks of the bank in req->bank_id into regs. The
+ * header is built once by the caller and reused for every block and bank.
+ */
+static int hikp_roce_trp_read_bank(struct hikp_cmd_header *req_header,
+				   struct roce_trp_req_param *req_data,
+				   struct roce_trp_bank_regs *regs)
 {
 	struct roce_trp_res_param *roce_trp_res;
-	struct hikp_cmd_ret *cmd_ret = NULL;
-	size_t cur_size;
+	struct hikp_cmd_ret *cmd_ret;
+	uint32_t total = 0;
+	uint32_t got = 0;
+	uint32_t cur;
 	int ret;
 
-	ret = hikp_roce_trp_get_data(&cmd_ret, block_id);
-	if (ret) {
-		printf("hikptool roce_trp get next data failed\n");
-		return ret;
-	}
+	req_data->block_id = 0;
+	do {
+		cmd_ret = hikp_cmd_alloc(req_header, req_data, sizeof(*req_data));
+		ret = hikp_rsp_normal_check(cmd_ret);
+		if (ret) {
+			printf("hikptool roce_trp get cmd data failed, ret: %d\n", ret);
+			goto free_cmd_ret;
+		}
 
-	roce_trp_res = (struct roce_trp_res_param *)cmd_ret->rsp_data;
-	cur_size = roce_trp_res->head.cur_block_num * sizeof(uint32_t);
+		roce_trp_res = (struct roce_trp_res_param *)cmd_ret->rsp_data;
+		if (got == 0) {
+			total = roce_trp_res->head.total_block_num;
+			if (!total) {
+				printf("hikptool roce_trp total_block_num error!\n");
+				ret = -EINVAL;
+				goto free_cmd_ret;
+			}
+		}
 
-	if (cur_size > data_size  || roce_trp_res->head.cur_block_num > ROCE_HIKP_TRP_REG_NUM) {
-		printf("hikptool roce_trp next log data copy size error, "
-		       "data size: 0x%zx, max size: 0x%zx, block_num: 0x%x\n",
-		       cur_size, data_size, roce_trp_res->head.cur_block_num);
+		cur = roce_trp_res->head.cur_block_num;
+		if (!cur || cur > ROCE_HIKP_TRP_REG_NUM || cur > total - got) {
+			printf("hikptool roce_trp log data copy size error, "
+			       "block_num: 0x%x, total: 0x%x, got: 0x%x\n", cur, total, got);
+			ret = -EINVAL;
+			goto free_cmd_ret;
+		}
+		memcpy(regs->offset + got, roce_trp_res->reg_data.offset, cur * sizeof(uint32_t));
+		memcpy(regs->data + got, roce_trp_res->reg_data.data, cur * sizeof(uint32_t));
+		got += cur;
+		req_data->block_id = roce_trp_res->block_id;
 		hikp_cmd_free(&cmd_ret);
-		return -EINVAL;
-	}
-	memcpy(*offset, roce_trp_res->reg_data.offset, cur_size);
-	memcpy(*data, roce_trp_res->reg_data.data, cur_size);
-
-	*block_id = roce_trp_res->block_id;
-	res_head->cur_block_num = roce_trp_res->head.cur_block_num;
-	res_head->total_block_num = res_head->total_block_num - roce_trp_res->head.cur_block_num;
-	hikp_cmd_free(&cmd_ret);
+	} while (got < total);
 
+	regs->reg_num = total;
 	return 0;
+
+free_cmd_ret:
+	hikp_cmd_free(&cmd_ret);
+	return ret;
 }
 
 /* DON'T change the order of these arrays or add entries between! */
@@ -367,11 +322,12 @@ static const struct reg_name_info {
 	{PAYL, g_trp_payl_reg_name, HIKP_ARRAY_SIZE(g_trp_payl_reg_name)},
 };
 
-static void hikp_roce_trp_print(uint8_t total_block_num,
-				const uint32_t *offset, const uint32_t *data)
+static void hikp_roce_trp_print(const struct roce_trp_bank_regs *regs, uint32_t bank_num,
+				bool bank_col)
 {
 	const char **reg_name;
 	uint8_t arr_len;
+	uint32_t bank;
 	uint32_t i;
 
 	for (i = 0; i < HIKP_ARRAY_SIZE(g_trp_reg_name_info_table); i++) {
@@ -389,28 +345,38 @@ static void hikp_roce_trp_print(uint8_t total_block_num,
 	}
 
 	printf("**************TRP INFO*************\n");
+	if (bank_col)
+		printf("%-6s", "bank");
 	printf("%-40s[addr_offset] : reg_data\n", "reg_name");
-	for (i = 0; i < total_block_num; i++)
-		printf("%-40s[0x%08X] : 0x%08X\n",
-		       i < arr_len ? reg_name[i] : "",
-		       offset[i], data[i]);
+	for (bank = 0; bank < bank_num; bank++) {
+		for (i = 0; i < regs[bank].reg_num; i++) {
+			if (bank_col)
+				printf("%-6u", bank);
+			printf("%-40s[0x%08X] : 0x%08X\n",
+			       i < arr_len ? reg_name[i] : "",
+			       regs[bank].offset[i], regs[bank].data[i]);
+		}
+	}
 	printf("***********************************\n");
 }
 
 void hikp_roce_trp_execute(struct major_cmd_ctrl *self)
 {
-	struct roce_trp_head res_head;
-	uint32_t *offset_start = NULL;
-	uint32_t *data_start = NULL;
-	uint8_t total_block_num;
-	uint32_t *offset = NULL;
-	uint32_t *data = NULL;
-	uint32_t block_id;
-	size_t data_size;
-	uint32_t times;
-	uint32_t i;
+	struct roce_trp_req_param req_data = { 0 };
+	struct hikp_cmd_header req_header = { 0 };
+	struct roce_trp_bank_regs *regs;
+	uint32_t first_bank = 0;
+	uint32_t bank_num = 1;
+	uint32_t bank_max = 0;
+	uint32_t bank;
 
-	block_id = 0;
+	if (g_roce_trp_param_t.sub_cmd == 0) {
+		printf("please enter module name: -m/--modlue\n");
+		self->err_no = -EINVAL;
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "get the first roce_trp block dfx fail.");
+		return;
+	}
 	if (g_roce_trp_param_t.bank_enter_flag) {
 		self->err_no = hikp_roce_trp_bank_check();
 		if (self->err_no) {
@@ -418,34 +384,38 @@ void hikp_roce_trp_execute(struct major_cmd_ctrl *self)
 			return;
 		}
 	}
-	self->err_no = hikp_roce_trp_get_total_data_num(&res_head, &offset, &data, &block_id);
-	if (self->err_no) {
+	if (g_roce_trp_param_t.bank_all) {
+		/* bank_check above has validated the module */
+		(void)hikp_roce_trp_bank_max(g_roce_trp_param_t.sub_cmd, &bank_max);
+		bank_num = bank_max + 1;
+	} else {
+		first_bank = g_roce_trp_param_t.bank_id;
+	}
+
+	/* One arena for every bank instead of two callocs per bank */
+	regs = (struct roce_trp_bank_regs *)calloc(bank_num, sizeof(*regs));
+	if (regs == NULL) {
+		self->err_no = -ENOMEM;
 		snprintf(self->err_str, sizeof(self->err_str),
-			 "get the first roce_trp block dfx fail.");
+			 "alloc roce_trp bank data failed.");
 		return;
 	}
-	total_block_num = res_head.total_block_num;
-	res_head.total_block_num = res_head.total_block_num - res_head.cur_block_num;
-	offset_start = offset;
-	data_start = data;
-	if (res_head.total_block_num) {
-		times = res_head.total_block_num / ROCE_HIKP_TRP_REG_NUM + 1;
-		for (i = 0; i < times; i++) {
-			offset = offset + res_head.cur_block_num;
-			data = data + res_head.cur_block_num;
-			data_size = res_head.total_block_num * sizeof(uint32_t);
-			self->err_no = hikp_roce_trp_get_next_data(&res_head, &offset,
-								   &data, &block_id, data_size);
-			if (self->err_no) {
-				snprintf(self->err_str, sizeof(self->err_str),
-					 "get multiple roce_trp block dfx fail.");
-				hikp_roce_trp_reg_data_free(&offset_start, &data_start);
-				return;
-			}
+
+	req_data.bdf = g_roce_trp_param_t.target.bdf;
+	hikp_cmd_init(&req_header, ROCE_MOD, GET_ROCEE_TRP_CMD, g_roce_trp_param_t.sub_cmd);
+	for (bank = 0; bank < bank_num; bank++) {
+		req_data.bank_id = first_bank + bank;
+		self->err_no = hikp_roce_trp_read_bank(&req_header, &req_data, &regs[bank]);
+		if (self->err_no) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "get roce_trp bank %u block dfx fail.", req_data.bank_id);
+			goto free_regs;
 		}
 	}
-	hikp_roce_trp_print(total_block_num, offset_start, data_start);
-	hikp_roce_trp_reg_data_free(&offset_start, &data_start);
+	hikp_roce_trp_print(regs, bank_num, g_roce_trp_param_t.bank_all);
+
+free_regs:
+	free(regs);
 }
 
 static void cmd_roce_trp_init(void)
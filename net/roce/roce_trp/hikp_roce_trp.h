@@ -38,6 +38,7 @@ struct cmd_roce_trp_param_t {
 	uint32_t sub_cmd;
 	uint32_t bank_id;
 	uint8_t bank_enter_flag;
+	bool bank_all;
 	struct tool_target target;
 };
 
@@ -58,6 +59,15 @@ struct roce_trp_res_param {
 	struct roce_trp_res reg_data;
 };
 
+/* total_block_num is a u8, so one bank has at most UINT8_MAX registers */
+#define ROCE_TRP_BANK_MAX_REG UINT8_MAX
+
+struct roce_trp_bank_regs {
+	uint32_t reg_num;
+	uint32_t offset[ROCE_TRP_BANK_MAX_REG];
+	uint32_t data[ROCE_TRP_BANK_MAX_REG];
+};
+
 struct roce_trp_module {
 	uint8_t module_name[MAX_TRP_MODULE_NAME_LEN];
 	uint32_t sub_cmd_code;
@@ -72,6 +82,7 @@ enum roce_trp_type {
 
 void hikp_roce_set_trp_submodule(uint32_t module);
 void hikp_roce_set_trp_bankid(uint32_t bank_id);
+void hikp_roce_set_trp_bank_all(bool bank_all);
 int hikp_roce_set_trp_bdf(char *nic_name);
 void hikp_roce_trp_execute(struct major_cmd_ctrl *self);
 
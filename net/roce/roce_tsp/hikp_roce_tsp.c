@@ -312,7 +312,7 @@ static void cmd_roce_tsp_init(void)
 	cmd_option_register("-i", "--interface", true, hikp_roce_tsp_target);
 	cmd_option_register("-m", "--module", true, hikp_roce_tsp_module_select);
 	cmd_option_register("-b", "--bank", true, hikp_roce_tsp_bank_get);
-	cmd_option_register("-c", "--clear", false, hikp_roce_tsp_clear_set);
+	cmd_writer_option_register("-c", "--clear", false, hikp_roce_tsp_clear_set);
 }
 
 HIKP_CMD_DECLARE("roce_tsp", "get or clear roce_tsp registers information", cmd_roce_tsp_init);
@@ -11,6 +11,7 @@
  * See the Mulan PSL v2 for more details.
  */
 
+#include <inttypes.h>
 #include "tool_cmd.h"
 #include "hikp_net_lib.h"
 #include "hikpt_rciep.h"
@@ -31,6 +32,10 @@ static const struct dfx_type_parse g_dfx_type_parse[] = {
 	{TYPE_64_STATS, WIDTH_64_BIT, "64 bit statistics"},
 };
 
+/* position + 1 of each type_id in g_dfx_type_parse, 0 if the type is unknown */
+static uint8_t g_dfx_type_idx[UB_DFX_TYPE_ID_NUM];
+static bool g_dfx_type_idx_built;
+
 static void dfx_help_info(const struct major_cmd_ctrl *self)
 {
 	printf("\n  Usage: %s %s\n", self->cmd_ptr->name, "-i <interface>\n");
@@ -39,6 +44,10 @@ static void dfx_help_info(const struct major_cmd_ctrl *self)
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>",
 	       "device target or bdf id, e.g. ubn0 or 0000:35:00.0");
+	printf("    %s, %-25s %s\n", "-t", "--interval=<seconds>",
+	       "sample every interval and show changed registers with rates");
+	printf("    %s, %-25s %s\n", "-n", "--count=<num>",
+	       "number of sample intervals, default 0 means until interrupted");
 	printf("    %s\n", "	[-m/--module LRB/PFA/PM] : this is necessary param\n");
 }
 
@@ -182,29 +191,32 @@ err_out:
 	return ret;
 }
 
-static bool is_type_found(uint16_t type_id, uint32_t *index)
+static const struct dfx_type_parse *hikp_ub_dfx_get_type(uint8_t type_id)
 {
 	size_t arr_size = HIKP_ARRAY_SIZE(g_dfx_type_parse);
 	size_t i;
 
-	for (i = 0; i < arr_size; i++) {
-		if (g_dfx_type_parse[i].type_id == type_id) {
-			*index = i;
-			return true;
-		}
+	if (!g_dfx_type_idx_built) {
+		for (i = arr_size; i > 0; i--)
+			g_dfx_type_idx[g_dfx_type_parse[i - 1].type_id] = (uint8_t)i;
+		g_dfx_type_idx_built = true;
 	}
 
-	return false;
+	if (g_dfx_type_idx[type_id] == 0)
+		return NULL;
+
+	return &g_dfx_type_parse[g_dfx_type_idx[type_id] - 1];
 }
 
 static void hikp_ub_dfx_print_type_head(uint8_t type_id, uint8_t *last_type_id)
 {
-	uint32_t index = 0;
+	const struct dfx_type_parse *type;
 
 	if (type_id != *last_type_id) {
 		printf("-----------------------------------------------------\n");
-		if (is_type_found(type_id, &index))
-			printf("type name: %s\n\n", g_dfx_type_parse[index].type_name);
+		type = hikp_ub_dfx_get_type(type_id);
+		if (type != NULL)
+			printf("type name: %s\n\n", type->type_name);
 		else
 			HIKP_WARN_PRINT("type name: unknown type, type id is %hhu\n\n", type_id);
 
@@ -274,48 +286,256 @@ static void hikp_ub_dfx_print(const struct ub_dfx_rsp_head *rsp_head, uint32_t *
 	printf("################### ====== dump end ====== ######################\n");
 }
 
-static void hikp_ub_dfx_execute(struct major_cmd_ctrl *self)
+/* Walk all blocks of the module, reg_data is allocated on success. */
+static int hikp_ub_dfx_fetch(struct major_cmd_ctrl *self, struct ub_dfx_rsp_head *rsp_head,
+			     uint32_t **reg_data, uint32_t *real_reg_size, uint32_t *version)
 {
-	struct ub_dfx_rsp_head rsp_head = { 0 };
 	struct ub_dfx_rsp_head tmp_head = { 0 };
-	uint32_t *reg_data = NULL;
 	uint32_t max_dfx_size = 0;
-	uint32_t real_reg_size;
-	uint32_t version;
 	uint32_t i;
 
-	if (!(g_ub_dfx_param.flag & MODULE_SET_FLAG)) {
-		self->err_no = -EINVAL;
-		snprintf(self->err_str, sizeof(self->err_str), "Please specify a module.");
-		dfx_help_info(self);
-		return;
-	}
-
-	self->err_no = hikp_ub_get_first_blk_dfx(&rsp_head, &reg_data, &max_dfx_size, &version);
+	*reg_data = NULL;
+	self->err_no = hikp_ub_get_first_blk_dfx(rsp_head, reg_data, &max_dfx_size, version);
 	if (self->err_no != 0) {
 		snprintf(self->err_str, sizeof(self->err_str), "get the first block dfx fail.");
-		return;
+		return self->err_no;
 	}
-	real_reg_size = (uint32_t)rsp_head.cur_blk_size;
-	for (i = 1; i < rsp_head.total_blk_num; i++) {
+	*real_reg_size = (uint32_t)rsp_head->cur_blk_size;
+	for (i = 1; i < rsp_head->total_blk_num; i++) {
 		self->err_no = hikp_ub_get_blk_dfx(&tmp_head, i,
-						   reg_data + (real_reg_size / sizeof(uint32_t)),
+						   *reg_data + (*real_reg_size / sizeof(uint32_t)),
 						   &max_dfx_size);
 		if (self->err_no != 0) {
 			snprintf(self->err_str, sizeof(self->err_str),
 				"getting block%u reg fail.", i);
-			free(reg_data);
-			return;
+			free(*reg_data);
+			*reg_data = NULL;
+			return self->err_no;
 		}
-		real_reg_size += (uint32_t)tmp_head.cur_blk_size;
+		*real_reg_size += (uint32_t)tmp_head.cur_blk_size;
 		memset(&tmp_head, 0, sizeof(struct ub_dfx_rsp_head));
 	}
 
+	return 0;
+}
+
+static uint64_t hikp_ub_dfx_get_reg(const uint32_t *reg, uint8_t bit_width, uint16_t *offset)
+{
+	*offset = (uint16_t)HI_GET_BITFIELD(reg[0], 0, DFX_REG_ADDR_MASK);
+	if (bit_width == WIDTH_32_BIT)
+		return reg[1];
+
+	return (uint64_t)reg[1] | (HI_GET_BITFIELD((uint64_t)reg[0], DFX_REG_VALUE_OFF,
+				   DFX_REG_VALUE_MASK) << BIT_NUM_OF_WORD);
+}
+
+static uint32_t hikp_ub_dfx_delta_type(const struct ub_dfx_type_head *type_head,
+				       const uint32_t *old_reg, const uint32_t *new_reg,
+				       double interval)
+{
+	uint32_t num = (uint32_t)type_head->reg_num;
+	uint64_t old_val, new_val, delta;
+	uint32_t changed = 0;
+	uint16_t offset;
+	uint64_t mask;
+	uint32_t i;
+
+	mask = type_head->bit_width == WIDTH_32_BIT ? UINT32_MAX :
+	       (HI_BIT(DFX_REG_B64_VALUE_BITS) - 1);
+	for (i = 0; i < num; i++) {
+		old_val = hikp_ub_dfx_get_reg(old_reg + i * WORD_NUM_PER_REG,
+					      type_head->bit_width, &offset);
+		new_val = hikp_ub_dfx_get_reg(new_reg + i * WORD_NUM_PER_REG,
+					      type_head->bit_width, &offset);
+		if (old_val == new_val)
+			continue;
+
+		changed++;
+		if (type_head->type_id == TYPE_32_RUNNING_STATUS) {
+			printf("%03u: 0x%04x\t0x%" PRIx64 " -> 0x%" PRIx64 "\n",
+			       i + 1, offset, old_val, new_val);
+			continue;
+		}
+		if (tool_cnt_delta(old_val, new_val, mask, &delta) == TOOL_CNT_DOWN) {
+			printf("%03u: 0x%04x\t-%-20" PRIu64 "\t(cleared or reset)\n",
+			       i + 1, offset, delta);
+			continue;
+		}
+		printf("%03u: 0x%04x\t+%-20" PRIu64 "\t%.1f/s\n", i + 1, offset, delta,
+		       interval > 0 ? (double)delta / interval : 0.0);
+	}
+
+	return changed;
+}
+
+/*
+ * Both samples come from the same firmware, so the layout is expected to
+ * match, a mismatch is reported rather than decoded.
+ */
+static int hikp_ub_dfx_delta(const struct ub_dfx_rsp_head *rsp_head, const uint32_t *old_data,
+			     const uint32_t *new_data, uint32_t data_len, double interval)
+{
+	const struct ub_dfx_type_head *old_head, *new_head;
+	const uint32_t *old_ptr = old_data;
+	const uint32_t *new_ptr = new_data;
+	uint32_t left = data_len / sizeof(uint32_t);
+	uint8_t last_type_id = 0;
+	uint32_t changed = 0;
+	uint32_t num_u32;
+	int ret = 0;
+	uint8_t i;
+
+	printf("****************** module %s reg delta over %.3fs ********************\n",
+	       g_ub_dfx_module_parse[g_ub_dfx_param.module_idx].module_name, interval);
+	for (i = 0; i < rsp_head->total_type_num; i++) {
+		old_head = (const struct ub_dfx_type_head *)old_ptr;
+		new_head = (const struct ub_dfx_type_head *)new_ptr;
+		num_u32 = (uint32_t)new_head->reg_num * WORD_NUM_PER_REG + 1; /* including head */
+		if (left < num_u32) {
+			HIKP_ERROR_PRINT("register real size exceeds the max size\n");
+			ret = -EINVAL;
+			break;
+		}
+		if (old_head->type_id != new_head->type_id ||
+		    old_head->reg_num != new_head->reg_num ||
+		    old_head->bit_width != new_head->bit_width) {
+			HIKP_ERROR_PRINT("No.%u type differs from the last sample.\n", i + 1u);
+			ret = -EINVAL;
+			break;
+		}
+		if (new_head->type_id == INCORRECT_REG_TYPE)
+			break;
+		if (new_head->bit_width != WIDTH_32_BIT && new_head->bit_width != WIDTH_64_BIT) {
+			HIKP_ERROR_PRINT("type%hhu's bit width error.\n", new_head->type_id);
+			ret = -EINVAL;
+			break;
+		}
+		hikp_ub_dfx_print_type_head(new_head->type_id, &last_type_id);
+		changed += hikp_ub_dfx_delta_type(new_head, old_ptr + 1, new_ptr + 1, interval);
+		old_ptr += num_u32;
+		new_ptr += num_u32;
+		left -= num_u32;
+	}
+	printf("%u register(s) changed.\n", changed);
+	printf("################### ====== delta end ====== ######################\n");
+
+	return ret;
+}
+
+/* Keep the previous reg_data and print what changed in every period. */
+static void hikp_ub_dfx_sample(struct major_cmd_ctrl *self)
+{
+	uint64_t period_ns = (uint64_t)g_ub_dfx_param.interval * HIKP_NSEC_PER_SEC;
+	struct ub_dfx_rsp_head old_head = { 0 };
+	struct ub_dfx_rsp_head new_head = { 0 };
+	uint32_t old_size = 0, new_size = 0;
+	uint32_t *old_data = NULL;
+	uint32_t *new_data = NULL;
+	uint64_t last_ns, now_ns;
+	uint32_t version;
+	uint32_t round;
+
+	if (hikp_ub_dfx_fetch(self, &old_head, &old_data, &old_size, &version) != 0)
+		return;
+	last_ns = tool_get_time_ns();
+
+	printf("DFX cmd version: 0x%x\n\n", version);
+	for (round = 1; ; round++) {
+		self->err_no = cmd_sleep_until(last_ns + period_ns);
+		if (self->err_no != 0) {
+			snprintf(self->err_str, sizeof(self->err_str), "retake the lock fail.");
+			break;
+		}
+		if (hikp_ub_dfx_fetch(self, &new_head, &new_data, &new_size, &version) != 0)
+			break;
+		now_ns = tool_get_time_ns();
+
+		if (old_head.total_type_num != new_head.total_type_num || old_size != new_size) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "register layout changed between samples, firmware changed?");
+			self->err_no = -EINVAL;
+			free(new_data);
+			break;
+		}
+		self->err_no = hikp_ub_dfx_delta(&new_head, old_data, new_data, new_size,
+						 (double)(now_ns - last_ns) / HIKP_NSEC_PER_SEC);
+		if (self->err_no != 0) {
+			snprintf(self->err_str, sizeof(self->err_str), "compare dfx samples fail.");
+			free(new_data);
+			break;
+		}
+		(void)fflush(stdout);
+
+		free(old_data);
+		old_data = new_data;
+		old_head = new_head;
+		last_ns = now_ns;
+		if (g_ub_dfx_param.count != 0 && round == g_ub_dfx_param.count)
+			break;
+	}
+	free(old_data);
+}
+
+static void hikp_ub_dfx_execute(struct major_cmd_ctrl *self)
+{
+	struct ub_dfx_rsp_head rsp_head = { 0 };
+	uint32_t *reg_data = NULL;
+	uint32_t real_reg_size;
+	uint32_t version;
+
+	if (!(g_ub_dfx_param.flag & MODULE_SET_FLAG)) {
+		self->err_no = -EINVAL;
+		snprintf(self->err_str, sizeof(self->err_str), "Please specify a module.");
+		dfx_help_info(self);
+		return;
+	}
+	if (g_ub_dfx_param.count != 0 && g_ub_dfx_param.interval == 0) {
+		self->err_no = -EINVAL;
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-n/--count needs -t/--interval.");
+		return;
+	}
+
+	if (g_ub_dfx_param.interval != 0) {
+		hikp_ub_dfx_sample(self);
+		return;
+	}
+
+	if (hikp_ub_dfx_fetch(self, &rsp_head, &reg_data, &real_reg_size, &version) != 0)
+		return;
+
 	printf("DFX cmd version: 0x%x\n\n", version);
 	hikp_ub_dfx_print((const struct ub_dfx_rsp_head *)&rsp_head, reg_data);
 	free(reg_data);
 }
 
+static int hikp_ub_dfx_interval_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t interval;
+
+	self->err_no = string_toui(argv, &interval);
+	if (self->err_no != 0 || interval == 0 || interval > UB_DFX_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "sample interval should be 1~%u seconds.", UB_DFX_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+	g_ub_dfx_param.interval = interval;
+
+	return 0;
+}
+
+static int hikp_ub_dfx_count_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	self->err_no = string_toui(argv, &g_ub_dfx_param.count);
+	if (self->err_no != 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "parse sample count failed.");
+		return self->err_no;
+	}
+
+	return 0;
+}
+
 static void cmd_ub_dfx_init(void)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
@@ -326,6 +546,8 @@ static void cmd_ub_dfx_init(void)
 	cmd_option_register("-h", "--help", false, hikp_ub_dfx_help);
 	cmd_option_register("-i", "--interface", true, hikp_ub_dfx_target);
 	cmd_option_register("-m", "--module", true, hikp_ub_dfx_module_select);
+	cmd_option_register("-t", "--interval", true, hikp_ub_dfx_interval_set);
+	cmd_option_register("-n", "--count", true, hikp_ub_dfx_count_set);
 }
 
 HIKP_CMD_DECLARE("ub_dfx", "dump ub dfx info of hardware", cmd_ub_dfx_init);
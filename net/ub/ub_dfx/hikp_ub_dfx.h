@@ -35,6 +35,8 @@ enum ub_dfx_reg_type {
 };
 
 #define MAX_TYPE_NAME_LEN 40
+#define UB_DFX_TYPE_ID_NUM 256
+#define UB_DFX_MAX_INTERVAL 3600
 
 enum ub_dfx_reg_width {
 	WIDTH_32_BIT = 32,
@@ -52,6 +54,8 @@ struct ub_dfx_param {
 	uint32_t sub_cmd_code;
 	uint8_t module_idx;
 	uint8_t flag;
+	uint32_t interval; /* seconds between samples, 0 for a single dump */
+	uint32_t count; /* sample periods, 0 means until interrupted */
 };
 
 #define MAX_MODULE_NAME_LEN 20
@@ -88,6 +92,7 @@ struct ub_dfx_rsp_head {
 #define DFX_REG_VALUE_OFF 16
 #define DFX_REG_VALUE_MASK 0xFFFF
 #define DFX_REG_ADDR_MASK 0xFFFF
+#define DFX_REG_B64_VALUE_BITS 48
 
 #define WORD_NUM_PER_REG 2
 #define BIT_NUM_OF_WORD 32
@@ -13,14 +13,20 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/types.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include "hikpt_rciep.h"
 #include "hikp_unic_ppp.h"
 
+#define UNIC_PPP_INDEX_MIN_SIZE	64
+#define UNIC_PPP_SNAP_MAX_REC	(1U << 20)
+
 static struct hikp_unic_ppp_hw_resources g_unic_ppp_hw_res = { 0 };
 static struct unic_ppp_param g_unic_ppp_param = { 0 };
+static struct unic_ppp_hw_res_cache g_unic_ppp_hw_res_cache[UNIC_PPP_HW_RES_CACHE_NUM];
+static uint32_t g_unic_ppp_hw_res_cache_next;
 
 static void hikp_unic_ppp_show_ip_tbl(const void *data);
 static void hikp_unic_ppp_show_guid_tbl(const void *data);
@@ -48,6 +54,12 @@ static int hikp_unic_ppp_cmd_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-i", "--interface=<interface>",
 	       "device target or bdf id, e.g. ubn0 or 0000:35:00.0");
 	printf("    %s, %-24s %s\n", "-du", "--dump", "dump ip or guid table info.");
+	printf("    %s, %-24s %s\n", "-sp", "--sparse", "skip entries with an all-zero address.");
+	printf("    %s, %-24s %s\n", "-fd", "--find=<addr>[,...]",
+	       "look up IPv6 (or IPv4 as ::ffff:a.b.c.d) addresses or GUIDs.");
+	printf("    %s, %-25s %s\n", "-s", "--save=<file>", "save the ip or guid table to file.");
+	printf("    %s, %-25s %s\n", "-d", "--diff=<file>",
+	       "show the entries changed since the table was saved to file.");
 
 	return 0;
 }
@@ -157,14 +169,50 @@ static int hikp_unic_query_ppp_by_blkid(struct hikp_cmd_header *req_header, cons
 	return ret;
 }
 
+static struct unic_ppp_hw_res_cache *hikp_unic_ppp_hw_res_cache_find(const struct bdf_t *bdf)
+{
+	struct unic_ppp_hw_res_cache *cache;
+	uint32_t i;
+
+	for (i = 0; i < UNIC_PPP_HW_RES_CACHE_NUM; i++) {
+		cache = &g_unic_ppp_hw_res_cache[i];
+		if (cache->valid && cache->bdf.domain == bdf->domain &&
+		    cache->bdf.bus_id == bdf->bus_id && cache->bdf.dev_id == bdf->dev_id &&
+		    cache->bdf.fun_id == bdf->fun_id)
+			return cache;
+	}
+
+	return NULL;
+}
+
+/* The table sizes of a port are fixed, query them once per BDF and process. */
 static int hikp_unic_get_ppp_entry_hw_res(const struct bdf_t *bdf,
 					  struct hikp_unic_ppp_hw_resources *hw_res)
 {
 	struct hikp_cmd_header req_header = { 0 };
+	struct unic_ppp_hw_res_cache *cache;
+	int ret;
+
+	cache = hikp_unic_ppp_hw_res_cache_find(bdf);
+	if (cache != NULL) {
+		*hw_res = cache->hw_res;
+		return 0;
+	}
 
 	hikp_cmd_init(&req_header, UB_MOD, GET_UNIC_PPP_CMD, UNIC_PPP_ENTRY_HW_SPEC_GET);
-	return hikp_unic_query_ppp_by_blkid(&req_header, bdf, hw_res,
-					    sizeof(struct hikp_unic_ppp_hw_resources));
+	ret = hikp_unic_query_ppp_by_blkid(&req_header, bdf, hw_res,
+					   sizeof(struct hikp_unic_ppp_hw_resources));
+	if (ret != 0)
+		return ret;
+
+	cache = &g_unic_ppp_hw_res_cache[g_unic_ppp_hw_res_cache_next];
+	g_unic_ppp_hw_res_cache_next = (g_unic_ppp_hw_res_cache_next + 1) %
+				       UNIC_PPP_HW_RES_CACHE_NUM;
+	cache->bdf = *bdf;
+	cache->hw_res = *hw_res;
+	cache->valid = true;
+
+	return 0;
 }
 
 static int hikp_unic_ppp_alloc_ip_tbl_entry(const struct hikp_unic_ppp_hw_resources *hw_res,
@@ -347,28 +395,66 @@ static int hikp_unic_query_ppp_guid_tbl(struct hikp_cmd_header *req_header,
 	return ret;
 }
 
+static bool hikp_unic_ppp_addr_is_zero(const void *addr, size_t len)
+{
+	const uint8_t *byte = (const uint8_t *)addr;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (byte[i] != 0)
+			return false;
+	}
+
+	return true;
+}
+
+static bool hikp_unic_ppp_ip_valid(const struct unic_ip_entry *entry)
+{
+	return !hikp_unic_ppp_addr_is_zero(entry->ip_addr, sizeof(entry->ip_addr));
+}
+
+static bool hikp_unic_ppp_uc_guid_valid(const struct unic_guid_uc_entry *entry)
+{
+	return !hikp_unic_ppp_addr_is_zero(entry->guid_addr, sizeof(entry->guid_addr));
+}
+
+static bool hikp_unic_ppp_mc_guid_valid(const struct unic_guid_mc_entry *entry)
+{
+	return !hikp_unic_ppp_addr_is_zero(entry->guid_addr, sizeof(entry->guid_addr)) &&
+	       !hikp_unic_ppp_addr_is_zero(entry->function_bitmap,
+					   sizeof(entry->function_bitmap));
+}
+
 static void hikp_unic_ppp_show_ip_tbl(const void *data)
 {
 	struct unic_ip_tbl *ip_tbl = (struct unic_ip_tbl *)data;
 	struct unic_ip_entry *entry;
 	uint16_t *ip_addr_tbl_str;
+	uint32_t skipped = 0;
 	uint32_t i, j;
 
 	printf("ip_table_size = %u\n", ip_tbl->entry_size);
 	printf("index\t| func_id\t| ip_addr\n");
 	for (i = 0; i < ip_tbl->entry_size; i++) {
 		entry = &ip_tbl->entry[i];
+		if (g_unic_ppp_param.sparse && !hikp_unic_ppp_ip_valid(entry)) {
+			skipped++;
+			continue;
+		}
 		ip_addr_tbl_str = (uint16_t *)entry->ip_addr;
 		printf("%-4u\t| %-3u\t\t| ", entry->index, entry->function_id);
 		for (j = 0; j < IP_ADDR_TBL_LEN - 1; j++)
 			printf("%04x:" , ntohs(ip_addr_tbl_str[j]));
 		printf("%04x\n",  ntohs(ip_addr_tbl_str[IP_ADDR_TBL_LEN - 1]));
 	}
+	if (g_unic_ppp_param.sparse)
+		printf("skipped %u invalid entries\n", skipped);
 }
 
 static void hikp_unic_ppp_show_guid_tbl(const void *data)
 {
 	struct unic_guid_tbl *guid_tbl = (struct unic_guid_tbl *)data;
+	uint32_t skipped = 0;
 	uint32_t cnt;
 	int i;
 
@@ -376,6 +462,11 @@ static void hikp_unic_ppp_show_guid_tbl(const void *data)
 	if (guid_tbl->uc_tbl.entry_size > 0) {
 		printf("| num\t| func id | GUID \n");
 		for (cnt = 0; cnt < guid_tbl->uc_tbl.entry_size; cnt++) {
+			if (g_unic_ppp_param.sparse &&
+			    !hikp_unic_ppp_uc_guid_valid(&guid_tbl->uc_tbl.entry[cnt])) {
+				skipped++;
+				continue;
+			}
 			printf("| %3u\t| %7u | ", cnt, guid_tbl->uc_tbl.entry[cnt].function_id);
 			for (i = 0; i < HIKP_UNIC_GUID_ADDR_LEN - 1; i++) {
 				printf("%02x:", guid_tbl->uc_tbl.entry[cnt].guid_addr[i]);
@@ -389,6 +480,11 @@ static void hikp_unic_ppp_show_guid_tbl(const void *data)
 	if (guid_tbl->mc_tbl.entry_size > 0) {
 		printf("| num\t|  idx\t| %-48s\t| bitmap\n", "GUID");
 		for (cnt = 0; cnt < guid_tbl->mc_tbl.entry_size; cnt++) {
+			if (g_unic_ppp_param.sparse &&
+			    !hikp_unic_ppp_mc_guid_valid(&guid_tbl->mc_tbl.entry[cnt])) {
+				skipped++;
+				continue;
+			}
 			printf("| %3u\t| %4u\t| ", cnt, guid_tbl->mc_tbl.entry[cnt].idx);
 			for (i = 0; i < HIKP_UNIC_GUID_ADDR_LEN - 1; i++) {
 				printf("%02x:", guid_tbl->mc_tbl.entry[cnt].guid_addr[i]);
@@ -401,6 +497,383 @@ static void hikp_unic_ppp_show_guid_tbl(const void *data)
 			printf("%08x\n", guid_tbl->mc_tbl.entry[cnt].function_bitmap[0]);
 		}
 	}
+	if (g_unic_ppp_param.sparse)
+		printf("skipped %u invalid entries\n", skipped);
+}
+
+static void hikp_unic_ppp_index_free(struct unic_ppp_index *index)
+{
+	free(index->slot);
+	index->slot = NULL;
+	free(index->rec);
+	index->rec = NULL;
+	index->rec_num = 0;
+}
+
+/* Takes over rec, which is freed with the index. */
+static int hikp_unic_ppp_index_build(struct unic_ppp_index *index,
+				     struct unic_ppp_rec *rec, uint32_t rec_num)
+{
+	uint32_t size = UNIC_PPP_INDEX_MIN_SIZE;
+	uint32_t pos;
+	uint32_t i;
+
+	index->rec = rec;
+	index->rec_num = rec_num;
+	/* at most half full, so every probe run ends at an empty slot */
+	while (size < rec_num * 2)
+		size <<= 1;
+
+	index->slot = (uint32_t *)calloc(size, sizeof(uint32_t));
+	if (index->slot == NULL) {
+		HIKP_ERROR_PRINT("Fail to alloc ip/guid index memory.\n");
+		hikp_unic_ppp_index_free(index);
+		return -ENOMEM;
+	}
+	index->mask = size - 1;
+
+	for (i = 0; i < rec_num; i++) {
+		pos = tool_fnv1a(rec[i].addr, HIKP_UNIC_GUID_ADDR_LEN) & index->mask;
+		while (index->slot[pos] != 0)
+			pos = (pos + 1) & index->mask;
+		index->slot[pos] = i + 1;
+	}
+
+	return 0;
+}
+
+/* Entries with an all-zero address are never indexed or saved. */
+static uint32_t hikp_unic_ppp_rec_build(const union unic_ppp_feature_info *data,
+					struct unic_ppp_rec *rec)
+{
+	const struct unic_guid_tbl *guid_tbl = &data->guid_tbl;
+	const struct unic_ip_tbl *ip_tbl = &data->ip_tbl;
+	uint32_t num = 0;
+	uint32_t i;
+
+	if (g_unic_ppp_param.feature_idx == UNIC_PPP_IP_FEATURE_IDX) {
+		for (i = 0; i < ip_tbl->entry_size; i++) {
+			if (!hikp_unic_ppp_ip_valid(&ip_tbl->entry[i]))
+				continue;
+			rec[num].type = UNIC_PPP_REC_IP;
+			rec[num].idx = ip_tbl->entry[i].index;
+			rec[num].func_id = ip_tbl->entry[i].function_id;
+			memcpy(rec[num].addr, ip_tbl->entry[i].ip_addr, sizeof(rec[num].addr));
+			num++;
+		}
+		return num;
+	}
+
+	for (i = 0; i < guid_tbl->uc_tbl.entry_size; i++) {
+		if (!hikp_unic_ppp_uc_guid_valid(&guid_tbl->uc_tbl.entry[i]))
+			continue;
+		rec[num].type = UNIC_PPP_REC_UC_GUID;
+		rec[num].idx = i;
+		rec[num].func_id = guid_tbl->uc_tbl.entry[i].function_id;
+		memcpy(rec[num].addr, guid_tbl->uc_tbl.entry[i].guid_addr, sizeof(rec[num].addr));
+		num++;
+	}
+	for (i = 0; i < guid_tbl->mc_tbl.entry_size; i++) {
+		if (!hikp_unic_ppp_mc_guid_valid(&guid_tbl->mc_tbl.entry[i]))
+			continue;
+		rec[num].type = UNIC_PPP_REC_MC_GUID;
+		rec[num].idx = guid_tbl->mc_tbl.entry[i].idx;
+		memcpy(rec[num].addr, guid_tbl->mc_tbl.entry[i].guid_addr, sizeof(rec[num].addr));
+		memcpy(rec[num].func_bitmap, guid_tbl->mc_tbl.entry[i].function_bitmap,
+		       sizeof(rec[num].func_bitmap));
+		num++;
+	}
+
+	return num;
+}
+
+static int hikp_unic_ppp_index_from_tbl(struct unic_ppp_index *index,
+					const union unic_ppp_feature_info *data)
+{
+	struct unic_ppp_rec *rec;
+	uint32_t max_num;
+
+	if (g_unic_ppp_param.feature_idx == UNIC_PPP_IP_FEATURE_IDX)
+		max_num = data->ip_tbl.entry_size;
+	else
+		max_num = data->guid_tbl.uc_tbl.entry_size + data->guid_tbl.mc_tbl.entry_size;
+
+	rec = (struct unic_ppp_rec *)calloc(max_num + 1, sizeof(struct unic_ppp_rec));
+	if (rec == NULL) {
+		HIKP_ERROR_PRINT("Fail to alloc ip/guid record memory.\n");
+		return -ENOMEM;
+	}
+
+	return hikp_unic_ppp_index_build(index, rec, hikp_unic_ppp_rec_build(data, rec));
+}
+
+/*
+ * Walk the probe run of addr from *pos, which starts at UINT32_MAX, and
+ * return the next entry of that address, NULL at the end of the run.
+ */
+static const struct unic_ppp_rec *hikp_unic_ppp_index_next(const struct unic_ppp_index *index,
+							   const uint8_t *addr, uint32_t *pos)
+{
+	const struct unic_ppp_rec *rec;
+
+	if (*pos == UINT32_MAX)
+		*pos = tool_fnv1a(addr, HIKP_UNIC_GUID_ADDR_LEN) & index->mask;
+
+	while (index->slot[*pos] != 0) {
+		rec = &index->rec[index->slot[*pos] - 1];
+		*pos = (*pos + 1) & index->mask;
+		if (memcmp(rec->addr, addr, HIKP_UNIC_GUID_ADDR_LEN) == 0)
+			return rec;
+	}
+
+	return NULL;
+}
+
+static const struct unic_ppp_rec *hikp_unic_ppp_index_lookup(const struct unic_ppp_index *index,
+							     const struct unic_ppp_rec *key)
+{
+	const struct unic_ppp_rec *rec;
+	uint32_t pos = UINT32_MAX;
+
+	while ((rec = hikp_unic_ppp_index_next(index, key->addr, &pos)) != NULL) {
+		if (rec->type != key->type)
+			continue;
+		if (rec->type == UNIC_PPP_REC_MC_GUID || rec->func_id == key->func_id)
+			return rec;
+	}
+
+	return NULL;
+}
+
+static void hikp_unic_ppp_format_addr(char *buf, size_t size, bool is_ip, const uint8_t *addr)
+{
+	size_t len = 0;
+	uint32_t i;
+	int ret;
+
+	buf[0] = '\0';
+	for (i = 0; i < HIKP_UNIC_GUID_ADDR_LEN && len < size; i += is_ip ? 2 : 1) {
+		if (is_ip)
+			ret = snprintf(buf + len, size - len, "%s%02x%02x", i ? ":" : "",
+				       addr[i], addr[i + 1]);
+		else
+			ret = snprintf(buf + len, size - len, "%s%02x", i ? ":" : "", addr[i]);
+		if (ret < 0)
+			return;
+		len += (size_t)ret;
+	}
+}
+
+static void hikp_unic_ppp_show_rec_head(void)
+{
+	printf("   type | index | func_id | %-47s | func bitMap[255  <--  0]\n", "addr");
+}
+
+static void hikp_unic_ppp_show_rec(const char *tag, const struct unic_ppp_rec *rec)
+{
+	static const char * const type_name[] = { "ip", "uc", "mc" };
+	char addr_str[HIKP_UNIC_IP_ADDR_FMT_SIZE] = { 0 };
+	const uint32_t *bitmap = rec->func_bitmap;
+
+	hikp_unic_ppp_format_addr(addr_str, sizeof(addr_str), rec->type == UNIC_PPP_REC_IP,
+				  rec->addr);
+	if (rec->type != UNIC_PPP_REC_MC_GUID) {
+		printf("%-2s %-4s | %-5u | %-7u | %-47s | -\n",
+		       tag, type_name[rec->type], rec->idx, rec->func_id, addr_str);
+		return;
+	}
+
+	printf("%-2s mc   | %-5u | -       | %-47s | %08x:%08x:%08x:%08x:%08x:%08x:%08x:%08x\n",
+	       tag, rec->idx, addr_str, bitmap[7], bitmap[6], bitmap[5], bitmap[4],
+	       bitmap[3], bitmap[2], bitmap[1], bitmap[0]);
+}
+
+static void hikp_unic_ppp_show_find(const struct unic_ppp_index *index,
+				    const struct unic_ppp_param *ppp_param)
+{
+	char addr_str[HIKP_UNIC_IP_ADDR_FMT_SIZE] = { 0 };
+	const struct unic_ppp_rec *rec;
+	uint32_t match;
+	uint32_t pos;
+	uint32_t i;
+
+	hikp_unic_ppp_show_rec_head();
+	for (i = 0; i < ppp_param->find_num; i++) {
+		pos = UINT32_MAX;
+		match = 0;
+		while ((rec = hikp_unic_ppp_index_next(index, ppp_param->find_addr[i],
+						       &pos)) != NULL) {
+			hikp_unic_ppp_show_rec("", rec);
+			match++;
+		}
+		if (match == 0) {
+			hikp_unic_ppp_format_addr(addr_str, sizeof(addr_str),
+						  ppp_param->feature_idx == UNIC_PPP_IP_FEATURE_IDX,
+						  ppp_param->find_addr[i]);
+			printf("   %s is not programmed\n", addr_str);
+		}
+	}
+}
+
+static int hikp_unic_ppp_snap_key_check(const void *saved_key, const void *key)
+{
+	const struct unic_ppp_snap_key *saved = saved_key;
+	const struct unic_ppp_snap_key *cur = key;
+
+	if (saved->bdf.domain != cur->bdf.domain || saved->bdf.bdf_id != cur->bdf.bdf_id) {
+		HIKP_ERROR_PRINT("%s was saved for another device.\n", g_unic_ppp_param.snap_file);
+		return -EINVAL;
+	}
+	if (saved->feature_idx != cur->feature_idx) {
+		HIKP_ERROR_PRINT("%s holds the %s table.\n", g_unic_ppp_param.snap_file,
+				 saved->feature_idx == UNIC_PPP_IP_FEATURE_IDX ?
+				 UNIC_PPP_IP_TBL_NAME : UNIC_PPP_GUID_TBL_NAME);
+		return -EINVAL;
+	}
+
+	return TOOL_SNAP_KEY_MATCH;
+}
+
+static void hikp_unic_ppp_snap_init(struct tool_snap *snap, struct unic_ppp_snap_key *key,
+				    const struct unic_ppp_param *ppp_param)
+{
+	key->bdf = ppp_param->target.bdf;
+	key->feature_idx = (uint32_t)ppp_param->feature_idx;
+
+	snap->file = ppp_param->snap_file;
+	snap->name = "unic_ppp table";
+	snap->type = UNIC_PPP_SNAP_MAGIC;
+	snap->version = UNIC_PPP_SNAP_VER;
+	snap->key = key;
+	snap->key_len = sizeof(*key);
+	snap->max_data_len = UNIC_PPP_SNAP_MAX_REC * sizeof(struct unic_ppp_rec);
+	snap->key_check = hikp_unic_ppp_snap_key_check;
+}
+
+static int hikp_unic_ppp_snap_save(const struct unic_ppp_index *index,
+				   const struct unic_ppp_param *ppp_param)
+{
+	struct unic_ppp_snap_key key = { 0 };
+	struct tool_snap snap = { 0 };
+	int ret;
+
+	hikp_unic_ppp_snap_init(&snap, &key, ppp_param);
+	ret = tool_snap_save(&snap, index->rec, index->rec_num * sizeof(*index->rec), false);
+	if (ret == 0)
+		printf("saved %u entries to %s\n", index->rec_num, ppp_param->snap_file);
+
+	return ret;
+}
+
+static int hikp_unic_ppp_snap_load(struct unic_ppp_index *index, struct tool_snap_head *head,
+				   const struct unic_ppp_param *ppp_param)
+{
+	struct unic_ppp_snap_key saved = { 0 };
+	struct unic_ppp_snap_key key = { 0 };
+	struct tool_snap snap = { 0 };
+	void *rec = NULL;
+	int ret;
+
+	hikp_unic_ppp_snap_init(&snap, &key, ppp_param);
+	ret = tool_snap_load(&snap, head, &saved, &rec);
+	if (ret != 0)
+		return ret;
+
+	if (head->data_len % sizeof(struct unic_ppp_rec) != 0) {
+		HIKP_ERROR_PRINT("%s is not a unic_ppp table snapshot.\n", ppp_param->snap_file);
+		free(rec);
+		return -EINVAL;
+	}
+
+	return hikp_unic_ppp_index_build(index, rec, head->data_len / sizeof(struct unic_ppp_rec));
+}
+
+static bool hikp_unic_ppp_rec_changed(const struct unic_ppp_rec *old,
+				      const struct unic_ppp_rec *cur)
+{
+	if (old->type == UNIC_PPP_REC_MC_GUID)
+		return memcmp(old->func_bitmap, cur->func_bitmap, sizeof(old->func_bitmap)) != 0;
+
+	/* an IP moved to another table position */
+	return old->type == UNIC_PPP_REC_IP && old->idx != cur->idx;
+}
+
+static int hikp_unic_ppp_snap_diff(const struct unic_ppp_index *index,
+				   const struct unic_ppp_param *ppp_param)
+{
+	uint32_t added = 0, removed = 0, changed = 0;
+	struct unic_ppp_index old_index = { 0 };
+	struct tool_snap_head head = { 0 };
+	const struct unic_ppp_rec *rec;
+	uint32_t i;
+	int ret;
+
+	ret = hikp_unic_ppp_snap_load(&old_index, &head, ppp_param);
+	if (ret != 0)
+		return ret;
+
+	printf("changes since %s (%.3f s ago, %u -> %u entries):\n", ppp_param->snap_file,
+	       tool_snap_age(&head), old_index.rec_num, index->rec_num);
+	hikp_unic_ppp_show_rec_head();
+	for (i = 0; i < index->rec_num; i++) {
+		rec = hikp_unic_ppp_index_lookup(&old_index, &index->rec[i]);
+		if (rec == NULL) {
+			hikp_unic_ppp_show_rec("+", &index->rec[i]);
+			added++;
+		} else if (hikp_unic_ppp_rec_changed(rec, &index->rec[i])) {
+			hikp_unic_ppp_show_rec("-", rec);
+			hikp_unic_ppp_show_rec("+", &index->rec[i]);
+			changed++;
+		}
+	}
+	for (i = 0; i < old_index.rec_num; i++) {
+		if (hikp_unic_ppp_index_lookup(index, &old_index.rec[i]) == NULL) {
+			hikp_unic_ppp_show_rec("-", &old_index.rec[i]);
+			removed++;
+		}
+	}
+	printf("added %u, removed %u, changed %u\n", added, removed, changed);
+
+	hikp_unic_ppp_index_free(&old_index);
+	return 0;
+}
+
+static bool hikp_unic_ppp_opt_active(const struct unic_ppp_param *ppp_param)
+{
+	return ppp_param->find_num != 0 || ppp_param->snap_flag != 0;
+}
+
+/*
+ * -fd/-s/-d: the walked table is indexed once, every lookup and the diff
+ * in both directions are then hash probes.
+ */
+static int hikp_unic_ppp_opt_run(const struct unic_ppp_feature_cmd *unic_ppp_cmd,
+				 const union unic_ppp_feature_info *data,
+				 const struct unic_ppp_param *ppp_param)
+{
+	struct unic_ppp_index index = { 0 };
+	int ret;
+
+	ret = hikp_unic_ppp_index_from_tbl(&index, data);
+	if (ret != 0)
+		return ret;
+
+	if (ppp_param->snap_flag & UNIC_PPP_SNAP_DIFF_FLAG) {
+		ret = hikp_unic_ppp_snap_diff(&index, ppp_param);
+		goto out;
+	}
+
+	if (ppp_param->find_num != 0)
+		hikp_unic_ppp_show_find(&index, ppp_param);
+	else
+		unic_ppp_cmd->show(data);
+
+	if (ppp_param->snap_flag & UNIC_PPP_SNAP_SAVE_FLAG)
+		ret = hikp_unic_ppp_snap_save(&index, ppp_param);
+
+out:
+	hikp_unic_ppp_index_free(&index);
+	return ret;
 }
 
 static int hikp_unic_ppp_check_input_param(struct major_cmd_ctrl *self,
@@ -421,6 +894,58 @@ static int hikp_unic_ppp_check_input_param(struct major_cmd_ctrl *self,
 		return self->err_no;
 	}
 
+	if ((ppp_param->snap_flag & UNIC_PPP_SNAP_DIFF_FLAG) && ppp_param->find_str[0] != '\0') {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-d/--diff can't be used with -fd/--find.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	return 0;
+}
+
+static int hikp_unic_ppp_parse_one_addr(const char *str, bool is_ip, uint8_t *addr)
+{
+	static const uint8_t v4_mapped[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff };
+
+	if (!is_ip)
+		return hikp_ether_parse_addr(str, addr, HIKP_UNIC_GUID_ADDR_LEN);
+
+	if (inet_pton(AF_INET6, str, addr) == 1)
+		return 0;
+
+	memcpy(addr, v4_mapped, sizeof(v4_mapped));
+	return inet_pton(AF_INET, str, addr + sizeof(v4_mapped)) == 1 ? 0 : -EINVAL;
+}
+
+/* -fd may come before -du, so its addresses are parsed once the table is known. */
+static int hikp_unic_ppp_parse_find(struct major_cmd_ctrl *self,
+				    struct unic_ppp_param *ppp_param)
+{
+	bool is_ip = ppp_param->feature_idx == UNIC_PPP_IP_FEATURE_IDX;
+	char *save_ptr = NULL;
+	char *tok;
+
+	for (tok = strtok_r(ppp_param->find_str, ",", &save_ptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &save_ptr)) {
+		if (ppp_param->find_num >= UNIC_PPP_MAX_FIND) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "-fd/--find takes at most %u addresses.", UNIC_PPP_MAX_FIND);
+			self->err_no = -EINVAL;
+			return self->err_no;
+		}
+		if (hikp_unic_ppp_parse_one_addr(tok, is_ip,
+						 ppp_param->find_addr[ppp_param->find_num]) != 0) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "please input %s for -fd/--find.", is_ip ?
+				 "IP addresses like fe80::1 or 192.168.1.2" :
+				 "GUIDs like 16 hex bytes separated by ':'");
+			self->err_no = -EINVAL;
+			return self->err_no;
+		}
+		ppp_param->find_num++;
+	}
+
 	return 0;
 }
 
@@ -456,6 +981,10 @@ static void hikp_unic_ppp_cmd_execute(struct major_cmd_ctrl *self)
 	if (ret != 0)
 		return;
 
+	ret = hikp_unic_ppp_parse_find(self, &g_unic_ppp_param);
+	if (ret != 0)
+		return;
+
 	ret = hikp_unic_get_ppp_entry_hw_res(&g_unic_ppp_param.target.bdf, &g_unic_ppp_hw_res);
 	if (ret != 0) {
 		snprintf(self->err_str, sizeof(self->err_str),
@@ -483,13 +1012,79 @@ static void hikp_unic_ppp_cmd_execute(struct major_cmd_ctrl *self)
 	}
 
 	printf("############## UNIC_PPP: %s info ############\n", unic_ppp_cmd->feature_name);
-	unic_ppp_cmd->show(unic_ppp_data);
+	if (hikp_unic_ppp_opt_active(&g_unic_ppp_param)) {
+		ret = hikp_unic_ppp_opt_run(unic_ppp_cmd, unic_ppp_data, &g_unic_ppp_param);
+		if (ret != 0) {
+			snprintf(self->err_str, sizeof(self->err_str),
+				 "failed to look up or snapshot the %s table, ret = %d.",
+				 unic_ppp_cmd->feature_name, ret);
+			self->err_no = ret;
+		}
+	} else {
+		unic_ppp_cmd->show(unic_ppp_data);
+	}
 	printf("#################### END #######################\n");
 
 out:
 	hikp_unic_ppp_data_free(unic_ppp_data);
 }
 
+static int hikp_unic_cmd_ppp_sparse(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(self);
+	HIKP_SET_USED(argv);
+
+	g_unic_ppp_param.sparse = true;
+
+	return 0;
+}
+
+static int hikp_unic_cmd_ppp_find(struct major_cmd_ctrl *self, const char *argv)
+{
+	if (strlen(argv) >= sizeof(g_unic_ppp_param.find_str)) {
+		snprintf(self->err_str, sizeof(self->err_str), "-fd/--find parameter is too long.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	(void)snprintf(g_unic_ppp_param.find_str, sizeof(g_unic_ppp_param.find_str), "%s", argv);
+
+	return 0;
+}
+
+static int hikp_unic_cmd_ppp_snap_file(struct major_cmd_ctrl *self, const char *argv,
+				       uint8_t flag)
+{
+	if (g_unic_ppp_param.snap_flag & ~flag) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "-s/--save and -d/--diff can't be used together.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	if (strlen(argv) >= sizeof(g_unic_ppp_param.snap_file)) {
+		snprintf(self->err_str, sizeof(self->err_str), "snapshot file name is too long.");
+		self->err_no = -EINVAL;
+		return self->err_no;
+	}
+
+	(void)snprintf(g_unic_ppp_param.snap_file, sizeof(g_unic_ppp_param.snap_file), "%s",
+		       argv);
+	g_unic_ppp_param.snap_flag |= flag;
+
+	return 0;
+}
+
+static int hikp_unic_cmd_ppp_snap_save_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_unic_cmd_ppp_snap_file(self, argv, UNIC_PPP_SNAP_SAVE_FLAG);
+}
+
+static int hikp_unic_cmd_ppp_snap_diff_set(struct major_cmd_ctrl *self, const char *argv)
+{
+	return hikp_unic_cmd_ppp_snap_file(self, argv, UNIC_PPP_SNAP_DIFF_FLAG);
+}
+
 static void cmd_unic_get_ppp_init(void)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
@@ -500,6 +1095,10 @@ static void cmd_unic_get_ppp_init(void)
 	cmd_option_register("-h", "--help", false, hikp_unic_ppp_cmd_help);
 	cmd_option_register("-i", "--interface", true, hikp_unic_cmd_get_ppp_target);
 	cmd_option_register("-du", "--dump", true, hikp_unic_cmd_ppp_feature_select);
+	cmd_option_register("-sp", "--sparse", false, hikp_unic_cmd_ppp_sparse);
+	cmd_option_register("-fd", "--find", true, hikp_unic_cmd_ppp_find);
+	cmd_option_register("-s", "--save", true, hikp_unic_cmd_ppp_snap_save_set);
+	cmd_option_register("-d", "--diff", true, hikp_unic_cmd_ppp_snap_diff_set);
 }
 
 HIKP_CMD_DECLARE("unic_ppp", "dump ppp info of unic!", cmd_unic_get_ppp_init);
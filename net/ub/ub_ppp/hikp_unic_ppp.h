@@ -106,9 +106,69 @@ struct unic_ppp_feature_cmd {
 	void (*show)(const void *data);
 };
 
+#define UNIC_PPP_MAX_FIND		32
+#define UNIC_PPP_FIND_STR_LEN		1024
+#define UNIC_PPP_SNAP_PATH_LEN		256
+#define UNIC_PPP_SNAP_SAVE_FLAG		0x1
+#define UNIC_PPP_SNAP_DIFF_FLAG		0x2
+#define UNIC_PPP_SNAP_MAGIC		0x55505053 /* "SPPU" */
+#define UNIC_PPP_SNAP_VER		2
+#define UNIC_PPP_HW_RES_CACHE_NUM	8
+
+enum unic_ppp_rec_type {
+	UNIC_PPP_REC_IP = 0,
+	UNIC_PPP_REC_UC_GUID,
+	UNIC_PPP_REC_MC_GUID,
+};
+
+/*
+ * One valid IP or GUID table entry, both as indexed and as stored in a
+ * --save file. An IP and a unicast GUID are keyed by address and func_id,
+ * a multicast GUID by address only.
+ */
+struct unic_ppp_rec {
+	uint8_t type; /* enum unic_ppp_rec_type */
+	uint8_t rsv[3];
+	uint32_t idx; /* table position for unicast GUIDs */
+	uint32_t func_id; /* IP and unicast GUID only */
+	uint8_t addr[HIKP_UNIC_GUID_ADDR_LEN]; /* IP in network order or GUID */
+	uint32_t func_bitmap[HIKP_UNIC_GUID_BITMAP_LEN]; /* multicast GUID only */
+};
+
+/*
+ * Open addressing over rec[], a slot holds the rec index + 1 or 0 if empty.
+ * Only the address is hashed, so the probe run of an address holds all of
+ * its functions.
+ */
+struct unic_ppp_index {
+	struct unic_ppp_rec *rec;
+	uint32_t rec_num;
+	uint32_t *slot;
+	uint32_t mask;
+};
+
+/* Snapshot key of a --save file, the payload is an array of struct unic_ppp_rec. */
+struct unic_ppp_snap_key {
+	struct bdf_t bdf;
+	uint32_t feature_idx; /* ip or guid table */
+};
+
+struct unic_ppp_hw_res_cache {
+	bool valid;
+	struct bdf_t bdf;
+	struct hikp_unic_ppp_hw_resources hw_res;
+};
+
 struct unic_ppp_param {
 	struct tool_target target;
 	int feature_idx;
+	bool sparse; /* skip entries with an all-zero address */
+	/* -fd is parsed once the table type is known */
+	char find_str[UNIC_PPP_FIND_STR_LEN];
+	uint8_t find_addr[UNIC_PPP_MAX_FIND][HIKP_UNIC_GUID_ADDR_LEN];
+	uint32_t find_num;
+	uint8_t snap_flag;
+	char snap_file[UNIC_PPP_SNAP_PATH_LEN];
 };
 
 struct unic_ppp_req_para {
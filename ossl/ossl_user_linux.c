@@ -53,11 +53,12 @@ int uda_fcntl(const char *lock_file, uint32_t operation, int *fd)
 	if ((fd == NULL) || (lock_file == NULL))
 		return -EFAULT;
 
-	fd_t = open(lock_file, O_WRONLY | O_CREAT, 0600);
+	/* A read lock needs the file open for reading */
+	fd_t = open(lock_file, O_RDWR | O_CREAT, 0600);
 	if (fd_t < 0)
 		return -errno;
 
-	g_fcntl_lock.l_type = F_WRLCK;
+	g_fcntl_lock.l_type = operation == UDA_FLOCK_SHARED_BLOCK ? F_RDLCK : F_WRLCK;
 	if (operation == UDA_FLOCK_NOBLOCK)
 		ret = fcntl(fd_t, F_SETLK, &g_fcntl_lock);
 	else
@@ -94,12 +95,17 @@ int uda_unfcntl(const int *fd, const uint32_t operation)
 
 void record_syslog(const char *ident, const int priority, const char *logs)
 {
+	static bool opened;
+
 	if (!logs || !ident) {
 		printf("Invalid parameter [%s].\n", __func__);
 		return;
 	}
 
-	openlog(ident, LOG_CONS | LOG_PID, LOG_USER);
+	/* openlog() keeps ident, callers pass the tool name which lives for the process */
+	if (!opened) {
+		openlog(ident, LOG_CONS | LOG_PID, LOG_USER);
+		opened = true;
+	}
 	syslog(priority, "%s", logs);
-	closelog();
 }
@@ -59,7 +59,8 @@
 
 enum {
 	UDA_FLOCK_NOBLOCK = 0,
-	UDA_FLOCK_BLOCK = 1
+	UDA_FLOCK_BLOCK = 1,
+	UDA_FLOCK_SHARED_BLOCK = 2 /* blocking read lock, may be held by many */
 };
 
 extern int uda_access(const char *file_dir);
@@ -141,12 +141,11 @@ static int port_err_state_rsp_data_check(struct hikp_cmd_ret *cmd_ret)
 	return 0;
 }
 
-int pcie_error_state_get(uint32_t port_id)
+int pcie_error_state_query(uint32_t port_id, struct pcie_err_state *state)
 {
 	struct hikp_cmd_header req_header;
 	struct hikp_cmd_ret *cmd_ret = NULL;
 	struct pcie_info_req_para req_data = { 0 };
-	struct pcie_err_state *state = NULL;
 	int ret;
 
 	req_data.interface_id = port_id;
@@ -154,26 +153,35 @@ int pcie_error_state_get(uint32_t port_id)
 	hikp_cmd_init(&req_header, PCIE_MOD, PCIE_INFO, INFO_ERR_STATE_SHOW);
 	cmd_ret = hikp_cmd_alloc(&req_header, &req_data, sizeof(req_data));
 	ret = port_err_state_rsp_data_check(cmd_ret);
-	if (ret)
-		goto free_cmd_ret;
+	if (ret == 0)
+		*state = *(struct pcie_err_state *)cmd_ret->rsp_data;
+	hikp_cmd_free(&cmd_ret);
 
-	state = (struct pcie_err_state *)cmd_ret->rsp_data;
+	return ret;
+}
 
-	Info("phy_lane_err_counter = %u\n", state->test_cnt.bits.phy_lane_err_counter);
+int pcie_error_state_get(uint32_t port_id)
+{
+	struct pcie_err_state state;
+	int ret;
+
+	ret = pcie_error_state_query(port_id, &state);
+	if (ret)
+		return ret;
+
+	Info("phy_lane_err_counter = %u\n", state.test_cnt.bits.phy_lane_err_counter);
 	Info("symbol_unlock_counter = %u\n",
-	     state->symbol_unlock_cnt.bits.symbol_unlock_counter);
-	Info("mac_int_status = 0x%x\n", state->mac_int_status);
+	     state.symbol_unlock_cnt.bits.symbol_unlock_counter);
+	Info("mac_int_status = 0x%x\n", state.mac_int_status);
 	Info("loop_back_link_data_err_cnt = %u\n",
-	     state->loop_link_data_err_cnt.bits.loop_back_link_data_err_cnt);
-	Info("pcs_rx_err_cnt = %u\n", state->rx_err_cnt.bits.pcs_rx_err_cnt);
+	     state.loop_link_data_err_cnt.bits.loop_back_link_data_err_cnt);
+	Info("pcs_rx_err_cnt = %u\n", state.rx_err_cnt.bits.pcs_rx_err_cnt);
 	Info("reg_framing_err_count = %u\n",
-	     state->framing_err_cnt.bits.reg_framing_err_count);
-	Info("dl_lcrc_err_num = %u\n", state->lcrc_err_num.bits.dl_lcrc_err_num);
-	Info("dl_dcrc_err_num = %u\n", state->dcrc_err_num.bits.dl_dcrc_err_num);
-free_cmd_ret:
-	hikp_cmd_free(&cmd_ret);
+	     state.framing_err_cnt.bits.reg_framing_err_count);
+	Info("dl_lcrc_err_num = %u\n", state.lcrc_err_num.bits.dl_lcrc_err_num);
+	Info("dl_dcrc_err_num = %u\n", state.dcrc_err_num.bits.dl_dcrc_err_num);
 
-	return ret;
+	return 0;
 }
 
 int pcie_error_state_clear(uint32_t port_id)
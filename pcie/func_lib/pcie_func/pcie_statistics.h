@@ -125,6 +125,7 @@ struct pcie_info_req_para {
 };
 
 int pcie_port_distribution_get(uint32_t chip_id);
+int pcie_error_state_query(uint32_t port_id, struct pcie_err_state *state);
 int pcie_error_state_get(uint32_t port_id);
 int pcie_error_state_clear(uint32_t port_id);
 int port_distribution_rsp_data_check(const struct hikp_cmd_ret *cmd_ret, uint32_t *port_num);
@@ -145,7 +145,7 @@ static void cmd_pcie_info_init(void)
 	cmd_option_register("-h", "--help", false, pcie_info_help);
 	cmd_option_register("-d", "--distribution", false, pcie_distribution_show);
 	cmd_option_register("-es", "--error-show", false, pcie_err_state_show);
-	cmd_option_register("-ec", "--error-clear", false, pcie_err_state_clear);
+	cmd_writer_option_register("-ec", "--error-clear", false, pcie_err_state_clear);
 	cmd_option_register("-i", "--interface", true, pcie_port_chip_set);
 }
 
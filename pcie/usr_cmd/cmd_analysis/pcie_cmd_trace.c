@@ -178,9 +178,9 @@ static void cmd_pcie_trace_init(void)
 	major_cmd->execute = pcie_trace_execute;
 
 	cmd_option_register("-h", "--help", false, pcie_trace_help);
-	cmd_option_register("-c", "--clear", false, pcie_trace_clear);
+	cmd_writer_option_register("-c", "--clear", false, pcie_trace_clear);
 	cmd_option_register("-s", "--show", false, pcie_trace_show);
-	cmd_option_register("-m", "--mode", true, pcie_trace_mode_set);
+	cmd_writer_option_register("-m", "--mode", true, pcie_trace_mode_set);
 	cmd_option_register("-f", "--information", false, pcie_link_information_get);
 	cmd_option_register("-i", "--interface", true, pcie_port_id_set);
 	cmd_option_register("-pm", "--pm-state", false, pcie_pm_show);
@@ -81,7 +81,7 @@ static void cmd_ras_dump_init(void)
 	major_cmd->option_count = 0;
 	major_cmd->execute = ras_dump_execute;
 
-	cmd_option_register("-c", "--clear", false, ras_set_clear);
+	cmd_writer_option_register("-c", "--clear", false, ras_set_clear);
 	cmd_option_register("-h", "--help", false, ras_dump_help);
 }
 
@@ -116,3 +116,175 @@ int sas_analy_cmd(struct tool_sas_cmd *cmd)
 
 	return 0;
 }
+
+static const char *g_queue_kind_name[SAS_QUEUE_KIND_NUM] = { "dq", "cq" };
+
+static uint32_t sas_sample_hist_idx(uint32_t occ)
+{
+	uint32_t idx = 0;
+
+	while (occ != 0 && idx < SAS_SAMPLE_HIST_NUM - 1) {
+		occ >>= 1;
+		idx++;
+	}
+
+	return idx;
+}
+
+static int sas_sample_get_ptr(const struct tool_sas_cmd *cmd, uint32_t cmd_type,
+			      uint32_t *reg_save)
+{
+	struct tool_sas_cmd ptr_cmd = *cmd;
+	uint32_t reg_num = 0;
+	int ret;
+
+	ptr_cmd.sas_cmd_type = cmd_type;
+	ret = sas_get_res(&ptr_cmd, reg_save, &reg_num);
+	if (ret)
+		return ret;
+	if (reg_num < REG_NUM_PTR_MAX) {
+		printf("SAS get queue pointer is failed\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static void sas_sample_update(struct sas_queue_sample *q, uint32_t rd, uint32_t wr,
+			      bool first, uint64_t now_ns)
+{
+	uint32_t prod_adv, cons_adv, occ;
+
+	rd &= SAS_QUEUE_DEPTH - 1;
+	wr &= SAS_QUEUE_DEPTH - 1;
+	occ = (wr - rd) & (SAS_QUEUE_DEPTH - 1);
+	q->occ_sum += occ;
+	q->occ_max = HIKP_MAX(q->occ_max, occ);
+	q->hist[sas_sample_hist_idx(occ)]++;
+	if (first) {
+		q->rd = rd;
+		q->wr = wr;
+		return;
+	}
+
+	prod_adv = (wr - q->wr) & (SAS_QUEUE_DEPTH - 1);
+	cons_adv = (rd - q->rd) & (SAS_QUEUE_DEPTH - 1);
+	q->prod_adv += prod_adv;
+	q->cons_adv += cons_adv;
+	if (prod_adv != 0 && cons_adv == 0)
+		q->stuck_num++;
+
+	/* Work was pending at the previous sample and the consumer took none of it */
+	if (cons_adv == 0 && q->wr != q->rd) {
+		if (q->stall_start_ns == 0)
+			q->stall_start_ns = now_ns;
+		q->stall_max_ns = HIKP_MAX(q->stall_max_ns, now_ns - q->stall_start_ns);
+	} else {
+		q->stall_start_ns = 0;
+	}
+	q->rd = rd;
+	q->wr = wr;
+}
+
+static const char *sas_sample_flag(const struct sas_queue_sample *q)
+{
+	if (q->prod_adv != 0 && q->cons_adv == 0)
+		return "STUCK";
+	if (q->stall_max_ns >= SAS_SAMPLE_STALL_MS * HIKP_NSEC_PER_MSEC)
+		return "STALL";
+
+	return "";
+}
+
+static void sas_sample_print(struct sas_queue_sample q[][SAS_QUEUE_NUM], uint32_t sample_num,
+			     double elapsed)
+{
+	const struct sas_queue_sample *cur;
+	uint32_t kind, i, b;
+
+	printf("    QUEUE  PROD/s      CONS/s      OCC_AVG   OCC_MAX  MAX_STALL(ms)  P_ONLY  FLAG\n");
+	for (kind = 0; kind < SAS_QUEUE_KIND_NUM; kind++) {
+		for (i = 0; i < SAS_QUEUE_NUM; i++) {
+			cur = &q[kind][i];
+			printf("    %s%-4u %-11.1f %-11.1f %-9.2f %-8u %-14.1f %-7u %s\n",
+			       g_queue_kind_name[kind], i, (double)cur->prod_adv / elapsed,
+			       (double)cur->cons_adv / elapsed,
+			       (double)cur->occ_sum / sample_num, cur->occ_max,
+			       (double)cur->stall_max_ns / HIKP_NSEC_PER_MSEC, cur->stuck_num,
+			       sas_sample_flag(cur));
+		}
+	}
+
+	printf("  occupancy histogram (samples per occupancy range, busy queues only):\n");
+	for (kind = 0; kind < SAS_QUEUE_KIND_NUM; kind++) {
+		for (i = 0; i < SAS_QUEUE_NUM; i++) {
+			cur = &q[kind][i];
+			if (cur->occ_max == 0)
+				continue;
+			printf("    %s%-4u 0:%u", g_queue_kind_name[kind], i, cur->hist[0]);
+			for (b = 1; b < SAS_SAMPLE_HIST_NUM; b++) {
+				if (cur->hist[b] == 0)
+					continue;
+				if (b == 1)
+					printf(" 1:%u", cur->hist[b]);
+				else
+					printf(" %u-%u:%u", 1U << (b - 1), (1U << b) - 1, cur->hist[b]);
+			}
+			printf("\n");
+		}
+	}
+}
+
+int sas_analy_sample(const struct tool_sas_cmd *cmd, const struct sas_sample_para *para)
+{
+	static const uint32_t cmd_type[SAS_QUEUE_KIND_NUM] = { ANADQ_PRT, ANACQ_PRT };
+	struct sas_queue_sample q[SAS_QUEUE_KIND_NUM][SAS_QUEUE_NUM] = { 0 };
+	uint32_t reg_save[RESP_MAX_NUM] = { 0 };
+	uint64_t period_ns, start_ns, end_ns, deadline, now_ns, last_ns;
+	uint32_t sample_num = 0;
+	uint32_t late_num = 0;
+	uint32_t kind, i;
+	double elapsed;
+	int ret;
+
+	if (cmd == NULL || para == NULL || para->interval == 0)
+		return -EINVAL;
+
+	period_ns = para->interval * HIKP_NSEC_PER_MSEC;
+	start_ns = tool_get_time_ns();
+	end_ns = start_ns + para->time * HIKP_NSEC_PER_SEC;
+	deadline = start_ns;
+	now_ns = start_ns;
+	do {
+		for (kind = 0; kind < SAS_QUEUE_KIND_NUM; kind++) {
+			ret = sas_sample_get_ptr(cmd, cmd_type[kind], reg_save);
+			if (ret)
+				return ret;
+			for (i = 0; i < SAS_QUEUE_NUM; i++)
+				sas_sample_update(&q[kind][i], reg_save[i * REG_NUM_DQ],
+						  reg_save[i * REG_NUM_DQ + 1], sample_num == 0,
+						  now_ns);
+		}
+		sample_num++;
+		last_ns = now_ns;
+
+		/* Keep a fixed rate, a slow mailbox shows up as late samples */
+		deadline += period_ns;
+		now_ns = tool_get_time_ns();
+		if (now_ns > deadline) {
+			late_num++;
+			deadline = now_ns;
+		} else {
+			tool_sleep_until(deadline);
+			now_ns = deadline;
+		}
+	} while (now_ns < end_ns);
+
+	/* Advances happen between the first and the last sample */
+	elapsed = (double)(last_ns - start_ns) / HIKP_NSEC_PER_SEC;
+	printf("  sas queue sampling: %u samples in %.2fs, interval %u ms, %u late\n",
+	       sample_num, elapsed, para->interval, late_num);
+	sas_sample_print(q, sample_num, elapsed > 0 ? elapsed : 1);
+
+	return 0;
+}
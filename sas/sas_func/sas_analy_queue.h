@@ -27,6 +27,37 @@
 #define CQ_COAL_CNT 3
 #define CQ_COAL_ENABLE 3
 
+/* Slots per DQ/CQ, as set up by the hisi_sas driver */
+#define SAS_QUEUE_DEPTH 4096
+/* Empty, then one bucket per power of two up to SAS_QUEUE_DEPTH - 1 */
+#define SAS_SAMPLE_HIST_NUM 13
+/* Consumer not moving with work pending for this long is reported */
+#define SAS_SAMPLE_STALL_MS 100
+
+enum sas_queue_kind {
+	SAS_QUEUE_DQ,
+	SAS_QUEUE_CQ,
+	SAS_QUEUE_KIND_NUM,
+};
+
+/*
+ * Both queue kinds are rings of SAS_QUEUE_DEPTH slots: the write pointer
+ * is moved by the producer (driver for DQ, hardware for CQ) and the read
+ * pointer by the consumer.
+ */
+struct sas_queue_sample {
+	uint32_t rd;
+	uint32_t wr;
+	uint64_t prod_adv;
+	uint64_t cons_adv;
+	uint64_t occ_sum;
+	uint32_t occ_max;
+	uint32_t hist[SAS_SAMPLE_HIST_NUM];
+	uint32_t stuck_num; /* samples where the producer moved but the consumer did not */
+	uint64_t stall_start_ns; /* 0 if the consumer is not stalled */
+	uint64_t stall_max_ns;
+};
+
 struct sas_analy_para {
 	uint32_t chip_id;
 	uint32_t die_id;
@@ -34,5 +65,6 @@ struct sas_analy_para {
 };
 
 int sas_analy_cmd(struct tool_sas_cmd *cmd);
+int sas_analy_sample(const struct tool_sas_cmd *cmd, const struct sas_sample_para *para);
 
 #endif /* SAS_ANALY_DQ_H */
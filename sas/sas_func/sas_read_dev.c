@@ -46,33 +46,52 @@ static int sas_get_dev(const struct tool_sas_cmd *cmd, uint32_t *reg_save, uint3
 	return 0;
 }
 
+static const char *g_dev_type[] = {
+	"not SATA",
+	"SATA",
+};
+
+static const char *g_dev_speed[] = {
+	"1.5Gbps",
+	"3.0GBPS",
+	"6.0Gbps",
+	"12.0GBPS",
+};
+
+const char *sas_dev_link_type_str(const struct sas_dev_link *link, uint32_t phy_id)
+{
+	return g_dev_type[((link->link_type >> phy_id) & 0x1) ? 1 : 0];
+}
+
+/* NULL if the phy is down or reports an unknown speed */
+const char *sas_dev_link_speed_str(const struct sas_dev_link *link, uint32_t phy_id)
+{
+	uint32_t index;
+
+	if (((link->phy_status >> phy_id) & 0x1) == 0)
+		return NULL;
+
+	index = ((link->link_speed >> (phy_id * LINK_SPEED_WIDTH)) & 0xf) - LINK_SPEED_OFFSET;
+	if (index >= HIKP_ARRAY_SIZE(g_dev_speed))
+		return NULL;
+
+	return g_dev_speed[index];
+}
+
 static void print_dev_link(const uint32_t *reg_save)
 {
+	struct sas_dev_link link;
+	const char *speed;
 	uint32_t i;
-	uint32_t index, index1;
-	uint32_t phy_status = reg_save[0];
-	uint32_t link_type = reg_save[1];
-	uint32_t link_speed = reg_save[2];
-	const char *dev_type[] = {
-		"not SATA",
-		"SATA",
-	};
-
-	const char *dev_speed[] = {
-		"1.5Gbps",
-		"3.0GBPS",
-		"6.0Gbps",
-		"12.0GBPS",
-	};
 
+	link.phy_status = reg_save[0];
+	link.link_type = reg_save[1];
+	link.link_speed = reg_save[2];
 	for (i = 0; i <= SAS_MAX_PHY_NUM; i++) {
-		if ((phy_status >> i) & 0x1) {
-			index = ((link_type >> i) & 0x1) ? 1 : 0;
-			index1 = ((link_speed >> (i * LINK_SPEED_WIDTH)) & 0xf) - LINK_SPEED_OFFSET;
-			if (index1 < HIKP_ARRAY_SIZE(dev_speed))
-				printf("device on phy%u is %s, link speed is %s\n",
-				       i, dev_type[index], dev_speed[index1]);
-		}
+		speed = sas_dev_link_speed_str(&link, i);
+		if (speed != NULL)
+			printf("device on phy%u is %s, link speed is %s\n",
+			       i, sas_dev_link_type_str(&link, i), speed);
 	}
 }
 
@@ -108,3 +127,27 @@ int sas_dev(const struct tool_sas_cmd *cmd)
 	sas_print_dev(reg_save, reg_num, cmd->sas_cmd_type);
 	return 0;
 }
+
+int sas_dev_link_get(uint32_t chip_id, uint32_t die_id, struct sas_dev_link *link)
+{
+	struct tool_sas_cmd cmd = {
+		.sas_cmd_type = DEV_LINK,
+		.chip_id = chip_id,
+		.die_id = die_id,
+		.dev_id = (uint32_t)(-1),
+	};
+	uint32_t reg_save[RESP_MAX_NUM] = { 0 };
+	uint32_t reg_num = 0;
+	int ret;
+
+	ret = sas_get_dev(&cmd, reg_save, &reg_num);
+	if (ret)
+		return ret;
+	if (reg_num < REG_NUM_DEV_LINK_MAX)
+		return -EINVAL;
+
+	link->phy_status = reg_save[0];
+	link->link_type = reg_save[1];
+	link->link_speed = reg_save[2];
+	return 0;
+}
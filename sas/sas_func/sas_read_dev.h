@@ -46,6 +46,16 @@ struct hikp_sas_itct {
 	struct hikp_sas_itct_dw2 dw2;
 };
 
+/* DEV_LINK response: bitmap of up phys, bitmap of SATA phys, 4 bits of speed per phy */
+struct sas_dev_link {
+	uint32_t phy_status;
+	uint32_t link_type;
+	uint32_t link_speed;
+};
+
 int sas_dev(const struct tool_sas_cmd *cmd);
+int sas_dev_link_get(uint32_t chip_id, uint32_t die_id, struct sas_dev_link *link);
+const char *sas_dev_link_type_str(const struct sas_dev_link *link, uint32_t phy_id);
+const char *sas_dev_link_speed_str(const struct sas_dev_link *link, uint32_t phy_id);
 
 #endif /* SAS_DEV_H */
@@ -16,6 +16,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <errno.h>
+#include <inttypes.h>
 #include "hikptdev_plug.h"
 #include "sas_common.h"
 #include "sas_read_errcode.h"
@@ -32,7 +33,6 @@ static int sas_get_errcode(const struct tool_sas_cmd *cmd, uint32_t *reg_save, u
 	hikp_cmd_init(&req_header, SAS_MOD, SAS_ERRCODE, cmd->sas_cmd_type);
 	cmd_ret = hikp_cmd_alloc(&req_header, &req_data, sizeof(req_data));
 	if (cmd_ret == NULL || cmd_ret->status != 0 || cmd_ret->rsp_data_num > RESP_MAX_NUM) {
-		printf("sas_errcode excutes hikp_cmd_alloc err\n");
 		hikp_cmd_free(&cmd_ret);
 		return -EINVAL;
 	}
@@ -89,10 +89,232 @@ int sas_errcode_read(struct tool_sas_cmd *cmd)
 		return -ENOSPC;
 
 	ret = sas_get_errcode(cmd, reg_save, &reg_num);
-	if (ret)
+	if (ret) {
+		printf("sas_errcode excutes hikp_cmd_alloc err\n");
 		return ret;
+	}
 
 	sas_print_errcode(cmd->sas_cmd_type, reg_save, reg_num);
 
 	return 0;
 }
+
+static const char *g_errcode_name[SAS_ERR_NUM] = {
+	"DWS_LOST",
+	"RESET_PROB",
+	"CRC_FAIL",
+	"OPEN_REJ",
+};
+
+static int sas_errcode_get_all(uint32_t chip_id, uint32_t die_id, uint32_t *reg_save,
+			       uint32_t *reg_num)
+{
+	struct tool_sas_cmd cmd = { 0 };
+	int ret;
+
+	cmd.sas_cmd_type = ERRCODE_ALL;
+	cmd.chip_id = chip_id;
+	cmd.die_id = die_id;
+	ret = sas_get_errcode(&cmd, reg_save, reg_num);
+	if (ret)
+		return ret;
+
+	if (*reg_num < REG_NUM_ERR_CODE_ALL_MAX)
+		return -EINVAL;
+	*reg_num = REG_NUM_ERR_CODE_ALL_MAX;
+
+	return 0;
+}
+
+static void sas_errcode_print_time(void)
+{
+	uint64_t now = tool_get_wall_time_ns();
+
+	printf("%" PRIu64 ".%03" PRIu64, (uint64_t)(now / HIKP_NSEC_PER_SEC),
+	       (uint64_t)(now % HIKP_NSEC_PER_SEC / HIKP_NSEC_PER_MSEC));
+}
+
+/*
+ * Find the chip/die pairs answering the errcode query, the same way info
+ * collection does: the first die failing on a chip means no more chips.
+ */
+static uint32_t sas_errcode_probe(const struct tool_sas_cmd *cmd, struct sas_errcode_unit *units)
+{
+	uint32_t reg_save[RESP_MAX_NUM] = { 0 };
+	struct sas_errcode_unit *unit;
+	uint32_t unit_num = 0;
+	uint32_t reg_num = 0;
+	uint32_t chip, die;
+	bool first_die;
+
+	for (chip = 0; chip < SAS_WATCH_MAX_CHIP_NUM; chip++) {
+		if (cmd->chip_id != (uint32_t)(-1) && chip != cmd->chip_id)
+			continue;
+
+		first_die = true;
+		for (die = 0; die < SAS_WATCH_MAX_DIE_NUM; die++) {
+			if (cmd->die_id != (uint32_t)(-1) && die != cmd->die_id)
+				continue;
+			if (sas_errcode_get_all(chip, die, reg_save, &reg_num) != 0)
+				break;
+
+			first_die = false;
+			unit = &units[unit_num++];
+			unit->chip_id = chip;
+			unit->die_id = die;
+			unit->phy_num = reg_num / SAS_ERR_NUM;
+			memcpy(unit->last, reg_save, sizeof(unit->last));
+			unit->has_last = true;
+			unit->link_valid = sas_dev_link_get(chip, die, &unit->link) == 0;
+		}
+		if (first_die)
+			break;
+	}
+
+	return unit_num;
+}
+
+static void sas_errcode_watch_link(struct sas_errcode_unit *unit)
+{
+	const char *old_speed, *new_speed;
+	struct sas_dev_link link;
+	uint32_t phy;
+
+	if (sas_dev_link_get(unit->chip_id, unit->die_id, &link) != 0) {
+		unit->link_valid = false;
+		return;
+	}
+
+	for (phy = 0; unit->link_valid && phy < unit->phy_num; phy++) {
+		old_speed = sas_dev_link_speed_str(&unit->link, phy);
+		new_speed = sas_dev_link_speed_str(&link, phy);
+		if (old_speed == new_speed)
+			continue;
+
+		sas_errcode_print_time();
+		printf(" chip%u die%u phy%u link %s -> %s\n", unit->chip_id, unit->die_id, phy,
+		       old_speed != NULL ? old_speed : "down",
+		       new_speed != NULL ? new_speed : "down");
+	}
+	unit->link = link;
+	unit->link_valid = true;
+}
+
+static void sas_errcode_watch_phy(const struct sas_errcode_unit *unit, uint32_t phy,
+				  const uint32_t *reg_save, double interval, uint32_t rate)
+{
+	const uint32_t *cur = &reg_save[phy * SAS_ERR_NUM];
+	const uint32_t *last = &unit->last[phy * SAS_ERR_NUM];
+	uint32_t delta[SAS_ERR_NUM];
+	const char *speed = NULL;
+	bool cleared = false;
+	bool changed = false;
+	bool alert = false;
+	uint64_t move;
+	uint32_t i;
+
+	for (i = 0; i < SAS_ERR_NUM; i++) {
+		/* 32bit counters, only a decrease from the top of the range is a wrap */
+		cleared = cleared ||
+			  tool_cnt_delta(last[i], cur[i], UINT32_MAX, &move) == TOOL_CNT_DOWN;
+		delta[i] = (uint32_t)move;
+		changed = changed || delta[i] != 0;
+		alert = alert || (delta[i] != 0 && (double)delta[i] / interval >= rate);
+	}
+	if (cleared) {
+		sas_errcode_print_time();
+		printf(" chip%u die%u phy%u counters cleared, new baseline\n", unit->chip_id,
+		       unit->die_id, phy);
+		return;
+	}
+	if (!changed)
+		return;
+
+	if (unit->link_valid)
+		speed = sas_dev_link_speed_str(&unit->link, phy);
+
+	sas_errcode_print_time();
+	printf(" chip%u die%u phy%u", unit->chip_id, unit->die_id, phy);
+	if (speed != NULL)
+		printf(" link=%s/%s", sas_dev_link_type_str(&unit->link, phy), speed);
+	else
+		printf(" link=%s", unit->link_valid ? "down" : "-");
+	for (i = 0; i < SAS_ERR_NUM; i++)
+		printf(" %s=+%u(%.1f/s)", g_errcode_name[i], delta[i],
+		       (double)delta[i] / interval);
+	printf("%s\n", alert ? " ALERT" : "");
+}
+
+static void sas_errcode_watch_unit(struct sas_errcode_unit *unit, double interval,
+				   uint32_t rate)
+{
+	uint32_t reg_save[RESP_MAX_NUM] = { 0 };
+	uint32_t reg_num = 0;
+	uint32_t phy;
+	int ret;
+
+	ret = sas_errcode_get_all(unit->chip_id, unit->die_id, reg_save, &reg_num);
+	if (ret) {
+		sas_errcode_print_time();
+		printf(" chip%u die%u err=%d\n", unit->chip_id, unit->die_id, ret);
+		unit->has_last = false;
+		return;
+	}
+
+	sas_errcode_watch_link(unit);
+	if (unit->has_last) {
+		for (phy = 0; phy < unit->phy_num; phy++)
+			sas_errcode_watch_phy(unit, phy, reg_save, interval, rate);
+	}
+	memcpy(unit->last, reg_save, sizeof(unit->last));
+	unit->has_last = true;
+}
+
+int sas_errcode_watch(const struct tool_sas_cmd *cmd, const struct sas_errcode_watch_para *para)
+{
+	uint64_t period_ns = (uint64_t)para->interval * HIKP_NSEC_PER_SEC;
+	struct sas_errcode_unit *units;
+	uint64_t deadline, now_ns, last_ns;
+	uint32_t unit_num;
+	double interval;
+	uint32_t round;
+	uint32_t i;
+	int ret = 0;
+
+	if (cmd == NULL || para == NULL || para->interval == 0)
+		return -EINVAL;
+
+	units = (struct sas_errcode_unit *)calloc(SAS_WATCH_MAX_CHIP_NUM * SAS_WATCH_MAX_DIE_NUM,
+						  sizeof(*units));
+	if (units == NULL)
+		return -ENOMEM;
+
+	unit_num = sas_errcode_probe(cmd, units);
+	if (unit_num == 0) {
+		printf("no SAS chip/die answers the error code query\n");
+		free(units);
+		return -ENODEV;
+	}
+
+	printf("# watching %u SAS chip/die every %us, alert at %u/s, only changed phys are shown\n",
+	       unit_num, para->interval, para->rate);
+	(void)fflush(stdout);
+	last_ns = tool_get_time_ns();
+	deadline = last_ns;
+	for (round = 0; para->count == 0 || round < para->count; round++) {
+		deadline += period_ns;
+		ret = cmd_sleep_until(deadline);
+		if (ret != 0)
+			break;
+
+		now_ns = tool_get_time_ns();
+		interval = (double)(now_ns - last_ns) / HIKP_NSEC_PER_SEC;
+		last_ns = now_ns;
+		for (i = 0; i < unit_num; i++)
+			sas_errcode_watch_unit(&units[i], interval, para->rate);
+		(void)fflush(stdout);
+	}
+
+	free(units);
+	return ret;
+}
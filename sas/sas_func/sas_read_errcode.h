@@ -15,12 +15,37 @@
 #define SAS_ERRCODE_REG_H
 
 #include "sas_tools_include.h"
+#include "sas_common.h"
+#include "sas_read_dev.h"
 
 struct sas_errcode_req_para {
 	uint32_t chip_id;
 	uint32_t die_id;
 };
 
+#define SAS_WATCH_MAX_CHIP_NUM 10
+#define SAS_WATCH_MAX_DIE_NUM 10
+#define SAS_WATCH_MAX_INTERVAL 3600 /* seconds */
+#define SAS_WATCH_DEF_RATE 1 /* errors per second */
+
+struct sas_errcode_watch_para {
+	uint32_t interval; /* seconds, 0 means no watch */
+	uint32_t count; /* rounds, 0 means until interrupted */
+	uint32_t rate; /* alert when a counter grows at least this fast per second */
+};
+
+/* One chip/die pair being watched with its previous counters and link */
+struct sas_errcode_unit {
+	uint32_t chip_id;
+	uint32_t die_id;
+	bool has_last;
+	uint32_t last[REG_NUM_ERR_CODE_ALL_MAX];
+	uint32_t phy_num;
+	bool link_valid;
+	struct sas_dev_link link;
+};
+
 int sas_errcode_read(struct tool_sas_cmd *cmd);
+int sas_errcode_watch(const struct tool_sas_cmd *cmd, const struct sas_errcode_watch_para *para);
 
 #endif /* SAS_ERRCODE_REG_H */
@@ -29,6 +29,10 @@ static int sas_anacq_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit\n");
 	printf("    %s, %-25s %s\n", "-p", "--pointer", "display cq queue read/write pointer\n");
 	printf("    %s, %-25s %s\n", "-s", "--number", "display cq number\n");
+	printf("    %s, %-25s %s\n", "-m", "--sample=<seconds>",
+	       "sample all dq/cq read/write pointers for <seconds>\n");
+	printf("    %s, %-25s %s\n", "-i", "--interval=<ms>",
+	       "sample interval, default 10 ms\n");
 	printf("\n");
 
 	return 0;
@@ -58,6 +62,21 @@ static int sas_anacq_excute_funs_call(uint32_t cmd_type)
 	return -1;
 }
 
+static void sas_anacq_sample_execute(struct major_cmd_ctrl *self)
+{
+	int ret;
+
+	ret = sas_analy_sample(sas_get_cmd_p(), sas_get_sample_p());
+	(void)sas_set_cmd_type(SAS_UNKNOW_CMD);
+	sas_reset_sample_para();
+	if (ret == 0) {
+		printf("sas_analy_cq_sample success.\n");
+	} else {
+		snprintf(self->err_str, sizeof(self->err_str), "sas_analy_cq_sample error.\n");
+		self->err_no = ret;
+	}
+}
+
 static void sas_anacq_execute(struct major_cmd_ctrl *self)
 {
 	int ret, cmd;
@@ -77,6 +96,11 @@ static void sas_anacq_execute(struct major_cmd_ctrl *self)
 		"sas_analy_cq failed, unknown type",
 	};
 
+	if (sas_get_sample_p()->time != 0) {
+		sas_anacq_sample_execute(self);
+		return;
+	}
+
 	cmd = sas_get_cmd_type();
 	ret = sas_anacq_excute_funs_call(cmd);
 	(void)sas_set_cmd_type(SAS_UNKNOW_CMD);
@@ -102,6 +126,8 @@ static void cmd_sas_anacq_init(void)
 	cmd_option_register("-h", "--help", false, sas_anacq_help);
 	cmd_option_register("-p", "--pointer", false, sas_anacq_prt);
 	cmd_option_register("-s", "--number", false, sas_anacq_num);
+	cmd_option_register("-m", "--sample", true, sas_set_sample_time);
+	cmd_option_register("-i", "--interval", true, sas_set_sample_interval);
 }
 
 HIKP_CMD_DECLARE("sas_anacq", "sas analysis cq queue ", cmd_sas_anacq_init);
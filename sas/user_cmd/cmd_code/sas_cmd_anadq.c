@@ -29,6 +29,10 @@ static int sas_anadq_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit\n");
 	printf("    %s, %-25s %s\n", "-p", "--pointer", "display dq queue read/write pointer\n");
 	printf("    %s, %-25s %s\n", "-s", "--number", "display dq number\n");
+	printf("    %s, %-25s %s\n", "-m", "--sample=<seconds>",
+	       "sample all dq/cq read/write pointers for <seconds>\n");
+	printf("    %s, %-25s %s\n", "-i", "--interval=<ms>",
+	       "sample interval, default 10 ms\n");
 	printf("\n");
 
 	return 0;
@@ -58,6 +62,21 @@ static int sas_anadq_excute_funs_call(uint32_t cmd_type)
 	return -1;
 }
 
+static void sas_anadq_sample_execute(struct major_cmd_ctrl *self)
+{
+	int ret;
+
+	ret = sas_analy_sample(sas_get_cmd_p(), sas_get_sample_p());
+	(void)sas_set_cmd_type(SAS_UNKNOW_CMD);
+	sas_reset_sample_para();
+	if (ret == 0) {
+		printf("sas_analy_dq_sample success.\n");
+	} else {
+		snprintf(self->err_str, sizeof(self->err_str), "sas_analy_dq_sample error.\n");
+		self->err_no = ret;
+	}
+}
+
 static void sas_anadq_execute(struct major_cmd_ctrl *self)
 {
 	int ret, cmd;
@@ -71,6 +90,11 @@ static void sas_anadq_execute(struct major_cmd_ctrl *self)
 		"sas_analy_dq failed, unknown type",
 	};
 
+	if (sas_get_sample_p()->time != 0) {
+		sas_anadq_sample_execute(self);
+		return;
+	}
+
 	cmd = sas_get_cmd_type();
 	ret = sas_anadq_excute_funs_call(cmd);
 	(void)sas_set_cmd_type(SAS_UNKNOW_CMD);
@@ -96,6 +120,8 @@ static void cmd_sas_anadq_init(void)
 	cmd_option_register("-h", "--help", false, sas_anadq_help);
 	cmd_option_register("-p", "--pointer", false, sas_anadq_prt);
 	cmd_option_register("-s", "--number", false, sas_anadq_num);
+	cmd_option_register("-m", "--sample", true, sas_set_sample_time);
+	cmd_option_register("-i", "--interval", true, sas_set_sample_interval);
 }
 
 HIKP_CMD_DECLARE("sas_anadq", "sas analysis dq queue ", cmd_sas_anadq_init);
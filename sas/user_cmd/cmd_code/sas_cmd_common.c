@@ -23,6 +23,10 @@ static struct tool_sas_cmd g_sas_cmd = {
 	.dqe_id = (uint32_t)(-1),
 };
 
+static struct sas_sample_para g_sas_sample = {
+	.interval = SAS_SAMPLE_DEF_INTERVAL,
+};
+
 static int sas_set_id(struct major_cmd_ctrl *self, const char *argv, uint32_t *id)
 {
 	int ret;
@@ -88,3 +92,46 @@ int sas_set_dqe_id(struct major_cmd_ctrl *self, const char *argv)
 {
 	return sas_set_id(self, argv, &g_sas_cmd.dqe_id);
 }
+
+int sas_set_sample_time(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t val = 0;
+	int ret;
+
+	ret = string_toui(argv, &val);
+	if (ret || val == 0 || val > SAS_SAMPLE_MAX_TIME) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "Invalid sample time, range is 1~%u seconds.", SAS_SAMPLE_MAX_TIME);
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+	g_sas_sample.time = val;
+	return 0;
+}
+
+int sas_set_sample_interval(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t val = 0;
+	int ret;
+
+	ret = string_toui(argv, &val);
+	if (ret || val == 0 || val > SAS_SAMPLE_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "Invalid sample interval, range is 1~%u ms.", SAS_SAMPLE_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+	g_sas_sample.interval = val;
+	return 0;
+}
+
+struct sas_sample_para *sas_get_sample_p(void)
+{
+	return &g_sas_sample;
+}
+
+void sas_reset_sample_para(void)
+{
+	g_sas_sample.time = 0;
+	g_sas_sample.interval = SAS_SAMPLE_DEF_INTERVAL;
+}
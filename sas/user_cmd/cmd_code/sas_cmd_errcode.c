@@ -16,6 +16,10 @@
 #include "sas_tools_include.h"
 #include "sas_read_errcode.h"
 
+static struct sas_errcode_watch_para g_errcode_watch = {
+	.rate = SAS_WATCH_DEF_RATE,
+};
+
 static int sas_errcode_help(struct major_cmd_ctrl *self, const char *argv)
 {
 	HIKP_SET_USED(argv);
@@ -27,6 +31,12 @@ static int sas_errcode_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("\n  Options:\n\n");
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit\n");
 	printf("    %s, %-25s %s\n", "-t", "--type", "read error code of 8 phys\n");
+	printf("    %s, %-25s %s\n", "-w", "--watch=<seconds>",
+	       "watch error codes of all phys every <seconds>, print only changed phys\n");
+	printf("    %s, %-25s %s\n", "-n", "--count=<num>",
+	       "stop watching after <num> rounds, default until interrupted\n");
+	printf("    %s, %-25s %s\n", "-r", "--rate=<errors/s>",
+	       "flag a phy as ALERT at this per counter rate, default 1\n");
 	printf("\n");
 
 	return 0;
@@ -48,6 +58,70 @@ static int sas_errcode_one(struct major_cmd_ctrl *self, char const *argv)
 	return 0;
 }
 
+static int sas_errcode_watch_interval(struct major_cmd_ctrl *self, char const *argv)
+{
+	uint32_t val = 0;
+	int ret;
+
+	ret = string_toui(argv, &val);
+	if (ret || val == 0 || val > SAS_WATCH_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "Invalid watch interval, range is 1~%u seconds.", SAS_WATCH_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+
+	g_errcode_watch.interval = val;
+	return 0;
+}
+
+static int sas_errcode_watch_count(struct major_cmd_ctrl *self, char const *argv)
+{
+	uint32_t val = 0;
+	int ret;
+
+	ret = string_toui(argv, &val);
+	if (ret || val == 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "Invalid watch count.");
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+
+	g_errcode_watch.count = val;
+	return 0;
+}
+
+static int sas_errcode_watch_rate(struct major_cmd_ctrl *self, char const *argv)
+{
+	uint32_t val = 0;
+	int ret;
+
+	ret = string_toui(argv, &val);
+	if (ret || val == 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "Invalid alert rate.");
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+
+	g_errcode_watch.rate = val;
+	return 0;
+}
+
+static void sas_errcode_watch_execute(struct major_cmd_ctrl *self)
+{
+	int ret;
+
+	ret = sas_errcode_watch(sas_get_cmd_p(), &g_errcode_watch);
+	(void)sas_set_cmd_type(SAS_UNKNOW_CMD);
+	g_errcode_watch.interval = 0;
+	g_errcode_watch.count = 0;
+	g_errcode_watch.rate = SAS_WATCH_DEF_RATE;
+	if (ret) {
+		snprintf(self->err_str, sizeof(self->err_str), "sas_errcode watch error.\n");
+		self->err_no = ret;
+	}
+}
+
 static int sas_errcode_excute_funs_call(uint32_t cmd_type)
 {
 	if (cmd_type != SAS_UNKNOW_CMD)
@@ -75,6 +149,11 @@ static void sas_errcode_execute(struct major_cmd_ctrl *self)
 		"sas_errcode failed, unknown type",
 	};
 
+	if (g_errcode_watch.interval != 0) {
+		sas_errcode_watch_execute(self);
+		return;
+	}
+
 	cmd = sas_get_cmd_type();
 	ret = sas_errcode_excute_funs_call(cmd);
 	(void)sas_set_cmd_type(SAS_UNKNOW_CMD);
@@ -99,6 +178,9 @@ static void cmd_sas_errcode_init(void)
 	cmd_option_register("-c", "--chipid", true, sas_set_chip_id);
 	cmd_option_register("-d", "--dieid", true, sas_set_die_id);
 	cmd_option_register("-t", "--type", true, sas_errcode_one);
+	cmd_option_register("-w", "--watch", true, sas_errcode_watch_interval);
+	cmd_option_register("-n", "--count", true, sas_errcode_watch_count);
+	cmd_option_register("-r", "--rate", true, sas_errcode_watch_rate);
 }
 
 HIKP_CMD_DECLARE("sas_errcode", "sas read error code", cmd_sas_errcode_init);
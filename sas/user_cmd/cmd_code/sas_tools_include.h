@@ -31,6 +31,15 @@ struct tool_sas_cmd {
 	uint32_t dqe_id;
 };
 
+#define SAS_SAMPLE_MAX_TIME 3600 /* seconds */
+#define SAS_SAMPLE_MAX_INTERVAL 1000 /* ms */
+#define SAS_SAMPLE_DEF_INTERVAL 10 /* ms */
+
+struct sas_sample_para {
+	uint32_t time; /* seconds to sample for, 0 means a one-shot read */
+	uint32_t interval; /* ms between two samples */
+};
+
 int sas_set_cmd_type(int cmd_type);
 int sas_get_cmd_type(void);
 int sas_get_phy_id(void);
@@ -41,5 +50,9 @@ int sas_set_phy_id(struct major_cmd_ctrl *self, const char *argv);
 int sas_set_die_id(struct major_cmd_ctrl *self, const char *argv);
 int sas_set_que_id(struct major_cmd_ctrl *self, const char *argv);
 int sas_set_dqe_id(struct major_cmd_ctrl *self, const char *argv);
+int sas_set_sample_time(struct major_cmd_ctrl *self, const char *argv);
+int sas_set_sample_interval(struct major_cmd_ctrl *self, const char *argv);
+struct sas_sample_para *sas_get_sample_p(void);
+void sas_reset_sample_para(void);
 
 #endif /* SAS_TOOLS_INCLUDE_H */
@@ -22,7 +22,6 @@
 
 static struct cmd_serdes_param g_serdes_param = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
 
-#define SERDES_OUTPUT_MAX_SIZE 2560
 static char g_serdes_data_out_buf[SERDES_OUTPUT_MAX_SIZE] = {0};
 static struct hilink_cmd_out g_out_put = {0};
 
@@ -283,12 +282,13 @@ static void hikp_serdes_print(struct cmd_serdes_param *cmd)
 		hikp_serdes_dump_print(cmd);
 }
 
-int hikp_serdes_get_reponse(struct cmd_serdes_param *cmd)
+int hikp_serdes_query(const struct cmd_serdes_param *cmd, struct hilink_cmd_out *out)
 {
 	struct hikp_cmd_header req_header = {0};
 	struct hikp_cmd_ret *cmd_ret;
 	struct hilink_cmd_in hilink_cmd = {0};
 	size_t out_out_header_size;
+	uint32_t buf_size = out->str_len;
 
 	hilink_cmd.cmd_type              = cmd->cmd_type;
 	hilink_cmd.sub_cmd               = cmd->sub_cmd;
@@ -297,8 +297,6 @@ int hikp_serdes_get_reponse(struct cmd_serdes_param *cmd)
 	hilink_cmd.cmd_para.start_sds_id = cmd->start_sds_id;
 	hilink_cmd.cmd_para.sds_num      = cmd->sds_num;
 
-	hikp_serdes_logout_init(&g_out_put, g_serdes_data_out_buf, SERDES_OUTPUT_MAX_SIZE, 0);
-
 	hikp_cmd_init(&req_header, SERDES_MOD, cmd->cmd_type, cmd->sub_cmd);
 	cmd_ret = hikp_cmd_alloc(&req_header, &hilink_cmd, sizeof(hilink_cmd));
 	if (cmd_ret == NULL || cmd_ret->status != 0) {
@@ -306,21 +304,33 @@ int hikp_serdes_get_reponse(struct cmd_serdes_param *cmd)
 		hikp_cmd_free(&cmd_ret);
 		return -EINVAL;
 	}
-	out_out_header_size = sizeof(g_out_put.str_len) + sizeof(g_out_put.result_offset) +
-			      sizeof(g_out_put.type) + sizeof(g_out_put.ret_val);
-	memcpy(&g_out_put, cmd_ret->rsp_data, out_out_header_size);
+	out_out_header_size = sizeof(out->str_len) + sizeof(out->result_offset) +
+			      sizeof(out->type) + sizeof(out->ret_val);
+	memcpy(out, cmd_ret->rsp_data, out_out_header_size);
 
-	if ((cmd_ret->rsp_data_num * sizeof(uint32_t) - out_out_header_size) > SERDES_OUTPUT_MAX_SIZE) {
+	if ((cmd_ret->rsp_data_num * sizeof(uint32_t) - out_out_header_size) > buf_size) {
 		printf("serdes_info rsp_data data copy size error, data size:0x%zx max size:0x%x.",
 			(cmd_ret->rsp_data_num * sizeof(uint32_t) - out_out_header_size),
-			SERDES_OUTPUT_MAX_SIZE);
+			buf_size);
 		hikp_cmd_free(&cmd_ret);
 		return -EINVAL;
 	}
-	memcpy(g_out_put.out_str, cmd_ret->rsp_data + out_out_header_size / sizeof(uint32_t),
+	memcpy(out->out_str, cmd_ret->rsp_data + out_out_header_size / sizeof(uint32_t),
 		cmd_ret->rsp_data_num * sizeof(uint32_t) - out_out_header_size);
 	hikp_cmd_free(&cmd_ret);
 
+	return 0;
+}
+
+int hikp_serdes_get_reponse(struct cmd_serdes_param *cmd)
+{
+	int ret;
+
+	hikp_serdes_logout_init(&g_out_put, g_serdes_data_out_buf, SERDES_OUTPUT_MAX_SIZE, 0);
+	ret = hikp_serdes_query(cmd, &g_out_put);
+	if (ret != 0)
+		return ret;
+
 	hikp_serdes_print(cmd);
 
 	return 0;
@@ -147,6 +147,9 @@ struct hilink_cmd_in {
 	};
 };
 
+#define SERDES_OUTPUT_MAX_SIZE 2560
+
+/* out_str/str_len give the buffer on input, str_len is firmware's on return */
 struct hilink_cmd_out {
 	uint32_t str_len;                     /* out_str length */
 	uint32_t result_offset;
@@ -215,6 +218,7 @@ struct hilink_brief_info {
 	uint32_t rsvd_1;
 };
 
+int hikp_serdes_query(const struct cmd_serdes_param *cmd, struct hilink_cmd_out *out);
 int hikp_serdes_get_reponse(struct cmd_serdes_param *cmd);
 
 #endif /* HIKP_SERDES_H */
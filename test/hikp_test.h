@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef HIKP_TEST_H
+#define HIKP_TEST_H
+
+#include <stdio.h>
+
+/* Failed checks of the running test program, its exit code is HIKP_TEST_RESULT() */
+static int g_hikp_test_fail;
+
+#define HIKP_TEST_CHECK(cond)                                                      \
+	do {                                                                       \
+		if (!(cond)) {                                                     \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,     \
+				__LINE__, #cond);                                  \
+			g_hikp_test_fail++;                                        \
+		}                                                                  \
+	} while (0)
+
+#define HIKP_TEST_RESULT() (g_hikp_test_fail != 0 ? 1 : 0)
+
+#endif /* HIKP_TEST_H */
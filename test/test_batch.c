@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+/* The batch parser lives next to the tool's main, keep that one out of the way */
+#define main hikp_main
+int hikp_main(const int argc, const char **argv);
+#include "hikp_init_main.c"
+#undef main
+#include "hikp_test.h"
+
+/* hikp_register.ld is not used for the host link, give it an empty command table */
+int _s_cmd_data;
+__asm__(".globl _e_cmd_data\n\t.set _e_cmd_data, _s_cmd_data");
+
+#define TEST_LINE_LEN 512
+
+static int test_split(const char *text, const char **argv)
+{
+	static char line[TEST_LINE_LEN];
+
+	(void)snprintf(line, sizeof(line), "%s", text);
+	return hikp_batch_split_line(line, argv, BATCH_MAX_ARGS);
+}
+
+static void test_split_line(void)
+{
+	const char *argv[BATCH_MAX_ARGS];
+
+	HIKP_TEST_CHECK(test_split("nic_info -i eth0\n", argv) == 4);
+	HIKP_TEST_CHECK(strcmp(argv[0], get_tool_name()) == 0);
+	HIKP_TEST_CHECK(strcmp(argv[1], "nic_info") == 0 && strcmp(argv[3], "eth0") == 0);
+	HIKP_TEST_CHECK(test_split(" \tnic_info\t-i  eth0 \r\n", argv) == 4);
+	HIKP_TEST_CHECK(strcmp(argv[2], "-i") == 0 && strcmp(argv[3], "eth0") == 0);
+
+	/* Blank and comment lines hold no command */
+	HIKP_TEST_CHECK(test_split("", argv) == 1);
+	HIKP_TEST_CHECK(test_split("   \n", argv) == 1);
+	HIKP_TEST_CHECK(test_split("# nic_info -i eth0", argv) == 1);
+	HIKP_TEST_CHECK(test_split("  # indented", argv) == 1);
+	/* A '#' only starts a comment at the start of a word */
+	HIKP_TEST_CHECK(test_split("nic_dfx -m SSU # trailing", argv) == 4);
+	HIKP_TEST_CHECK(test_split("nic_dfx a#b", argv) == 3 && strcmp(argv[2], "a#b") == 0);
+
+	/* Quotes group words and are dropped, the other quote is literal inside */
+	HIKP_TEST_CHECK(test_split("cmd 'a b' \"c  d\"", argv) == 4);
+	HIKP_TEST_CHECK(strcmp(argv[2], "a b") == 0 && strcmp(argv[3], "c  d") == 0);
+	HIKP_TEST_CHECK(test_split("cmd \"it's\" 'say \"hi\"'", argv) == 4);
+	HIKP_TEST_CHECK(strcmp(argv[2], "it's") == 0 && strcmp(argv[3], "say \"hi\"") == 0);
+	HIKP_TEST_CHECK(test_split("cmd pre'fix 'post \"\"", argv) == 4);
+	HIKP_TEST_CHECK(strcmp(argv[2], "prefix post") == 0 && strcmp(argv[3], "") == 0);
+	HIKP_TEST_CHECK(test_split("cmd 'open", argv) == -EINVAL);
+	HIKP_TEST_CHECK(test_split("cmd \"open'", argv) == -EINVAL);
+
+	/* A line pasted from a shell may start with the tool name */
+	HIKP_TEST_CHECK(test_split(TOOL_NAME " nic_info -i eth0", argv) == 4);
+	HIKP_TEST_CHECK(strcmp(argv[1], "nic_info") == 0);
+	HIKP_TEST_CHECK(test_split(TOOL_NAME, argv) == 1);
+}
+
+static void test_split_limit(void)
+{
+	const char *argv[BATCH_MAX_ARGS];
+	char line[TEST_LINE_LEN] = { 0 };
+	int i;
+
+	/* argv[0] is the tool name, BATCH_MAX_ARGS - 1 words fit */
+	for (i = 0; i < BATCH_MAX_ARGS - 1; i++)
+		(void)strcat(line, "w ");
+	HIKP_TEST_CHECK(test_split(line, argv) == BATCH_MAX_ARGS);
+	(void)strcat(line, "w");
+	HIKP_TEST_CHECK(test_split(line, argv) == -E2BIG);
+}
+
+static void test_batch_mode(void)
+{
+	const char *file_short[] = { TOOL_NAME, "-f", "cmds.txt" };
+	const char *file_long[] = { TOOL_NAME, "--file", "-" };
+	const char *cmd[] = { TOOL_NAME, "nic_info", "-f" };
+
+	HIKP_TEST_CHECK(is_batch_mode(ARG_NUM_FOR_BATCH, file_short));
+	HIKP_TEST_CHECK(is_batch_mode(ARG_NUM_FOR_BATCH, file_long));
+	HIKP_TEST_CHECK(!is_batch_mode(ARG_NUM_FOR_BATCH, cmd));
+	HIKP_TEST_CHECK(!is_batch_mode(ARG_NUM_FOR_BATCH - 1, file_short));
+}
+
+int main(void)
+{
+	test_split_line();
+	test_split_limit();
+	test_batch_mode();
+
+	return HIKP_TEST_RESULT();
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include "hikp_nic_ppp.c"
+#include "hikp_test.h"
+
+#define TEST_REC_NUM 1000
+#define TEST_MAC_NUM 200
+
+static struct major_cmd_ctrl g_test_self;
+static struct nic_ppp_mac_rec g_test_rec[TEST_REC_NUM];
+
+static void test_param_reset(void)
+{
+	memset(&g_ppp_param, 0, sizeof(g_ppp_param));
+	memset(&g_test_self, 0, sizeof(g_test_self));
+	g_ppp_param.vlan_id = -1;
+}
+
+static void test_parse_find(void)
+{
+	static const uint8_t mac0[] = { 0x00, 0x18, 0x2d, 0x00, 0x00, 0x01 };
+	static const uint8_t mac1[] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+	char list[(NIC_PPP_MAX_FIND_MAC + 1) * HIKP_NIC_ETH_ADDR_FMT_SIZE] = { 0 };
+	uint32_t i;
+
+	test_param_reset();
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_find(&g_test_self,
+						    "00:18:2d:00:00:01,FF-FF-FF-FF-FF-FF") == 0);
+	HIKP_TEST_CHECK(g_ppp_param.find_num == 2);
+	HIKP_TEST_CHECK(memcmp(g_ppp_param.find_mac[0], mac0, sizeof(mac0)) == 0);
+	HIKP_TEST_CHECK(memcmp(g_ppp_param.find_mac[1], mac1, sizeof(mac1)) == 0);
+	/* -fd may be given again, the MACs add up */
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_find(&g_test_self, "0:1:2:3:4:5") == 0);
+	HIKP_TEST_CHECK(g_ppp_param.find_num == 3 && g_ppp_param.find_mac[2][5] == 5);
+
+	static const char * const bad[] = {
+		"00:18:2d:00:00", "00:18:2d:00:00:01:02", "00:18:2d:00:00:0g",
+		"000:18:2d:00:00:01", "00:18:2d:00:00:01x", "00 18 2d 00 00 01", "",
+	};
+	for (i = 0; i < HIKP_ARRAY_SIZE(bad); i++) {
+		test_param_reset();
+		HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_find(&g_test_self, bad[i]) == -EINVAL ||
+				(bad[i][0] == '\0' && g_ppp_param.find_num == 0));
+	}
+
+	test_param_reset();
+	for (i = 0; i <= NIC_PPP_MAX_FIND_MAC; i++)
+		(void)snprintf(list + strlen(list), sizeof(list) - strlen(list),
+			       "%s00:00:00:00:00:%02x", i == 0 ? "" : ",", i);
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_find(&g_test_self, list) == -EINVAL);
+	HIKP_TEST_CHECK(g_ppp_param.find_num == NIC_PPP_MAX_FIND_MAC);
+}
+
+static void test_parse_vlan(void)
+{
+	test_param_reset();
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_vlan(&g_test_self, "0") == 0);
+	HIKP_TEST_CHECK(g_ppp_param.vlan_id == 0);
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_vlan(&g_test_self, "4095") == 0);
+	HIKP_TEST_CHECK(g_ppp_param.vlan_id == NIC_PPP_MAX_VLAN_ID);
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_vlan(&g_test_self, "4096") == -EINVAL);
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_vlan(&g_test_self, "-1") == -EINVAL);
+	HIKP_TEST_CHECK(hikp_nic_cmd_ppp_parse_vlan(&g_test_self, "vlan") == -EINVAL);
+	HIKP_TEST_CHECK(g_ppp_param.vlan_id == NIC_PPP_MAX_VLAN_ID);
+}
+
+/*
+ * TEST_MAC_NUM MACs in five VLANs, every tenth MAC also multicast in place of
+ * its VLAN 0 entry, so several records share a probe run.
+ */
+static uint32_t test_rec_fill(struct nic_ppp_mac_rec *rec)
+{
+	uint32_t i;
+
+	memset(rec, 0, sizeof(*rec) * TEST_REC_NUM);
+	for (i = 0; i < TEST_REC_NUM; i++) {
+		rec[i].key.mac_addr[0] = 0x02;
+		rec[i].key.mac_addr[4] = (uint8_t)((i % TEST_MAC_NUM) >> 8);
+		rec[i].key.mac_addr[5] = (uint8_t)(i % TEST_MAC_NUM);
+		rec[i].idx = i;
+		if (i % 10 == 9 && i < TEST_MAC_NUM) {
+			rec[i].func_bitmap[0] = i;
+			continue;
+		}
+		rec[i].key.is_uc = 1;
+		rec[i].key.vlan_id = (uint16_t)(i / TEST_MAC_NUM);
+		rec[i].e_vport = (uint16_t)i;
+	}
+
+	return TEST_REC_NUM;
+}
+
+static uint32_t test_linear_count(const struct nic_ppp_mac_rec *rec, uint32_t num,
+				  const uint8_t *mac, int vlan_id)
+{
+	uint32_t count = 0;
+	uint32_t i;
+
+	for (i = 0; i < num; i++) {
+		if (memcmp(rec[i].key.mac_addr, mac, HIKP_NIC_ETH_MAC_ADDR_LEN) != 0)
+			continue;
+		if (vlan_id == -1 || (rec[i].key.is_uc && rec[i].key.vlan_id == vlan_id))
+			count++;
+	}
+
+	return count;
+}
+
+static void test_mac_index(void)
+{
+	struct nic_ppp_mac_index index = { 0 };
+	const struct nic_ppp_mac_rec *rec;
+	struct nic_ppp_mac_rec *copy;
+	struct nic_ppp_mac_key key;
+	uint32_t num, count, pos;
+	uint32_t i;
+	int vlan_id;
+
+	num = test_rec_fill(g_test_rec);
+	copy = (struct nic_ppp_mac_rec *)calloc(num, sizeof(*copy));
+	HIKP_TEST_CHECK(copy != NULL);
+	if (copy == NULL)
+		return;
+	memcpy(copy, g_test_rec, num * sizeof(*copy));
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_index_build(&index, copy, num) == 0);
+	HIKP_TEST_CHECK(index.mask + 1 >= num * 2);
+
+	/* Every record is found by its own key */
+	for (i = 0; i < num; i++) {
+		rec = hikp_nic_ppp_mac_index_lookup(&index, &g_test_rec[i].key);
+		HIKP_TEST_CHECK(rec != NULL && rec->idx == g_test_rec[i].idx);
+	}
+
+	/* -fd with and without -vl matches what a scan of the table finds */
+	for (i = 0; i < TEST_MAC_NUM; i++) {
+		for (vlan_id = -1; vlan_id <= 5; vlan_id++) {
+			pos = UINT32_MAX;
+			count = 0;
+			while (hikp_nic_ppp_mac_index_next(&index, g_test_rec[i].key.mac_addr,
+							   vlan_id, &pos) != NULL)
+				count++;
+			HIKP_TEST_CHECK(count == test_linear_count(g_test_rec, num,
+								   g_test_rec[i].key.mac_addr,
+								   vlan_id));
+		}
+	}
+
+	/* Absent keys: unknown MAC, known MAC in another VLAN or of another type */
+	key = g_test_rec[0].key;
+	key.mac_addr[3] = 0x55;
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_index_lookup(&index, &key) == NULL);
+	key = g_test_rec[0].key;
+	key.vlan_id = NIC_PPP_MAX_VLAN_ID;
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_index_lookup(&index, &key) == NULL);
+	key = g_test_rec[0].key;
+	key.is_uc = 0;
+	key.vlan_id = 0;
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_index_lookup(&index, &key) == NULL);
+
+	hikp_nic_ppp_mac_index_free(&index);
+	HIKP_TEST_CHECK(index.rec == NULL && index.slot == NULL && index.rec_num == 0);
+
+	/* An empty table still has slots to probe */
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_index_build(&index, calloc(1, sizeof(*copy)), 0) == 0);
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_index_lookup(&index, &g_test_rec[0].key) == NULL);
+	hikp_nic_ppp_mac_index_free(&index);
+}
+
+static void test_snap_diff(void)
+{
+	char file[] = "/tmp/hikp_test_nic_ppp_XXXXXX";
+	struct nic_ppp_mac_index old_index = { 0 };
+	struct nic_ppp_mac_index index = { 0 };
+	struct tool_snap_head head = { 0 };
+	struct nic_ppp_mac_rec *copy;
+	uint32_t num;
+	int fd;
+
+	fd = mkstemp(file);
+	HIKP_TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+	close(fd);
+
+	num = test_rec_fill(g_test_rec);
+	copy = (struct nic_ppp_mac_rec *)calloc(num, sizeof(*copy));
+	HIKP_TEST_CHECK(copy != NULL);
+	if (copy == NULL)
+		return;
+	memcpy(copy, g_test_rec, num * sizeof(*copy));
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_index_build(&index, copy, num) == 0);
+
+	test_param_reset();
+	(void)snprintf(g_ppp_param.snap_file, sizeof(g_ppp_param.snap_file), "%s", file);
+	g_ppp_param.target.bdf.domain = 0;
+	g_ppp_param.target.bdf.bdf_id = 0x3500;
+	HIKP_TEST_CHECK(hikp_nic_ppp_snap_save(&index, &g_ppp_param) == 0);
+	HIKP_TEST_CHECK(hikp_nic_ppp_snap_load(&old_index, &head, &g_ppp_param) == 0);
+	HIKP_TEST_CHECK(old_index.rec_num == num);
+	HIKP_TEST_CHECK(memcmp(old_index.rec, g_test_rec, num * sizeof(*copy)) == 0);
+	HIKP_TEST_CHECK(hikp_nic_ppp_snap_diff(&index, &g_ppp_param) == 0);
+
+	/* Only the vport of a unicast and the bitmap of a multicast entry count */
+	HIKP_TEST_CHECK(!hikp_nic_ppp_mac_rec_changed(&old_index.rec[0], &index.rec[0]));
+	index.rec[0].e_vport++;
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_rec_changed(&old_index.rec[0], &index.rec[0]));
+	index.rec[0].idx++;
+	index.rec[0].e_vport--;
+	HIKP_TEST_CHECK(!hikp_nic_ppp_mac_rec_changed(&old_index.rec[0], &index.rec[0]));
+	index.rec[9].func_bitmap[HIKP_NIC_ENTRY_FUNC_BITMAP_CNT - 1] = 1;
+	HIKP_TEST_CHECK(hikp_nic_ppp_mac_rec_changed(&old_index.rec[9], &index.rec[9]));
+	hikp_nic_ppp_mac_index_free(&old_index);
+
+	/* A snapshot of another function is not diffed */
+	g_ppp_param.target.bdf.bdf_id = 0x3600;
+	HIKP_TEST_CHECK(hikp_nic_ppp_snap_load(&old_index, &head, &g_ppp_param) == -EINVAL);
+	HIKP_TEST_CHECK(hikp_nic_ppp_snap_diff(&index, &g_ppp_param) == -EINVAL);
+
+	hikp_nic_ppp_mac_index_free(&index);
+	unlink(file);
+}
+
+int main(void)
+{
+	test_parse_find();
+	test_parse_vlan();
+	test_mac_index();
+	test_snap_diff();
+
+	return HIKP_TEST_RESULT();
+}
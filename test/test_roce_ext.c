@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <unistd.h>
+#include "hikp_roce_ext_common.c"
+#include "hikp_test.h"
+
+#define TEST_REG_NUM 5
+#define TEST_OUT_LEN 4096
+
+static uint32_t g_test_offset[TEST_REG_NUM] = { 0x0, 0x4, 0x8, 0xc, 0x10 };
+static const char *g_test_name[TEST_REG_NUM] = {
+	"slow_cnt", "wrap_cnt", "cleared_cnt", "idle_cnt", "fast_cnt",
+};
+
+static void test_output_init(struct roce_ext_res_output *output, uint32_t *data)
+{
+	memset(output, 0, sizeof(*output));
+	output->res_head.total_block_num = TEST_REG_NUM;
+	output->reg.offset = g_test_offset;
+	output->reg.data_u32 = data;
+	output->per_val_size = sizeof(uint32_t);
+	output->reg_name.reg_name = g_test_name;
+	output->reg_name.arr_len = TEST_REG_NUM;
+}
+
+/* Run the rate window and return what it printed */
+static void test_rate_show(const uint32_t *old_data, const uint32_t *new_data, char *out,
+			   size_t len)
+{
+	uint32_t old_copy[TEST_REG_NUM];
+	uint32_t new_copy[TEST_REG_NUM];
+	struct roce_ext_res_output old_output;
+	struct roce_ext_res_output new_output;
+	FILE *fp = tmpfile();
+	int saved_fd;
+	size_t n = 0;
+
+	memcpy(old_copy, old_data, sizeof(old_copy));
+	memcpy(new_copy, new_data, sizeof(new_copy));
+	test_output_init(&old_output, old_copy);
+	test_output_init(&new_output, new_copy);
+	out[0] = '\0';
+	HIKP_TEST_CHECK(fp != NULL);
+	if (fp == NULL)
+		return;
+
+	(void)fflush(stdout);
+	saved_fd = dup(STDOUT_FILENO);
+	(void)dup2(fileno(fp), STDOUT_FILENO);
+	hikp_roce_ext_rate_show(GET_ROCEE_MDB_CMD, &old_output, &new_output, 2.0);
+	(void)fflush(stdout);
+	(void)dup2(saved_fd, STDOUT_FILENO);
+	(void)close(saved_fd);
+
+	rewind(fp);
+	n = fread(out, 1, len - 1, fp);
+	out[n] = '\0';
+	(void)fclose(fp);
+}
+
+static void test_rate(void)
+{
+	static const uint32_t old_data[TEST_REG_NUM] = { 100, 0xfffffff0, 500, 7, 1000 };
+	static const uint32_t new_data[TEST_REG_NUM] = { 150, 0x10, 100, 7, 3000 };
+	char out[TEST_OUT_LEN];
+	const char *fast, *slow, *wrap, *cleared;
+
+	test_rate_show(old_data, new_data, out, sizeof(out));
+	fast = strstr(out, "fast_cnt");
+	slow = strstr(out, "slow_cnt");
+	wrap = strstr(out, "wrap_cnt");
+	cleared = strstr(out, "cleared_cnt");
+
+	/* Fastest first, a wrap near the top is an increase of 0x20 */
+	HIKP_TEST_CHECK(fast != NULL && slow != NULL && wrap != NULL);
+	HIKP_TEST_CHECK(fast < slow && slow < wrap);
+	HIKP_TEST_CHECK(fast != NULL && strstr(fast, ": 2000 ") != NULL);
+	HIKP_TEST_CHECK(wrap != NULL && strstr(wrap, ": 32 ") != NULL);
+	/* A clear is listed after the rates with its drop, never as a ~4G increase */
+	HIKP_TEST_CHECK(cleared != NULL && wrap != NULL && cleared > wrap);
+	HIKP_TEST_CHECK(cleared != NULL && strstr(cleared, ": -400 ") != NULL);
+	HIKP_TEST_CHECK(strstr(out, "4294967") == NULL);
+	HIKP_TEST_CHECK(strstr(out, "idle_cnt") == NULL);
+	HIKP_TEST_CHECK(strstr(out, "3 of 5 register(s) moved, 1 went down.") != NULL);
+
+	/* --top bounds the rate list only, the drops are always shown */
+	g_roce_ext_rate.top = 1;
+	test_rate_show(old_data, new_data, out, sizeof(out));
+	HIKP_TEST_CHECK(strstr(out, "fast_cnt") != NULL && strstr(out, "slow_cnt") == NULL);
+	HIKP_TEST_CHECK(strstr(out, "cleared_cnt") != NULL);
+	g_roce_ext_rate.top = ROCE_EXT_RATE_DEF_TOP;
+}
+
+int main(void)
+{
+	test_rate();
+
+	return HIKP_TEST_RESULT();
+}
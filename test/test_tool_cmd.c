@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include "tool_cmd.c"
+#include "hikp_test.h"
+
+#define TEST_OPTION_NUM 48
+#define TEST_NAME_LEN 16
+#define TEST_BENCH_ROUNDS 20000
+
+static char g_test_little[TEST_OPTION_NUM][TEST_NAME_LEN];
+static char g_test_large[TEST_OPTION_NUM][TEST_NAME_LEN];
+static struct hikp_cmd_type g_test_cmd = { "test_cmd", "", NULL };
+static const char *g_test_param;
+static uint32_t g_test_record_num;
+
+static int test_record(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(self);
+
+	g_test_param = argv;
+	g_test_record_num++;
+
+	return 0;
+}
+
+/* Even options take a parameter, odd ones do not */
+static struct major_cmd_ctrl *test_setup(void)
+{
+	struct major_cmd_ctrl *major_cmd = get_major_cmd();
+	uint32_t i;
+
+	major_cmd->option_count = 0;
+	major_cmd->cmd_ptr = &g_test_cmd;
+	for (i = 0; i < TEST_OPTION_NUM; i++) {
+		(void)snprintf(g_test_little[i], TEST_NAME_LEN, "-o%u", i);
+		(void)snprintf(g_test_large[i], TEST_NAME_LEN, "--opt%u", i);
+		cmd_option_register(g_test_little[i], g_test_large[i], i % 2 == 0, test_record);
+	}
+	g_test_param = NULL;
+	g_test_record_num = 0;
+
+	return major_cmd;
+}
+
+static int test_parse(const char **argv, int argc, enum cmd_parse_err_type type, int arg_idx)
+{
+	struct major_cmd_ctrl *major_cmd = test_setup();
+	int ret;
+
+	ret = major_command_parse(major_cmd, argc, argv);
+	HIKP_TEST_CHECK(major_cmd->parse_err.type == type);
+	HIKP_TEST_CHECK(major_cmd->parse_err.arg_idx == arg_idx);
+
+	return ret;
+}
+
+static void test_option_parse(void)
+{
+	const char *ok[] = { "-o0", "x", "--opt2=y", "--opt3" };
+	const char *dash_eq[] = { "--opt4=-5" };
+	const char *dash[] = { "-o4", "-5" };
+	const char *no_param[] = { "--opt1=v" };
+	const char *empty[] = { "--opt4=" };
+	const char *last[] = { "--opt4" };
+	const char *repeat[] = { "-o0", "a", "--opt0", "b" };
+	const char *unknown[] = { "-o1", "-zz" };
+
+	HIKP_TEST_CHECK(test_parse(ok, HIKP_ARRAY_SIZE(ok), CMD_PARSE_OK, -1) == 0);
+	HIKP_TEST_CHECK(g_test_record_num == 3);
+	HIKP_TEST_CHECK(test_parse(dash_eq, HIKP_ARRAY_SIZE(dash_eq), CMD_PARSE_OK, -1) == 0);
+	HIKP_TEST_CHECK(g_test_param != NULL && strcmp(g_test_param, "-5") == 0);
+	HIKP_TEST_CHECK(test_parse(dash, HIKP_ARRAY_SIZE(dash), CMD_PARSE_MISSING_PARAM, 0) != 0);
+	HIKP_TEST_CHECK(test_parse(no_param, HIKP_ARRAY_SIZE(no_param),
+				   CMD_PARSE_UNEXPECTED_PARAM, 0) != 0);
+	HIKP_TEST_CHECK(test_parse(empty, HIKP_ARRAY_SIZE(empty), CMD_PARSE_MISSING_PARAM, 0) != 0);
+	HIKP_TEST_CHECK(test_parse(last, HIKP_ARRAY_SIZE(last), CMD_PARSE_MISSING_PARAM, 0) != 0);
+	HIKP_TEST_CHECK(test_parse(repeat, HIKP_ARRAY_SIZE(repeat),
+				   CMD_PARSE_REPEATED_OPTION, 2) != 0);
+	HIKP_TEST_CHECK(test_parse(unknown, HIKP_ARRAY_SIZE(unknown),
+				   CMD_PARSE_UNKNOWN_OPTION, 1) != 0);
+}
+
+/* The option lookup before the hash table: compare against every registered option */
+static int test_linear_lookup(const struct major_cmd_ctrl *major_cmd, const char *name)
+{
+	int i;
+
+	for (i = 0; i < major_cmd->option_count; i++) {
+		if (is_specified_option(name, major_cmd->options[i].little,
+					major_cmd->options[i].large))
+			return i;
+	}
+
+	return -1;
+}
+
+/* The hashed lookup must find exactly what the linear scan finds, report both costs */
+static void test_option_lookup(void)
+{
+	struct major_cmd_ctrl *major_cmd = test_setup();
+	const char *name[TEST_OPTION_NUM * 2 + 4];
+	uint64_t hash_ns, linear_ns, start;
+	uint32_t name_num = 0;
+	uint32_t round, i;
+	int hit = 0;
+
+	for (i = 0; i < TEST_OPTION_NUM; i++) {
+		name[name_num++] = g_test_little[i];
+		name[name_num++] = g_test_large[i];
+	}
+	name[name_num++] = "-o";
+	name[name_num++] = "--opt";
+	name[name_num++] = "--opt480";
+	name[name_num++] = "-x";
+
+	for (i = 0; i < name_num; i++)
+		HIKP_TEST_CHECK(cmd_option_lookup(major_cmd, name[i], strlen(name[i])) ==
+				test_linear_lookup(major_cmd, name[i]));
+
+	start = tool_get_time_ns();
+	for (round = 0; round < TEST_BENCH_ROUNDS; round++)
+		hit += cmd_option_lookup(major_cmd, name[round % name_num],
+					 strlen(name[round % name_num]));
+	hash_ns = tool_get_time_ns() - start;
+
+	start = tool_get_time_ns();
+	for (round = 0; round < TEST_BENCH_ROUNDS; round++)
+		hit -= test_linear_lookup(major_cmd, name[round % name_num]);
+	linear_ns = tool_get_time_ns() - start;
+
+	HIKP_TEST_CHECK(hit == 0);
+	printf("option lookup over %d options: hashed %.1f ns, linear %.1f ns\n",
+	       major_cmd->option_count, (double)hash_ns / TEST_BENCH_ROUNDS,
+	       (double)linear_ns / TEST_BENCH_ROUNDS);
+}
+
+int main(void)
+{
+	test_option_parse();
+	test_option_lookup();
+
+	return HIKP_TEST_RESULT();
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "tool_lib.h"
+#include "hikp_test.h"
+
+#define TEST_SNAP_TYPE 0x7e57
+#define TEST_SNAP_OTHER_DEV 9
+
+struct test_snap_key {
+	uint32_t dev;
+	uint32_t table;
+};
+
+static void test_cnt_delta(void)
+{
+	uint64_t mask = UINT32_MAX;
+	uint64_t delta = 0;
+
+	HIKP_TEST_CHECK(tool_cnt_delta(100, 100, mask, &delta) == TOOL_CNT_UP && delta == 0);
+	HIKP_TEST_CHECK(tool_cnt_delta(100, 150, mask, &delta) == TOOL_CNT_UP && delta == 50);
+	/* A wrap only from the top of the range to the bottom of it */
+	HIKP_TEST_CHECK(tool_cnt_delta(0xfffffff0, 0x10, mask, &delta) == TOOL_CNT_WRAP &&
+			delta == 0x20);
+	HIKP_TEST_CHECK(tool_cnt_delta(UINT32_MAX, 0, mask, &delta) == TOOL_CNT_WRAP &&
+			delta == 1);
+	/* A cleared or reset counter goes down and is never a huge increase */
+	HIKP_TEST_CHECK(tool_cnt_delta(100, 50, mask, &delta) == TOOL_CNT_DOWN && delta == 50);
+	HIKP_TEST_CHECK(tool_cnt_delta(0x80000000, 0, mask, &delta) == TOOL_CNT_DOWN &&
+			delta == 0x80000000);
+	HIKP_TEST_CHECK(tool_cnt_delta(0xfffffff0, 0x80000000, mask, &delta) ==
+			TOOL_CNT_DOWN && delta == 0x7ffffff0);
+	/* Bits above the counter width are not part of the value */
+	HIKP_TEST_CHECK(tool_cnt_delta(0x1ffffffffULL, 0x200000001ULL, mask, &delta) ==
+			TOOL_CNT_WRAP && delta == 2);
+	HIKP_TEST_CHECK(tool_cnt_delta(UINT64_MAX - 1, 1, UINT64_MAX, &delta) ==
+			TOOL_CNT_WRAP && delta == 3);
+	HIKP_TEST_CHECK(tool_cnt_delta(1ULL << 40, 1, UINT64_MAX, &delta) == TOOL_CNT_DOWN);
+}
+
+/* Published 32 bit FNV-1a vectors */
+static void test_fnv1a(void)
+{
+	static const uint8_t mac[] = { 0x00, 0x18, 0x2d, 0x00, 0x00, 0x01 };
+
+	HIKP_TEST_CHECK(tool_fnv1a("", 0) == 0x811c9dc5U);
+	HIKP_TEST_CHECK(tool_fnv1a(NULL, 0) == 0x811c9dc5U);
+	HIKP_TEST_CHECK(tool_fnv1a("a", 1) == 0xe40c292cU);
+	HIKP_TEST_CHECK(tool_fnv1a("foobar", 6) == 0xbf9cf968U);
+	/* Binary keys, only len bytes count */
+	HIKP_TEST_CHECK(tool_fnv1a(mac, sizeof(mac)) != tool_fnv1a(mac, sizeof(mac) - 1));
+	HIKP_TEST_CHECK(tool_fnv1a("foobarx", 6) == 0xbf9cf968U);
+}
+
+/* Another table of the same device is skipped, another device can not be diffed */
+static int test_snap_key_check(const void *saved_key, const void *key)
+{
+	const struct test_snap_key *saved = saved_key;
+	const struct test_snap_key *want = key;
+
+	if (saved->dev == TEST_SNAP_OTHER_DEV)
+		return -EINVAL;
+
+	return saved->table == want->table ? TOOL_SNAP_KEY_MATCH : TOOL_SNAP_KEY_SKIP;
+}
+
+static int test_snap_load_table(struct tool_snap *snap, uint32_t table, char *out, size_t len)
+{
+	struct test_snap_key want = { 1, table };
+	struct test_snap_key saved = { 0 };
+	struct tool_snap_head head = { 0 };
+	void *data = NULL;
+	int ret;
+
+	snap->key = &want;
+	ret = tool_snap_load(snap, &head, &saved, &data);
+	if (ret == 0) {
+		HIKP_TEST_CHECK(saved.table == table);
+		HIKP_TEST_CHECK(head.data_len < len);
+		HIKP_TEST_CHECK(tool_snap_age(&head) >= 0 && tool_snap_age(&head) < 60);
+		memcpy(out, data, HIKP_MIN(len, (size_t)head.data_len + 1));
+	}
+	free(data);
+
+	return ret;
+}
+
+static int test_snap_save_table(struct tool_snap *snap, uint32_t dev, uint32_t table,
+				const char *data, bool append)
+{
+	struct test_snap_key key = { dev, table };
+
+	snap->key = &key;
+	return tool_snap_save(snap, data, (uint32_t)strlen(data), append);
+}
+
+static void test_snap(void)
+{
+	char file[] = "/tmp/hikp_test_snap_XXXXXX";
+	struct tool_snap snap = {
+		.file = file,
+		.name = "test",
+		.type = TEST_SNAP_TYPE,
+		.version = 1,
+		.key_len = sizeof(struct test_snap_key),
+		.max_data_len = 16,
+		.key_check = test_snap_key_check,
+	};
+	char out[32] = { 0 };
+	int fd;
+
+	fd = mkstemp(file);
+	HIKP_TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+	close(fd);
+
+	/* Records of several tables in one file, each found by its key */
+	HIKP_TEST_CHECK(test_snap_save_table(&snap, 1, 1, "first", false) == 0);
+	HIKP_TEST_CHECK(test_snap_save_table(&snap, 1, 2, "second", true) == 0);
+	HIKP_TEST_CHECK(test_snap_save_table(&snap, 1, 3, "", true) == 0);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 2, out, sizeof(out)) == 0);
+	HIKP_TEST_CHECK(strcmp(out, "second") == 0);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 1, out, sizeof(out)) == 0);
+	HIKP_TEST_CHECK(strcmp(out, "first") == 0);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 3, out, sizeof(out)) == 0);
+	HIKP_TEST_CHECK(out[0] == '\0');
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 4, out, sizeof(out)) == -ENOENT);
+
+	/* A key the module rejects stops the search */
+	HIKP_TEST_CHECK(test_snap_save_table(&snap, TEST_SNAP_OTHER_DEV, 4, "x", true) == 0);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 4, out, sizeof(out)) == -EINVAL);
+
+	/* A plain save starts the file over */
+	HIKP_TEST_CHECK(test_snap_save_table(&snap, 1, 2, "again", false) == 0);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 1, out, sizeof(out)) == -ENOENT);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 2, out, sizeof(out)) == 0);
+	HIKP_TEST_CHECK(strcmp(out, "again") == 0);
+
+	/* Another module, layout or an oversized payload is not taken */
+	snap.version = 2;
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 2, out, sizeof(out)) == -EINVAL);
+	snap.version = 1;
+	snap.type++;
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 2, out, sizeof(out)) == -EINVAL);
+	snap.type--;
+	snap.max_data_len = 4;
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 2, out, sizeof(out)) == -EINVAL);
+	snap.max_data_len = 16;
+
+	/* A cut payload is reported, not returned short */
+	HIKP_TEST_CHECK(truncate(file, (off_t)(sizeof(struct tool_snap_head) +
+					       sizeof(struct test_snap_key) + 2)) == 0);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 2, out, sizeof(out)) == -EINVAL);
+
+	unlink(file);
+	HIKP_TEST_CHECK(test_snap_load_table(&snap, 2, out, sizeof(out)) == -ENOENT);
+}
+
+int main(void)
+{
+	test_cnt_delta();
+	test_fnv1a();
+	test_snap();
+
+	return HIKP_TEST_RESULT();
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2022 Hisilicon Technologies Co., Ltd.
+ * Hikptool is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ *
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include "hikp_unic_ppp.c"
+#include "hikp_test.h"
+
+#define TEST_ENTRY_NUM 64
+#define TEST_FUNC_NUM 4
+
+static struct major_cmd_ctrl g_test_self;
+static struct unic_guid_uc_entry g_test_uc[TEST_ENTRY_NUM];
+static struct unic_guid_mc_entry g_test_mc[TEST_ENTRY_NUM];
+static struct unic_ip_entry g_test_ip[TEST_ENTRY_NUM];
+static struct unic_ppp_rec g_test_rec[TEST_ENTRY_NUM * 2];
+
+static void test_param_reset(int feature_idx, const char *find)
+{
+	memset(&g_unic_ppp_param, 0, sizeof(g_unic_ppp_param));
+	memset(&g_test_self, 0, sizeof(g_test_self));
+	g_unic_ppp_param.feature_idx = feature_idx;
+	(void)snprintf(g_unic_ppp_param.find_str, sizeof(g_unic_ppp_param.find_str), "%s", find);
+}
+
+static void test_parse_find(void)
+{
+	static const uint8_t v6[HIKP_UNIC_GUID_ADDR_LEN] = { 0xfe, 0x80, [15] = 0x01 };
+	static const uint8_t v4[HIKP_UNIC_GUID_ADDR_LEN] = {
+		[10] = 0xff, [11] = 0xff, [12] = 192, [13] = 168, [14] = 1, [15] = 2,
+	};
+	char list[(UNIC_PPP_MAX_FIND + 1) * sizeof("10.0.0.255,")] = { 0 };
+	uint32_t i;
+
+	test_param_reset(UNIC_PPP_IP_FEATURE_IDX, "fe80::1,192.168.1.2");
+	HIKP_TEST_CHECK(hikp_unic_ppp_parse_find(&g_test_self, &g_unic_ppp_param) == 0);
+	HIKP_TEST_CHECK(g_unic_ppp_param.find_num == 2);
+	HIKP_TEST_CHECK(memcmp(g_unic_ppp_param.find_addr[0], v6, sizeof(v6)) == 0);
+	HIKP_TEST_CHECK(memcmp(g_unic_ppp_param.find_addr[1], v4, sizeof(v4)) == 0);
+
+	/* The same text is a GUID or an IP depending on -du */
+	test_param_reset(UNIC_PPP_GUID_FEATURE_IDX,
+			 "fe:80:00:00:00:00:00:00:00:00:00:00:00:00:00:01");
+	HIKP_TEST_CHECK(hikp_unic_ppp_parse_find(&g_test_self, &g_unic_ppp_param) == 0);
+	HIKP_TEST_CHECK(memcmp(g_unic_ppp_param.find_addr[0], v6, sizeof(v6)) == 0);
+	test_param_reset(UNIC_PPP_GUID_FEATURE_IDX, "fe80::1");
+	HIKP_TEST_CHECK(hikp_unic_ppp_parse_find(&g_test_self, &g_unic_ppp_param) == -EINVAL);
+	test_param_reset(UNIC_PPP_GUID_FEATURE_IDX,
+			 "fe:80:00:00:00:00:00:00:00:00:00:00:00:00:01");
+	HIKP_TEST_CHECK(hikp_unic_ppp_parse_find(&g_test_self, &g_unic_ppp_param) == -EINVAL);
+	test_param_reset(UNIC_PPP_IP_FEATURE_IDX, "192.168.1");
+	HIKP_TEST_CHECK(hikp_unic_ppp_parse_find(&g_test_self, &g_unic_ppp_param) == -EINVAL);
+	test_param_reset(UNIC_PPP_IP_FEATURE_IDX, "fe80::1::2");
+	HIKP_TEST_CHECK(hikp_unic_ppp_parse_find(&g_test_self, &g_unic_ppp_param) == -EINVAL);
+
+	for (i = 0; i <= UNIC_PPP_MAX_FIND; i++)
+		(void)snprintf(list + strlen(list), sizeof(list) - strlen(list), "%s10.0.0.%u",
+			       i == 0 ? "" : ",", i);
+	test_param_reset(UNIC_PPP_IP_FEATURE_IDX, list);
+	HIKP_TEST_CHECK(hikp_unic_ppp_parse_find(&g_test_self, &g_unic_ppp_param) == -EINVAL);
+	HIKP_TEST_CHECK(g_unic_ppp_param.find_num == UNIC_PPP_MAX_FIND);
+}
+
+/* -sp and the index skip entries with an all-zero address, and mc ones without functions */
+static void test_sparse(void)
+{
+	struct unic_guid_uc_entry *uc = g_test_uc;
+	struct unic_guid_mc_entry *mc = g_test_mc;
+	struct unic_ip_entry *ip = g_test_ip;
+	struct unic_ppp_rec *rec = g_test_rec;
+	union unic_ppp_feature_info data;
+	uint32_t i;
+
+	for (i = 0; i < TEST_ENTRY_NUM; i += 4) {
+		ip[i].index = i;
+		ip[i].function_id = i % TEST_FUNC_NUM;
+		ip[i].ip_addr[3] = i + 1;
+		uc[i].guid_addr[15] = (uint8_t)(i + 1);
+		mc[i].guid_addr[15] = (uint8_t)(i + 1);
+		mc[i].function_bitmap[0] = i / 8 % 2;
+	}
+	HIKP_TEST_CHECK(!hikp_unic_ppp_ip_valid(&ip[1]) && hikp_unic_ppp_ip_valid(&ip[4]));
+	HIKP_TEST_CHECK(!hikp_unic_ppp_mc_guid_valid(&mc[0]) &&
+			hikp_unic_ppp_mc_guid_valid(&mc[8]));
+
+	test_param_reset(UNIC_PPP_IP_FEATURE_IDX, "");
+	data.ip_tbl.entry_size = TEST_ENTRY_NUM;
+	data.ip_tbl.entry = ip;
+	HIKP_TEST_CHECK(hikp_unic_ppp_rec_build(&data, rec) == TEST_ENTRY_NUM / 4);
+	HIKP_TEST_CHECK(rec[1].type == UNIC_PPP_REC_IP && rec[1].idx == 4);
+
+	test_param_reset(UNIC_PPP_GUID_FEATURE_IDX, "");
+	data.guid_tbl.uc_tbl.entry_size = TEST_ENTRY_NUM;
+	data.guid_tbl.uc_tbl.entry = uc;
+	data.guid_tbl.mc_tbl.entry_size = TEST_ENTRY_NUM;
+	data.guid_tbl.mc_tbl.entry = mc;
+	HIKP_TEST_CHECK(hikp_unic_ppp_rec_build(&data, rec) == TEST_ENTRY_NUM / 4 +
+			TEST_ENTRY_NUM / 8);
+	HIKP_TEST_CHECK(rec[1].type == UNIC_PPP_REC_UC_GUID && rec[1].idx == 4);
+	HIKP_TEST_CHECK(rec[TEST_ENTRY_NUM / 4].type == UNIC_PPP_REC_MC_GUID);
+}
+
+/* TEST_ENTRY_NUM addresses, each bound to every function as IP and as unicast GUID */
+static uint32_t test_rec_fill(struct unic_ppp_rec *rec)
+{
+	uint32_t num = 0;
+	uint32_t i, f;
+
+	for (i = 0; i < TEST_ENTRY_NUM; i++) {
+		for (f = 0; f < TEST_FUNC_NUM; f++, num++) {
+			memset(&rec[num], 0, sizeof(rec[num]));
+			rec[num].type = f % 2 ? UNIC_PPP_REC_IP : UNIC_PPP_REC_UC_GUID;
+			rec[num].idx = num;
+			rec[num].func_id = f;
+			rec[num].addr[0] = 0xfe;
+			rec[num].addr[15] = (uint8_t)i;
+		}
+	}
+
+	return num;
+}
+
+static void test_index(void)
+{
+	struct unic_ppp_rec *rec;
+	struct unic_ppp_index index = { 0 };
+	const struct unic_ppp_rec *found;
+	struct unic_ppp_rec key;
+	uint32_t num, count, pos;
+	uint32_t i;
+
+	rec = (struct unic_ppp_rec *)calloc(TEST_ENTRY_NUM * TEST_FUNC_NUM, sizeof(*rec));
+	HIKP_TEST_CHECK(rec != NULL);
+	if (rec == NULL)
+		return;
+	num = test_rec_fill(rec);
+	HIKP_TEST_CHECK(hikp_unic_ppp_index_build(&index, rec, num) == 0);
+
+	for (i = 0; i < num; i++) {
+		key = index.rec[i];
+		found = hikp_unic_ppp_index_lookup(&index, &key);
+		HIKP_TEST_CHECK(found != NULL && found->idx == key.idx);
+		pos = UINT32_MAX;
+		count = 0;
+		while (hikp_unic_ppp_index_next(&index, key.addr, &pos) != NULL)
+			count++;
+		HIKP_TEST_CHECK(count == TEST_FUNC_NUM);
+	}
+
+	/* Unicast keys include the function, multicast ones do not */
+	key = index.rec[0];
+	key.func_id = TEST_FUNC_NUM;
+	HIKP_TEST_CHECK(hikp_unic_ppp_index_lookup(&index, &key) == NULL);
+	key.type = UNIC_PPP_REC_MC_GUID;
+	HIKP_TEST_CHECK(hikp_unic_ppp_index_lookup(&index, &key) == NULL);
+	index.rec[0].type = UNIC_PPP_REC_MC_GUID;
+	HIKP_TEST_CHECK(hikp_unic_ppp_index_lookup(&index, &key) == &index.rec[0]);
+	key.addr[1] = 1;
+	HIKP_TEST_CHECK(hikp_unic_ppp_index_lookup(&index, &key) == NULL);
+
+	hikp_unic_ppp_index_free(&index);
+}
+
+static void test_snap(void)
+{
+	char file[] = "/tmp/hikp_test_unic_ppp_XXXXXX";
+	struct unic_ppp_index old_index = { 0 };
+	struct unic_ppp_index index = { 0 };
+	struct tool_snap_head head = { 0 };
+	struct unic_ppp_rec *rec;
+	uint32_t num;
+	int fd;
+
+	fd = mkstemp(file);
+	HIKP_TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+	close(fd);
+
+	rec = (struct unic_ppp_rec *)calloc(TEST_ENTRY_NUM * TEST_FUNC_NUM, sizeof(*rec));
+	HIKP_TEST_CHECK(rec != NULL);
+	if (rec == NULL)
+		return;
+	num = test_rec_fill(rec);
+	HIKP_TEST_CHECK(hikp_unic_ppp_index_build(&index, rec, num) == 0);
+
+	test_param_reset(UNIC_PPP_IP_FEATURE_IDX, "");
+	(void)snprintf(g_unic_ppp_param.snap_file, sizeof(g_unic_ppp_param.snap_file), "%s", file);
+	g_unic_ppp_param.target.bdf.bdf_id = 0x3500;
+	HIKP_TEST_CHECK(hikp_unic_ppp_snap_save(&index, &g_unic_ppp_param) == 0);
+	HIKP_TEST_CHECK(hikp_unic_ppp_snap_load(&old_index, &head, &g_unic_ppp_param) == 0);
+	HIKP_TEST_CHECK(old_index.rec_num == num);
+	HIKP_TEST_CHECK(memcmp(old_index.rec, index.rec, num * sizeof(*rec)) == 0);
+	HIKP_TEST_CHECK(hikp_unic_ppp_snap_diff(&index, &g_unic_ppp_param) == 0);
+
+	/* An IP moving in the table changed, a unicast GUID has no position to move */
+	HIKP_TEST_CHECK(index.rec[1].type == UNIC_PPP_REC_IP);
+	index.rec[1].idx++;
+	HIKP_TEST_CHECK(hikp_unic_ppp_rec_changed(&old_index.rec[1], &index.rec[1]));
+	index.rec[0].idx++;
+	HIKP_TEST_CHECK(!hikp_unic_ppp_rec_changed(&old_index.rec[0], &index.rec[0]));
+	hikp_unic_ppp_index_free(&old_index);
+
+	/* Neither the other table nor another device is diffed */
+	g_unic_ppp_param.feature_idx = UNIC_PPP_GUID_FEATURE_IDX;
+	HIKP_TEST_CHECK(hikp_unic_ppp_snap_load(&old_index, &head, &g_unic_ppp_param) == -EINVAL);
+	g_unic_ppp_param.feature_idx = UNIC_PPP_IP_FEATURE_IDX;
+	g_unic_ppp_param.target.bdf.bdf_id = 0x3600;
+	HIKP_TEST_CHECK(hikp_unic_ppp_snap_load(&old_index, &head, &g_unic_ppp_param) == -EINVAL);
+
+	hikp_unic_ppp_index_free(&index);
+	unlink(file);
+}
+
+int main(void)
+{
+	test_parse_find();
+	test_sparse();
+	test_index();
+	test_snap();
+
+	return HIKP_TEST_RESULT();
+}
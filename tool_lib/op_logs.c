@@ -14,6 +14,7 @@
 #include <syslog.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <signal.h>
 #include "tool_lib.h"
 #include "hikptdev_plug.h"
@@ -24,70 +25,193 @@ static char g_cmd_exec_time[LOG_TIME_LENGTH] = {0};
 static bool g_record = true;
 static bool g_log_info;
 static char g_input_buf[OP_LOG_FILE_W_MAXSIZE + 1] = {0};
+static struct timeval g_tv;
 
-static int op_log_write(const char *log_data)
-{
-	size_t w_size;
-	FILE *fd;
+/* The input record put aside while batch lines are recorded in between */
+static struct op_log_input_save {
+	char exec_time[LOG_TIME_LENGTH];
+	char input_buf[OP_LOG_FILE_W_MAXSIZE + 1];
+	struct timeval tv;
+} g_input_save;
 
-	if (strlen(g_op_log) == 0)
-		return -EINVAL;
+/*
+ * The operation log is kept open with O_APPEND for the whole process.
+ * Records are collected in g_op_log_buf and go out with one write(), which
+ * the kernel appends atomically, so no file lock is needed per record. The
+ * lock is only taken to roll the file back.
+ */
+static int g_op_log_fd = -1;
+static char g_op_log_buf[OP_LOG_BUF_SIZE];
+static size_t g_op_log_buf_len;
+static bool g_op_log_buffered;
+static const char *g_op_log_dir;
+/* Rollback note, the first thing written to the new file when it is opened */
+static char g_op_log_note[OP_LOG_FILE_W_MAXSIZE + 1];
+
+static int op_log_file_rollback(const char *op_log_backup, const char *log_dir);
 
-	if (!is_file_exist(g_op_log))
-		return -EPERM;
+static int op_log_open(void)
+{
+	int fd;
 
-	fd = fopen(g_op_log, "a");
-	if (fd == NULL) {
+	fd = open(g_op_log, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0640);
+	if (fd < 0) {
 		HIKP_ERROR_PRINT("Can not open operation log file[%s], errno is %d\n",
 				 g_op_log, errno);
 		return -errno;
 	}
 
-	if (chmod(g_op_log, 0640)) {
+	if (fchmod(fd, 0640)) {
 		HIKP_ERROR_PRINT("Can not chmod log file[%s], errno is %d\n", g_op_log, errno);
-		(void)fclose(fd);
+		(void)close(fd);
 		return -errno;
 	}
 
-	w_size = fwrite((void *)log_data, 1U, strlen(log_data), fd);
-	if (strlen(log_data) > ((uint32_t)w_size)) {
-		HIKP_ERROR_PRINT("Error data size write to file, errno is %d\n", errno);
-		(void)fclose(fd);
-		return -errno;
+	if (g_op_log_fd >= 0)
+		(void)close(g_op_log_fd);
+	g_op_log_fd = fd;
+
+	if (g_op_log_note[0] != '\0') {
+		if (write(fd, g_op_log_note, strlen(g_op_log_note)) < 0)
+			HIKP_ERROR_PRINT("Error data size write to file, errno is %d\n", errno);
+		g_op_log_note[0] = '\0';
 	}
 
-	return fclose(fd);
+	return 0;
 }
 
-static int op_log_write_buffer(const char *log_data, const char *log_dir)
+/* A long running process may outgrow the log, roll it back and reopen. */
+static void op_log_check_size(void)
 {
-	sigset_t sigset;
-	int op_lock_fd;
+	char op_log_backup[OP_LOG_FILE_PATH_MAXLEN] = {0};
+	struct stat st = {0};
+	char *dir_end;
 	int ret;
 
-	sigfillset(&sigset);
-	(void)sigprocmask(SIG_BLOCK, &sigset, NULL);
-	ret = tool_flock(OP_LOG_LOCK_NAME, UDA_FLOCK_BLOCK, &op_lock_fd, log_dir);
-	if (ret == -ENOENT) {
-		HIKP_ERROR_PRINT("Folder or file required by the operation is not exist.\n");
-		return ret;
+	if (fstat(g_op_log_fd, &st) != 0 || st.st_size <= OP_LOG_FILE_MAX_SIZE)
+		return;
+
+	ret = snprintf(op_log_backup, sizeof(op_log_backup), "%s", g_op_log);
+	if (ret < 0 || (size_t)ret >= sizeof(op_log_backup))
+		return;
+	dir_end = strrchr(op_log_backup, '/');
+	if (dir_end == NULL)
+		return;
+	snprintf(dir_end + 1, sizeof(op_log_backup) - (size_t)(dir_end + 1 - op_log_backup),
+		 "%s", OP_LOG_FILE_BACKUP);
+
+	if (op_log_file_rollback(op_log_backup, g_op_log_dir) == 0)
+		(void)op_log_open();
+}
+
+static int op_log_flush_buffer(void)
+{
+	size_t done = 0;
+	ssize_t len;
+
+	if (g_op_log_buf_len == 0)
+		return 0;
+
+	if (g_op_log_fd < 0)
+		return -EINVAL;
+
+	op_log_check_size();
+	while (done < g_op_log_buf_len) {
+		len = write(g_op_log_fd, g_op_log_buf + done, g_op_log_buf_len - done);
+		if (len < 0 && errno == EINTR)
+			continue;
+		if (len <= 0) {
+			HIKP_ERROR_PRINT("Error data size write to file, errno is %d\n", errno);
+			g_op_log_buf_len = 0;
+			return -errno;
+		}
+		done += (size_t)len;
 	}
+	g_op_log_buf_len = 0;
 
-	if (ret) {
-		HIKP_ERROR_PRINT("Multi-user operate in the meantime will causes fault(%d).\n",
-				 ret);
-		return ret;
+	return 0;
+}
+
+static int op_log_write(const char *log_data)
+{
+	size_t len = strlen(log_data);
+	int ret;
+
+	if (g_op_log_fd < 0)
+		return -EINVAL;
+
+	if (len > sizeof(g_op_log_buf))
+		return -EINVAL;
+
+	if (len > sizeof(g_op_log_buf) - g_op_log_buf_len) {
+		ret = op_log_flush_buffer();
+		if (ret)
+			return ret;
 	}
 
+	memcpy(g_op_log_buf + g_op_log_buf_len, log_data, len);
+	g_op_log_buf_len += len;
+	if (g_op_log_buffered)
+		return 0;
+
+	return op_log_flush_buffer();
+}
+
+static int op_log_write_buffer(const char *log_data)
+{
+	sigset_t sigset;
+	sigset_t oldset;
+	int ret;
+
+	/* Keep the signal path from writing half way through a record */
+	sigfillset(&sigset);
+	(void)sigprocmask(SIG_BLOCK, &sigset, &oldset);
 	ret = op_log_write(log_data);
-	if (ret == 0)
-		g_log_info = true;
+	(void)sigprocmask(SIG_SETMASK, &oldset, NULL);
+
+	return ret;
+}
+
+int op_log_flush(void)
+{
+	sigset_t sigset;
+	sigset_t oldset;
+	int ret;
+
+	sigfillset(&sigset);
+	(void)sigprocmask(SIG_BLOCK, &sigset, &oldset);
+	ret = op_log_flush_buffer();
+	(void)sigprocmask(SIG_SETMASK, &oldset, NULL);
 
-	tool_unlock(&op_lock_fd, UDA_FLOCK_BLOCK);
-	(void)sigprocmask(SIG_UNBLOCK, &sigset, NULL);
 	return ret;
 }
 
+void op_log_set_buffered(bool buffered)
+{
+	g_op_log_buffered = buffered;
+	if (!buffered)
+		(void)op_log_flush();
+}
+
+/* A forked child leaves the log to its parent, including what is still buffered */
+void op_log_detach(void)
+{
+	g_op_log_buf_len = 0;
+	if (g_op_log_fd >= 0) {
+		(void)close(g_op_log_fd);
+		g_op_log_fd = -1;
+	}
+}
+
+static void op_log_close(void)
+{
+	(void)op_log_flush();
+	if (g_op_log_fd >= 0) {
+		(void)close(g_op_log_fd);
+		g_op_log_fd = -1;
+	}
+}
+
 void op_log_on(void)
 {
 	g_record = true;
@@ -114,7 +238,6 @@ static double op_log_diff_timeval(const struct timeval *now, const struct timeva
 
 static int op_log_add_time_to_log(char *log_base, int *offset, uint32_t flag)
 {
-	static struct timeval g_tv;
 	struct timeval tv = {0};
 	struct tm ptm = {0};
 	int len = 0;
@@ -169,10 +292,19 @@ static int op_log_add_info_to_log(char *log_base, int *offset, const char *str)
 static int op_log_file_rollback(const char *op_log_backup, const char *log_dir)
 {
 	char rollback_log[OP_LOG_FILE_W_MAXSIZE + 1] = {0};
+	int op_lock_fd = -1;
 	int offset = 0;
 	int ret;
 
+	/* rename() is atomic, the lock only keeps two processes from both rolling */
+	ret = tool_flock(OP_LOG_LOCK_NAME, UDA_FLOCK_BLOCK, &op_lock_fd, log_dir);
+	if (ret) {
+		HIKP_ERROR_PRINT("Multi-user operate in the meantime will causes fault(%d).\n",
+				 ret);
+		return ret;
+	}
 	ret = file_rollback(g_op_log, op_log_backup, OP_LOG_FILE_MAX_SIZE);
+	tool_unlock(&op_lock_fd, UDA_FLOCK_BLOCK);
 	if (ret) {
 		if (ret == FILE_LEN_OK)
 			return 0;
@@ -197,7 +329,10 @@ static int op_log_file_rollback(const char *op_log_backup, const char *log_dir)
 	snprintf(rollback_log + offset,
 		 (uint32_t)(OP_LOG_FILE_W_MAXSIZE + 1 - offset), OP_LOG_ITEM_END);
 
-	return op_log_write_buffer(rollback_log, log_dir);
+	/* Records still buffered go after the note, op_log_open() writes it first */
+	(void)snprintf(g_op_log_note, sizeof(g_op_log_note), "%s", rollback_log);
+
+	return 0;
 }
 
 static int op_log_dir_mk(const char *log_path)
@@ -263,10 +398,20 @@ int op_log_initialise(const char *log_dir)
 	snprintf(op_log_backup, OP_LOG_FILE_PATH_MAXLEN, "%s" DIR_BREAK_STRING "%s",
 		 log_path, OP_LOG_FILE_BACKUP);
 
+	g_op_log_dir = log_dir;
 	ret = op_log_file_rollback((const char *)op_log_backup, log_dir);
 	if (ret)
 		return ret;
 
+	ret = op_log_open();
+	if (ret)
+		return ret;
+	(void)atexit(op_log_close);
+
+	ret = op_log_flush();
+	if (ret)
+		return ret;
+
 	op_log_record_time();
 
 	return ret;
@@ -280,10 +425,14 @@ void op_log_record_input(const int argc, const char **argv)
 	int ret;
 
 	memset(g_input_buf, 0, sizeof(g_input_buf));
+	g_log_info = false;
 
 	if (argv == NULL || argc <= 0)
 		return;
 
+	/* A batch line is recorded long after initialise, stamp its own start */
+	op_log_record_time();
+
 	arg = input_str;
 	for (int i = 0; i < argc; i++) {
 		ret = snprintf(arg, (sizeof(input_str) - (arg - input_str)), "%s ", argv[i]);
@@ -308,7 +457,21 @@ void op_log_record_input(const int argc, const char **argv)
 		printf("snprintf exec cmd failed, ret 0x%x\n", ret);
 }
 
-void op_log_record_result(int ret, const char *tool_name, const char *log_dir)
+void op_log_save_input(void)
+{
+	memcpy(g_input_save.exec_time, g_cmd_exec_time, sizeof(g_cmd_exec_time));
+	memcpy(g_input_save.input_buf, g_input_buf, sizeof(g_input_buf));
+	g_input_save.tv = g_tv;
+}
+
+void op_log_restore_input(void)
+{
+	memcpy(g_cmd_exec_time, g_input_save.exec_time, sizeof(g_cmd_exec_time));
+	memcpy(g_input_buf, g_input_save.input_buf, sizeof(g_input_buf));
+	g_tv = g_input_save.tv;
+}
+
+void op_log_record_result(int ret, const char *tool_name)
 {
 	char result_str[OP_LOG_FILE_W_MAXSIZE + 1] = {0};
 	int offset = 0;
@@ -338,7 +501,8 @@ void op_log_record_result(int ret, const char *tool_name, const char *log_dir)
 	record_syslog(tool_name, LOG_INFO, result_str);
 
 	snprintf(result_str + offset, (sizeof(result_str) - offset), OP_LOG_ITEM_END);
-	(void)op_log_write_buffer(result_str, log_dir);
+	if (op_log_write_buffer(result_str) == 0)
+		g_log_info = true;
 }
 
 static bool log_info_is_ok(void)
@@ -365,68 +529,34 @@ static void signal_format_end_log_str(char *log_str, int signal_code)
 	log_str[20] += signal_code % LOG_TIME_DECIMAL; /* 20: units of signal_code */
 }
 
-static int signal_fcntl(const char *name, uint32_t operation, int *fd)
-{
-	char lock_file[TOOL_LOCK_PATH_MAX_LEN] = HIKP_LOG_DIR_PATH TOOL_LOCK_FLODER_NAME;
-	int lock_file_len = 0;
-	int tmp = 0;
-	int ret;
-
-	while (lock_file[lock_file_len] != '\0')
-		lock_file_len++;
-
-	if (!is_dir_exist(lock_file)) {
-		ret = op_log_dir_create(lock_file, lock_file_len);
-		if (ret)
-			return ret;
-	}
-
-	while (name[tmp] != '\0') {
-		lock_file[lock_file_len] = name[tmp];
-		lock_file_len++;
-		tmp++;
-	}
-	lock_file[lock_file_len] = '\0';
-
-	return uda_fcntl(lock_file, operation, fd);
-}
-
 static void signal_op_log_write(int signal_code)
 {
 	char log_str[] = "[00:00:00] [KILLED<00>].\r\n";
-	int op_log_fd;
-	int start_len;
-	int len;
-	int fd;
+	char out[OP_LOG_FILE_W_MAXSIZE + sizeof(log_str)];
+	size_t out_len = 0;
+	size_t i;
 
-	if (log_info_is_ok())
+	if (g_op_log_fd < 0)
 		return;
 
-	if (signal_fcntl(OP_LOG_LOCK_NAME, UDA_FLOCK_BLOCK, &op_log_fd))
+	/* Records still buffered were complete, let them out first */
+	if (g_op_log_buf_len != 0 && write(g_op_log_fd, g_op_log_buf, g_op_log_buf_len) < 0)
 		return;
+	g_op_log_buf_len = 0;
 
-	fd = open(g_op_log, O_WRONLY | O_APPEND);
-	if (fd == -1) {
-		(void)uda_unfcntl(&op_log_fd, UDA_FLOCK_BLOCK);
+	if (log_info_is_ok())
 		return;
-	}
-	(void)chmod(g_op_log, 0640);
-	start_len = 0;
-	while (g_input_buf[start_len] != '\0')
-		start_len += 1;
 
-	len = write(fd, g_input_buf, start_len);
-	if (len == -1)
-		goto SIGNAL_LOG_OUT;
+	/* Only async-signal-safe calls from here, and a single write() for the record */
+	for (i = 0; g_input_buf[i] != '\0' && out_len < OP_LOG_FILE_W_MAXSIZE; i++)
+		out[out_len++] = g_input_buf[i];
 
 	signal_format_end_log_str(log_str, signal_code);
-	len = write(fd, log_str, sizeof(log_str));
-	if (len == -1)
-		goto SIGNAL_LOG_OUT;
+	for (i = 0; log_str[i] != '\0'; i++)
+		out[out_len++] = log_str[i];
 
-SIGNAL_LOG_OUT:
-	(void)close(fd);
-	(void)uda_unfcntl(&op_log_fd, UDA_FLOCK_BLOCK);
+	if (write(g_op_log_fd, out, out_len) < 0)
+		return;
 }
 
 static void signal_handle(int arg)
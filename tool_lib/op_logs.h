@@ -14,6 +14,8 @@
 #ifndef OP_LOGS_H
 #define OP_LOGS_H
 
+#include <stdbool.h>
+
 #define OP_LOG_SEC_AND_MICROSEC_TRANS 1000000.0
 #define OP_LOG_DIR_NAME "operation_logs"
 #define OP_LOG_FILE_NAME "operations.log"
@@ -27,6 +29,7 @@
 #define OP_LOG_PARAM_MAX_STRING 512
 #define OP_LOG_LOCK_NAME "op_log"
 #define OP_LOG_FILE_MAX_SIZE 0x400000 // 4M
+#define OP_LOG_BUF_SIZE (OP_LOG_FILE_W_MAXSIZE * 16)
 
 #define LOG_FLAG_DATE_TIME 0x1
 #define LOG_FLAG_ONLY_TIME 0x2
@@ -51,6 +54,11 @@ void op_log_on(void);
 void op_log_off(void);
 int op_log_initialise(const char *log_dir);
 void op_log_record_input(const int argc, const char **argv);
-void op_log_record_result(int ret, const char *tool_name, const char *log_dir);
+void op_log_save_input(void);
+void op_log_restore_input(void);
+void op_log_record_result(int ret, const char *tool_name);
+void op_log_set_buffered(bool buffered);
+int op_log_flush(void);
+void op_log_detach(void);
 
 #endif /* OP_LOGS_H */
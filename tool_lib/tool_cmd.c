@@ -11,6 +11,10 @@
  * See the Mulan PSL v2 for more details.
  */
 #include "tool_cmd.h"
+#include "hikptdev_plug.h"
+
+/* hikptool command adapter, also linked into libhikptool without the CLI main */
+struct cmd_adapter g_tool = { 0 };
 
 /* save the tool real name pointer, it was update when enter main function */
 static const char *g_tool_name = TOOL_NAME;
@@ -31,34 +35,6 @@ void command_mechanism_init(struct cmd_adapter *adapter, const char *name)
 	adapter->version = TOOL_VER;
 }
 
-static int major_command_check_param(const struct cmd_option *option, const char *arg)
-{
-	if (option == NULL)
-		return -EFAULT;
-
-	if (option->have_param) {
-		if ((!arg) || (arg[0] == '-'))
-			return -EINVAL;
-		return 0;
-	}
-
-	return -EPERM;
-}
-
-static int major_command_check_param_ubctl(const struct cmd_option *option, const char *arg)
-{
-	if (option == NULL)
-		return -EFAULT;
-
-	if (option->have_param) {
-		if (!arg)
-			return -EINVAL;
-		return 0;
-	}
-
-	return -EPERM;
-}
-
 static int check_command_length(const int argc, const char **argv)
 {
 	unsigned long long str_len = 0;
@@ -111,62 +87,143 @@ bool is_specified_option(const char *arg, const char *little, const char *large)
 	       (strncmp(arg, large, strlen(large) + 1) == 0);
 }
 
+static uint32_t cmd_option_hash(const char *name, size_t len)
+{
+	return tool_fnv1a(name, len) & (CMD_OPTION_HASH_SIZE - 1);
+}
+
+static bool cmd_option_name_match(const char *opt_name, const char *name, size_t len)
+{
+	return opt_name != NULL && strlen(opt_name) == len && strncmp(opt_name, name, len) == 0;
+}
+
+static void cmd_option_hash_add(struct major_cmd_ctrl *major_cmd, const char *name, int idx)
+{
+	uint32_t pos;
+	uint32_t i;
+
+	if (name == NULL)
+		return;
+
+	/* Linear probing, an earlier registration of the same name stays first */
+	pos = cmd_option_hash(name, strlen(name));
+	for (i = 0; i < CMD_OPTION_HASH_SIZE; i++) {
+		if (major_cmd->option_hash[pos] == 0) {
+			major_cmd->option_hash[pos] = (uint8_t)(idx + 1);
+			return;
+		}
+		pos = (pos + 1) & (CMD_OPTION_HASH_SIZE - 1);
+	}
+}
+
+static int cmd_option_lookup(const struct major_cmd_ctrl *major_cmd, const char *name, size_t len)
+{
+	const struct cmd_option *option;
+	uint32_t pos;
+	uint32_t i;
+	int idx;
+
+	pos = cmd_option_hash(name, len);
+	for (i = 0; i < CMD_OPTION_HASH_SIZE; i++) {
+		if (major_cmd->option_hash[pos] == 0)
+			return -1;
+
+		idx = major_cmd->option_hash[pos] - 1;
+		option = &major_cmd->options[idx];
+		if (idx < major_cmd->option_count &&
+		    (cmd_option_name_match(option->little, name, len) ||
+		     cmd_option_name_match(option->large, name, len)))
+			return idx;
+
+		pos = (pos + 1) & (CMD_OPTION_HASH_SIZE - 1);
+	}
+
+	return -1;
+}
+
+static int cmd_parse_fail(struct major_cmd_ctrl *major_cmd, enum cmd_parse_err_type type,
+			  int arg_idx)
+{
+	major_cmd->parse_err.type = type;
+	major_cmd->parse_err.arg_idx = arg_idx;
+	major_cmd->err_no = -EINVAL;
+
+	return -EINVAL;
+}
+
+/*
+ * Single pass over argv with a hash lookup per token. Options taking a
+ * parameter accept "-o value", "--opt value" and "--opt=value"; only the
+ * last form lets a value start with '-', except for ubctl whose values
+ * may always do so.
+ */
 static int major_command_parse(struct major_cmd_ctrl *major_cmd, const int argc, const char **argv)
 {
+	bool dash_param = strcmp(major_cmd->cmd_ptr->name, "ubctl") == 0;
 	struct cmd_option *option = NULL;
-	int intermediate_var;
 	const char *param = NULL;
-	int i, j;
+	const char *eq;
+	size_t len;
 	int ret;
+	int i, j;
 
+	major_cmd->parse_err.type = CMD_PARSE_OK;
+	major_cmd->parse_err.arg_idx = -1;
 	for (i = 0; i < argc; i++) {
-		/* Traverse all registered subcommands */
-		for (j = 0; j < major_cmd->option_count; j++) {
-			option = &major_cmd->options[j];
-			if (!is_specified_option(argv[i], option->little, option->large))
-				continue;
-
-			/* Prevent duplicate input */
-			if (major_cmd->options_repeat_flag[j] != 0) {
-				major_cmd->err_no = -EINVAL;
+		eq = strncmp(argv[i], "--", strlen("--")) == 0 ? strchr(argv[i], '=') : NULL;
+		len = eq != NULL ? (size_t)(eq - argv[i]) : strlen(argv[i]);
+		j = cmd_option_lookup(major_cmd, argv[i], len);
+		if (j < 0) {
+			snprintf(major_cmd->err_str, sizeof(major_cmd->err_str),
+				 "%s is not option needed.", argv[i]);
+			return cmd_parse_fail(major_cmd, CMD_PARSE_UNKNOWN_OPTION, i);
+		}
+		option = &major_cmd->options[j];
+
+		/* Prevent duplicate input */
+		if (major_cmd->options_repeat_flag[j] != 0) {
+			snprintf(major_cmd->err_str, sizeof(major_cmd->err_str),
+				 "Repeated option %s.", option->little);
+			return cmd_parse_fail(major_cmd, CMD_PARSE_REPEATED_OPTION, i);
+		}
+		major_cmd->options_repeat_flag[j] = 1;
+
+		if (eq != NULL) {
+			param = eq + 1;
+			if (!option->have_param) {
 				snprintf(major_cmd->err_str, sizeof(major_cmd->err_str),
-					 "Repeated option %s.", option->little);
-				return -EINVAL;
+					 "%s option does not take a parameter.", option->little);
+				return cmd_parse_fail(major_cmd, CMD_PARSE_UNEXPECTED_PARAM, i);
 			}
-			major_cmd->options_repeat_flag[j] = 1;
-
-			/* Determine whether the subcommand is related to the parameter */
-			intermediate_var = i + 1;
-			param = intermediate_var < argc ? argv[intermediate_var] : NULL;
-			if (strcmp(major_cmd->cmd_ptr->name, "ubctl") == 0)
-				ret = major_command_check_param_ubctl(option, param);
-			else
-				ret = major_command_check_param(option, param);
-			if (ret == 0) {
-				i++;
-			} else if (ret == -EINVAL) {
-				major_cmd->err_no = -EINVAL;
+			if (param[0] == '\0') {
 				snprintf(major_cmd->err_str, sizeof(major_cmd->err_str),
 					 "%s option need parameter.", option->little);
-				return -EINVAL;
+				return cmd_parse_fail(major_cmd, CMD_PARSE_MISSING_PARAM, i);
+			}
+		} else {
+			/* Options without parameter still see the next token, as they always did */
+			param = i + 1 < argc ? argv[i + 1] : NULL;
+			if (option->have_param) {
+				if (param == NULL || (!dash_param && param[0] == '-')) {
+					snprintf(major_cmd->err_str, sizeof(major_cmd->err_str),
+						 "%s option need parameter.",
+						 option->little);
+					return cmd_parse_fail(major_cmd,
+							      CMD_PARSE_MISSING_PARAM, i);
+				}
+				i++;
 			}
-
-			/* Record the option identifier and parameter
-			 * information to provide parameters
-			 * for subsequent execute processing.
-			 */
-			ret = sub_command_record(major_cmd, option, param);
-			if (ret)
-				return ret;
-
-			break;
 		}
 
-		if (j == major_cmd->option_count) {
-			major_cmd->err_no = -EINVAL;
-			snprintf(major_cmd->err_str, sizeof(major_cmd->err_str),
-				 "%s is not option needed.", argv[i]);
-			return -EINVAL;
+		/* Record the option identifier and parameter
+		 * information to provide parameters
+		 * for subsequent execute processing.
+		 */
+		ret = sub_command_record(major_cmd, option, param);
+		if (ret) {
+			major_cmd->parse_err.type = CMD_PARSE_RECORD_FAIL;
+			major_cmd->parse_err.arg_idx = i;
+			return ret;
 		}
 	}
 
@@ -189,20 +246,218 @@ void cmd_option_register(const char *little, const char *large,
 		return;
 	}
 
+	/* Command init resets option_count, start a fresh table with it */
+	if (major_cmd->option_count == 0)
+		memset(major_cmd->option_hash, 0, sizeof(major_cmd->option_hash));
+
 	option = &major_cmd->options[major_cmd->option_count];
 	major_cmd->options_repeat_flag[major_cmd->option_count] = 0;
+	cmd_option_hash_add(major_cmd, little, major_cmd->option_count);
+	cmd_option_hash_add(major_cmd, large, major_cmd->option_count);
 	major_cmd->option_count++;
 
 	option->record = record;
 	option->little = little;
 	option->large = large;
 	option->have_param = have_param;
+	option->is_writer = false;
+}
+
+/*
+ * Register an option that changes hardware state (clear counters, set a
+ * mode...). A command given any such option takes its module lock
+ * exclusively instead of shared, so it never runs next to a reader.
+ */
+void cmd_writer_option_register(const char *little, const char *large,
+				uint8_t have_param, command_record_t record)
+{
+	struct major_cmd_ctrl *major_cmd = get_major_cmd();
+	int count = major_cmd->option_count;
+
+	cmd_option_register(little, large, have_param, record);
+	if (major_cmd->option_count > count)
+		major_cmd->options[count].is_writer = true;
+}
+
+/*
+ * Commands are serialized per firmware module only: read-only queries share
+ * the module lock, options that change hardware state take it exclusively.
+ * Commands spanning all modules lock every module in ascending order, so
+ * no two commands can wait on each other.
+ */
+#define CMD_LOCK_MOD_NUM	HIKP_MOD_NUM
+#define CMD_LOCK_ALL_MOD	CMD_LOCK_MOD_NUM
+#define CMD_LOCK_NAME_LEN	64
+
+struct cmd_lock_domain {
+	const char *name;
+	uint32_t mod_code;
+};
+
+/* A name ending in '_' is a command prefix, any other one an exact command name */
+static const struct cmd_lock_domain g_cmd_lock_domain[] = {
+	{"nic_", NIC_MOD},
+	{"roce_", ROCE_MOD},
+	{"roh_", ROH_MOD},
+	{"unic_", UB_MOD},
+	{"ubus", UBUS_MOD},
+	{"ummu", UMMU_MOD},
+	{"ub_bp", UB_MOD},
+	{"ub_crd", UB_MOD},
+	{"ub_dfx", UB_MOD},
+	{"ub_info", UB_MOD},
+	{"ub_link", UB_MOD},
+	{"ubctl", UB_MOD},
+	{"pcie_", PCIE_MOD},
+	{"serdes_", SERDES_MOD},
+	{"socip_", SOCIP_MOD},
+	{"sas_", SAS_MOD},
+	{"sata_", SATA_MOD},
+	{"cxl_", CXL_MOD},
+	{"imp", IMP_MOD},
+	{"scc", SCC_MOD},
+	{"hccs", HCCS_MOD},
+	{"sdma_", SDMA_MOD},
+	{"cpu_ring", CORE_RING_MOD},
+	{"bbox_export", RAS_MOD},
+};
+
+struct cmd_lock {
+	int fd[CMD_LOCK_MOD_NUM];
+	uint32_t num;
+	uint32_t operation;
+	uint32_t first;
+	uint32_t last;
+};
+
+/* The lock of the running command, cmd_sleep_until() lets go of it */
+static struct cmd_lock g_cmd_lock;
+
+static uint32_t cmd_lock_mod_code(const char *name)
+{
+	const struct cmd_lock_domain *domain;
+	size_t len;
+	size_t i;
+
+	for (i = 0; i < HIKP_ARRAY_SIZE(g_cmd_lock_domain); i++) {
+		domain = &g_cmd_lock_domain[i];
+		len = strlen(domain->name);
+		if (domain->name[len - 1] == '_' ? strncmp(name, domain->name, len) != 0 :
+		    strcmp(name, domain->name) != 0)
+			continue;
+		/* a module code out of the lock range falls back to locking all */
+		return domain->mod_code < CMD_LOCK_MOD_NUM ? domain->mod_code : CMD_LOCK_ALL_MOD;
+	}
+
+	return CMD_LOCK_ALL_MOD;
+}
+
+static bool cmd_lock_is_writer(const struct major_cmd_ctrl *major_cmd, uint32_t mod_code)
+{
+	int j;
+
+	/* info_collect only reads, anything else unknown is treated as a writer */
+	if (mod_code == CMD_LOCK_ALL_MOD)
+		return strcmp(major_cmd->cmd_ptr->name, "info_collect") != 0;
+
+	for (j = 0; j < major_cmd->option_count; j++) {
+		if (major_cmd->options_repeat_flag[j] != 0 && major_cmd->options[j].is_writer)
+			return true;
+	}
+
+	return false;
+}
+
+static bool cmd_is_verbose(void)
+{
+	const char *env = getenv(CMD_VERBOSE_ENV);
+
+	return env != NULL && env[0] != '\0' && strcmp(env, "0") != 0;
+}
+
+static void cmd_lock_release(struct cmd_lock *lock)
+{
+	while (lock->num > 0) {
+		lock->num--;
+		tool_unlock(&lock->fd[lock->num], lock->operation);
+	}
+}
+
+static int cmd_lock_acquire(struct cmd_lock *lock)
+{
+	char name[CMD_LOCK_NAME_LEN] = {0};
+	uint32_t mod_code;
+	int ret;
+
+	for (mod_code = lock->first; mod_code <= lock->last; mod_code++) {
+		snprintf(name, sizeof(name), "%s_%u", CMD_EXECUTE_LOCK_NAME, mod_code);
+		ret = tool_flock(name, lock->operation, &lock->fd[lock->num], HIKP_LOG_DIR_PATH);
+		if (ret) {
+			cmd_lock_release(lock);
+			return ret;
+		}
+		lock->num++;
+	}
+
+	return 0;
+}
+
+static int cmd_lock_take(const struct major_cmd_ctrl *major_cmd, struct cmd_lock *lock)
+{
+	uint32_t mod_code;
+	uint64_t start_ns;
+	bool writer;
+	int ret;
+
+	mod_code = cmd_lock_mod_code(major_cmd->cmd_ptr->name);
+	writer = cmd_lock_is_writer(major_cmd, mod_code);
+	lock->first = mod_code == CMD_LOCK_ALL_MOD ? 0 : mod_code;
+	lock->last = mod_code == CMD_LOCK_ALL_MOD ? CMD_LOCK_MOD_NUM - 1 : mod_code;
+	lock->num = 0;
+	lock->operation = writer ? UDA_FLOCK_BLOCK : UDA_FLOCK_SHARED_BLOCK;
+
+	start_ns = tool_get_time_ns();
+	ret = cmd_lock_acquire(lock);
+	if (ret)
+		return ret;
+
+	if (cmd_is_verbose())
+		HIKP_INFO_PRINT("%s waited %.3f ms for %s lock of %u module(s).\n",
+				major_cmd->cmd_ptr->name,
+				(double)(tool_get_time_ns() - start_ns) / HIKP_NSEC_PER_MSEC,
+				writer ? "exclusive" : "shared", lock->num);
+
+	return 0;
+}
+
+/*
+ * Sampling loops wait here between periods. A reader lets go of its shared
+ * lock while waiting, so a monitor running for hours does not hold off the
+ * writers of its module. A writer keeps its exclusive lock for the whole run.
+ */
+int cmd_sleep_until(uint64_t deadline_ns)
+{
+	struct cmd_lock *lock = &g_cmd_lock;
+	int ret;
+
+	if (lock->num == 0 || lock->operation != UDA_FLOCK_SHARED_BLOCK) {
+		tool_sleep_until(deadline_ns);
+		return 0;
+	}
+
+	cmd_lock_release(lock);
+	tool_sleep_until(deadline_ns);
+	ret = cmd_lock_acquire(lock);
+	if (ret)
+		HIKP_ERROR_PRINT("retaking the execute lock failed(%d).\n", ret);
+
+	return ret < 0 ? ret : -ret;
 }
 
 void command_parse_and_excute(const int argc, const char **argv)
 {
 	struct major_cmd_ctrl *major_cmd = get_major_cmd();
-	int lock_fd;
+	struct cmd_lock *lock = &g_cmd_lock;
 	int ret;
 
 	major_cmd->err_no = check_command_length(argc, argv);
@@ -217,7 +472,7 @@ void command_parse_and_excute(const int argc, const char **argv)
 		if (major_command_parse(major_cmd, argc - 2, argv + 2))
 			goto PARSE_OUT;
 	}
-	ret = tool_flock(CMD_EXECUTE_LOCK_NAME, UDA_FLOCK_BLOCK, &lock_fd, HIKP_LOG_DIR_PATH);
+	ret = cmd_lock_take(major_cmd, lock);
 	if (ret) {
 		major_cmd->err_no = ret < 0 ? ret : -ret;
 		snprintf(major_cmd->err_str, sizeof(major_cmd->err_str), "locking failed.");
@@ -232,7 +487,7 @@ void command_parse_and_excute(const int argc, const char **argv)
 			 "Command execute is null.");
 	}
 
-	tool_unlock(&lock_fd, UDA_FLOCK_BLOCK);
+	cmd_lock_release(lock);
 PARSE_OUT:
 	if (major_cmd->err_no)
 		HIKP_ERROR_PRINT("%s command error(%d): %s\n",
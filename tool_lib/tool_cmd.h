@@ -16,9 +16,13 @@
 #include "tool_lib.h"
 
 #define CMD_EXECUTE_LOCK_NAME "op_execute_lock"
+/* Set to a non-zero value to report the time spent waiting for the execute locks */
+#define CMD_VERBOSE_ENV "HIKPTOOL_VERBOSE"
 
 /* The maximum number of this command supported by a single main command */
 #define COMMAND_MAX_OPTIONS 64
+/* Open addressing slots for short and long option names, a power of two */
+#define CMD_OPTION_HASH_SIZE 256
 /* Full command maximum length */
 #define COMMAND_MAX_STRING 512
 /* Length of command error description */
@@ -45,15 +49,34 @@ struct cmd_option {
 	const char *little;
 	const char *large;
 	uint8_t have_param;
+	bool is_writer; /* changes hardware state, see cmd_writer_option_register() */
 	command_record_t record;
 };
 
+enum cmd_parse_err_type {
+	CMD_PARSE_OK = 0,
+	CMD_PARSE_UNKNOWN_OPTION,
+	CMD_PARSE_REPEATED_OPTION,
+	CMD_PARSE_MISSING_PARAM,
+	CMD_PARSE_UNEXPECTED_PARAM,
+	CMD_PARSE_RECORD_FAIL,
+};
+
+/* Why major command parsing stopped, next to the err_no/err_str text */
+struct cmd_parse_err {
+	enum cmd_parse_err_type type;
+	int arg_idx; /* offending token in the option argv, -1 if none */
+};
+
 /* Main command description */
 struct major_cmd_ctrl {
 	int option_count;
 	struct cmd_option options[COMMAND_MAX_OPTIONS];
 	uint32_t options_repeat_flag[COMMAND_MAX_OPTIONS];
+	/* option index plus one, 0 for an empty slot */
+	uint8_t option_hash[CMD_OPTION_HASH_SIZE];
 	command_executeute_t execute;
+	struct cmd_parse_err parse_err;
 
 	int err_no;
 	char err_str[COMMANDER_ERR_MAX_STRING + 1];
@@ -81,7 +104,10 @@ extern void command_mechanism_init(struct cmd_adapter *adapter, const char *name
 extern bool is_specified_option(const char *arg, const char *little, const char *large);
 extern void cmd_option_register(const char *little, const char *large, uint8_t have_param,
 				command_record_t record);
+extern void cmd_writer_option_register(const char *little, const char *large,
+				       uint8_t have_param, command_record_t record);
 extern void command_parse_and_excute(const int argc, const char **argv);
+extern int cmd_sleep_until(uint64_t deadline_ns);
 extern struct major_cmd_ctrl *get_major_cmd(void);
 
 #endif /* TOOL_CMD_H */
@@ -16,7 +16,7 @@
 #include <errno.h>
 #include <time.h>
 
-uint32_t get_chip_type(void)
+static uint32_t read_chip_type(void)
 {
 	char part_num_str[MIDR_BUFFER_SIZE] = {0};
 	char midr_buffer[MIDR_BUFFER_SIZE] = {0};
@@ -64,6 +64,20 @@ uint32_t get_chip_type(void)
 	return chip_type;
 }
 
+/* The chip does not change under a running process, read MIDR only once */
+uint32_t get_chip_type(void)
+{
+	static uint32_t chip_type = CHIP_UNKNOW;
+	static bool detected;
+
+	if (!detected) {
+		chip_type = read_chip_type();
+		detected = true;
+	}
+
+	return chip_type;
+}
+
 int string_toui(const char *nptr, uint32_t *value)
 {
 	char *endptr = NULL;
@@ -400,3 +414,181 @@ bool tool_can_print(uint32_t interval, uint32_t burst, uint32_t *print_num, uint
 
 	return false;
 }
+
+enum tool_cnt_move tool_cnt_delta(uint64_t old_val, uint64_t new_val, uint64_t mask,
+				  uint64_t *delta)
+{
+	uint64_t window = mask / TOOL_CNT_WRAP_WINDOW;
+
+	old_val &= mask;
+	new_val &= mask;
+	if (new_val >= old_val) {
+		*delta = new_val - old_val;
+		return TOOL_CNT_UP;
+	}
+	if (old_val >= mask - window && new_val <= window) {
+		*delta = (new_val - old_val) & mask;
+		return TOOL_CNT_WRAP;
+	}
+	*delta = old_val - new_val;
+
+	return TOOL_CNT_DOWN;
+}
+
+/* 32 bit FNV-1a, the hash of the small open addressing lookup tables */
+uint32_t tool_fnv1a(const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	uint32_t hash = 2166136261U;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= p[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/* CLOCK_MONOTONIC in ns, for measuring sample intervals of the periodic modes */
+uint64_t tool_get_time_ns(void)
+{
+	struct timespec ts = {0};
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * HIKP_NSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/* CLOCK_REALTIME in ns, for time stamps that are printed or stored in files */
+uint64_t tool_get_wall_time_ns(void)
+{
+	struct timespec ts = {0};
+
+	(void)clock_gettime(CLOCK_REALTIME, &ts);
+	return (uint64_t)ts.tv_sec * HIKP_NSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Sleep until an absolute tool_get_time_ns() deadline, so that a periodic
+ * sampler keeps its rate however long each round takes.
+ */
+void tool_sleep_until(uint64_t deadline_ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec = (time_t)(deadline_ns / HIKP_NSEC_PER_SEC);
+	ts.tv_nsec = (long)(deadline_ns % HIKP_NSEC_PER_SEC);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+}
+
+int tool_snap_save(const struct tool_snap *snap, const void *data, uint32_t data_len,
+		   bool append)
+{
+	struct tool_snap_head head = {0};
+	FILE *fp;
+	int ret = 0;
+
+	head.magic = TOOL_SNAP_MAGIC;
+	head.type = snap->type;
+	head.version = snap->version;
+	head.key_len = snap->key_len;
+	head.time_ns = tool_get_wall_time_ns();
+	head.data_len = data_len;
+
+	fp = fopen(snap->file, append ? "ab" : "wb");
+	if (fp == NULL) {
+		ret = -errno;
+		HIKP_ERROR_PRINT("failed to open %s, errno = %d.\n", snap->file, -ret);
+		return ret;
+	}
+	if (fwrite(&head, sizeof(head), 1, fp) != 1 ||
+	    (snap->key_len != 0 && fwrite(snap->key, snap->key_len, 1, fp) != 1) ||
+	    (data_len != 0 && fwrite(data, data_len, 1, fp) != 1)) {
+		HIKP_ERROR_PRINT("failed to write %s.\n", snap->file);
+		ret = -EIO;
+	}
+	if (fclose(fp) != 0 && ret == 0)
+		ret = -errno;
+
+	return ret;
+}
+
+static int tool_snap_read_data(const struct tool_snap *snap, FILE *fp,
+			       const struct tool_snap_head *head, void **data)
+{
+	/* Zeroed slack after the payload, the buffer is never NULL for an empty one */
+	*data = calloc(1, (size_t)head->data_len + sizeof(uint64_t));
+	if (*data == NULL) {
+		HIKP_ERROR_PRINT("failed to alloc %u bytes for %s.\n", head->data_len, snap->file);
+		return -ENOMEM;
+	}
+	if (head->data_len != 0 && fread(*data, head->data_len, 1, fp) != 1) {
+		HIKP_ERROR_PRINT("%s is truncated.\n", snap->file);
+		free(*data);
+		*data = NULL;
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Find the first record whose key snap->key_check() takes and return its
+ * payload in *data, to be freed by the caller. The saved key is copied to
+ * saved_key, which must hold snap->key_len bytes.
+ */
+int tool_snap_load(const struct tool_snap *snap, struct tool_snap_head *head,
+		   void *saved_key, void **data)
+{
+	int ret = -ENOENT;
+	FILE *fp;
+
+	*data = NULL;
+	fp = fopen(snap->file, "rb");
+	if (fp == NULL) {
+		ret = -errno;
+		HIKP_ERROR_PRINT("failed to open %s, errno = %d.\n", snap->file, -ret);
+		return ret;
+	}
+
+	while (fread(head, sizeof(*head), 1, fp) == 1) {
+		if (head->magic != TOOL_SNAP_MAGIC || head->type != snap->type ||
+		    head->version != snap->version || head->key_len != snap->key_len ||
+		    head->data_len > snap->max_data_len) {
+			HIKP_ERROR_PRINT("%s is not a %s snapshot.\n", snap->file, snap->name);
+			ret = -EINVAL;
+			goto out;
+		}
+		if (snap->key_len != 0 && fread(saved_key, snap->key_len, 1, fp) != 1) {
+			HIKP_ERROR_PRINT("%s is truncated.\n", snap->file);
+			ret = -EINVAL;
+			goto out;
+		}
+		ret = snap->key_check != NULL ? snap->key_check(saved_key, snap->key) :
+		      TOOL_SNAP_KEY_MATCH;
+		if (ret < 0)
+			goto out;
+		if (ret == TOOL_SNAP_KEY_MATCH) {
+			ret = tool_snap_read_data(snap, fp, head, data);
+			goto out;
+		}
+		if (fseek(fp, (long)head->data_len, SEEK_CUR) != 0)
+			break;
+		ret = -ENOENT;
+	}
+	HIKP_ERROR_PRINT("%s holds no matching %s snapshot.\n", snap->file, snap->name);
+	ret = -ENOENT;
+
+out:
+	fclose(fp);
+	return ret;
+}
+
+/* Seconds from a loaded record to now, 0 if the clock went back */
+double tool_snap_age(const struct tool_snap_head *head)
+{
+	uint64_t now_ns = tool_get_wall_time_ns();
+
+	return now_ns > head->time_ns ? (double)(now_ns - head->time_ns) / HIKP_NSEC_PER_SEC : 0;
+}
@@ -33,6 +33,7 @@
 #define HIKP_DIV_ROUND_UP(n, d) (((n) + (d) - 1) / (d))
 
 #define HIKP_MIN(a, b)          ((a) < (b) ? (a) : (b))
+#define HIKP_MAX(a, b)          ((a) > (b) ? (a) : (b))
 
 #define BITS_PER_LONG	(sizeof(long) * 8)
 #define GENMASK(h, l) (((~0UL) << (l)) & (~0UL >> (BITS_PER_LONG - 1 - (h))))
@@ -44,6 +45,9 @@
 
 #define HIKP_BITS_PER_BYTE  8
 
+#define HIKP_NSEC_PER_SEC	1000000000ULL
+#define HIKP_NSEC_PER_MSEC	1000000ULL
+
 #define MAX_CMD_LEN 30
 #define MAX_HELP_INFO_LEN 100
 struct hikp_cmd_type {
@@ -125,5 +129,69 @@ bool is_file_exist(const char *file);
 int generate_file_name(unsigned char *file_name, uint32_t file_name_len,
 		       const unsigned char *prefix);
 bool tool_can_print(uint32_t interval, uint32_t burst, uint32_t *print_num, uint64_t *last_time);
+uint32_t tool_fnv1a(const void *data, size_t len);
+uint64_t tool_get_time_ns(void);
+uint64_t tool_get_wall_time_ns(void);
+void tool_sleep_until(uint64_t deadline_ns);
+
+/*
+ * How a counter moved between two samples. A decrease is only taken as a wrap
+ * when the old value sat in the top 1/TOOL_CNT_WRAP_WINDOW of the counter range
+ * and the new one in the bottom of it, any other decrease is a clear or reset.
+ */
+#define TOOL_CNT_WRAP_WINDOW 16U
+
+enum tool_cnt_move {
+	TOOL_CNT_UP,
+	TOOL_CNT_WRAP,
+	TOOL_CNT_DOWN, /* delta is the decrease, there is no rate */
+};
+
+enum tool_cnt_move tool_cnt_delta(uint64_t old_val, uint64_t new_val, uint64_t mask,
+				  uint64_t *delta);
+
+/*
+ * A --save/--diff snapshot file is a list of records, each one this head,
+ * key_len bytes of module key and data_len bytes of module payload. The key
+ * tells what was sampled (device, sub command, ...), the payload is opaque.
+ */
+#define TOOL_SNAP_MAGIC 0x50414E53 /* "SNAP" */
+
+struct tool_snap_head {
+	uint32_t magic;
+	uint32_t type; /* module snapshot type */
+	uint32_t version; /* module key and payload layout */
+	uint32_t key_len;
+	uint64_t time_ns; /* tool_get_wall_time_ns() at save */
+	uint32_t data_len;
+	uint32_t rsv;
+};
+
+enum tool_snap_key_state {
+	TOOL_SNAP_KEY_MATCH,
+	TOOL_SNAP_KEY_SKIP, /* record of another table in the same file */
+};
+
+struct tool_snap {
+	const char *file;
+	const char *name; /* module name for messages */
+	uint32_t type;
+	uint32_t version;
+	const void *key; /* key to save, or the one wanted by a load */
+	uint32_t key_len;
+	uint32_t max_data_len;
+	/*
+	 * Return a tool_snap_key_state, or print why the saved key can not be
+	 * diffed against the wanted one and return a negative errno.
+	 * NULL takes the first record.
+	 */
+	int (*key_check)(const void *saved_key, const void *key);
+};
+
+int tool_snap_save(const struct tool_snap *snap, const void *data, uint32_t data_len,
+		   bool append);
+int tool_snap_load(const struct tool_snap *snap, struct tool_snap_head *head,
+		   void *saved_key, void **data);
+double tool_snap_age(const struct tool_snap_head *head);
 
 #endif /* TOOL_LIB_H */
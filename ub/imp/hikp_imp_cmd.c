@@ -27,6 +27,12 @@ static int hikp_imp_cmd_help(struct major_cmd_ctrl *self, const char *argv)
 	printf("  Options:\n\n");
 	printf("    %s, %-25s %s\n", "-h", "--help", "display this help and exit");
 	printf("    %s, %-25s %s\n", "-l", "--log", "dump imp log function");
+	printf("    %s, %-25s %s\n", "-f", "--follow",
+	       "append only the log written since the last follow to a rolling file");
+	printf("    %s, %-25s %s\n", "-i", "--interval=<s>",
+	       "keep following every <s> seconds, used with -f");
+	printf("    %s, %-25s %s\n", "-n", "--count=<num>",
+	       "stop following after <num> rounds, default until interrupted");
 	printf("    %s, %-25s %s\n", "-c", "--chip=<chip>", "chip id for dump imp dfx");
 	printf("    %s, %-25s %s\n", "-d", "--die=<die>", "die id for dump imp dfx");
 	printf("\n");
@@ -45,6 +51,46 @@ static int hikp_imp_cmd_dump_log(struct major_cmd_ctrl *self, const char *argv)
 	return 0;
 }
 
+static int hikp_imp_cmd_follow_log(struct major_cmd_ctrl *self, const char *argv)
+{
+	HIKP_SET_USED(self);
+	HIKP_SET_USED(argv);
+
+	g_imp_cmd_cfg.param_mask |= PARAM_FUNC_MASK;
+	g_imp_cmd_cfg.func_type = IMP_FUNC_FOLLOW_LOG;
+
+	return 0;
+}
+
+static int hikp_imp_cmd_get_interval(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t val = 0;
+
+	if (string_toui(argv, &val) != 0 || val == 0 || val > IMP_FOLLOW_MAX_INTERVAL) {
+		snprintf(self->err_str, sizeof(self->err_str),
+			 "Invalid interval, range is 1~%u seconds.", IMP_FOLLOW_MAX_INTERVAL);
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+	g_imp_cmd_cfg.interval = val;
+
+	return 0;
+}
+
+static int hikp_imp_cmd_get_count(struct major_cmd_ctrl *self, const char *argv)
+{
+	uint32_t val = 0;
+
+	if (string_toui(argv, &val) != 0 || val == 0) {
+		snprintf(self->err_str, sizeof(self->err_str), "Invalid count.");
+		self->err_no = -EINVAL;
+		return -EINVAL;
+	}
+	g_imp_cmd_cfg.count = val;
+
+	return 0;
+}
+
 static int hikp_imp_cmd_get_chip(struct major_cmd_ctrl *self, const char *argv)
 {
 	char *endptr = NULL;
@@ -92,8 +138,10 @@ static void hikp_imp_cmd_execute(struct major_cmd_ctrl *self)
 		return;
 	}
 
-	/* Currently, only the dump log function is supported. */
-	hikp_imp_dump_log(self, &g_imp_cmd_cfg);
+	if (g_imp_cmd_cfg.func_type == IMP_FUNC_FOLLOW_LOG)
+		hikp_imp_follow_log(self, &g_imp_cmd_cfg);
+	else
+		hikp_imp_dump_log(self, &g_imp_cmd_cfg);
 }
 
 static void cmd_imp_dfx_init(void)
@@ -105,6 +153,9 @@ static void cmd_imp_dfx_init(void)
 
 	cmd_option_register("-h", "--help", false, hikp_imp_cmd_help);
 	cmd_option_register("-l", "--log", false, hikp_imp_cmd_dump_log);
+	cmd_option_register("-f", "--follow", false, hikp_imp_cmd_follow_log);
+	cmd_option_register("-i", "--interval", true, hikp_imp_cmd_get_interval);
+	cmd_option_register("-n", "--count", true, hikp_imp_cmd_get_count);
 	cmd_option_register("-c", "--chip", true, hikp_imp_cmd_get_chip);
 	cmd_option_register("-d", "--die", true, hikp_imp_cmd_get_die);
 }
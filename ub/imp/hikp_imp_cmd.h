@@ -19,8 +19,11 @@
 #define PARAM_CHIP_MASK		HI_BIT(1)
 #define PARAM_DIE_MASK		HI_BIT(2)
 
+#define IMP_FOLLOW_MAX_INTERVAL	3600 /* seconds */
+
 enum imp_func_type {
 	IMP_FUNC_DUMP_LOG = 1,
+	IMP_FUNC_FOLLOW_LOG = 2,
 };
 
 struct imp_cmd_cfg {
@@ -29,6 +32,8 @@ struct imp_cmd_cfg {
 	uint8_t die;
 	uint8_t rsvd;
 	uint32_t param_mask;
+	uint32_t interval; /* follow period in seconds, 0 means a single pass */
+	uint32_t count; /* follow rounds, 0 means until interrupted */
 };
 
 #endif /* HIKP_IMP_CMD_H */
@@ -188,3 +188,231 @@ void hikp_imp_dump_log(struct major_cmd_ctrl *self, struct imp_cmd_cfg *cmd_cfg)
 	self->err_no = hikp_imp_log_write_to_file(log_data, log_size);
 	free(log_data);
 }
+
+static void hikp_imp_log_load_cursor(const char *path, const struct imp_cmd_cfg *cmd_cfg,
+				     struct imp_log_cursor *cursor)
+{
+	size_t read_cnt = 0;
+	FILE *fp;
+
+	fp = fopen(path, "r");
+	if (fp != NULL) {
+		read_cnt = fread(cursor, 1, sizeof(*cursor), fp);
+		(void)fclose(fp);
+	}
+
+	if (read_cnt != sizeof(*cursor) || cursor->magic != IMP_LOG_CURSOR_MAGIC ||
+	    cursor->version != IMP_LOG_CURSOR_VER || cursor->chip != cmd_cfg->chip ||
+	    cursor->die != cmd_cfg->die || cursor->offset > LOG_DATA_BLK_SIZE) {
+		memset(cursor, 0, sizeof(*cursor));
+		cursor->magic = IMP_LOG_CURSOR_MAGIC;
+		cursor->version = IMP_LOG_CURSOR_VER;
+		cursor->chip = cmd_cfg->chip;
+		cursor->die = cmd_cfg->die;
+		cursor->csum = tool_fnv1a(NULL, 0);
+	}
+}
+
+static int hikp_imp_log_save_cursor(const char *path, const struct imp_log_cursor *cursor)
+{
+	char tmp_path[OP_LOG_FILE_PATH_MAXLEN] = {0};
+	size_t write_cnt;
+	FILE *fp;
+	int ret;
+
+	ret = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+	if (ret < 0 || (size_t)ret >= sizeof(tmp_path))
+		return -EINVAL;
+
+	/* Write aside and rename, so an interrupted save keeps the old cursor */
+	fp = fopen(tmp_path, "w");
+	if (fp == NULL) {
+		HIKP_ERROR_PRINT("open %s failed, errno is %d\n", tmp_path, errno);
+		return -errno;
+	}
+	write_cnt = fwrite(cursor, 1, sizeof(*cursor), fp);
+	if (fclose(fp) != 0 || write_cnt != sizeof(*cursor)) {
+		HIKP_ERROR_PRINT("write %s failed.\n", tmp_path);
+		(void)remove(tmp_path);
+		return -EIO;
+	}
+
+	if (rename(tmp_path, path) != 0) {
+		HIKP_ERROR_PRINT("rename %s failed, errno is %d\n", tmp_path, errno);
+		(void)remove(tmp_path);
+		return -errno;
+	}
+
+	return 0;
+}
+
+static int hikp_imp_log_fetch_blk(struct imp_cmd_cfg *cmd_cfg, uint32_t blk_id,
+				  struct imp_log_rsp_data *blk)
+{
+	struct hikp_cmd_ret *cmd_ret = NULL;
+	struct imp_log_rsp_data *log_rsp;
+	int ret;
+
+	ret = hikp_imp_log_get_blk_data(&cmd_ret, blk_id, cmd_cfg);
+	if (ret)
+		goto err_out;
+
+	log_rsp = (struct imp_log_rsp_data *)(cmd_ret->rsp_data);
+	if (log_rsp->cur_blk_size > sizeof(log_rsp->log_data)) {
+		HIKP_ERROR_PRINT("blk%u data size(0x%x) is invalid.\n",
+				 blk_id, log_rsp->cur_blk_size);
+		ret = -EINVAL;
+		goto err_out;
+	}
+	memcpy(blk, log_rsp, sizeof(*blk));
+
+err_out:
+	hikp_cmd_free(&cmd_ret);
+
+	return ret;
+}
+
+/*
+ * Append everything after the cursor to fp. The block the cursor stops in
+ * is read again since it may have grown, then all blocks after it.
+ */
+static int hikp_imp_log_follow_data(struct imp_cmd_cfg *cmd_cfg, struct imp_log_cursor *cursor,
+				    FILE *fp, uint32_t *new_len)
+{
+	struct imp_log_rsp_data first, blk;
+	uint32_t blk_id = cursor->blk_id;
+	uint32_t start = cursor->offset;
+	bool restart;
+	uint32_t len;
+	int ret;
+
+	/*
+	 * Block 0 tells the current block count, a saved block past it means the
+	 * log restarted. A failed fetch is no such evidence, it keeps the cursor.
+	 */
+	ret = hikp_imp_log_fetch_blk(cmd_cfg, 0, &first);
+	if (ret)
+		return ret;
+
+	blk = first;
+	restart = blk_id != 0 && blk_id >= first.total_blk_num;
+	if (!restart && blk_id != 0) {
+		ret = hikp_imp_log_fetch_blk(cmd_cfg, blk_id, &blk);
+		if (ret)
+			return ret;
+	}
+	if (!restart && start != 0)
+		restart = blk.cur_blk_size < start ||
+			  tool_fnv1a(blk.log_data, start) != cursor->csum;
+	if (restart) {
+		printf("imp log has been restarted, follow it from the beginning.\n");
+		blk_id = 0;
+		start = 0;
+		blk = first;
+	}
+
+	for (;;) {
+		len = blk.cur_blk_size - start;
+		if (len != 0 && fwrite(blk.log_data + start, 1, len, fp) != len) {
+			HIKP_ERROR_PRINT("write imp log failed, errno is %d\n", errno);
+			return -EIO;
+		}
+		*new_len += len;
+		cursor->blk_id = blk_id;
+		cursor->offset = blk.cur_blk_size;
+		cursor->csum = tool_fnv1a(blk.log_data, blk.cur_blk_size);
+
+		blk_id++;
+		if (blk_id >= blk.total_blk_num)
+			break;
+
+		start = 0;
+		ret = hikp_imp_log_fetch_blk(cmd_cfg, blk_id, &blk);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int hikp_imp_log_follow_once(struct imp_cmd_cfg *cmd_cfg, struct imp_log_cursor *cursor,
+				    const char *log_path, const char *backup_path,
+				    const char *cursor_path)
+{
+	struct imp_log_cursor next = *cursor;
+	uint32_t new_len = 0;
+	FILE *fp;
+	int ret;
+
+	ret = file_rollback(log_path, backup_path, IMP_LOG_FOLLOW_MAX_SIZE);
+	if (ret == 0)
+		printf("imp follow log is full, the old one is backed up to %s.\n", backup_path);
+	else if (ret != FILE_LEN_OK)
+		return ret;
+
+	fp = fopen(log_path, "a");
+	if (fp == NULL) {
+		HIKP_ERROR_PRINT("open %s failed, errno is %d\n", log_path, errno);
+		return -errno;
+	}
+
+	ret = hikp_imp_log_follow_data(cmd_cfg, &next, fp, &new_len);
+	/* A failed close may have lost the data, keep the cursor to fetch it again */
+	if (fclose(fp) != 0) {
+		HIKP_ERROR_PRINT("close %s failed, errno is %d\n", log_path, errno);
+		return ret != 0 ? ret : -EIO;
+	}
+	/* Data already written stays, the cursor only moves past what was saved */
+	if (new_len != 0 || ret == 0) {
+		*cursor = next;
+		(void)hikp_imp_log_save_cursor(cursor_path, cursor);
+	}
+	if (ret)
+		return ret;
+
+	if (new_len != 0 || cmd_cfg->interval == 0)
+		printf("follow imp log completed, %u new bytes appended to %s.\n",
+		       new_len, log_path);
+
+	return 0;
+}
+
+void hikp_imp_follow_log(struct major_cmd_ctrl *self, struct imp_cmd_cfg *cmd_cfg)
+{
+	char backup_path[OP_LOG_FILE_PATH_MAXLEN] = {0};
+	char cursor_path[OP_LOG_FILE_PATH_MAXLEN] = {0};
+	char log_path[OP_LOG_FILE_PATH_MAXLEN] = {0};
+	struct imp_log_cursor cursor;
+	uint64_t deadline;
+	uint32_t round;
+
+	(void)snprintf(log_path, sizeof(log_path), HIKP_LOG_DIR_PATH IMP_LOG_FOLLOW_FILE,
+		       cmd_cfg->chip, cmd_cfg->die);
+	(void)snprintf(backup_path, sizeof(backup_path), HIKP_LOG_DIR_PATH IMP_LOG_FOLLOW_BACKUP,
+		       cmd_cfg->chip, cmd_cfg->die);
+	(void)snprintf(cursor_path, sizeof(cursor_path), HIKP_LOG_DIR_PATH IMP_LOG_CURSOR_FILE,
+		       cmd_cfg->chip, cmd_cfg->die);
+	hikp_imp_log_load_cursor(cursor_path, cmd_cfg, &cursor);
+
+	deadline = tool_get_time_ns();
+	for (round = 1; ; round++) {
+		self->err_no = hikp_imp_log_follow_once(cmd_cfg, &cursor, log_path, backup_path,
+							cursor_path);
+		if (self->err_no && cmd_cfg->interval == 0) {
+			snprintf(self->err_str, sizeof(self->err_str), "follow imp log fail.");
+			return;
+		}
+		if (self->err_no)
+			printf("follow imp log round %u fail, ret %d.\n", round, self->err_no);
+		(void)fflush(stdout);
+
+		if (cmd_cfg->interval == 0 || (cmd_cfg->count != 0 && round >= cmd_cfg->count))
+			break;
+		deadline += (uint64_t)cmd_cfg->interval * HIKP_NSEC_PER_SEC;
+		self->err_no = cmd_sleep_until(deadline);
+		if (self->err_no) {
+			snprintf(self->err_str, sizeof(self->err_str), "retake the lock fail.");
+			return;
+		}
+	}
+}
@@ -44,6 +44,31 @@ struct imp_log_blk_ctrl {
 	uint32_t total_blk_num;
 };
 
+#define IMP_LOG_FOLLOW_FILE	"imp_follow_c%u_d%u.log"
+#define IMP_LOG_FOLLOW_BACKUP	"imp_follow_c%u_d%u.log.old"
+#define IMP_LOG_CURSOR_FILE	"imp_follow_c%u_d%u.cursor"
+#define IMP_LOG_FOLLOW_MAX_SIZE	0x1000000 /* 16M, then rolled to the .old file */
+
+#define IMP_LOG_CURSOR_MAGIC	0x474f4c49 /* "ILOG" */
+#define IMP_LOG_CURSOR_VER	1
+
+/*
+ * Where imp -f stopped: bytes [0, offset) of block blk_id have been
+ * written out. csum covers these bytes, so a restarted or wrapped log
+ * is noticed when the block is read again.
+ */
+struct imp_log_cursor {
+	uint32_t magic;
+	uint32_t version;
+	uint8_t chip;
+	uint8_t die;
+	uint8_t rsv[2];
+	uint32_t blk_id;
+	uint32_t offset;
+	uint32_t csum;
+};
+
 void hikp_imp_dump_log(struct major_cmd_ctrl *self, struct imp_cmd_cfg *cmd_cfg);
+void hikp_imp_follow_log(struct major_cmd_ctrl *self, struct imp_cmd_cfg *cmd_cfg);
 
 #endif /* HIKP_IMP_LOG_H */
@@ -131,6 +131,6 @@ void cmd_ubus_err_init(void)
 	major_cmd->execute = ubus_err_execute;
 	cmd_option_register("-h", "--help", false, ubus_err_help);
 	cmd_option_register("-i", "--portidx", true, ubus_err_port_id_set);
-	cmd_option_register("-ec", "--clear", false, ubus_err_cmd_clear_set);
+	cmd_writer_option_register("-ec", "--clear", false, ubus_err_cmd_clear_set);
 	cmd_option_register("-es", "--show", false, ubus_err_cmd_show_set);
 }
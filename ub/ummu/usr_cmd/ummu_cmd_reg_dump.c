@@ -428,7 +428,7 @@ static void cmd_ummu_reg_dump_init(void)
 	cmd_option_register("-h", "--help", false, ummu_reg_dump_help);
 	cmd_option_register("-d", "--dump", true, ummu_reg_dump_type_set);
 	cmd_option_register("-i", "--cache_idx", true, ummu_cache_idx_set);
-	cmd_option_register("-s", "--sync_timeout_set", true, ummu_sync_timeout_set);
+	cmd_writer_option_register("-s", "--sync_timeout_set", true, ummu_sync_timeout_set);
 	cmd_option_register("-r", "--rr_win_num", true, ummu_rr_win_num_set);
 	cmd_option_register("-k", "--kcmd_entry_no", true, ummu_kcmd_entry_no_set);
 	cmd_option_register("-u", "--ummu_id", true, ummu_id_set);